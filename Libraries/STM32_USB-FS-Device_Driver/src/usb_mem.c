@@ -1,132 +1,240 @@
-/**
-  ******************************************************************************
-  * @file    usb_mem.c
-  * @author  MCD Application Team
-  * @version V4.1.0
-  * @date    26-May-2017
-  * @brief   Utility functions for memory transfers to/from PMA
-  ******************************************************************************
-  * @attention
-  *
-  * <h2><center>&copy; Copyright (c) 2017 STMicroelectronics International N.V. 
-  * All rights reserved.</center></h2>
-  *
-  * Redistribution and use in source and binary forms, with or without 
-  * modification, are permitted, provided that the following conditions are met:
-  *
-  * 1. Redistribution of source code must retain the above copyright notice, 
-  *    this list of conditions and the following disclaimer.
-  * 2. Redistributions in binary form must reproduce the above copyright notice,
-  *    this list of conditions and the following disclaimer in the documentation
-  *    and/or other materials provided with the distribution.
-  * 3. Neither the name of STMicroelectronics nor the names of other 
-  *    contributors to this software may be used to endorse or promote products 
-  *    derived from this software without specific written permission.
-  * 4. This software, including modifications and/or derivative works of this 
-  *    software, must execute solely and exclusively on microcontroller or
-  *    microprocessor devices manufactured by or for STMicroelectronics.
-  * 5. Redistribution and use of this software other than as permitted under 
-  *    this license is void and will automatically terminate your rights under 
-  *    this license. 
-  *
-  * THIS SOFTWARE IS PROVIDED BY STMICROELECTRONICS AND CONTRIBUTORS "AS IS" 
-  * AND ANY EXPRESS, IMPLIED OR STATUTORY WARRANTIES, INCLUDING, BUT NOT 
-  * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A 
-  * PARTICULAR PURPOSE AND NON-INFRINGEMENT OF THIRD PARTY INTELLECTUAL PROPERTY
-  * RIGHTS ARE DISCLAIMED TO THE FULLEST EXTENT PERMITTED BY LAW. IN NO EVENT 
-  * SHALL STMICROELECTRONICS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
-  * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
-  * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, 
-  * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
-  * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING 
-  * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
-  * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
-  *
-  ******************************************************************************
-  */
-
-/* Includes ------------------------------------------------------------------*/
-#include "usb_lib.h"
-
-/* Private typedef -----------------------------------------------------------*/
-/* Private define ------------------------------------------------------------*/
-/* Private macro -------------------------------------------------------------*/
-/* Private variables ---------------------------------------------------------*/
-/* Extern variables ----------------------------------------------------------*/
-/* Private function prototypes -----------------------------------------------*/
-/* Private functions ---------------------------------------------------------*/
-
-/**
-  * Function Name  : UserToPMABufferCopy
-  * Description    : Copy a buffer from user memory area to packet memory area (PMA)
-  * Input          : - pbUsrBuf: pointer to user memory area.
-  *                  - wPMABufAddr: address into PMA.
-  *                  - wNBytes: no. of bytes to be copied.
-  * Output         : None.
-  * Return         : None	.
-  **/
-void UserToPMABufferCopy(uint8_t *pbUsrBuf, uint16_t wPMABufAddr, uint16_t wNBytes)
-{
-#if defined STM32F303xE || defined STM32F302x8 
-  uint32_t n = (wNBytes + 1) >> 1;   /* n = (wNBytes + 1) / 2 */
-  uint32_t i;
-  uint16_t *pdwVal;
-  pdwVal = (uint16_t *)(wPMABufAddr + PMAAddr);
-  
-  for (i = n; i != 0; i--)
-  {
-    *pdwVal++ = *(uint16_t*)pbUsrBuf++;
-    pbUsrBuf++;
-  }
-#else
-  uint32_t n = (wNBytes + 1) >> 1;   /* n = (wNBytes + 1) / 2 */
-  uint32_t i, temp1, temp2;
-  uint16_t *pdwVal;
-  pdwVal = (uint16_t *)(wPMABufAddr * 2 + PMAAddr);
-  for (i = n; i != 0; i--)
-  {
-    temp1 = (uint16_t) * pbUsrBuf;
-    pbUsrBuf++;
-    temp2 = temp1 | (uint16_t) * pbUsrBuf << 8;
-    *pdwVal++ = temp2;
-    pdwVal++;
-    pbUsrBuf++;
-  }
-#endif
-}
-
-/**
-  * Function Name  : PMAToUserBufferCopy
-  * Description    : Copy a buffer from user memory area to packet memory area (PMA)
-  * Input          : - pbUsrBuf    = pointer to user memory area.
-  *                  - wPMABufAddr = address into PMA.
-  *                  - wNBytes     = no. of bytes to be copied.
-  * Output         : None.
-  * Return         : None.
-  **/
-void PMAToUserBufferCopy(uint8_t *pbUsrBuf, uint16_t wPMABufAddr, uint16_t wNBytes)
-{
-#if defined STM32F303xE || defined STM32F302x8 
-  uint32_t n = (wNBytes + 1) >> 1;/* /2*/
-  uint32_t i;
-  uint16_t *pdwVal;
-  pdwVal = (uint16_t *)(wPMABufAddr + PMAAddr);
-  for (i = n; i != 0; i--)
-  {
-    *(uint16_t*)pbUsrBuf++ = *pdwVal++;
-    pbUsrBuf++;
-  }
-#else
-  uint32_t n = (wNBytes + 1) >> 1;/* /2*/
-  uint32_t i;
-  uint32_t *pdwVal;
-  pdwVal = (uint32_t *)(wPMABufAddr * 2 + PMAAddr);
-  for (i = n; i != 0; i--)
-  {
-    *(uint16_t*)pbUsrBuf++ = *pdwVal++;
-    pbUsrBuf++;
-  }
-#endif
-}
-
-/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
+/**
+  ******************************************************************************
+  * @file    usb_mem.c
+  * @author  MCD Application Team
+  * @version V4.1.0
+  * @date    26-May-2017
+  * @brief   Utility functions for memory transfers to/from PMA
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2017 STMicroelectronics International N.V. 
+  * All rights reserved.</center></h2>
+  *
+  * Redistribution and use in source and binary forms, with or without 
+  * modification, are permitted, provided that the following conditions are met:
+  *
+  * 1. Redistribution of source code must retain the above copyright notice, 
+  *    this list of conditions and the following disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  * 3. Neither the name of STMicroelectronics nor the names of other 
+  *    contributors to this software may be used to endorse or promote products 
+  *    derived from this software without specific written permission.
+  * 4. This software, including modifications and/or derivative works of this 
+  *    software, must execute solely and exclusively on microcontroller or
+  *    microprocessor devices manufactured by or for STMicroelectronics.
+  * 5. Redistribution and use of this software other than as permitted under 
+  *    this license is void and will automatically terminate your rights under 
+  *    this license. 
+  *
+  * THIS SOFTWARE IS PROVIDED BY STMICROELECTRONICS AND CONTRIBUTORS "AS IS" 
+  * AND ANY EXPRESS, IMPLIED OR STATUTORY WARRANTIES, INCLUDING, BUT NOT 
+  * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A 
+  * PARTICULAR PURPOSE AND NON-INFRINGEMENT OF THIRD PARTY INTELLECTUAL PROPERTY
+  * RIGHTS ARE DISCLAIMED TO THE FULLEST EXTENT PERMITTED BY LAW. IN NO EVENT 
+  * SHALL STMICROELECTRONICS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+  * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, 
+  * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+  * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING 
+  * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+  * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "usb_lib.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Extern variables ----------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * Function Name  : UserToPMABufferCopy
+  * Description    : Copy a buffer from user memory area to packet memory area (PMA)
+  *                  Exactly wNBytes are written. wPMABufAddr may be odd: the low
+  *                  byte already in that PMA word is kept, so a packet can be
+  *                  assembled from the two spans of a ring buffer.
+  *                  Halfword aligned sources are copied with 16-bit loads,
+  *                  unaligned sources byte-wise; both loops are unrolled by 4.
+  * Input          : - pbUsrBuf: pointer to user memory area.
+  *                  - wPMABufAddr: address into PMA.
+  *                  - wNBytes: no. of bytes to be copied.
+  * Output         : None.
+  * Return         : None	.
+  **/
+void UserToPMABufferCopy(uint8_t *pbUsrBuf, uint16_t wPMABufAddr, uint16_t wNBytes)
+{
+#if defined STM32F303xE || defined STM32F302x8 
+  uint32_t n = (wNBytes + 1) >> 1;   /* n = (wNBytes + 1) / 2 */
+  uint32_t i;
+  uint16_t *pdwVal;
+  pdwVal = (uint16_t *)(wPMABufAddr + PMAAddr);
+  
+  for (i = n; i != 0; i--)
+  {
+    *pdwVal++ = *(uint16_t*)pbUsrBuf++;
+    pbUsrBuf++;
+  }
+#else
+  /* Each 16-bit PMA word occupies a 32-bit slot: halfword index i is at pdwVal[2 * i] */
+  uint32_t i;
+  uint16_t *pdwVal;
+  uint16_t *pwUsr;
+
+  pdwVal = (uint16_t *)((wPMABufAddr & ~1) * 2 + PMAAddr);
+  if ((wPMABufAddr & 1) && (wNBytes != 0))
+  {
+    /* odd start: fill the high byte of the current word */
+    *pdwVal = (uint16_t)((*pdwVal & 0x00FF) | ((uint16_t)*pbUsrBuf++ << 8));
+    pdwVal += 2;
+    wNBytes--;
+  }
+
+  if (((uint32_t)pbUsrBuf & 1) == 0)
+  {
+    pwUsr = (uint16_t *)pbUsrBuf;
+    for (i = wNBytes >> 3; i != 0; i--)
+    {
+      pdwVal[0] = pwUsr[0];
+      pdwVal[2] = pwUsr[1];
+      pdwVal[4] = pwUsr[2];
+      pdwVal[6] = pwUsr[3];
+      pdwVal += 8;
+      pwUsr += 4;
+    }
+    for (i = (wNBytes >> 1) & 3; i != 0; i--)
+    {
+      *pdwVal = *pwUsr++;
+      pdwVal += 2;
+    }
+    pbUsrBuf = (uint8_t *)pwUsr;
+  }
+  else
+  {
+    for (i = wNBytes >> 3; i != 0; i--)
+    {
+      pdwVal[0] = (uint16_t)(pbUsrBuf[0] | (pbUsrBuf[1] << 8));
+      pdwVal[2] = (uint16_t)(pbUsrBuf[2] | (pbUsrBuf[3] << 8));
+      pdwVal[4] = (uint16_t)(pbUsrBuf[4] | (pbUsrBuf[5] << 8));
+      pdwVal[6] = (uint16_t)(pbUsrBuf[6] | (pbUsrBuf[7] << 8));
+      pdwVal += 8;
+      pbUsrBuf += 8;
+    }
+    for (i = (wNBytes >> 1) & 3; i != 0; i--)
+    {
+      *pdwVal = (uint16_t)(pbUsrBuf[0] | (pbUsrBuf[1] << 8));
+      pdwVal += 2;
+      pbUsrBuf += 2;
+    }
+  }
+
+  if (wNBytes & 1)
+  {
+    *pdwVal = *pbUsrBuf;    /* high byte is filled by a following odd-start copy, if any */
+  }
+#endif
+}
+
+/**
+  * Function Name  : PMAToUserBufferCopy
+  * Description    : Copy a buffer from packet memory area (PMA) to user memory area.
+  *                  Exactly wNBytes are written (no pad byte for odd lengths), and
+  *                  wPMABufAddr may be odd, so a packet can be split across the
+  *                  two spans of a ring buffer at any byte.
+  *                  Halfword aligned destinations get one 16-bit store per PMA
+  *                  word, unaligned ones byte stores; both loops are unrolled by 4.
+  * Input          : - pbUsrBuf    = pointer to user memory area.
+  *                  - wPMABufAddr = address into PMA.
+  *                  - wNBytes     = no. of bytes to be copied.
+  * Output         : None.
+  * Return         : None.
+  **/
+void PMAToUserBufferCopy(uint8_t *pbUsrBuf, uint16_t wPMABufAddr, uint16_t wNBytes)
+{
+#if defined STM32F303xE || defined STM32F302x8 
+  uint32_t n = (wNBytes + 1) >> 1;/* /2*/
+  uint32_t i;
+  uint16_t *pdwVal;
+  pdwVal = (uint16_t *)(wPMABufAddr + PMAAddr);
+  for (i = n; i != 0; i--)
+  {
+    *(uint16_t*)pbUsrBuf++ = *pdwVal++;
+    pbUsrBuf++;
+  }
+#else
+  /* Each 16-bit PMA word occupies a 32-bit slot in the CPU address space */
+  uint32_t i;
+  uint32_t wVal;
+  uint32_t *pdwVal;
+  uint16_t *pwUsr;
+
+  pdwVal = (uint32_t *)((wPMABufAddr & ~1) * 2 + PMAAddr);
+  if ((wPMABufAddr & 1) && (wNBytes != 0))
+  {
+    /* odd start: the first byte is the high half of the current word */
+    *pbUsrBuf++ = (uint8_t)(*pdwVal++ >> 8);
+    wNBytes--;
+  }
+
+  if (((uint32_t)pbUsrBuf & 1) == 0)
+  {
+    pwUsr = (uint16_t *)pbUsrBuf;
+    for (i = wNBytes >> 3; i != 0; i--)
+    {
+      pwUsr[0] = (uint16_t)pdwVal[0];
+      pwUsr[1] = (uint16_t)pdwVal[1];
+      pwUsr[2] = (uint16_t)pdwVal[2];
+      pwUsr[3] = (uint16_t)pdwVal[3];
+      pwUsr += 4;
+      pdwVal += 4;
+    }
+    for (i = (wNBytes >> 1) & 3; i != 0; i--)
+    {
+      *pwUsr++ = (uint16_t)*pdwVal++;
+    }
+    pbUsrBuf = (uint8_t *)pwUsr;
+  }
+  else
+  {
+    for (i = wNBytes >> 3; i != 0; i--)
+    {
+      wVal = pdwVal[0];
+      pbUsrBuf[0] = (uint8_t)wVal;
+      pbUsrBuf[1] = (uint8_t)(wVal >> 8);
+      wVal = pdwVal[1];
+      pbUsrBuf[2] = (uint8_t)wVal;
+      pbUsrBuf[3] = (uint8_t)(wVal >> 8);
+      wVal = pdwVal[2];
+      pbUsrBuf[4] = (uint8_t)wVal;
+      pbUsrBuf[5] = (uint8_t)(wVal >> 8);
+      wVal = pdwVal[3];
+      pbUsrBuf[6] = (uint8_t)wVal;
+      pbUsrBuf[7] = (uint8_t)(wVal >> 8);
+      pbUsrBuf += 8;
+      pdwVal += 4;
+    }
+    for (i = (wNBytes >> 1) & 3; i != 0; i--)
+    {
+      wVal = *pdwVal++;
+      pbUsrBuf[0] = (uint8_t)wVal;
+      pbUsrBuf[1] = (uint8_t)(wVal >> 8);
+      pbUsrBuf += 2;
+    }
+  }
+
+  if (wNBytes & 1)
+  {
+    *pbUsrBuf = (uint8_t)*pdwVal;
+  }
+#endif
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,97 @@
+/*
+*********************************************************************************************************
+*
+*	模块名称 : nanoprintf 主机端测速
+*	文件名称 : bench_npf.c
+*	说    明 : 和 main.c 中 NpfBench() 相同的整数转换对比, 另外测几个格式的 npf_snprintf() 总时间。
+*			  在PC上运行, 用 clock_gettime() 计时, 单位 ns/次。
+*			  结果只反映PC的CPU, 不能换算成 Cortex-M3 的时钟周期 (开发板上的结果见 NPF_BENCH_EN)。
+*
+*			  用法: make -C Tests bench
+*
+*********************************************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+#define NANOPRINTF_IMPLEMENTATION
+#include "nanoprintf.h"
+
+#define NPF_BENCH_FMTS	3
+#define NPF_BENCH_LOOP	1000000
+
+/* 格式化整数时 npf_snprintf() 的总时间 */
+static const char *s_pBenchFmt[NPF_BENCH_FMTS] =
+{
+	"%d %s %08X\r\n",
+	"\r\n$TXDROP=%u#\r\n",
+	"%5d %-6s|\r\n"
+};
+
+/* main.c 中 NpfUtoaRef() 的副本: 原来的转换循环, 每位一次除法和一次求余 */
+static int NpfUtoaRef(char *buf, uint32_t i, unsigned base)
+{
+	char *dst = buf;
+
+	if (i == 0)
+	{
+		*dst++ = '0';
+	}
+	else
+	{
+		while (i)
+		{
+			unsigned const d = (unsigned)(i % base);
+
+			i /= base;
+			*dst++ = (d < 10) ? (char)('0' + d) : (char)('a' + (d - 10));
+		}
+	}
+	return (int)(dst - buf);
+}
+
+static double NowNs(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main(void)
+{
+	char acBuf[48];
+	volatile unsigned uiBase = 10;	/* 进制用变量, 防止编译器把除法优化成常数乘法 */
+	volatile int iSink = 0;
+	double dStart;
+	int i, k;
+
+	dStart = NowNs();
+	for (k = 0; k < NPF_BENCH_LOOP; k++)
+	{
+		iSink += NpfUtoaRef(acBuf, 4000000000u, uiBase);
+	}
+	printf("utoa   ref  %6.1f ns", (NowNs() - dStart) / NPF_BENCH_LOOP);
+
+	dStart = NowNs();
+	for (k = 0; k < NPF_BENCH_LOOP; k++)
+	{
+		iSink += npf__utoa_rev(acBuf, 4000000000u, uiBase, NPF_FMT_SPEC_CONV_CASE_LOWER);
+	}
+	printf("  ->  npf__utoa_rev %6.1f ns\n", (NowNs() - dStart) / NPF_BENCH_LOOP);
+
+	for (i = 0; i < NPF_BENCH_FMTS; i++)
+	{
+		dStart = NowNs();
+		for (k = 0; k < NPF_BENCH_LOOP; k++)
+		{
+			iSink += npf_snprintf(acBuf, sizeof(acBuf), s_pBenchFmt[i], -123456, "K1", 0x20001234);
+		}
+		printf("fmt %d  npf_snprintf %6.1f ns\n", i, (NowNs() - dStart) / NPF_BENCH_LOOP);
+	}
+
+	(void)iSink;
+	return 0;
+}
@@ -0,0 +1,149 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+为 test_iap_patch.c 生成差分升级测试用例: 用 Tools/iap_diff.py 生成差分包, 由 C 程序用 iap_patch.c 还原。
+
+每个用例写出 3 个文件和 cases.txt 中的一行:
+    <名称>.old    设备应用程序区中正在运行的程序
+    <名称>.new    期望生成的新程序 (期望失败时为空)
+    <名称>.dpt    差分包
+    cases.txt     "<名称> <期望结果>", 期望结果为 ok, size, patch (对应 IAP_OK, IAP_ERR_SIZE, IAP_ERR_PATCH)
+
+用法:
+    python3 gen_cases.py 输出目录
+"""
+
+import os
+import random
+import struct
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..", "Tools"))
+
+from iap_diff import make_patch, apply_patch, read_varint, OP_END, OP_COPY, OP_DATA  # noqa: E402
+
+PAGE_SIZE = 2048
+
+
+def rand_bytes(rng, n):
+    return bytes(rng.getrandbits(8) for _ in range(n))
+
+
+def list_ops(patch):
+    """返回命令列表 (命令, 长度, 源地址, 目标地址), 用于检查用例覆盖了想要的情况"""
+    ops = []
+    src = 0
+    dst = 0
+    i = 20
+    while True:
+        op = patch[i]
+        i += 1
+        if op == OP_END:
+            return ops
+        n, i = read_varint(patch, i)
+        if op == OP_COPY:
+            d, i = read_varint(patch, i)
+            src = (src + ((d >> 1) ^ (-(d & 1) & 0xFFFFFFFF))) & 0xFFFFFFFF
+            ops.append((OP_COPY, n, src, dst))
+            src += n
+        else:
+            ops.append((OP_DATA, n, None, dst))
+            i += n
+        dst += n
+
+
+def crosses_page(start, n):
+    return start // PAGE_SIZE != (start + n - 1) // PAGE_SIZE
+
+
+def case_empty(rng):
+    """新程序为空: 差分包只有包头和 END, 设备拒绝 (iap_Start 不接受长度0)"""
+    old = rand_bytes(rng, 8 * 1024)
+    patch = make_patch(old, b"")
+    assert list_ops(patch) == []
+    return old, b"", patch, "size"
+
+
+def case_same(rng):
+    """新旧程序相同: 一条 COPY 复制整个程序"""
+    old = rand_bytes(rng, 24 * 1024)
+    patch = make_patch(old, old)
+    assert list_ops(patch) == [(OP_COPY, len(old), 0, 0)]
+    return old, old, patch, "ok"
+
+
+def case_rewrite(rng):
+    """完全重写: 新程序和旧程序无关, 全部是 DATA, 新程序比旧程序长"""
+    old = rand_bytes(rng, 16 * 1024)
+    new = rand_bytes(rng, 20 * 1024 + 4)
+    patch = make_patch(old, new)
+    assert all(op[0] == OP_DATA for op in list_ops(patch))
+    return old, new, patch, "ok"
+
+
+def case_cross(rng):
+    """插入、删除、移动数据块: COPY 的源和目标都跨越页边界, 源地址增量有正有负, DATA 有奇数长度"""
+    old = bytearray(rand_bytes(rng, 20 * 1024))
+    new = bytearray()
+    new += old[12000:15001]                 # 后面的块移到最前面, 下一条 COPY 增量为负
+    new += old[0:3000]
+    new += rand_bytes(rng, 101)             # 插入奇数个字节
+    new += old[3000:7000]
+    new += old[7500:12000]                  # 删除 500 字节
+    new += old[15001:]
+    new[4095] ^= 0x5A                       # 修改页边界两侧的字节
+    new[4096] ^= 0xA5
+    new += b"\xFF" * (-len(new) % 4)        # 主机用0xFF补齐到4的整数倍
+    patch = make_patch(bytes(old), bytes(new))
+
+    ops = list_ops(patch)
+    copies = [op for op in ops if op[0] == OP_COPY]
+    assert any(crosses_page(op[2], op[1]) for op in copies), "no COPY source crosses a page"
+    assert any(crosses_page(op[3], op[1]) for op in copies), "no COPY target crosses a page"
+    assert any(crosses_page(op[2], op[1]) and op[2] % PAGE_SIZE != op[3] % PAGE_SIZE for op in copies)
+    assert any(b[2] < a[2] + a[1] for a, b in zip(copies, copies[1:])), "no negative delta"
+    assert any(op[0] == OP_DATA and op[1] % 2 for op in ops), "no odd DATA run"
+    return bytes(old), bytes(new), patch, "ok"
+
+
+def case_wrong_old(rng):
+    """设备上运行的不是差分包对应的旧版本: 长度相同, 一个字节不同"""
+    old = bytearray(rand_bytes(rng, 8 * 1024))
+    new = bytes(old[:4096]) + rand_bytes(rng, 64) + bytes(old[4096:])
+    patch = make_patch(bytes(old), new)
+    old[5000] ^= 1
+    return bytes(old), b"", patch, "patch"
+
+
+CASES = [
+    ("empty", case_empty),
+    ("same", case_same),
+    ("rewrite", case_rewrite),
+    ("cross", case_cross),
+    ("wrong_old", case_wrong_old),
+]
+
+
+def main():
+    out_dir = sys.argv[1]
+    os.makedirs(out_dir, exist_ok=True)
+    rng = random.Random(20261017)
+
+    lines = []
+    for name, func in CASES:
+        old, new, patch, expect = func(rng)
+        assert len(old) % 4 == 0 and len(new) % 4 == 0
+        if expect == "ok":
+            assert apply_patch(old, patch) == new
+        for ext, data in (("old", old), ("new", new), ("dpt", patch)):
+            with open(os.path.join(out_dir, "%s.%s" % (name, ext)), "wb") as f:
+                f.write(data)
+        lines.append("%s %s\n" % (name, expect))
+
+    with open(os.path.join(out_dir, "cases.txt"), "w") as f:
+        f.writelines(lines)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,52 @@
+/*
+	主机端单元测试用的 bsp.h 替身。只声明被测模块 (modbus_slave.c) 用到的 BSP 接口,
+	由各测试程序自己实现 (见 test_modbus.c)。
+*/
+#ifndef _BSP_H_
+#define _BSP_H_
+
+#include "stm32f10x.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+/* 单线程回放, 不需要关中断 */
+#define ENABLE_INT()
+#define DISABLE_INT()
+
+/* 串口 */
+typedef enum
+{
+	COM1 = 0,
+	COM2 = 1,
+	COM3 = 2,
+}COM_PORT_E;
+
+#define UART3_BAUD		9600
+#ifndef UART3_RX_DMA_EN
+	#define UART3_RX_DMA_EN	0
+#endif
+
+#define RS485_RX_EN()
+#define RS485_TX_EN()
+
+void RS485_SendBuf(uint8_t *_ucaBuf, uint16_t _usLen);
+void comClearRxFifo(COM_PORT_E _ucPort);
+uint16_t comPollRxDma(COM_PORT_E _ucPort);
+
+/* us级硬件定时, 和 bsp_timer.h 中的定义相同 */
+typedef struct _HARD_TMR
+{
+	struct _HARD_TMR *pNext;
+	uint32_t Expire;
+	uint32_t Period;
+	void (*CallBack)(void *_pArg);
+	void *pArg;
+	volatile uint8_t Active;
+}HARD_TMR_T;
+
+uint32_t bsp_GetHardTimerCount32(void);
+void bsp_StartHardTimerEx(HARD_TMR_T *_pTmr, uint32_t _uiDelay, uint32_t _uiPeriod,
+	void (*_pCallBack)(void *_pArg), void *_pArg);
+
+#endif
@@ -0,0 +1,40 @@
+/*
+	主机端单元测试用的 stm32f10x.h 替身。只提供被测模块用到的类型和宏, 不包含任何外设寄存器。
+	__DMB() 映射为真正的内存屏障, 多线程测试中和 Cortex-M3 的 DMB 作用相同。
+	Flash 和 CRC 函数只有声明, 由用到它们的测试程序实现。
+*/
+#ifndef __STM32F10x_H
+#define __STM32F10x_H
+
+#include <stdint.h>
+#include <assert.h>
+
+#define __IO	volatile
+
+#define __DMB()		__atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+#define assert_param(expr)	assert(expr)
+
+/* iap.c 用到的 Flash 和 CRC 库函数, 由测试程序用内存模拟 (见 test_iap_patch.c) */
+typedef enum {DISABLE = 0, ENABLE = !DISABLE} FunctionalState;
+
+typedef enum
+{
+	FLASH_BUSY = 1,
+	FLASH_ERROR_PG,
+	FLASH_ERROR_WRP,
+	FLASH_COMPLETE,
+	FLASH_TIMEOUT
+}FLASH_Status;
+
+#define RCC_AHBPeriph_CRC	((uint32_t)0x00000040)
+
+void FLASH_Unlock(void);
+void FLASH_Lock(void);
+FLASH_Status FLASH_ErasePage(uint32_t Page_Address);
+FLASH_Status FLASH_ProgramHalfWord(uint32_t Address, uint16_t Data);
+void RCC_AHBPeriphClockCmd(uint32_t RCC_AHBPeriph, FunctionalState NewState);
+void CRC_ResetDR(void);
+uint32_t CRC_CalcBlockCRC(uint32_t pBuffer[], uint32_t BufferLength);
+
+#endif
@@ -0,0 +1,241 @@
+/*
+	主机端测试 bsp_uart_fifo.c 用的 bsp.h 替身。提供串口驱动用到的外设类型、常数和库函数声明,
+	常数和 STM32F10x 标准外设库相同。外设寄存器是普通的结构体变量, 库函数按硬件行为模拟
+	(见 sim_uart.c)。编译时本目录必须排在 stub/ 之前。
+*/
+#ifndef _BSP_H_
+#define _BSP_H_
+
+#include "stm32f10x.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+/* 中断屏蔽, 由 sim_uart.c 记录 PRIMASK */
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t priMask);
+
+#define ENABLE_INT()	__set_PRIMASK(0)	/* 使能全局中断 */
+#define DISABLE_INT()	__set_PRIMASK(1)	/* 禁止全局中断 */
+
+typedef enum {RESET = 0, SET = !RESET} FlagStatus, ITStatus;
+
+/* 外设寄存器, 只保留用到的 */
+typedef struct
+{
+	__IO uint16_t SR;
+	__IO uint16_t DR;
+	__IO uint16_t CR1;		/* 测试程序用它记录打开的中断 (USART_IT_xxx 的低8位) */
+}USART_TypeDef;
+
+typedef struct
+{
+	__IO uint32_t CCR;
+	__IO uint32_t CNDTR;
+	__IO uint32_t CPAR;
+	__IO uint32_t CMAR;
+}DMA_Channel_TypeDef;
+
+/* ODR 是输出状态; BSRR/BRR 的写入在下一次访问该端口时合并到 ODR (见 SimGpio) */
+typedef struct
+{
+	__IO uint32_t ODR;
+	__IO uint32_t BSRR;
+	__IO uint32_t BRR;
+}GPIO_TypeDef;
+
+extern USART_TypeDef g_tSimUsart[3];
+extern DMA_Channel_TypeDef g_tSimDma1[7];
+extern GPIO_TypeDef g_tSimGpio[4];
+
+#define USART1			(&g_tSimUsart[0])
+#define USART2			(&g_tSimUsart[1])
+#define USART3			(&g_tSimUsart[2])
+
+#define DMA1_Channel1	(&g_tSimDma1[0])
+#define DMA1_Channel2	(&g_tSimDma1[1])
+#define DMA1_Channel3	(&g_tSimDma1[2])
+#define DMA1_Channel4	(&g_tSimDma1[3])
+#define DMA1_Channel5	(&g_tSimDma1[4])
+#define DMA1_Channel6	(&g_tSimDma1[5])
+#define DMA1_Channel7	(&g_tSimDma1[6])
+
+/* 同一端口上的多个引脚先后写 BSRR/BRR, 每次访问端口前先把上次的写入合并到 ODR */
+GPIO_TypeDef *SimGpio(uint8_t _ucPort);
+
+#define GPIOA			(SimGpio(0))
+#define GPIOB			(SimGpio(1))
+#define GPIOC			(SimGpio(2))
+#define GPIOD			(SimGpio(3))
+
+typedef enum
+{
+	DMA1_Channel2_IRQn = 12,
+	DMA1_Channel3_IRQn = 13,
+	DMA1_Channel4_IRQn = 14,
+	DMA1_Channel5_IRQn = 15,
+	DMA1_Channel6_IRQn = 16,
+	DMA1_Channel7_IRQn = 17,
+	USART1_IRQn = 37,
+	USART2_IRQn = 38,
+	USART3_IRQn = 39,
+}IRQn_Type;
+
+/* RCC */
+#define RCC_AHBPeriph_DMA1		((uint32_t)0x00000001)
+#define RCC_APB2Periph_AFIO		((uint32_t)0x00000001)
+#define RCC_APB2Periph_GPIOA	((uint32_t)0x00000004)
+#define RCC_APB2Periph_GPIOB	((uint32_t)0x00000008)
+#define RCC_APB2Periph_GPIOC	((uint32_t)0x00000010)
+#define RCC_APB2Periph_GPIOD	((uint32_t)0x00000020)
+#define RCC_APB2Periph_USART1	((uint32_t)0x00004000)
+#define RCC_APB1Periph_USART2	((uint32_t)0x00020000)
+#define RCC_APB1Periph_USART3	((uint32_t)0x00040000)
+
+void RCC_APB2PeriphClockCmd(uint32_t RCC_APB2Periph, FunctionalState NewState);
+void RCC_APB1PeriphClockCmd(uint32_t RCC_APB1Periph, FunctionalState NewState);
+
+/* GPIO */
+#define GPIO_Pin_1				((uint16_t)0x0002)
+#define GPIO_Pin_2				((uint16_t)0x0004)
+#define GPIO_Pin_3				((uint16_t)0x0008)
+#define GPIO_Pin_4				((uint16_t)0x0010)
+#define GPIO_Pin_9				((uint16_t)0x0200)
+#define GPIO_Pin_10				((uint16_t)0x0400)
+#define GPIO_Pin_11				((uint16_t)0x0800)
+
+typedef enum {GPIO_Speed_10MHz = 1, GPIO_Speed_2MHz, GPIO_Speed_50MHz} GPIOSpeed_TypeDef;
+
+typedef enum
+{
+	GPIO_Mode_IN_FLOATING = 0x04,
+	GPIO_Mode_Out_PP = 0x10,
+	GPIO_Mode_AF_PP = 0x18
+}GPIOMode_TypeDef;
+
+typedef struct
+{
+	uint16_t GPIO_Pin;
+	GPIOSpeed_TypeDef GPIO_Speed;
+	GPIOMode_TypeDef GPIO_Mode;
+}GPIO_InitTypeDef;
+
+void GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_InitStruct);
+
+/* USART */
+typedef struct
+{
+	uint32_t USART_BaudRate;
+	uint16_t USART_WordLength;
+	uint16_t USART_StopBits;
+	uint16_t USART_Parity;
+	uint16_t USART_Mode;
+	uint16_t USART_HardwareFlowControl;
+}USART_InitTypeDef;
+
+#define USART_WordLength_8b					((uint16_t)0x0000)
+#define USART_WordLength_9b					((uint16_t)0x1000)
+#define USART_StopBits_1					((uint16_t)0x0000)
+#define USART_StopBits_2					((uint16_t)0x2000)
+#define USART_StopBits_1_5					((uint16_t)0x3000)
+#define USART_Parity_No						((uint16_t)0x0000)
+#define USART_Parity_Even					((uint16_t)0x0400)
+#define USART_Parity_Odd					((uint16_t)0x0600)
+#define USART_Mode_Rx						((uint16_t)0x0004)
+#define USART_Mode_Tx						((uint16_t)0x0008)
+#define USART_HardwareFlowControl_None		((uint16_t)0x0000)
+
+#define USART_IT_TXE						((uint16_t)0x0727)
+#define USART_IT_TC							((uint16_t)0x0626)
+#define USART_IT_RXNE						((uint16_t)0x0525)
+#define USART_IT_IDLE						((uint16_t)0x0424)
+
+#define USART_DMAReq_Tx						((uint16_t)0x0080)
+#define USART_DMAReq_Rx						((uint16_t)0x0040)
+
+#define USART_FLAG_TXE						((uint16_t)0x0080)
+#define USART_FLAG_TC						((uint16_t)0x0040)
+#define USART_FLAG_RXNE						((uint16_t)0x0020)
+#define USART_FLAG_IDLE						((uint16_t)0x0010)
+
+void USART_Init(USART_TypeDef *USARTx, USART_InitTypeDef *USART_InitStruct);
+void USART_Cmd(USART_TypeDef *USARTx, FunctionalState NewState);
+void USART_ITConfig(USART_TypeDef *USARTx, uint16_t USART_IT, FunctionalState NewState);
+void USART_DMACmd(USART_TypeDef *USARTx, uint16_t USART_DMAReq, FunctionalState NewState);
+void USART_SendData(USART_TypeDef *USARTx, uint16_t Data);
+uint16_t USART_ReceiveData(USART_TypeDef *USARTx);
+FlagStatus USART_GetFlagStatus(USART_TypeDef *USARTx, uint16_t USART_FLAG);
+void USART_ClearFlag(USART_TypeDef *USARTx, uint16_t USART_FLAG);
+ITStatus USART_GetITStatus(USART_TypeDef *USARTx, uint16_t USART_IT);
+
+/* DMA */
+typedef struct
+{
+	uint32_t DMA_PeripheralBaseAddr;
+	uint32_t DMA_MemoryBaseAddr;
+	uint32_t DMA_DIR;
+	uint32_t DMA_BufferSize;
+	uint32_t DMA_PeripheralInc;
+	uint32_t DMA_MemoryInc;
+	uint32_t DMA_PeripheralDataSize;
+	uint32_t DMA_MemoryDataSize;
+	uint32_t DMA_Mode;
+	uint32_t DMA_Priority;
+	uint32_t DMA_M2M;
+}DMA_InitTypeDef;
+
+#define DMA_DIR_PeripheralDST			((uint32_t)0x00000010)
+#define DMA_DIR_PeripheralSRC			((uint32_t)0x00000000)
+#define DMA_PeripheralInc_Disable		((uint32_t)0x00000000)
+#define DMA_MemoryInc_Enable			((uint32_t)0x00000080)
+#define DMA_PeripheralDataSize_Byte		((uint32_t)0x00000000)
+#define DMA_MemoryDataSize_Byte			((uint32_t)0x00000000)
+#define DMA_Mode_Circular				((uint32_t)0x00000020)
+#define DMA_Mode_Normal					((uint32_t)0x00000000)
+#define DMA_Priority_High				((uint32_t)0x00002000)
+#define DMA_Priority_Medium				((uint32_t)0x00001000)
+#define DMA_M2M_Disable					((uint32_t)0x00000000)
+
+#define DMA_IT_TC						((uint32_t)0x00000002)
+#define DMA_IT_HT						((uint32_t)0x00000004)
+
+#define DMA1_IT_GL2						((uint32_t)0x00000010)
+#define DMA1_IT_TC2						((uint32_t)0x00000020)
+#define DMA1_IT_GL4						((uint32_t)0x00001000)
+#define DMA1_IT_TC4						((uint32_t)0x00002000)
+#define DMA1_IT_GL7						((uint32_t)0x01000000)
+#define DMA1_IT_TC7						((uint32_t)0x02000000)
+
+#define DMA1_FLAG_TC3					((uint32_t)0x00000200)
+#define DMA1_FLAG_HT3					((uint32_t)0x00000400)
+#define DMA1_FLAG_TC5					((uint32_t)0x00020000)
+#define DMA1_FLAG_HT5					((uint32_t)0x00040000)
+#define DMA1_FLAG_TC6					((uint32_t)0x00200000)
+#define DMA1_FLAG_HT6					((uint32_t)0x00400000)
+
+void DMA_DeInit(DMA_Channel_TypeDef *DMAy_Channelx);
+void DMA_Init(DMA_Channel_TypeDef *DMAy_Channelx, DMA_InitTypeDef *DMA_InitStruct);
+void DMA_Cmd(DMA_Channel_TypeDef *DMAy_Channelx, FunctionalState NewState);
+void DMA_ITConfig(DMA_Channel_TypeDef *DMAy_Channelx, uint32_t DMA_IT, FunctionalState NewState);
+void DMA_SetCurrDataCounter(DMA_Channel_TypeDef *DMAy_Channelx, uint16_t DataNumber);
+uint16_t DMA_GetCurrDataCounter(DMA_Channel_TypeDef *DMAy_Channelx);
+FlagStatus DMA_GetFlagStatus(uint32_t DMAy_FLAG);
+void DMA_ClearFlag(uint32_t DMAy_FLAG);
+ITStatus DMA_GetITStatus(uint32_t DMAy_IT);
+void DMA_ClearITPendingBit(uint32_t DMAy_IT);
+
+/* NVIC */
+typedef struct
+{
+	uint8_t NVIC_IRQChannel;
+	uint8_t NVIC_IRQChannelPreemptionPriority;
+	uint8_t NVIC_IRQChannelSubPriority;
+	FunctionalState NVIC_IRQChannelCmd;
+}NVIC_InitTypeDef;
+
+void NVIC_Init(NVIC_InitTypeDef *NVIC_InitStruct);
+
+#include "bsp_ring.h"
+#include "bsp_uart_fifo.h"
+
+#endif
@@ -0,0 +1,326 @@
+/*
+	模拟的串口/DMA外设和库函数, 说明见 sim_uart.h。
+*/
+#include "sim_uart.h"
+
+/* 模拟的外设 */
+USART_TypeDef g_tSimUsart[3];
+DMA_Channel_TypeDef g_tSimDma1[7];
+GPIO_TypeDef g_tSimGpio[4];
+
+int g_iErrors;
+const char *g_pCase;
+
+uint32_t g_ulSimPrimask;
+USART_InitTypeDef g_tSimUsartInit[3];
+uint32_t g_ulSimUsartInitCount[3];
+
+static uint32_t s_ulDmaIsr;				/* DMA1_ISR */
+static uint16_t s_usDmaStart[7];		/* 启动DMA时写入的计数值 */
+static uint32_t s_ulDmaBase[7];			/* DMA_Init() 给出的内存地址, 就是发送/接收FIFO的缓冲区 */
+
+/* 和硬件一样, BSRR 置位优先于 BRR 复位 */
+GPIO_TypeDef *SimGpio(uint8_t _ucPort)
+{
+	GPIO_TypeDef *pGpio;
+
+	pGpio = &g_tSimGpio[_ucPort];
+	pGpio->ODR = (pGpio->ODR & ~pGpio->BRR) | pGpio->BSRR;
+	pGpio->BSRR = 0;
+	pGpio->BRR = 0;
+	return pGpio;
+}
+
+/* 被测模块调用的库函数 */
+uint32_t __get_PRIMASK(void)
+{
+	return g_ulSimPrimask;
+}
+
+void __set_PRIMASK(uint32_t priMask)
+{
+	g_ulSimPrimask = priMask;
+}
+
+void RCC_APB2PeriphClockCmd(uint32_t RCC_APB2Periph, FunctionalState NewState)
+{
+	(void)RCC_APB2Periph;
+	(void)NewState;
+}
+
+void RCC_APB1PeriphClockCmd(uint32_t RCC_APB1Periph, FunctionalState NewState)
+{
+	(void)RCC_APB1Periph;
+	(void)NewState;
+}
+
+void RCC_AHBPeriphClockCmd(uint32_t RCC_AHBPeriph, FunctionalState NewState)
+{
+	(void)RCC_AHBPeriph;
+	(void)NewState;
+}
+
+void GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_InitStruct)
+{
+	(void)GPIOx;
+	(void)GPIO_InitStruct;
+}
+
+void NVIC_Init(NVIC_InitTypeDef *NVIC_InitStruct)
+{
+	(void)NVIC_InitStruct;
+}
+
+/* 记录参数; 和硬件一样不改变 CR1 中的中断使能位 */
+void USART_Init(USART_TypeDef *USARTx, USART_InitTypeDef *USART_InitStruct)
+{
+	g_tSimUsartInit[USARTx - g_tSimUsart] = *USART_InitStruct;
+	g_ulSimUsartInitCount[USARTx - g_tSimUsart]++;
+	USARTx->SR |= USART_FLAG_TXE | USART_FLAG_TC;		/* 发送器空闲 */
+}
+
+void USART_Cmd(USART_TypeDef *USARTx, FunctionalState NewState)
+{
+	(void)USARTx;
+	(void)NewState;
+}
+
+/* USART_IT_xxx 的低5位是 CR1 中的使能位号, 也是 SR 中对应标志的位号 */
+void USART_ITConfig(USART_TypeDef *USARTx, uint16_t USART_IT, FunctionalState NewState)
+{
+	if (NewState != DISABLE)
+	{
+		USARTx->CR1 |= 1 << (USART_IT & 0x1F);
+	}
+	else
+	{
+		USARTx->CR1 &= ~(1 << (USART_IT & 0x1F));
+	}
+}
+
+void USART_DMACmd(USART_TypeDef *USARTx, uint16_t USART_DMAReq, FunctionalState NewState)
+{
+	(void)USARTx;
+	(void)USART_DMAReq;
+	(void)NewState;
+}
+
+void USART_SendData(USART_TypeDef *USARTx, uint16_t Data)
+{
+	USARTx->DR = Data;
+}
+
+/* 先读SR再读DR, 清除 IDLE 和 RXNE 标志 */
+uint16_t USART_ReceiveData(USART_TypeDef *USARTx)
+{
+	USARTx->SR &= ~(USART_FLAG_IDLE | USART_FLAG_RXNE);
+	return USARTx->DR;
+}
+
+FlagStatus USART_GetFlagStatus(USART_TypeDef *USARTx, uint16_t USART_FLAG)
+{
+	return (USARTx->SR & USART_FLAG) ? SET : RESET;
+}
+
+void USART_ClearFlag(USART_TypeDef *USARTx, uint16_t USART_FLAG)
+{
+	USARTx->SR &= ~USART_FLAG;
+}
+
+ITStatus USART_GetITStatus(USART_TypeDef *USARTx, uint16_t USART_IT)
+{
+	uint16_t usBit;
+
+	usBit = 1 << (USART_IT & 0x1F);
+	return ((USARTx->CR1 & usBit) && (USARTx->SR & usBit)) ? SET : RESET;
+}
+
+void DMA_DeInit(DMA_Channel_TypeDef *DMAy_Channelx)
+{
+	memset((void *)DMAy_Channelx, 0, sizeof(*DMAy_Channelx));
+}
+
+void DMA_Init(DMA_Channel_TypeDef *DMAy_Channelx, DMA_InitTypeDef *DMA_InitStruct)
+{
+	DMAy_Channelx->CCR = DMA_InitStruct->DMA_DIR | DMA_InitStruct->DMA_Mode | DMA_InitStruct->DMA_MemoryInc;
+	DMAy_Channelx->CNDTR = DMA_InitStruct->DMA_BufferSize;
+	DMAy_Channelx->CPAR = DMA_InitStruct->DMA_PeripheralBaseAddr;
+	DMAy_Channelx->CMAR = DMA_InitStruct->DMA_MemoryBaseAddr;
+	s_ulDmaBase[DMAy_Channelx - g_tSimDma1] = DMA_InitStruct->DMA_MemoryBaseAddr;
+	s_usDmaStart[DMAy_Channelx - g_tSimDma1] = DMA_InitStruct->DMA_BufferSize;
+}
+
+void DMA_Cmd(DMA_Channel_TypeDef *DMAy_Channelx, FunctionalState NewState)
+{
+	if (NewState != DISABLE)
+	{
+		DMAy_Channelx->CCR |= 1;
+	}
+	else
+	{
+		DMAy_Channelx->CCR &= ~1;
+	}
+}
+
+void DMA_ITConfig(DMA_Channel_TypeDef *DMAy_Channelx, uint32_t DMA_IT, FunctionalState NewState)
+{
+	(void)DMAy_Channelx;
+	(void)DMA_IT;
+	(void)NewState;
+}
+
+/* 和硬件一样, 只能在通道关闭时写计数 */
+void DMA_SetCurrDataCounter(DMA_Channel_TypeDef *DMAy_Channelx, uint16_t DataNumber)
+{
+	if ((DMAy_Channelx->CCR & 1) == 0)
+	{
+		DMAy_Channelx->CNDTR = DataNumber;
+		s_usDmaStart[DMAy_Channelx - g_tSimDma1] = DataNumber;
+	}
+}
+
+uint16_t DMA_GetCurrDataCounter(DMA_Channel_TypeDef *DMAy_Channelx)
+{
+	return DMAy_Channelx->CNDTR;
+}
+
+FlagStatus DMA_GetFlagStatus(uint32_t DMAy_FLAG)
+{
+	return (s_ulDmaIsr & DMAy_FLAG) ? SET : RESET;
+}
+
+void DMA_ClearFlag(uint32_t DMAy_FLAG)
+{
+	s_ulDmaIsr &= ~DMAy_FLAG;
+}
+
+ITStatus DMA_GetITStatus(uint32_t DMAy_IT)
+{
+	return (s_ulDmaIsr & DMAy_IT) ? SET : RESET;
+}
+
+/* DMAx_IT_GLn 是通道的最低位, 清除它同时清除该通道的 TC/HT/TE */
+void DMA_ClearITPendingBit(uint32_t DMAy_IT)
+{
+	s_ulDmaIsr &= ~(DMAy_IT * 0x0F);
+}
+
+/* COM3 的接收回调, 测试中不用 */
+void MODBUS_ReciveNew(uint8_t *_pBuf, uint16_t _usLen)
+{
+	(void)_pBuf;
+	(void)_usLen;
+}
+
+/* 发送DMA通道正在工作 */
+uint8_t SimTxBusy(SIM_TX_T *_pSim)
+{
+	return (_pSim->Dma->CCR & 1) && _pSim->Dma->CNDTR != 0;
+}
+
+/*
+	发送DMA搬运至多 _usMax 个字节。计数减到0时置传输完成标志并执行DMA中断服务程序,
+	中断释放的字节数就是本次传输的长度。
+*/
+void SimTxDma(SIM_TX_T *_pSim, uint16_t _usMax)
+{
+	DMA_Channel_TypeDef *pDma;
+	uint16_t usStart;
+	uint16_t usDone;
+	uint16_t usLen;
+	uint32_t ulOffset;
+
+	pDma = _pSim->Dma;
+	if (!SimTxBusy(_pSim))
+	{
+		return;
+	}
+	CHECK(g_ulSimPrimask == 0);
+
+	usStart = s_usDmaStart[pDma - g_tSimDma1];
+	usDone = usStart - pDma->CNDTR;
+	ulOffset = pDma->CMAR - s_ulDmaBase[pDma - g_tSimDma1];
+	CHECK(pDma->CMAR >= s_ulDmaBase[pDma - g_tSimDma1]);
+	CHECK(ulOffset + usStart <= _pSim->BufSize);		/* 不越过缓冲区末尾 */
+
+	usLen = (pDma->CNDTR < _usMax) ? pDma->CNDTR : _usMax;
+	CHECK(_pSim->WireLen + usLen <= _pSim->WireSize);
+	memcpy(&_pSim->Wire[_pSim->WireLen], (uint8_t *)(uintptr_t)(pDma->CMAR + usDone), usLen);
+	_pSim->WireLen += usLen;
+	pDma->CNDTR -= usLen;
+	_pSim->Usart->SR &= ~USART_FLAG_TC;		/* 移位寄存器中有数据 */
+
+	if (pDma->CNDTR == 0)
+	{
+		/* DMA中断被更高优先级的中断推迟, 最后1个字节已经移出: TC中断先于DMA中断执行 */
+		if (rand() % 4 == 0)
+		{
+			_pSim->Usart->SR |= USART_FLAG_TC;
+			if (USART_GetITStatus(_pSim->Usart, USART_IT_TC) != RESET)
+			{
+				_pSim->UsartIRQHandler();
+			}
+		}
+
+		s_ulDmaIsr |= _pSim->DmaItTc | (_pSim->DmaItTc >> 1);
+		_pSim->Released += usStart;
+		_pSim->DmaIRQHandler();
+		CHECK((s_ulDmaIsr & _pSim->DmaItTc) == 0);
+	}
+}
+
+/* DMA空闲时, 最后1个字节移出, 置TC标志。TC中断打开时执行串口中断服务程序 */
+void SimTxIdle(SIM_TX_T *_pSim)
+{
+	if (SimTxBusy(_pSim))
+	{
+		return;
+	}
+	_pSim->Usart->SR |= USART_FLAG_TC | USART_FLAG_TXE;
+	if (USART_GetITStatus(_pSim->Usart, USART_IT_TC) != RESET)
+	{
+		_pSim->UsartIRQHandler();
+	}
+}
+
+/* 接收DMA把 _usLen 个字节逐个写入循环缓冲区, 经过半满、全满位置时执行DMA中断服务程序 */
+void SimRxDma(SIM_RX_T *_pSim, const uint8_t *_pData, uint16_t _usLen)
+{
+	DMA_Channel_TypeDef *pDma;
+	uint16_t usSize;
+	uint16_t i;
+
+	pDma = _pSim->Dma;
+	CHECK(pDma->CCR & 1);
+	CHECK((pDma->CCR & DMA_Mode_Circular) != 0);
+	CHECK(g_ulSimPrimask == 0);
+
+	usSize = s_usDmaStart[pDma - g_tSimDma1];
+	for (i = 0; i < _usLen; i++)
+	{
+		*(uint8_t *)(uintptr_t)(s_ulDmaBase[pDma - g_tSimDma1] + usSize - pDma->CNDTR) = _pData[i];
+		pDma->CNDTR--;
+		if (pDma->CNDTR == usSize / 2)
+		{
+			s_ulDmaIsr |= _pSim->DmaFlagHt;
+			_pSim->DmaIRQHandler();
+		}
+		else if (pDma->CNDTR == 0)
+		{
+			pDma->CNDTR = usSize;		/* 循环模式自动重装 */
+			s_ulDmaIsr |= _pSim->DmaFlagHt >> 1;
+			_pSim->DmaIRQHandler();
+		}
+	}
+}
+
+/* 一段数据之后总线空闲, 置IDLE标志, IDLE中断打开时执行串口中断服务程序 */
+void SimRxIdle(SIM_RX_T *_pSim)
+{
+	_pSim->Usart->SR |= USART_FLAG_IDLE;
+	if (USART_GetITStatus(_pSim->Usart, USART_IT_IDLE) != RESET)
+	{
+		_pSim->UsartIRQHandler();
+	}
+	CHECK((_pSim->Usart->SR & USART_FLAG_IDLE) == 0);	/* 中断服务程序清除了标志 */
+}
@@ -0,0 +1,69 @@
+/*
+	模拟的串口/DMA外设, 供 test_uart_dma.c 和 test_usb_bridge.c 使用。
+	sim_uart.c 按硬件行为实现 bsp_uart_fifo.c 调用的库函数, 并提供驱动发送DMA、接收DMA和总线空闲的函数:
+		- 发送: 通道使能后, 每次 SimTxDma() 从 CMAR 开始搬运若干字节到"线路", 计数减到0时置传输完成
+		  标志并执行DMA中断服务程序; DMA空闲时 SimTxIdle() 表示最后1个字节已经移出, 置TC标志,
+		  TC中断打开时执行串口中断;
+		- 接收: SimRxDma() 把线路上的字节逐个写入循环DMA的缓冲区, 经过半满、全满位置时置标志并执行
+		  DMA中断服务程序; SimRxIdle() 置IDLE标志并执行串口中断。
+*/
+#ifndef _SIM_UART_H_
+#define _SIM_UART_H_
+
+#include "bsp.h"
+
+/* 测试失败时打印位置和用例名, 并从当前函数返回 */
+extern int g_iErrors;
+extern const char *g_pCase;
+
+#define CHECK(cond)	do { if (!(cond)) { printf("%s:%d: [%s] CHECK(%s) failed\n", __FILE__, __LINE__, g_pCase, #cond); g_iErrors++; return; } } while (0)
+
+extern uint32_t g_ulSimPrimask;
+extern USART_InitTypeDef g_tSimUsartInit[3];	/* 每个串口最近一次 USART_Init() 的参数 */
+extern uint32_t g_ulSimUsartInitCount[3];
+
+/* 一个串口的发送通道 */
+typedef struct
+{
+	COM_PORT_E Port;
+	USART_TypeDef *Usart;
+	DMA_Channel_TypeDef *Dma;
+	uint32_t DmaItTc;
+	uint16_t BufSize;
+	void (*DmaIRQHandler)(void);
+	void (*UsartIRQHandler)(void);
+
+	uint8_t *Wire;						/* 线路上收到的数据 */
+	uint32_t WireSize;					/* Wire 的大小 */
+	uint32_t WireLen;
+	uint32_t SentLen;					/* 写入发送FIFO的字节数 */
+	uint32_t Released;					/* 传输完成中断已经释放的字节数 */
+}SIM_TX_T;
+
+/* 一个串口的接收通道 (循环DMA) */
+typedef struct
+{
+	USART_TypeDef *Usart;
+	DMA_Channel_TypeDef *Dma;
+	uint32_t DmaFlagHt;					/* 半满标志, 全满标志是它的低1位 */
+	void (*DmaIRQHandler)(void);
+	void (*UsartIRQHandler)(void);
+}SIM_RX_T;
+
+void DMA1_Channel2_IRQHandler(void);
+void DMA1_Channel3_IRQHandler(void);
+void DMA1_Channel4_IRQHandler(void);
+void DMA1_Channel5_IRQHandler(void);
+void DMA1_Channel6_IRQHandler(void);
+void DMA1_Channel7_IRQHandler(void);
+void USART1_IRQHandler(void);
+void USART2_IRQHandler(void);
+void USART3_IRQHandler(void);
+
+uint8_t SimTxBusy(SIM_TX_T *_pSim);
+void SimTxDma(SIM_TX_T *_pSim, uint16_t _usMax);
+void SimTxIdle(SIM_TX_T *_pSim);
+void SimRxDma(SIM_RX_T *_pSim, const uint8_t *_pData, uint16_t _usLen);
+void SimRxIdle(SIM_RX_T *_pSim);
+
+#endif
@@ -0,0 +1,316 @@
+/*
+*********************************************************************************************************
+*
+*	模块名称 : 差分升级还原测试
+*	文件名称 : test_iap_patch.c
+*	说    明 : 主机端测试 Tools/iap_diff.py 生成的差分包能被 iap_patch.c + iap.c 还原成新程序。
+*			  用例由 iap/gen_cases.py 生成 (见该文件), 包括空差分、新旧程序相同、完全重写、
+*			  跨页的 COPY、旧版本不符。
+*
+*			  512K Flash 用 mmap 映射到 0x08000000, 被测代码按真实地址读应用程序区。Flash 库函数按硬件
+*			  的规则模拟: 加锁时不能擦写, 擦除整页为0xFF, 只能向已擦除(0xFFFF)的半字编程。下载区和升级
+*			  信息页预先填成0, 没有提前擦除就写入会报错。
+*
+*			  每个差分包按几种分段长度输入 (逐字节、奇数长度、一次全部), 检查:
+*				(1) iap_PatchFinish() 的返回值;
+*				(2) 成功时下载区内容等于新程序, 升级信息页正确, 只擦除了需要的页;
+*				(3) Bootloader 区和应用程序区没有被改写, Flash 最后处于加锁状态。
+*
+*********************************************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "iap_patch.h"
+
+#define FLASH_BASE_ADDR		0x08000000
+#define FLASH_SIZE			(512 * 1024)
+
+#define FLASH_PTR(addr)		((uint8_t *)(uintptr_t)(addr))
+
+static uint8_t *s_pFlash;
+static uint8_t s_ucUnlocked;
+static uint32_t s_ulEraseCount;
+static uint32_t s_ulCrc;
+
+static const char *s_pCase;
+static int s_iErrors;
+
+#define CHECK(cond)	do { if (!(cond)) { printf("%s:%d: [%s] CHECK(%s) failed\n", __FILE__, __LINE__, s_pCase, #cond); s_iErrors++; return; } } while (0)
+
+/* 被测模块调用的 Flash 和 CRC 库函数 */
+void FLASH_Unlock(void)
+{
+	s_ucUnlocked = 1;
+}
+
+void FLASH_Lock(void)
+{
+	s_ucUnlocked = 0;
+}
+
+FLASH_Status FLASH_ErasePage(uint32_t Page_Address)
+{
+	if (s_ucUnlocked == 0)
+	{
+		return FLASH_ERROR_WRP;
+	}
+	if (Page_Address < FLASH_BASE_ADDR || Page_Address >= FLASH_BASE_ADDR + FLASH_SIZE)
+	{
+		return FLASH_ERROR_PG;
+	}
+
+	Page_Address -= (Page_Address - FLASH_BASE_ADDR) % IAP_PAGE_SIZE;
+	memset(FLASH_PTR(Page_Address), 0xFF, IAP_PAGE_SIZE);
+	s_ulEraseCount++;
+	return FLASH_COMPLETE;
+}
+
+FLASH_Status FLASH_ProgramHalfWord(uint32_t Address, uint16_t Data)
+{
+	uint8_t *p;
+
+	if (s_ucUnlocked == 0)
+	{
+		return FLASH_ERROR_WRP;
+	}
+	if (Address < FLASH_BASE_ADDR || Address >= FLASH_BASE_ADDR + FLASH_SIZE || (Address & 1))
+	{
+		return FLASH_ERROR_PG;
+	}
+
+	p = FLASH_PTR(Address);
+	if (p[0] != 0xFF || p[1] != 0xFF)
+	{
+		return FLASH_ERROR_PG;		/* 没有擦除 */
+	}
+	p[0] = Data & 0xFF;
+	p[1] = Data >> 8;
+	return FLASH_COMPLETE;
+}
+
+void RCC_AHBPeriphClockCmd(uint32_t RCC_AHBPeriph, FunctionalState NewState)
+{
+	(void)RCC_AHBPeriph;
+	(void)NewState;
+}
+
+void CRC_ResetDR(void)
+{
+	s_ulCrc = 0xFFFFFFFF;
+}
+
+/* 硬件CRC单元: 多项式0x04C11DB7, 按32位字从高位开始移入, 不反转, 不取反 */
+uint32_t CRC_CalcBlockCRC(uint32_t pBuffer[], uint32_t BufferLength)
+{
+	uint32_t i;
+	uint8_t j;
+
+	for (i = 0; i < BufferLength; i++)
+	{
+		s_ulCrc ^= pBuffer[i];
+		for (j = 0; j < 32; j++)
+		{
+			s_ulCrc = (s_ulCrc & 0x80000000) ? (s_ulCrc << 1) ^ 0x04C11DB7 : (s_ulCrc << 1);
+		}
+	}
+	return s_ulCrc;
+}
+
+/* 读入一个文件, 返回长度 */
+static uint32_t LoadFile(const char *_pDir, const char *_pName, const char *_pExt, uint8_t **_ppData)
+{
+	char acPath[512];
+	FILE *fp;
+	long lLen;
+
+	snprintf(acPath, sizeof(acPath), "%s/%s.%s", _pDir, _pName, _pExt);
+	fp = fopen(acPath, "rb");
+	if (fp == 0)
+	{
+		printf("%s: cannot open\n", acPath);
+		exit(1);
+	}
+	fseek(fp, 0, SEEK_END);
+	lLen = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	*_ppData = malloc(lLen + 1);
+	if (fread(*_ppData, 1, lLen, fp) != (size_t)lLen)
+	{
+		printf("%s: read error\n", acPath);
+		exit(1);
+	}
+	fclose(fp);
+	return (uint32_t)lLen;
+}
+
+/* 按指定的分段长度输入差分包并检查结果。_usChunk = 0 表示分段长度从1到97循环变化 */
+static void RunPatch(const uint8_t *_pOld, uint32_t _ulOldLen, const uint8_t *_pNew, uint32_t _ulNewLen,
+	const uint8_t *_pPatch, uint32_t _ulPatchLen, uint8_t _ucExpect, uint16_t _usChunk)
+{
+	const IAP_INFO_T *pInfo;
+	uint32_t ulPos;
+	uint32_t ulPages;
+	uint16_t usLen;
+	uint16_t usVary;
+	uint8_t ucRet;
+
+	/* 应用程序区是旧程序, 其余部分填成0 (未擦除) */
+	memset(s_pFlash, 0, FLASH_SIZE);
+	memcpy(FLASH_PTR(IAP_APP_ADDR), _pOld, _ulOldLen);
+	s_ucUnlocked = 0;
+	s_ulEraseCount = 0;
+
+	CHECK(iap_PatchStart(_ulPatchLen) == IAP_OK);
+
+	ulPos = 0;
+	usVary = 1;
+	while (ulPos < _ulPatchLen)
+	{
+		if (_usChunk == 0)
+		{
+			usLen = usVary;
+			usVary = (usVary % 97) + 1;
+		}
+		else
+		{
+			usLen = _usChunk;
+		}
+		if (usLen > _ulPatchLen - ulPos)
+		{
+			usLen = _ulPatchLen - ulPos;
+		}
+		CHECK(iap_PatchWrite(&_pPatch[ulPos], usLen) == usLen);
+		ulPos += usLen;
+	}
+	CHECK(iap_PatchGetRemain() == 0);
+	CHECK(iap_PatchWrite(_pPatch, 1) == 0);		/* 超出长度的数据不使用 */
+
+	ucRet = iap_PatchFinish();
+	if (ucRet != _ucExpect)
+	{
+		printf("%s:%d: [%s] chunk %u: iap_PatchFinish() = %u, expect %u\n", __FILE__, __LINE__,
+			s_pCase, _usChunk, ucRet, _ucExpect);
+		s_iErrors++;
+		return;
+	}
+
+	CHECK(s_ucUnlocked == 0);
+	CHECK(memcmp(FLASH_PTR(IAP_APP_ADDR), _pOld, _ulOldLen) == 0);
+	for (ulPos = 0; ulPos < IAP_APP_ADDR - IAP_BOOT_ADDR; ulPos++)
+	{
+		CHECK(FLASH_PTR(IAP_BOOT_ADDR)[ulPos] == 0);
+	}
+
+	pInfo = (const IAP_INFO_T *)FLASH_PTR(IAP_INFO_ADDR);
+	if (_ucExpect != IAP_OK)
+	{
+		CHECK(pInfo->ulMagic != IAP_MAGIC_READY);
+		return;
+	}
+
+	CHECK(memcmp(FLASH_PTR(IAP_DL_ADDR), _pNew, _ulNewLen) == 0);
+	CHECK(pInfo->ulMagic == IAP_MAGIC_READY);
+	CHECK(pInfo->ulSize == _ulNewLen);
+	CRC_ResetDR();
+	CHECK(pInfo->ulCrc == CRC_CalcBlockCRC((uint32_t *)_pNew, _ulNewLen / 4));
+	CHECK(pInfo->ulCrcInv == ~pInfo->ulCrc);
+
+	/* 只擦除升级信息页和新程序占用的页 */
+	ulPages = (_ulNewLen + IAP_PAGE_SIZE - 1) / IAP_PAGE_SIZE;
+	CHECK(s_ulEraseCount == ulPages + 1);
+	CHECK(FLASH_PTR(IAP_DL_ADDR + ulPages * IAP_PAGE_SIZE)[0] == 0);
+}
+
+static void RunCase(const char *_pDir, const char *_pName, const char *_pExpect)
+{
+	static const uint16_t s_usChunk[] = {1, 63, 0, 0xFFFF};
+	uint8_t *pOld;
+	uint8_t *pNew;
+	uint8_t *pPatch;
+	uint32_t ulOldLen;
+	uint32_t ulNewLen;
+	uint32_t ulPatchLen;
+	uint8_t ucExpect;
+	uint8_t i;
+
+	s_pCase = _pName;
+	if (strcmp(_pExpect, "ok") == 0)
+	{
+		ucExpect = IAP_OK;
+	}
+	else if (strcmp(_pExpect, "size") == 0)
+	{
+		ucExpect = IAP_ERR_SIZE;
+	}
+	else
+	{
+		ucExpect = IAP_ERR_PATCH;
+	}
+
+	ulOldLen = LoadFile(_pDir, _pName, "old", &pOld);
+	ulNewLen = LoadFile(_pDir, _pName, "new", &pNew);
+	ulPatchLen = LoadFile(_pDir, _pName, "dpt", &pPatch);
+
+	for (i = 0; i < sizeof(s_usChunk) / sizeof(s_usChunk[0]); i++)
+	{
+		RunPatch(pOld, ulOldLen, pNew, ulNewLen, pPatch, ulPatchLen, ucExpect, s_usChunk[i]);
+	}
+
+	free(pOld);
+	free(pNew);
+	free(pPatch);
+}
+
+int main(int argc, char *argv[])
+{
+	const char *pDir;
+	char acPath[512];
+	char acName[64];
+	char acExpect[16];
+	FILE *fp;
+	int iCount;
+
+	pDir = (argc > 1) ? argv[1] : "build/iap";
+
+	s_pFlash = mmap((void *)(uintptr_t)FLASH_BASE_ADDR, FLASH_SIZE, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+	if (s_pFlash != FLASH_PTR(FLASH_BASE_ADDR))
+	{
+		printf("test_iap_patch: cannot map flash at 0x%08X\n", FLASH_BASE_ADDR);
+		return 1;
+	}
+
+	/* 差分包只有包头时不接收 */
+	s_pCase = "head";
+	if (iap_PatchStart(PATCH_HEAD_SIZE) != IAP_ERR_SIZE)
+	{
+		printf("test_iap_patch: iap_PatchStart(PATCH_HEAD_SIZE) accepted\n");
+		s_iErrors++;
+	}
+
+	snprintf(acPath, sizeof(acPath), "%s/cases.txt", pDir);
+	fp = fopen(acPath, "r");
+	if (fp == 0)
+	{
+		printf("%s: cannot open\n", acPath);
+		return 1;
+	}
+	iCount = 0;
+	while (fscanf(fp, "%63s %15s", acName, acExpect) == 2)
+	{
+		RunCase(pDir, acName, acExpect);
+		iCount++;
+	}
+	fclose(fp);
+
+	if (s_iErrors != 0 || iCount == 0)
+	{
+		printf("test_iap_patch: FAILED, %d errors, %d cases\n", s_iErrors, iCount);
+		return 1;
+	}
+	printf("test_iap_patch: OK, %d cases\n", iCount);
+	return 0;
+}
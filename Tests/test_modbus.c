@@ -0,0 +1,351 @@
+/*
+*********************************************************************************************************
+*
+*	模块名称 : MODBUS 从站回放测试
+*	文件名称 : test_modbus.c
+*	说    明 : 主机端测试 modbus_slave.c。按 modbus/ 目录下的帧文件, 在模拟时钟上逐字节送入数据,
+*			  到时执行 T1.5/T3.5 硬件定时回调, 然后调用 MODS_Poll(), 核对应答帧、寄存器和统计值。
+*			  UART3_RX_DMA_EN = 1 编译时, 每条 rx 的数据在总线空闲(IDLE)后一次送入, 和DMA接收相同。
+*
+*			  帧文件每行一条命令, # 之后是注释:
+*				rx  字节...     从总线收到这些字节。字节写成16进制, crc 表示本行上一个 crc 之后各字节的CRC(低字节在前)
+*				wait us         总线空闲 us 微秒
+*				tx  字节...     期望上次检查之后从站发出的全部数据
+*				notx            期望上次检查之后从站没有发送数据
+*				set reg value   设置保持寄存器
+*				hold reg value  期望保持寄存器的值
+*				stat name value 期望统计值, name 为 ok/crc/frame/exc
+*				pio             只在逐字节中断接收时运行本文件 (用于 T1.5 字符间隔测试)
+*
+*********************************************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include "modbus_slave.h"
+#include "crc16.h"
+
+#define MAX_TMR		4
+
+static uint32_t s_uiNow;					/* 模拟的32位硬件定时器, 单位us */
+static uint16_t s_usTchar;					/* 1个字符时间 */
+static HARD_TMR_T *s_pTmr[MAX_TMR];			/* 启动过的硬件定时器 */
+static uint8_t s_aTx[1024];					/* 从站发出的数据 */
+static uint16_t s_usTxLen;
+
+static const char *s_pFile;
+static int s_iLine;
+static int s_iErrors;
+
+/* 被测模块调用的 BSP 接口 */
+uint32_t bsp_GetHardTimerCount32(void)
+{
+	return s_uiNow;
+}
+
+void bsp_StartHardTimerEx(HARD_TMR_T *_pTmr, uint32_t _uiDelay, uint32_t _uiPeriod,
+	void (*_pCallBack)(void *_pArg), void *_pArg)
+{
+	uint8_t i;
+
+	for (i = 0; i < MAX_TMR; i++)
+	{
+		if (s_pTmr[i] == _pTmr || s_pTmr[i] == 0)
+		{
+			s_pTmr[i] = _pTmr;
+			break;
+		}
+	}
+	_pTmr->Expire = s_uiNow + _uiDelay;
+	_pTmr->Period = _uiPeriod;
+	_pTmr->CallBack = _pCallBack;
+	_pTmr->pArg = _pArg;
+	_pTmr->Active = 1;
+}
+
+void RS485_SendBuf(uint8_t *_ucaBuf, uint16_t _usLen)
+{
+	if (s_usTxLen + _usLen <= sizeof(s_aTx))
+	{
+		memcpy(&s_aTx[s_usTxLen], _ucaBuf, _usLen);
+		s_usTxLen += _usLen;
+	}
+}
+
+void comClearRxFifo(COM_PORT_E _ucPort)
+{
+	(void)_ucPort;
+}
+
+uint16_t comPollRxDma(COM_PORT_E _ucPort)
+{
+	(void)_ucPort;
+	return 0;		/* 每条 rx 的数据都已经一次送完 */
+}
+
+/* 模拟时间前进 _uiUs 微秒, 按到期顺序执行定时回调 */
+static void Advance(uint32_t _uiUs)
+{
+	uint32_t uiEnd;
+	HARD_TMR_T *pNext;
+	uint8_t i;
+
+	uiEnd = s_uiNow + _uiUs;
+	for (;;)
+	{
+		pNext = 0;
+		for (i = 0; i < MAX_TMR; i++)
+		{
+			if (s_pTmr[i] != 0 && s_pTmr[i]->Active
+				&& (int32_t)(s_pTmr[i]->Expire - uiEnd) <= 0
+				&& (pNext == 0 || (int32_t)(s_pTmr[i]->Expire - pNext->Expire) < 0))
+			{
+				pNext = s_pTmr[i];
+			}
+		}
+		if (pNext == 0)
+		{
+			break;
+		}
+		s_uiNow = pNext->Expire;
+		pNext->Active = 0;
+		pNext->CallBack(pNext->pArg);
+	}
+	s_uiNow = uiEnd;
+}
+
+static void Fail(const char *_pMsg)
+{
+	printf("%s:%d: %s\n", s_pFile, s_iLine, _pMsg);
+	s_iErrors++;
+}
+
+/* 解析 16进制字节列表, crc 表示追加本帧(上一个 crc 之后)字节的CRC */
+static uint16_t ParseBytes(char *_pText, uint8_t *_pBuf)
+{
+	char *pTok;
+	uint16_t usLen;
+	uint16_t usStart;
+	uint16_t usCRC;
+
+	usLen = 0;
+	usStart = 0;
+	for (pTok = strtok(_pText, " \t"); pTok != 0; pTok = strtok(0, " \t"))
+	{
+		if (strcmp(pTok, "crc") == 0)
+		{
+			usCRC = CRC16_Modbus(&_pBuf[usStart], usLen - usStart);
+			_pBuf[usLen++] = usCRC;
+			_pBuf[usLen++] = usCRC >> 8;
+			usStart = usLen;
+		}
+		else
+		{
+			_pBuf[usLen++] = strtoul(pTok, 0, 16);
+		}
+	}
+	return usLen;
+}
+
+/* 从总线收到一串字节 */
+static void BusReceive(uint8_t *_pBuf, uint16_t _usLen)
+{
+#if UART3_RX_DMA_EN == 1
+	/* 数据全部收完, 再过1个字符时间产生 IDLE 中断, 一次发布 */
+	Advance(s_usTchar * (_usLen + 1));
+	MODBUS_ReciveNew(_pBuf, _usLen);
+#else
+	uint16_t i;
+
+	for (i = 0; i < _usLen; i++)
+	{
+		Advance(s_usTchar);
+		MODBUS_ReciveNew(&_pBuf[i], 1);
+	}
+#endif
+}
+
+static uint16_t StatValue(const char *_pName)
+{
+	if (strcmp(_pName, "ok") == 0)		return g_tModS.usFrameOk;
+	if (strcmp(_pName, "crc") == 0)		return g_tModS.usCrcErr;
+	if (strcmp(_pName, "frame") == 0)	return g_tModS.usFrameErr;
+	if (strcmp(_pName, "exc") == 0)		return g_tModS.usExcCount;
+	Fail("unknown stat name");
+	return 0xFFFF;
+}
+
+static void RunFile(const char *_pPath)
+{
+	FILE *fp;
+	char acLine[2048];
+	char acMsg[4200];
+	char *p;
+	uint8_t aBuf[1024];
+	uint16_t usLen;
+	unsigned int uiA;
+	unsigned int uiB;
+	char acName[16];
+
+	fp = fopen(_pPath, "r");
+	if (fp == 0)
+	{
+		printf("%s: cannot open\n", _pPath);
+		s_iErrors++;
+		return;
+	}
+
+	s_pFile = _pPath;
+	s_iLine = 0;
+	memset(s_pTmr, 0, sizeof(s_pTmr));
+	memset(g_usHoldReg, 0, sizeof(g_usHoldReg));
+	s_usTxLen = 0;
+	s_uiNow = 0xFFFF0000;		/* 运行中32位计数回绕 */
+	MODS_Init(UART3_BAUD);
+	s_usTchar = 11000000 / UART3_BAUD;
+
+	while (fgets(acLine, sizeof(acLine), fp) != 0)
+	{
+		s_iLine++;
+		p = strchr(acLine, '#');
+		if (p != 0)
+		{
+			*p = 0;
+		}
+		p = acLine + strspn(acLine, " \t\r\n");
+		usLen = strlen(p);
+		while (usLen > 0 && strchr(" \t\r\n", p[usLen - 1]) != 0)
+		{
+			p[--usLen] = 0;
+		}
+		if (*p == 0)
+		{
+			continue;
+		}
+
+		if (strcmp(p, "pio") == 0)
+		{
+#if UART3_RX_DMA_EN == 1
+			break;
+#endif
+		}
+		else if (strncmp(p, "rx ", 3) == 0)
+		{
+			usLen = ParseBytes(p + 3, aBuf);
+			BusReceive(aBuf, usLen);
+		}
+		else if (sscanf(p, "wait %u", &uiA) == 1)
+		{
+			Advance(uiA);
+		}
+		else if (strncmp(p, "tx ", 3) == 0)
+		{
+			usLen = ParseBytes(p + 3, aBuf);
+			if (usLen != s_usTxLen || memcmp(aBuf, s_aTx, usLen) != 0)
+			{
+				strcpy(acMsg, "reply mismatch, got:");
+				for (uiA = 0; uiA < s_usTxLen && uiA < 64; uiA++)
+				{
+					sprintf(acMsg + strlen(acMsg), " %02X", s_aTx[uiA]);
+				}
+				Fail(acMsg);
+			}
+			s_usTxLen = 0;
+		}
+		else if (strcmp(p, "notx") == 0)
+		{
+			if (s_usTxLen != 0)
+			{
+				Fail("unexpected reply");
+			}
+			s_usTxLen = 0;
+		}
+		else if (sscanf(p, "set %u %u", &uiA, &uiB) == 2)
+		{
+			g_usHoldReg[uiA] = uiB;
+		}
+		else if (sscanf(p, "hold %u %u", &uiA, &uiB) == 2)
+		{
+			if (g_usHoldReg[uiA] != uiB)
+			{
+				sprintf(acMsg, "hold %u is %u", uiA, g_usHoldReg[uiA]);
+				Fail(acMsg);
+			}
+		}
+		else if (sscanf(p, "stat %15s %u", acName, &uiB) == 2)
+		{
+			if (StatValue(acName) != uiB)
+			{
+				sprintf(acMsg, "stat %s is %u", acName, StatValue(acName));
+				Fail(acMsg);
+			}
+		}
+		else
+		{
+			Fail("bad command");
+		}
+
+		MODS_Poll();		/* 主程序一直在轮询 */
+	}
+	fclose(fp);
+}
+
+static int CompareName(const void *_p1, const void *_p2)
+{
+	return strcmp(*(char * const *)_p1, *(char * const *)_p2);
+}
+
+int main(int argc, char *argv[])
+{
+	DIR *pDir;
+	struct dirent *pEnt;
+	char *apName[64];
+	char acPath[512];
+	int iCount;
+	int i;
+
+	iCount = 0;
+	if (argc > 1)
+	{
+		for (i = 1; i < argc; i++)
+		{
+			RunFile(argv[i]);
+			iCount++;
+		}
+	}
+	else
+	{
+		/* 缺省运行 modbus/ 目录下的全部帧文件 */
+		pDir = opendir("modbus");
+		if (pDir == 0)
+		{
+			printf("test_modbus: no modbus/ directory\n");
+			return 1;
+		}
+		while ((pEnt = readdir(pDir)) != 0 && iCount < 64)
+		{
+			if (strstr(pEnt->d_name, ".txt") != 0)
+			{
+				apName[iCount++] = strdup(pEnt->d_name);
+			}
+		}
+		closedir(pDir);
+		qsort(apName, iCount, sizeof(apName[0]), CompareName);
+		for (i = 0; i < iCount; i++)
+		{
+			snprintf(acPath, sizeof(acPath), "modbus/%s", apName[i]);
+			RunFile(acPath);
+			free(apName[i]);
+		}
+	}
+
+	if (s_iErrors != 0)
+	{
+		printf("test_modbus (%s): FAILED, %d errors\n", UART3_RX_DMA_EN ? "dma" : "pio", s_iErrors);
+		return 1;
+	}
+	printf("test_modbus (%s): OK, %d files\n", UART3_RX_DMA_EN ? "dma" : "pio", iCount);
+	return 0;
+}
@@ -0,0 +1,236 @@
+/*
+*********************************************************************************************************
+*
+*	模块名称 : 环形缓冲区回绕测试
+*	文件名称 : test_ring.c
+*	说    明 : 主机端测试 bsp_ring.c。
+*			  (1) 读写索引是自由增长的16位计数, 从 0xFF00 附近开始, 多次越过 0xFFFF, 检查数据个数和剩余空间。
+*			  (2) 按串口DMA发送的方式取数据 (bsp_RingPeekSpan 取连续段, 发送完成后 bsp_RingConsume),
+*			      检查每段都不跨越缓冲区末尾, 回绕前后字节顺序不变。
+*			  (3) 混合使用 Put/PutByte/ReserveSpan 和 Get/GetByte, 检查数据完整。
+*			  (4) DMA接收覆盖未读数据后数据个数超过缓冲区大小, bsp_RingGet 不读出缓冲区之外。
+*
+*********************************************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bsp_ring.h"
+
+#define RING_SIZE	256
+#define TOTAL		(3 * 65536 + 1234)		/* 写入的总字节数, 16位索引回绕3次以上 */
+
+static int s_iErrors;
+
+#define CHECK(cond)	do { if (!(cond)) { printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); s_iErrors++; return; } } while (0)
+
+static uint8_t s_ucBuf[RING_SIZE];
+static uint32_t s_ulRand = 12345;
+
+static uint16_t Rand(uint16_t _usMax)
+{
+	s_ulRand = s_ulRand * 1103515245u + 12345u;
+	return (uint16_t)((s_ulRand >> 16) % (_usMax + 1));
+}
+
+/* 把读写索引都设置成 _usStart, 模拟运行了很久的缓冲区 */
+static void RingStartAt(RING_T *_pRing, uint16_t _usStart)
+{
+	bsp_RingInit(_pRing, s_ucBuf, RING_SIZE);
+	_pRing->usHead = _usStart;
+	_pRing->usTail = _usStart;
+}
+
+/* 索引正好跨越 0xFFFF 时的满、空判断 */
+static void TestFullAcrossWrap(void)
+{
+	RING_T tRing;
+	uint8_t aData[RING_SIZE];
+	uint8_t aOut[RING_SIZE];
+	uint16_t i;
+
+	for (i = 0; i < RING_SIZE; i++)
+	{
+		aData[i] = (uint8_t)(i * 7 + 3);
+	}
+
+	RingStartAt(&tRing, 0xFFFF - 100);
+	CHECK(bsp_RingPut(&tRing, aData, RING_SIZE) == RING_SIZE);
+	CHECK(tRing.usHead < tRing.usTail);				/* 写索引已经回绕 */
+	CHECK(bsp_RingCount(&tRing) == RING_SIZE);
+	CHECK(bsp_RingFree(&tRing) == 0);
+	CHECK(bsp_RingPutByte(&tRing, 0) == 0);
+	CHECK(bsp_RingPut(&tRing, aData, 1) == 0);
+
+	CHECK(bsp_RingGet(&tRing, aOut, RING_SIZE + 10) == RING_SIZE);
+	CHECK(memcmp(aOut, aData, RING_SIZE) == 0);
+	CHECK(bsp_RingCount(&tRing) == 0);
+	CHECK(bsp_RingFree(&tRing) == RING_SIZE);
+	CHECK(tRing.usTail == tRing.usHead);
+}
+
+/* DMA接收直接发布写索引, 覆盖未读数据时数据个数可以超过缓冲区大小 */
+static void TestOverrunGet(void)
+{
+	RING_T tRing;
+	uint8_t aOut[RING_SIZE + 64];
+	uint16_t i;
+
+	RingStartAt(&tRing, 0xFFFF - 10);
+	for (i = 0; i < RING_SIZE; i++)
+	{
+		s_ucBuf[i] = (uint8_t)i;
+	}
+	bsp_RingCommit(&tRing, RING_SIZE + 40);
+	CHECK(bsp_RingCount(&tRing) == RING_SIZE + 40);
+
+	memset(aOut, 0xAA, sizeof(aOut));
+	CHECK(bsp_RingGet(&tRing, aOut, sizeof(aOut)) == RING_SIZE);
+	CHECK(aOut[RING_SIZE] == 0xAA);				/* 没有多写 */
+	for (i = 0; i < RING_SIZE; i++)
+	{
+		CHECK(aOut[i] == (uint8_t)((0xFFFF - 10 + i) & (RING_SIZE - 1)));
+	}
+	CHECK(bsp_RingCount(&tRing) == 40);
+}
+
+/* 按串口DMA发送的方式消费数据 */
+static void TestDmaSpans(void)
+{
+	RING_T tRing;
+	uint8_t aData[RING_SIZE];
+	uint32_t ulPut = 0;
+	uint32_t ulGot = 0;
+	uint32_t ulWraps = 0;
+	uint16_t usLastHead;
+	uint16_t usLen, i;
+	uint8_t *pSpan;
+
+	RingStartAt(&tRing, 0xFF00);
+	usLastHead = tRing.usHead;
+	while (ulGot < TOTAL)
+	{
+		/* 主程序 comSendBuf: 写入随机长度, 放不下的部分丢弃 (测试中重新发送) */
+		if (ulPut < TOTAL)
+		{
+			usLen = Rand(RING_SIZE / 2);
+			if (usLen > TOTAL - ulPut)
+			{
+				usLen = (uint16_t)(TOTAL - ulPut);
+			}
+			for (i = 0; i < usLen; i++)
+			{
+				aData[i] = (uint8_t)((ulPut + i) * 131u >> 3);
+			}
+			ulPut += bsp_RingPut(&tRing, aData, usLen);
+		}
+		if (tRing.usHead < usLastHead)
+		{
+			ulWraps++;
+		}
+		usLastHead = tRing.usHead;
+
+		CHECK(bsp_RingCount(&tRing) == ulPut - ulGot);
+		CHECK(bsp_RingCount(&tRing) + bsp_RingFree(&tRing) == RING_SIZE);
+
+		/* DMA: 取一段连续数据发送, 发送完成中断中释放 */
+		usLen = bsp_RingPeekSpan(&tRing, &pSpan);
+		CHECK(pSpan + usLen <= s_ucBuf + RING_SIZE);		/* 不跨越缓冲区末尾 */
+		CHECK(usLen <= ulPut - ulGot);
+		for (i = 0; i < usLen; i++)
+		{
+			CHECK(pSpan[i] == (uint8_t)((ulGot + i) * 131u >> 3));
+		}
+		if (Rand(3) != 0)		/* 有时发送尚未完成 */
+		{
+			bsp_RingConsume(&tRing, usLen);
+			ulGot += usLen;
+		}
+	}
+	CHECK(ulWraps >= 3);
+	CHECK(bsp_RingCount(&tRing) == 0);
+}
+
+/* 混合使用各种读写函数 */
+static void TestMixed(void)
+{
+	RING_T tRing;
+	uint8_t aData[RING_SIZE];
+	uint32_t ulPut = 0;
+	uint32_t ulGot = 0;
+	uint16_t usLen, usDone, i;
+	uint8_t *pSpan;
+	uint8_t ucByte;
+
+	RingStartAt(&tRing, 0xFFF0);
+	while (ulGot < TOTAL)
+	{
+		switch (Rand(2))
+		{
+			case 0:
+				usLen = Rand(RING_SIZE);
+				for (i = 0; i < usLen; i++)
+				{
+					aData[i] = (uint8_t)(ulPut + i);
+				}
+				ulPut += bsp_RingPut(&tRing, aData, usLen);
+				break;
+
+			case 1:
+				if (bsp_RingPutByte(&tRing, (uint8_t)ulPut))
+				{
+					ulPut++;
+				}
+				break;
+
+			default:
+				usLen = bsp_RingReserveSpan(&tRing, &pSpan);
+				CHECK(pSpan + usLen <= s_ucBuf + RING_SIZE);
+				usLen = Rand(usLen);
+				for (i = 0; i < usLen; i++)
+				{
+					pSpan[i] = (uint8_t)(ulPut + i);
+				}
+				bsp_RingCommit(&tRing, usLen);
+				ulPut += usLen;
+				break;
+		}
+		CHECK(bsp_RingCount(&tRing) == ulPut - ulGot);
+
+		if (Rand(1))
+		{
+			usDone = bsp_RingGet(&tRing, aData, Rand(RING_SIZE));
+			for (i = 0; i < usDone; i++)
+			{
+				CHECK(aData[i] == (uint8_t)(ulGot + i));
+			}
+			ulGot += usDone;
+		}
+		else
+		{
+			while (Rand(4) && bsp_RingGetByte(&tRing, &ucByte))
+			{
+				CHECK(ucByte == (uint8_t)ulGot);
+				ulGot++;
+			}
+		}
+		CHECK(bsp_RingCount(&tRing) == ulPut - ulGot);
+	}
+}
+
+int main(void)
+{
+	TestFullAcrossWrap();
+	TestOverrunGet();
+	TestDmaSpans();
+	TestMixed();
+
+	if (s_iErrors)
+	{
+		printf("test_ring: %d error(s)\n", s_iErrors);
+		return 1;
+	}
+	printf("test_ring: OK\n");
+	return 0;
+}
@@ -0,0 +1,285 @@
+/*
+*********************************************************************************************************
+*
+*	模块名称 : 串口DMA发送测试
+*	文件名称 : test_uart_dma.c
+*	说    明 : 主机端测试 bsp_uart_fifo.c 的DMA发送路径 (UartTxDmaStart / UartTxDmaIRQ / TC中断)。
+*			  串口和DMA寄存器是 stub/uart/bsp.h 中的结构体变量, 库函数和DMA搬运由 stub/uart/sim_uart.c
+*			  按硬件行为模拟。
+*			  检查:
+*				(1) 线路上的数据和写入的数据完全相同, 发送FIFO的读写索引多次经过缓冲区末尾和16位回绕;
+*				(2) 每次DMA传输都不越过缓冲区末尾, 中断释放的字节数等于DMA传输的字节数 (usTxDmaLen),
+*				    comGetTxFree() 始终等于缓冲区大小减去未释放的字节数;
+*				(3) FIFO中有数据时DMA一定在工作, 不会停住; 最后一次传输完成后才打开TC中断;
+*				(4) RS485 (COM3): 发送期间 TXEN 一直为发送状态, 只有最后1个字节移出后才由 SendOver 切回接收,
+*				    连续的帧之间不会提前切换;
+*				(5) 在中断中 (PRIMASK = 1) 调用发送函数后 PRIMASK 保持不变;
+*				(6) comClearTxFifo 中止RS485发送时切回接收, 之后的发送正常。
+*
+*********************************************************************************************************
+*/
+
+#include "sim_uart.h"
+
+#define STREAM_SIZE		(1 << 19)
+
+static uint32_t s_ulStreamLen;
+
+static uint8_t s_aStream[STREAM_SIZE];
+static uint8_t s_aWire1[STREAM_SIZE];
+static uint8_t s_aWire3[STREAM_SIZE];
+
+static SIM_TX_T s_tCom1 = {COM1, USART1, DMA1_Channel4, DMA1_IT_TC4, UART1_TX_BUF_SIZE,
+	DMA1_Channel4_IRQHandler, USART1_IRQHandler, s_aWire1, STREAM_SIZE, 0, 0, 0};
+static SIM_TX_T s_tCom3 = {COM3, USART3, DMA1_Channel2, DMA1_IT_TC2, UART3_TX_BUF_SIZE,
+	DMA1_Channel2_IRQHandler, USART3_IRQHandler, s_aWire3, STREAM_SIZE, 0, 0, 0};
+
+/* 写入 _usLen 字节, 由调用者保证发送FIFO放得下 (comSendBuf 在FIFO满时会一直等待) */
+static void SimSend(SIM_TX_T *_pSim, uint16_t _usLen, uint8_t _ucNoWait)
+{
+	uint16_t usPut;
+
+	if (_pSim->SentLen + _usLen > STREAM_SIZE)
+	{
+		return;
+	}
+	if (_ucNoWait)
+	{
+		usPut = comSendBufNoWait(_pSim->Port, &s_aStream[_pSim->SentLen], _usLen);
+	}
+	else
+	{
+		comSendBuf(_pSim->Port, &s_aStream[_pSim->SentLen], _usLen);
+		usPut = _usLen;
+	}
+	_pSim->SentLen += usPut;
+}
+
+/* 每一步之后的不变量 */
+static void CheckTx(SIM_TX_T *_pSim)
+{
+	CHECK(g_ulSimPrimask == 0);
+	CHECK(_pSim->WireLen <= _pSim->SentLen);
+	CHECK(_pSim->Released <= _pSim->WireLen);
+	CHECK(comGetTxFree(_pSim->Port) == _pSim->BufSize - (_pSim->SentLen - _pSim->Released));
+
+	/* FIFO中有数据时DMA必须在工作 */
+	if (_pSim->Released < _pSim->SentLen)
+	{
+		CHECK(SimTxBusy(_pSim));
+	}
+
+	/* TC中断只在最后一次传输完成后打开 */
+	if (SimTxBusy(_pSim))
+	{
+		CHECK(USART_GetITStatus(_pSim->Usart, USART_IT_TC) == RESET);
+	}
+}
+
+/* 连续发送, 随机穿插DMA搬运和TC, 写入的总量远大于16位索引的回绕周期 */
+static void TestStream(void)
+{
+	SIM_TX_T *pSim = &s_tCom1;
+	uint16_t usFree;
+	uint16_t usLen;
+	uint32_t i;
+
+	g_pCase = "stream";
+	for (i = 0; pSim->SentLen < STREAM_SIZE - 2048; i++)
+	{
+		switch (rand() % 4)
+		{
+			case 0:
+			case 1:
+				usFree = comGetTxFree(pSim->Port);
+				usLen = rand() % 300 + 1;
+				if (usLen <= usFree)
+				{
+					SimSend(pSim, usLen, 0);
+				}
+				else
+				{
+					SimSend(pSim, usLen, 1);	/* 只写入放得下的部分 */
+				}
+				break;
+
+			case 2:
+				SimTxDma(pSim, rand() % 400 + 1);
+				break;
+
+			default:
+				SimTxIdle(pSim);
+				break;
+		}
+		CheckTx(pSim);
+		if (g_iErrors)
+		{
+			return;
+		}
+	}
+
+	while (SimTxBusy(pSim))
+	{
+		SimTxDma(pSim, rand() % 400 + 1);
+		CheckTx(pSim);
+	}
+	SimTxIdle(pSim);
+
+	CHECK(pSim->WireLen == pSim->SentLen);
+	CHECK(memcmp(pSim->Wire, s_aStream, pSim->WireLen) == 0);
+	CHECK(USART_GetITStatus(pSim->Usart, USART_IT_TC) == RESET);	/* 发送完毕后关闭TC中断 */
+	CHECK(comGetTxFree(pSim->Port) == pSim->BufSize);
+	s_ulStreamLen = pSim->SentLen;
+}
+
+/* RS485 TXEN 口线的当前状态, 0 表示接收 */
+static uint8_t SimTxEn(void)
+{
+	return (PORT_RS485_TXEN->ODR & PIN_RS485_TXEN) != 0;
+}
+
+/* RS485 应答帧: 每帧在最后1个字节移出后才切回接收; 帧发送中追加数据不提前切换 */
+static void TestRs485(void)
+{
+	SIM_TX_T *pSim = &s_tCom3;
+	uint16_t usFrame;
+	uint16_t usLen;
+	uint8_t ucAppend;
+
+	g_pCase = "rs485";
+	CHECK(SimTxEn() == 0);
+
+	for (usFrame = 0; usFrame < 2000; usFrame++)
+	{
+		usLen = rand() % 600 + 1;		/* 超过缓冲区一半, 经常在缓冲区末尾分两段 */
+		if (pSim->SentLen + 2 * usLen > STREAM_SIZE || usLen > comGetTxFree(pSim->Port))
+		{
+			break;
+		}
+		SimSend(pSim, usLen, 0);
+		CHECK(SimTxEn() == 1);
+
+		ucAppend = (rand() % 4 == 0);
+		while (SimTxBusy(pSim))
+		{
+			SimTxDma(pSim, rand() % 200 + 1);
+			CheckTx(pSim);
+			if (g_iErrors)
+			{
+				return;
+			}
+
+			/* 最后一段DMA完成后, 最后1个字节移出之前, 写入下一帧的开头 */
+			if (ucAppend && !SimTxBusy(pSim))
+			{
+				ucAppend = 0;
+				usLen = rand() % 64 + 1;
+				SimSend(pSim, usLen, 0);
+			}
+			SimTxIdle(pSim);
+			if (pSim->Released < pSim->SentLen)
+			{
+				CHECK(SimTxEn() == 1);		/* 还有数据, 不能切回接收 */
+			}
+		}
+		SimTxIdle(pSim);
+		CHECK(pSim->WireLen == pSim->SentLen);
+		CHECK(SimTxEn() == 0);			/* 没有停在发送状态 */
+	}
+
+	CHECK(memcmp(pSim->Wire, s_aStream, pSim->WireLen) == 0);
+}
+
+/* 发送途中清空发送FIFO: DMA停止, RS485 切回接收, 之后还能正常发送 */
+static void TestClearTx(void)
+{
+	SIM_TX_T *pSim = &s_tCom3;
+	uint16_t usLen;
+
+	g_pCase = "clear";
+	usLen = 500;
+	SimSend(pSim, usLen, 0);
+	CHECK(SimTxEn() == 1);
+	SimTxDma(pSim, 100);
+	CHECK(SimTxBusy(pSim));
+
+	comClearTxFifo(pSim->Port);
+	CHECK(g_ulSimPrimask == 0);
+	CHECK(!SimTxBusy(pSim));
+	CHECK(SimTxEn() == 0);
+	CHECK(comGetTxFree(pSim->Port) == pSim->BufSize);
+	CHECK((pSim->Usart->CR1 & USART_FLAG_TC) == 0);		/* TC中断已关闭, 不会再执行 SendOver */
+	pSim->SentLen = pSim->WireLen;		/* 被丢弃的数据不会出现在线路上 */
+	pSim->Released = pSim->WireLen;
+
+	/* 空闲时清空不执行 SendOver: 口线先置为发送状态, 清空后不会被切回接收 */
+	RS485_TX_EN();
+	comClearTxFifo(pSim->Port);
+	CHECK(SimTxEn() == 1);
+	RS485_RX_EN();
+
+	SimSend(pSim, 300, 0);
+	CHECK(SimTxEn() == 1);
+	while (SimTxBusy(pSim))
+	{
+		SimTxDma(pSim, 64);
+		CheckTx(pSim);
+	}
+	SimTxIdle(pSim);
+	CHECK(SimTxEn() == 0);
+	CHECK(pSim->WireLen == pSim->SentLen);
+	CHECK(memcmp(&pSim->Wire[pSim->WireLen - 300], &s_aStream[pSim->SentLen - 300], 300) == 0);
+}
+
+/* 在中断中 (PRIMASK = 1) 启动发送, 退出时不能打开中断 */
+static void TestIsrCall(void)
+{
+	SIM_TX_T *pSim = &s_tCom1;
+	uint16_t usLen;
+
+	g_pCase = "isr";
+	pSim->WireLen = 0;
+	pSim->SentLen = 0;
+	pSim->Released = 0;
+	bsp_InitUart();
+
+	__set_PRIMASK(1);
+	usLen = comSendBufNoWait(pSim->Port, s_aStream, 100);
+	CHECK(usLen == 100);
+	CHECK(g_ulSimPrimask == 1);
+	__set_PRIMASK(0);
+	pSim->SentLen = usLen;
+
+	while (SimTxBusy(pSim))
+	{
+		SimTxDma(pSim, 37);
+	}
+	CHECK(pSim->WireLen == 100);
+	CHECK(memcmp(pSim->Wire, s_aStream, 100) == 0);
+}
+
+int main(void)
+{
+	uint32_t i;
+
+	srand(1);
+	for (i = 0; i < STREAM_SIZE; i++)
+	{
+		s_aStream[i] = rand();
+	}
+
+	bsp_InitUart();
+
+	TestStream();
+	TestRs485();
+	TestClearTx();
+	TestIsrCall();
+
+	if (g_iErrors != 0)
+	{
+		printf("test_uart_dma: FAILED, %d errors\n", g_iErrors);
+		return 1;
+	}
+	printf("test_uart_dma: OK, COM1 %u bytes, COM3 %u bytes\n", (unsigned)s_ulStreamLen, (unsigned)s_tCom3.SentLen);
+	return 0;
+}
@@ -0,0 +1,379 @@
+/*
+*********************************************************************************************************
+*
+*	模块名称 : USB串口桥接测试
+*	文件名称 : test_usb_bridge.c
+*	说    明 : 主机端测试 usb_bridge.c (USB_COMPOSITE_EN = 1, USB_BRIDGE_EN = 1, 和 Keil 目标 103ZE_Bridge 相同)。
+*			  串口一侧是真正的 bsp_uart_fifo.c, 接在 stub/uart/sim_uart.c 模拟的 USART2 和 DMA1 通道6/7 上;
+*			  USB一侧由本文件模拟 USB_COM2 的端点: usb_PortSend / usb_StartTx / usb_ResumeRx 和 usb_endp.c
+*			  单缓冲时的行为相同, IN端点每次发送完成执行 TxLow 回调, OUT端点收到包后执行 ReciveNew 回调,
+*			  接收FIFO放不下一个满包时回应NAK。
+*			  检查:
+*				(1) 两个方向同时传输, PC -> 串口线路、串口线路 -> PC 的数据和发出的数据完全相同;
+*				(2) USB接收FIFO中有数据时串口一定在发送, OUT端点NAK时一定会被恢复, 不会停住;
+*				(3) 串口接收FIFO中有数据时IN端点一定在发送, USB发送FIFO满时数据留在串口接收FIFO中, 不丢失;
+*				(4) 测试中确实出现了 OUT端点NAK 和 USB发送FIFO满;
+*				(5) SET_LINE_CODING 转换成 USART2 的波特率、字长、停止位和校验位, 波特率为0时不修改;
+*				(6) SET_CONTROL_LINE_STATE 的 DTR/RTS 低电平有效输出到 GPIO, 初始化后为无效电平。
+*
+*********************************************************************************************************
+*/
+
+#include "sim_uart.h"
+#include "hw_config.h"
+#include "usb_desc.h"
+#include "usb_bridge.h"
+
+#define STREAM_SIZE		(1 << 18)
+
+/* 被测模块使用的USB端口和线路编码, 固件中在 hw_config.c 和 usb_prop.c */
+USB_COM_FIFO_T g_tUsbFifo[USB_PORT_NUM];
+LINE_CODING linecoding[VIRTUAL_COM_PORT_NUM_CDC] =
+{
+	{115200, 0x00, 0x00, 0x08},
+	{115200, 0x00, 0x00, 0x08},
+};
+
+static uint8_t s_aUsbTxBuf[USB_COM2_TX_BUF_SIZE];
+static uint8_t s_aUsbRxBuf[USB_COM2_RX_BUF_SIZE];
+static uint8_t s_aInPkt[VIRTUAL_COM_PORT_DATA_SIZE];	/* 装入IN端点、等待主机取走的包 */
+static uint16_t s_usInPktLen;
+
+static uint32_t s_ulOutNak;			/* OUT端点回应NAK的次数 */
+static uint32_t s_ulTxFull;			/* usb_PortSend 没有全部写入的次数 */
+
+static uint8_t s_aOutStream[STREAM_SIZE];		/* PC -> 串口 */
+static uint8_t s_aLineStream[STREAM_SIZE];		/* 串口 -> PC */
+static uint8_t s_aWire[STREAM_SIZE];			/* USART2 TX 线路上的数据 */
+static uint8_t s_aHost[STREAM_SIZE];			/* PC 从 IN端点收到的数据 */
+static uint32_t s_ulOutLen;
+static uint32_t s_ulLineLen;
+static uint32_t s_ulHostLen;
+
+static SIM_TX_T s_tTx2 = {COM2, USART2, DMA1_Channel7, DMA1_IT_TC7, UART2_TX_BUF_SIZE,
+	DMA1_Channel7_IRQHandler, USART2_IRQHandler, s_aWire, STREAM_SIZE, 0, 0, 0};
+static SIM_RX_T s_tRx2 = {USART2, DMA1_Channel6, DMA1_FLAG_HT6, DMA1_Channel6_IRQHandler, USART2_IRQHandler};
+
+/* 模拟的USB端口函数, 和 hw_config.c / usb_endp.c 的行为相同 */
+USB_COM_FIFO_T *usb_GetPort(USB_PORT_E _ePort)
+{
+	if (_ePort >= USB_PORT_NUM)
+	{
+		return 0;
+	}
+	return &g_tUsbFifo[_ePort];
+}
+
+/* IN端点空闲时从发送FIFO装入一个包 */
+void usb_StartTx(USB_COM_FIFO_T *_pPort)
+{
+	uint32_t ulPrimask;
+
+	ulPrimask = __get_PRIMASK();
+	DISABLE_INT();
+	if (_pPort->ucTxBusy == 0)
+	{
+		s_usInPktLen = bsp_RingGet(&_pPort->tTxRing, s_aInPkt, sizeof(s_aInPkt));
+		_pPort->ucTxBusy = (s_usInPktLen != 0);
+	}
+	__set_PRIMASK(ulPrimask);
+}
+
+void usb_ResumeRx(USB_COM_FIFO_T *_pPort)
+{
+	uint32_t ulPrimask;
+
+	ulPrimask = __get_PRIMASK();
+	DISABLE_INT();
+	if (_pPort->ucRxNak == 1 && bsp_RingFree(&_pPort->tRxRing) >= _pPort->usRxPktSize)
+	{
+		_pPort->ucRxNak = 0;
+	}
+	__set_PRIMASK(ulPrimask);
+}
+
+uint16_t usb_PortSend(USB_PORT_E _ePort, const uint8_t *_pTxBuf, uint16_t _usLen, USB_TX_POLICY_E _ePolicy)
+{
+	USB_COM_FIFO_T *pPort;
+	uint16_t usDone;
+
+	pPort = usb_GetPort(_ePort);
+	if (pPort == 0 || _ePolicy != USB_TX_PARTIAL)
+	{
+		g_iErrors++;		/* 桥接只使用 USB_TX_PARTIAL */
+		return 0;
+	}
+
+	usDone = bsp_RingPut(&pPort->tTxRing, _pTxBuf, _usLen);
+	if (usDone < _usLen)
+	{
+		s_ulTxFull++;
+	}
+	usb_StartTx(pPort);
+	return usDone;
+}
+
+/* 主机发出一个OUT包。端点NAK时返回0, 主机稍后重发 */
+static uint16_t SimUsbOut(const uint8_t *_pData, uint16_t _usLen)
+{
+	USB_COM_FIFO_T *pPort = &g_tUsbFifo[USB_BRIDGE_PORT];
+
+	if (pPort->ucRxNak)
+	{
+		s_ulOutNak++;
+		return 0;
+	}
+	if (bsp_RingFree(&pPort->tRxRing) < _usLen)
+	{
+		g_iErrors++;		/* 端点没有NAK, FIFO却放不下 */
+		printf("[%s] OUT packet overflows the receive FIFO\n", g_pCase);
+		return 0;
+	}
+
+	bsp_RingPut(&pPort->tRxRing, _pData, _usLen);
+	if (bsp_RingFree(&pPort->tRxRing) < pPort->usRxPktSize)
+	{
+		pPort->ucRxNak = 1;
+	}
+	if (pPort->ReciveNew)
+	{
+		pPort->ReciveNew();
+	}
+	return _usLen;
+}
+
+/* 主机取走IN端点的包, 发送完成中断装入下一个包并执行 TxLow 回调 */
+static void SimUsbIn(void)
+{
+	USB_COM_FIFO_T *pPort = &g_tUsbFifo[USB_BRIDGE_PORT];
+
+	if (pPort->ucTxBusy == 0)
+	{
+		return;
+	}
+	CHECK(s_ulHostLen + s_usInPktLen <= STREAM_SIZE);
+	memcpy(&s_aHost[s_ulHostLen], s_aInPkt, s_usInPktLen);
+	s_ulHostLen += s_usInPktLen;
+
+	pPort->ucTxBusy = 0;
+	usb_StartTx(pPort);
+	if (pPort->TxLow)
+	{
+		pPort->TxLow();
+	}
+}
+
+/* 串口线路上到达 _usLen 个字节, _ucIdle = 1 时随后总线空闲 */
+static void SimLineRx(uint16_t _usLen, uint8_t _ucIdle)
+{
+	SimRxDma(&s_tRx2, &s_aLineStream[s_ulLineLen], _usLen);
+	s_ulLineLen += _usLen;
+	if (_ucIdle)
+	{
+		SimRxIdle(&s_tRx2);
+	}
+}
+
+static void InitUsbPort(void)
+{
+	USB_COM_FIFO_T *pPort = &g_tUsbFifo[USB_BRIDGE_PORT];
+
+	memset(pPort, 0, sizeof(*pPort));
+	bsp_RingInit(&pPort->tTxRing, s_aUsbTxBuf, USB_COM2_TX_BUF_SIZE);
+	bsp_RingInit(&pPort->tRxRing, s_aUsbRxBuf, USB_COM2_RX_BUF_SIZE);
+	pPort->usRxPktSize = VIRTUAL_COM_PORT_DBG_OUT_SIZE;
+}
+
+/* 每一步之后的不变量: 两个方向都不会停住 */
+static void CheckBridge(void)
+{
+	USB_COM_FIFO_T *pPort = &g_tUsbFifo[USB_BRIDGE_PORT];
+
+	CHECK(g_ulSimPrimask == 0);
+	if (bsp_RingCount(&pPort->tRxRing) != 0 || pPort->ucRxNak)
+	{
+		CHECK(SimTxBusy(&s_tTx2));			/* 串口发送FIFO满, 由低水位回调继续 */
+	}
+	if (!comRxIsEmpty(COM2))
+	{
+		CHECK(pPort->ucTxBusy);				/* USB发送FIFO满, 由IN端点发送完成继续 */
+	}
+	CHECK(comGetRxOverrun(COM2) == 0);
+}
+
+/* 初始化: DTR/RTS 为无效电平, 回调已注册, USART2 按默认线路编码配置 */
+static void TestInit(void)
+{
+	USB_COM_FIFO_T *pPort = &g_tUsbFifo[USB_BRIDGE_PORT];
+
+	g_pCase = "init";
+	CHECK(PORT_COM2_DTR->ODR & PIN_COM2_DTR);
+	CHECK(PORT_COM2_RTS->ODR & PIN_COM2_RTS);
+	CHECK(pPort->ReciveNew != 0 && pPort->TxLow != 0);
+	CHECK(g_tSimUsartInit[1].USART_BaudRate == 115200);
+	CHECK(g_tSimUsartInit[1].USART_WordLength == USART_WordLength_8b);
+	CHECK(g_tSimUsartInit[1].USART_Parity == USART_Parity_No);
+}
+
+/* 两个方向同时传输, 随机穿插主机的OUT/IN事务、串口发送DMA和线路输入 */
+static void TestDuplex(void)
+{
+	USB_COM_FIFO_T *pPort = &g_tUsbFifo[USB_BRIDGE_PORT];
+	uint32_t ulPending;
+	uint16_t usLen;
+	uint32_t i;
+
+	g_pCase = "duplex";
+	for (i = 0; s_ulOutLen < STREAM_SIZE - 64 || s_ulLineLen < STREAM_SIZE - 1024; i++)
+	{
+		switch (rand() % 8)
+		{
+			case 0:
+			case 1:
+			case 2:		/* PC 发送得比串口快, OUT端点会NAK */
+				if (s_ulOutLen < STREAM_SIZE - 64)
+				{
+					usLen = rand() % pPort->usRxPktSize + 1;
+					s_ulOutLen += SimUsbOut(&s_aOutStream[s_ulOutLen], usLen);
+				}
+				break;
+
+			case 3:
+				SimTxDma(&s_tTx2, rand() % 64 + 1);
+				break;
+
+			case 4:
+				SimTxIdle(&s_tTx2);
+				break;
+
+			case 5:
+			case 6:		/* 串口线路输入, 不超过接收FIFO中能放下的量 (没有硬件流控) */
+				usLen = rand() % 300 + 1;
+				ulPending = s_ulLineLen - s_ulHostLen - bsp_RingCount(&pPort->tTxRing) - (pPort->ucTxBusy ? s_usInPktLen : 0);
+				if (s_ulLineLen + usLen <= STREAM_SIZE && ulPending + usLen <= UART2_RX_BUF_SIZE)
+				{
+					SimLineRx(usLen, rand() % 4 != 0);
+				}
+				break;
+
+			default:	/* PC 读取得比串口慢, USB发送FIFO会满 */
+				SimUsbIn();
+				break;
+		}
+		CheckBridge();
+		if (g_iErrors)
+		{
+			return;
+		}
+	}
+
+	/* 排空两个方向 */
+	SimRxIdle(&s_tRx2);
+	for (i = 0; i < 100000 && (SimTxBusy(&s_tTx2) || pPort->ucTxBusy); i++)
+	{
+		SimTxDma(&s_tTx2, 64);
+		SimUsbIn();
+		CheckBridge();
+		if (g_iErrors)
+		{
+			return;
+		}
+	}
+	SimTxIdle(&s_tTx2);
+
+	CHECK(bsp_RingCount(&pPort->tRxRing) == 0 && pPort->ucRxNak == 0);
+	CHECK(s_tTx2.WireLen == s_ulOutLen);
+	CHECK(memcmp(s_aWire, s_aOutStream, s_ulOutLen) == 0);
+	CHECK(comRxIsEmpty(COM2));
+	CHECK(s_ulHostLen == s_ulLineLen);
+	CHECK(memcmp(s_aHost, s_aLineStream, s_ulLineLen) == 0);
+	CHECK(s_ulOutNak > 0);
+	CHECK(s_ulTxFull > 0);
+}
+
+/* SET_LINE_CODING: STM32的字长包含校验位 */
+static void TestLineCoding(void)
+{
+	static const struct
+	{
+		LINE_CODING Coding;
+		uint16_t WordLength;
+		uint16_t StopBits;
+		uint16_t Parity;
+	}s_aCase[] =
+	{
+		{{921600, 0, 0, 8}, USART_WordLength_8b, USART_StopBits_1, USART_Parity_No},
+		{{9600, 2, 2, 8}, USART_WordLength_9b, USART_StopBits_2, USART_Parity_Even},
+		{{19200, 1, 1, 7}, USART_WordLength_8b, USART_StopBits_1_5, USART_Parity_Odd},
+		{{57600, 0, 0, 7}, USART_WordLength_8b, USART_StopBits_1, USART_Parity_No},	/* 7位无校验不支持 */
+		{{38400, 0, 3, 8}, USART_WordLength_8b, USART_StopBits_1, USART_Parity_No},	/* mark 校验不支持 */
+		{{4800, 0, 2, 6}, USART_WordLength_8b, USART_StopBits_1, USART_Parity_No},	/* 6位数据不支持 */
+	};
+	LINE_CODING tZero = {0, 0, 2, 8};
+	uint32_t ulCount;
+	uint32_t i;
+
+	g_pCase = "linecoding";
+	for (i = 0; i < sizeof(s_aCase) / sizeof(s_aCase[0]); i++)
+	{
+		usb_BridgeSetLineCoding((LINE_CODING *)&s_aCase[i].Coding);
+		CHECK(g_tSimUsartInit[1].USART_BaudRate == s_aCase[i].Coding.bitrate);
+		CHECK(g_tSimUsartInit[1].USART_WordLength == s_aCase[i].WordLength);
+		CHECK(g_tSimUsartInit[1].USART_StopBits == s_aCase[i].StopBits);
+		CHECK(g_tSimUsartInit[1].USART_Parity == s_aCase[i].Parity);
+		CHECK(g_tSimUsartInit[1].USART_Mode == (USART_Mode_Rx | USART_Mode_Tx));
+	}
+
+	ulCount = g_ulSimUsartInitCount[1];
+	usb_BridgeSetLineCoding(&tZero);
+	CHECK(g_ulSimUsartInitCount[1] == ulCount);		/* 波特率为0时保持原配置 */
+	CHECK(g_tSimUsartInit[1].USART_BaudRate == 4800);
+}
+
+/* SET_CONTROL_LINE_STATE: bit0 = DTR, bit1 = RTS, 有效时输出低电平 */
+static void TestCtrlLine(void)
+{
+	static const uint16_t s_aState[] = {0x03, 0x00, 0x01, 0x03, 0x02, 0x00};
+	uint16_t usState;
+	uint32_t i;
+
+	g_pCase = "ctrlline";
+	for (i = 0; i < sizeof(s_aState) / sizeof(s_aState[0]); i++)
+	{
+		usState = s_aState[i];
+		usb_BridgeSetCtrlLine(usState);
+		CHECK(((PORT_COM2_DTR->ODR & PIN_COM2_DTR) == 0) == ((usState & 0x01) != 0));
+		CHECK(((PORT_COM2_RTS->ODR & PIN_COM2_RTS) == 0) == ((usState & 0x02) != 0));
+	}
+}
+
+int main(void)
+{
+	uint32_t i;
+
+	srand(1);
+	for (i = 0; i < STREAM_SIZE; i++)
+	{
+		s_aOutStream[i] = rand();
+		s_aLineStream[i] = rand();
+	}
+
+	/* 和 bsp_InitUsb() 的顺序相同: 先初始化串口, 再初始化桥接 */
+	bsp_InitUart();
+	InitUsbPort();
+	usb_BridgeInit();
+
+	TestInit();
+	TestDuplex();
+	TestLineCoding();
+	TestCtrlLine();
+
+	if (g_iErrors != 0)
+	{
+		printf("test_usb_bridge: FAILED, %d errors\n", g_iErrors);
+		return 1;
+	}
+	printf("test_usb_bridge: OK, PC->COM2 %u bytes, COM2->PC %u bytes, %u NAK, %u USB TX full\n",
+		(unsigned)s_ulOutLen, (unsigned)s_ulLineLen, (unsigned)s_ulOutNak, (unsigned)s_ulTxFull);
+	return 0;
+}
@@ -0,0 +1,169 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+生成差分升级包 (格式见 User/iap/iap_patch.c)。
+
+设备用正在运行的程序(旧版本)和差分包生成新程序, 只需要传送变化的部分。旧版本必须和设备上
+运行的程序完全相同 (设备检查长度和CRC), 所以要保存每次发布的 .hex/.bin 文件。
+
+生成后默认用本脚本中和设备相同的算法还原一次, 确认和新程序一致 (--no-check 跳过)。
+
+用法:
+    python iap_diff.py old.hex new.hex update.dpt
+    python usb_iap.py COM5 update.dpt
+
+依赖: 无 (.hex 解析和CRC计算使用 usb_iap.py 中的函数)
+"""
+
+import argparse
+import struct
+import sys
+
+from usb_iap import load_image, stm32_crc
+
+MAGIC = b"DPT1"
+OP_END = 0x00
+OP_COPY = 0x01
+OP_DATA = 0x02
+
+KEY_LEN = 8         # 查找匹配用的索引长度
+MIN_COPY = 8        # 短于此长度的匹配按新数据发送 (COPY 命令本身占 3-7 字节)
+MAX_CAND = 32       # 每个索引最多记录的旧程序位置数
+
+
+def varint(n):
+    out = bytearray()
+    while True:
+        b = n & 0x7F
+        n >>= 7
+        if n:
+            out.append(b | 0x80)
+        else:
+            out.append(b)
+            return bytes(out)
+
+
+def zigzag(n):
+    return ((n << 1) ^ (n >> 31)) & 0xFFFFFFFF
+
+
+def make_patch(old, new):
+    index = {}
+    for i in range(len(old) - KEY_LEN + 1):
+        lst = index.setdefault(old[i:i + KEY_LEN], [])
+        if len(lst) < MAX_CAND:
+            lst.append(i)
+
+    out = bytearray(MAGIC)
+    out += struct.pack("<IIII", len(old), stm32_crc(old), len(new), stm32_crc(new))
+
+    literal = bytearray()
+    src = 0
+    pos = 0
+    while pos < len(new):
+        cands = index.get(new[pos:pos + KEY_LEN], [])
+        if src < len(old):
+            cands = [src] + cands       # 优先沿用上一次复制的位置, 增量为0
+        best_len = 0
+        best_src = 0
+        for c in cands:
+            n = 0
+            while pos + n < len(new) and c + n < len(old) and old[c + n] == new[pos + n]:
+                n += 1
+            if n > best_len:
+                best_len, best_src = n, c
+
+        if best_len >= MIN_COPY:
+            if literal:
+                out += bytes([OP_DATA]) + varint(len(literal)) + literal
+                literal = bytearray()
+            out += bytes([OP_COPY]) + varint(best_len) + varint(zigzag(best_src - src))
+            src = best_src + best_len
+            pos += best_len
+        else:
+            literal.append(new[pos])
+            pos += 1
+
+    if literal:
+        out += bytes([OP_DATA]) + varint(len(literal)) + literal
+    out.append(OP_END)
+    return bytes(out)
+
+
+def read_varint(patch, i):
+    n = 0
+    shift = 0
+    while True:
+        if shift >= 32:
+            raise ValueError("变长整数超过5字节")
+        b = patch[i]
+        i += 1
+        n |= (b & 0x7F) << shift
+        shift += 7
+        if not b & 0x80:
+            return n & 0xFFFFFFFF, i
+
+
+def apply_patch(old, patch):
+    """和 iap_patch.c 相同的还原算法, 用于检查差分包"""
+    if patch[:4] != MAGIC:
+        raise ValueError("不是差分包")
+    old_size, old_crc, new_size, new_crc = struct.unpack_from("<IIII", patch, 4)
+    if old_size != len(old) or old_crc != stm32_crc(old):
+        raise ValueError("旧程序版本不符")
+
+    out = bytearray()
+    src = 0
+    i = 20
+    while True:
+        op = patch[i]
+        i += 1
+        if op == OP_END:
+            break
+        n, i = read_varint(patch, i)
+        if op == OP_COPY:
+            d, i = read_varint(patch, i)
+            src = (src + ((d >> 1) ^ (-(d & 1) & 0xFFFFFFFF))) & 0xFFFFFFFF
+            if src > old_size or n > old_size - src:
+                raise ValueError("COPY 超出旧程序")
+            out += old[src:src + n]
+            src += n
+        elif op == OP_DATA:
+            out += patch[i:i + n]
+            i += n
+        else:
+            raise ValueError("未知命令 0x%02X" % op)
+        if len(out) > new_size:
+            raise ValueError("生成的程序超长")
+
+    if i != len(patch):
+        raise ValueError("END 后面还有数据")
+    if len(out) != new_size or stm32_crc(bytes(out)) != new_crc:
+        raise ValueError("生成的程序CRC错误")
+    return bytes(out)
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Generate a delta update package")
+    ap.add_argument("old", help="设备上正在运行的程序 (.bin 或 .hex)")
+    ap.add_argument("new", help="新程序 (.bin 或 .hex)")
+    ap.add_argument("patch", help="输出的差分包")
+    ap.add_argument("--no-check", action="store_true", help="不做还原检查")
+    args = ap.parse_args()
+
+    old = load_image(args.old)
+    new = load_image(args.new)
+    patch = make_patch(old, new)
+    if not args.no_check and apply_patch(old, patch) != new:
+        print("还原检查失败")
+        return 1
+
+    with open(args.patch, "wb") as f:
+        f.write(patch)
+    print("旧程序 %d 字节, 新程序 %d 字节, 差分包 %d 字节 (%.1f%%)"
+          % (len(old), len(new), len(patch), len(patch) * 100.0 / len(new)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
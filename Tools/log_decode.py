@@ -0,0 +1,432 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+解码二进制日志 (User/bsp/src/bsp_log.c)。
+
+设备只发送格式字符串的地址、时间戳和32位参数, 本程序从编译生成的 .axf (ELF) 文件中读出格式字符串
+和 %s 引用的常量字符串, 按 nanoprintf 的规则格式化 (和 User/bsp/nanoprintf.h 的配置相同: 支持宽度和
+精度, 不支持 %ll/%j/%z/%t/%n 和 %f, %f 按无效格式原样输出; 日志参数都是32位)。
+帧以外的字节 (printf 输出的文字) 原样显示。.axf 必须和设备上运行的程序是同一次编译生成的。
+
+帧格式 (小端):
+    0xA5, 参数个数 n, 格式字符串地址(4), 时刻us(4), 参数(4 * n), 校验和(1)
+    校验和 = 从参数个数到最后一个参数所有字节之和取反。格式字符串地址为 0 表示丢弃的日志条数。
+
+用法:
+    python log_decode.py ..\\Project\\103ZE\\output.axf COM3
+    python log_decode.py output.axf /dev/ttyUSB0 --baud 115200
+    python log_decode.py output.axf --file capture.bin
+
+依赖: 读串口时需要 pyserial (pip install pyserial)
+"""
+
+import argparse
+import codecs
+import struct
+import sys
+
+LOG_SYNC = 0xA5
+LOG_HEAD_SIZE = 10
+LOG_MAX_ARGS = 6
+
+NPF_FLOAT = False      # nanoprintf.h 的 NANOPRINTF_USE_FLOAT_FORMAT_SPECIFIERS
+
+SHT_NOBITS = 8
+SHF_ALLOC = 0x2
+
+
+class Elf:
+    """只读取 ELF32 小端文件中占用地址空间的段 (代码和常量), 用于按地址查找字符串"""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            data = f.read()
+        if data[:4] != b"\x7fELF" or data[4] != 1 or data[5] != 1:
+            raise ValueError("不是32位小端 ELF 文件")
+        shoff, = struct.unpack_from("<I", data, 0x20)
+        shentsize, shnum = struct.unpack_from("<HH", data, 0x2E)
+        self.sections = []
+        for i in range(shnum):
+            _, typ, flags, addr, off, size = struct.unpack_from("<IIIIII", data, shoff + i * shentsize)
+            if (flags & SHF_ALLOC) and typ != SHT_NOBITS and size > 0:
+                self.sections.append((addr, data[off:off + size]))
+
+    def read_cstr(self, addr):
+        for base, body in self.sections:
+            if base <= addr < base + len(body):
+                end = body.find(b"\0", addr - base)
+                if end < 0:
+                    end = len(body)
+                return body[addr - base:end]
+        return None
+
+
+# 和 nanoprintf.h 中的枚举对应
+LEN_NONE, LEN_SHORT, LEN_LONG, LEN_LONG_DOUBLE, LEN_CHAR = range(5)
+CONV_PERCENT, CONV_CHAR, CONV_STRING, CONV_SIGNED, CONV_OCTAL, CONV_HEX, CONV_UNSIGNED, CONV_POINTER, CONV_FLOAT = range(9)
+W_NONE, W_STAR, W_LITERAL = range(3)
+
+
+class Spec:
+    pass
+
+
+def _digit(c):
+    return 0x30 <= c <= 0x39
+
+
+def parse_format_spec(fmt, start):
+    """npf__parse_format_spec() 的移植。返回 (Spec, 长度), 不是格式说明时返回 (None, 0)"""
+    n = len(fmt)
+
+    def ch(k):
+        return fmt[k] if k < n else 0
+
+    fs = Spec()
+    fs.left_justified = fs.leading_zero_pad = 0
+    fs.prepend_sign = fs.prepend_space = fs.alternative_form = 0
+    fs.length_modifier = LEN_NONE
+    fs.upper = False
+
+    cur = start + 1
+    while ch(cur):
+        c = ch(cur)
+        if c == ord("-"):
+            fs.left_justified = 1
+            fs.leading_zero_pad = 0
+        elif c == ord("0"):
+            fs.leading_zero_pad = int(not fs.left_justified)
+        elif c == ord("+"):
+            fs.prepend_sign = 1
+            fs.prepend_space = 0
+        elif c == ord(" "):
+            fs.prepend_space = int(not fs.prepend_sign)
+        elif c == ord("#"):
+            fs.alternative_form = 1
+        else:
+            break
+        cur += 1
+
+    fs.field_width_type = W_NONE
+    fs.field_width = 0
+    if ch(cur) == ord("*"):
+        fs.field_width_type = W_STAR
+        cur += 1
+    else:
+        if _digit(ch(cur)):
+            fs.field_width_type = W_LITERAL
+        while _digit(ch(cur)):
+            fs.field_width = fs.field_width * 10 + ch(cur) - 0x30
+            cur += 1
+
+    fs.precision_type = W_NONE
+    fs.precision = 0
+    if ch(cur) == ord("."):
+        cur += 1
+        if ch(cur) == ord("*"):
+            fs.precision_type = W_STAR
+            cur += 1
+        elif ch(cur) == ord("-"):
+            cur += 1
+            while _digit(ch(cur)):
+                cur += 1
+        else:
+            fs.precision_type = W_LITERAL
+            while _digit(ch(cur)):
+                fs.precision = fs.precision * 10 + ch(cur) - 0x30
+                cur += 1
+
+    c = ch(cur)
+    cur += 1
+    if c == ord("h"):
+        if ch(cur) == ord("h"):
+            fs.length_modifier = LEN_CHAR
+            cur += 1
+        else:
+            fs.length_modifier = LEN_SHORT
+    elif c == ord("l"):
+        fs.length_modifier = LEN_LONG
+    elif c == ord("L") and NPF_FLOAT:
+        fs.length_modifier = LEN_LONG_DOUBLE
+    else:
+        cur -= 1
+
+    c = ch(cur)
+    cur += 1
+    if c == ord("%"):
+        fs.conv = CONV_PERCENT
+        fs.precision_type = W_NONE
+    elif c == ord("c"):
+        fs.conv = CONV_CHAR
+        fs.precision_type = W_NONE
+    elif c == ord("s"):
+        fs.conv = CONV_STRING
+        fs.leading_zero_pad = 0
+    elif c in (ord("i"), ord("d")):
+        fs.conv = CONV_SIGNED
+    elif c == ord("o"):
+        fs.conv = CONV_OCTAL
+    elif c in (ord("x"), ord("X")):
+        fs.conv = CONV_HEX
+        fs.upper = c == ord("X")
+    elif c == ord("u"):
+        fs.conv = CONV_UNSIGNED
+    elif c in (ord("f"), ord("F")) and NPF_FLOAT:
+        fs.conv = CONV_FLOAT
+        fs.upper = c == ord("F")
+    elif c == ord("p"):
+        fs.conv = CONV_POINTER
+        fs.precision_type = W_NONE
+    else:
+        return None, 0
+
+    if fs.precision_type in (W_NONE, W_STAR):
+        if fs.conv in (CONV_PERCENT, CONV_CHAR, CONV_STRING, CONV_POINTER):
+            fs.precision = 0
+        elif fs.conv == CONV_FLOAT:
+            fs.precision = 6
+        else:
+            fs.precision = 1
+
+    return fs, cur - start
+
+
+def _s32(v):
+    v &= 0xFFFFFFFF
+    return v - 0x100000000 if v & 0x80000000 else v
+
+
+def _utoa(val, base, upper):
+    if val == 0:
+        return b"0"
+    digits = b"0123456789ABCDEF" if upper else b"0123456789abcdef"
+    out = bytearray()
+    while val:
+        out.append(digits[val % base])
+        val //= base
+    return bytes(reversed(out))
+
+
+def npf_format(fmt, args, read_cstr):
+    """npf_vpprintf() 的移植, 参数是32位整数列表 (ARM: int/long 32位, char 无符号)"""
+    out = bytearray()
+    argi = [0]
+
+    def next_arg():
+        v = args[argi[0]] if argi[0] < len(args) else 0
+        argi[0] += 1
+        return v & 0xFFFFFFFF
+
+    cur = 0
+    while cur < len(fmt):
+        if fmt[cur] != ord("%"):
+            out.append(fmt[cur])
+            cur += 1
+            continue
+        fs, fs_len = parse_format_spec(fmt, cur)
+        if fs_len == 0:
+            out.append(fmt[cur])
+            cur += 1
+            continue
+
+        sign = 0
+        cbuf = b""
+
+        if fs.field_width_type == W_STAR:
+            w = _s32(next_arg())
+            fs.field_width_type = W_LITERAL
+            if w >= 0:
+                fs.field_width = w
+            else:
+                fs.field_width = -w
+                fs.left_justified = 1
+
+        if fs.precision_type == W_STAR:
+            p = _s32(next_arg())
+            if p >= 0:
+                fs.precision_type = W_LITERAL
+                fs.precision = p
+            else:
+                fs.precision_type = W_NONE
+
+        if fs.conv == CONV_PERCENT:
+            cbuf = b"%"
+        elif fs.conv == CONV_CHAR:
+            cbuf = bytes([next_arg() & 0xFF])
+        elif fs.conv == CONV_STRING:
+            addr = next_arg()
+            s = read_cstr(addr)
+            if s is None:
+                s = ("<0x%08X>" % addr).encode()
+            if fs.precision_type == W_LITERAL:
+                s = s[:fs.precision]
+            cbuf = s
+        elif fs.conv == CONV_SIGNED:
+            v = next_arg()
+            if fs.length_modifier == LEN_SHORT:
+                v = (v & 0xFFFF) - 0x10000 if v & 0x8000 else v & 0xFFFF
+            elif fs.length_modifier == LEN_CHAR:
+                v &= 0xFF           # ARM 的 char 是无符号的
+            else:
+                v = _s32(v)
+            sign = -1 if v < 0 else 1
+            if v == 0 and fs.precision == 0 and fs.precision_type == W_LITERAL:
+                cbuf = b""
+            else:
+                cbuf = str(abs(v)).encode()
+        elif fs.conv in (CONV_OCTAL, CONV_HEX, CONV_UNSIGNED):
+            base = 8 if fs.conv == CONV_OCTAL else (16 if fs.conv == CONV_HEX else 10)
+            v = next_arg()
+            if fs.length_modifier == LEN_SHORT:
+                v &= 0xFFFF
+            elif fs.length_modifier == LEN_CHAR:
+                v &= 0xFF
+            if v == 0 and fs.precision == 0:
+                if fs.conv == CONV_OCTAL and fs.alternative_form:
+                    fs.precision = 1
+                cbuf = b""
+            else:
+                cbuf = _utoa(v, base, fs.upper)
+            if v and fs.alternative_form:
+                if fs.conv == CONV_OCTAL:
+                    cbuf = b"0" + cbuf
+                elif fs.conv == CONV_HEX:
+                    cbuf = (b"0X" if fs.upper else b"0x") + cbuf
+        elif fs.conv == CONV_POINTER:
+            cbuf = b"0x" + _utoa(next_arg(), 16, False)
+        elif fs.conv == CONV_FLOAT:
+            next_arg()
+            cbuf = b"?"             # 日志参数只有32位, 不支持浮点数
+
+        sign_c = b""
+        if sign == -1:
+            sign_c = b"-"
+        elif sign == 1:
+            if fs.prepend_sign:
+                sign_c = b"+"
+            elif fs.prepend_space:
+                sign_c = b" "
+
+        pad_c = b""
+        if fs.field_width_type == W_LITERAL:
+            if fs.leading_zero_pad:
+                if fs.conv not in (CONV_STRING, CONV_CHAR, CONV_PERCENT):
+                    pad_c = b"0"
+            else:
+                pad_c = b" "
+
+        prec_pad = 0
+        if fs.conv not in (CONV_STRING, CONV_FLOAT):
+            prec_pad = max(0, fs.precision - len(cbuf))
+
+        field_pad = max(0, fs.field_width - len(cbuf) - len(sign_c) - prec_pad)
+
+        if not fs.left_justified and pad_c:
+            if sign_c in (b"-", b"+") and pad_c == b"0":
+                out += sign_c
+                sign_c = b""
+            out += pad_c * field_pad
+
+        if fs.conv == CONV_STRING:
+            out += cbuf
+        else:
+            out += sign_c
+            out += b"0" * prec_pad
+            out += cbuf
+
+        if fs.left_justified and pad_c:
+            out += pad_c * field_pad
+
+        cur += fs_len
+    return bytes(out)
+
+
+class Decoder:
+    """从字节流中分离日志帧和普通文字"""
+
+    def __init__(self, elf, write):
+        self.elf = elf
+        self.write = write
+        self.buf = bytearray()
+        self.text = bytearray()
+        self.utf8 = codecs.getincrementaldecoder("utf-8")("replace")   # 多字节字符可能分在两次读取中
+
+    def feed(self, data):
+        self.buf += data
+        while self.buf:
+            if self.buf[0] != LOG_SYNC:
+                self.text.append(self.buf.pop(0))
+                continue
+            if len(self.buf) < 2:
+                break
+            n = self.buf[1]
+            size = LOG_HEAD_SIZE + 4 * n + 1
+            if n > LOG_MAX_ARGS:
+                self.text.append(self.buf.pop(0))
+                continue
+            if len(self.buf) < size:
+                break
+            frame = bytes(self.buf[:size])
+            if (~sum(frame[1:-1])) & 0xFF != frame[-1]:
+                self.text.append(self.buf.pop(0))       # 不是日志帧, 按文字显示
+                continue
+            del self.buf[:size]
+            self.flush_text()
+            self.frame(frame, n)
+        self.flush_text()
+
+    def flush_text(self):
+        if self.text:
+            self.write(self.utf8.decode(bytes(self.text)))
+            self.text.clear()
+
+    def frame(self, frame, n):
+        fmt_addr, time_us = struct.unpack_from("<II", frame, 2)
+        args = list(struct.unpack_from("<%dI" % n, frame, LOG_HEAD_SIZE))
+        stamp = "[%4u.%06u] " % (time_us // 1000000, time_us % 1000000)
+        if fmt_addr == 0:
+            self.write(stamp + "*** 日志缓冲区满, 丢弃 %u 条 ***\n" % args[0])
+            return
+        fmt = self.elf.read_cstr(fmt_addr)
+        if fmt is None:
+            self.write(stamp + "<未知格式 0x%08X> %s\n" % (fmt_addr, " ".join("%08X" % a for a in args)))
+            return
+        text = npf_format(fmt, args, self.elf.read_cstr).decode("utf-8", "replace")
+        self.write(stamp + text.rstrip("\r\n") + "\n")
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Decode binary log frames using the firmware ELF")
+    ap.add_argument("elf", help="设备上运行的程序 (.axf)")
+    ap.add_argument("port", nargs="?", help="串口名, 例如 COM3 或 /dev/ttyUSB0")
+    ap.add_argument("--baud", type=int, default=115200, help="波特率 (默认 115200)")
+    ap.add_argument("--file", help="从文件读取保存的原始数据, 不打开串口")
+    args = ap.parse_args()
+
+    elf = Elf(args.elf)
+
+    def write(s):
+        sys.stdout.write(s)
+        sys.stdout.flush()
+
+    dec = Decoder(elf, write)
+    if args.file:
+        with open(args.file, "rb") as f:
+            dec.feed(f.read())
+        return 0
+    if not args.port:
+        ap.error("需要指定串口或 --file")
+
+    import serial
+    ser = serial.Serial(args.port, args.baud, timeout=0.1)
+    try:
+        while True:
+            dec.feed(ser.read(ser.in_waiting or 1))
+    except KeyboardInterrupt:
+        pass
+    ser.close()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
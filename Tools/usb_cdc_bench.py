@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+USB 虚拟串口回环吞吐量测试。
+
+固件的 UsbCmdPro() 会把 PC 发来的数据原样回显，本脚本持续发送随机数据并读回，
+校验内容并统计吞吐量 (单向字节数 / 秒)。在途数据量不超过 --window，
+避免设备的接收 FIFO (USB_RX_BUF_SIZE) 溢出。
+
+用法:
+    python usb_cdc_bench.py COM5
+    python usb_cdc_bench.py /dev/ttyACM0 --bytes 4000000 --window 1024
+
+依赖: pyserial (pip install pyserial)
+
+注意: 完成中断驱动的 IN 传输 (EP1_IN_Callback 连续装包) 还没有在开发板上用本脚本测过,
+吞吐量没有实测数据。全速批量传输的上限约 1MB/s (每帧最多19个64字节包), 实际值取决于主机驱动。
+"""
+
+import argparse
+import os
+import sys
+import time
+
+import serial
+
+
+def run(port, total, window, chunk, timeout):
+    ser = serial.Serial(port, 115200, timeout=0)    # 虚拟串口的波特率设置不影响USB传输速度
+    ser.reset_input_buffer()
+
+    data = os.urandom(total)
+    sent = 0
+    recv = 0
+    rx = bytearray()
+    t0 = time.perf_counter()
+    last = t0
+
+    while recv < total:
+        if sent < total and sent - recv < window:
+            n = min(chunk, total - sent, window - (sent - recv))
+            sent += ser.write(data[sent:sent + n])
+
+        got = ser.read(ser.in_waiting or 1)
+        if got:
+            rx += got
+            last = time.perf_counter()
+            if len(rx) >= 4096 or recv + len(rx) >= total:
+                if rx != data[recv:recv + len(rx)]:
+                    for i, b in enumerate(rx):
+                        if b != data[recv + i]:
+                            print("数据错误: 偏移 %d, 期望 0x%02X, 收到 0x%02X" % (recv + i, data[recv + i], b))
+                            return 1
+                recv += len(rx)
+                rx = bytearray()
+        elif time.perf_counter() - last > timeout:
+            print("超时: 已发送 %d, 已收到 %d" % (sent, recv + len(rx)))
+            return 1
+
+    dt = time.perf_counter() - t0
+    ser.close()
+    print("回环 %d 字节, 用时 %.3f 秒, 吞吐量 %.1f KB/s" % (total, dt, total / dt / 1024))
+    return 0
+
+
+def main():
+    ap = argparse.ArgumentParser(description="USB CDC loopback throughput benchmark")
+    ap.add_argument("port", help="虚拟串口名, 例如 COM5 或 /dev/ttyACM0")
+    ap.add_argument("--bytes", type=int, default=1000000, help="测试数据总量 (默认 1000000)")
+    ap.add_argument("--window", type=int, default=1024, help="最多在途字节数 (默认 1024)")
+    ap.add_argument("--chunk", type=int, default=512, help="每次写入的字节数 (默认 512)")
+    ap.add_argument("--timeout", type=float, default=2.0, help="无数据超时, 秒 (默认 2)")
+    args = ap.parse_args()
+    return run(args.port, args.bytes, args.window, args.chunk, args.timeout)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+通过 USB 虚拟串口升级程序 (仅 103ZE, 见 User/iap/iap.c)。
+
+协议:
+    PC  -> 设备  $IAP=<长度>,<CRC32十六进制>#
+    设备 -> PC   $IAP=OK#  (已擦除升级信息页和下载区的前几页, 可以发送数据)
+    PC  -> 设备  程序的二进制数据, 连续发送。设备写Flash时接收FIFO满, USB自动暂停, 不会丢数据
+    设备 -> PC   $IAP=OK# (CRC正确, 设备复位后由 Bootloader 安装) 或 $IAP=ERR=n#
+
+程序长度补齐为4的整数倍 (补0xFF)。CRC 和 STM32 硬件CRC单元相同: 多项式 0x04C11DB7,
+初值 0xFFFFFFFF, 每次输入一个小端32位字, 不反转, 结果不取反。
+
+程序必须按应用程序区地址 0x08002000 链接 (Keil 工程的 103ZE 目标)。支持 .bin 和 .hex 文件。
+
+也可以发送 iap_diff.py 生成的差分包 (文件以 "DPT1" 开头), 命令改为 $IAPD=<差分包长度>#,
+其余流程相同。
+
+用法:
+    python usb_iap.py COM5 ..\\Project\\103ZE\\output.hex
+    python usb_iap.py /dev/ttyACM0 output.bin
+    python usb_iap.py COM5 update.dpt
+
+依赖: pyserial (pip install pyserial)
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+APP_ADDR = 0x08002000
+SLOT_SIZE = 0x3E000
+
+
+def stm32_crc(data):
+    crc = 0xFFFFFFFF
+    for (word,) in struct.iter_unpack("<I", data):
+        crc ^= word
+        for _ in range(32):
+            if crc & 0x80000000:
+                crc = ((crc << 1) ^ 0x04C11DB7) & 0xFFFFFFFF
+            else:
+                crc = (crc << 1) & 0xFFFFFFFF
+    return crc
+
+
+def load_hex(path):
+    mem = {}
+    base = 0
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line.startswith(":"):
+                continue
+            rec = bytes.fromhex(line[1:])
+            n, addr, typ = rec[0], (rec[1] << 8) | rec[2], rec[3]
+            if typ == 0x00:
+                for i in range(n):
+                    mem[base + addr + i] = rec[4 + i]
+            elif typ == 0x04:
+                base = ((rec[4] << 8) | rec[5]) << 16
+            elif typ == 0x02:
+                base = ((rec[4] << 8) | rec[5]) << 4
+            elif typ == 0x01:
+                break
+    if not mem:
+        raise ValueError("hex 文件中没有数据")
+    lo, hi = min(mem), max(mem) + 1
+    if lo != APP_ADDR:
+        raise ValueError("程序起始地址 0x%08X, 应为 0x%08X" % (lo, APP_ADDR))
+    return bytes(mem.get(a, 0xFF) for a in range(lo, hi))
+
+
+def load_image(path):
+    if path.lower().endswith(".hex"):
+        data = load_hex(path)
+    else:
+        with open(path, "rb") as f:
+            data = f.read()
+    data += b"\xFF" * (-len(data) % 4)
+    if len(data) > SLOT_SIZE:
+        raise ValueError("程序 %d 字节, 超过应用程序区 %d 字节" % (len(data), SLOT_SIZE))
+    return data
+
+
+def wait_reply(ser, timeout):
+    """读到 $IAP=OK# 或 $IAP=ERR=n# 为止, 跳过回显的命令"""
+    buf = b""
+    t0 = time.perf_counter()
+    while time.perf_counter() - t0 < timeout:
+        buf += ser.read(ser.in_waiting or 1)
+        if b"$IAP=OK#" in buf:
+            return "OK"
+        i = buf.find(b"$IAP=ERR=")
+        if i >= 0 and buf.find(b"#", i) > 0:
+            return buf[i + 1:buf.find(b"#", i)].decode()
+    return "超时"
+
+
+def run(port, path, chunk):
+    import serial      # 只有发送时需要 pyserial, iap_diff.py 导入本文件时不需要
+
+    with open(path, "rb") as f:
+        is_patch = f.read(4) == b"DPT1"
+    if is_patch:
+        with open(path, "rb") as f:
+            data = f.read()
+        cmd = b"$IAPD=%d#" % len(data)
+        print("差分包 %d 字节" % len(data))
+    else:
+        data = load_image(path)
+        crc = stm32_crc(data)
+        cmd = b"$IAP=%d,%08X#" % (len(data), crc)
+        print("程序 %d 字节, CRC32 %08X" % (len(data), crc))
+
+    ser = serial.Serial(port, 115200, timeout=0.05)
+    ser.reset_input_buffer()
+
+    t0 = time.perf_counter()
+    ser.write(cmd)
+    r = wait_reply(ser, 2.0)
+    if r != "OK":
+        print("开始升级失败: %s" % r)
+        return 1
+
+    for i in range(0, len(data), chunk):
+        ser.write(data[i:i + chunk])
+    r = wait_reply(ser, 30.0)      # 差分包的长COPY和最后的CRC校验需要时间
+    dt = time.perf_counter() - t0
+    ser.close()
+    if r != "OK":
+        print("升级失败: %s" % r)
+        return 1
+    print("写入并校验完成, 用时 %.3f 秒 (%.1f KB/s), 设备复位后安装新程序" % (dt, len(data) / dt / 1024))
+    return 0
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Firmware update over the USB virtual COM port")
+    ap.add_argument("port", help="虚拟串口名, 例如 COM5 或 /dev/ttyACM0")
+    ap.add_argument("image", help="程序文件 (.bin 或 .hex) 或差分包")
+    ap.add_argument("--chunk", type=int, default=4096, help="每次写入的字节数 (默认 4096)")
+    args = ap.parse_args()
+    return run(args.port, args.image, args.chunk)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
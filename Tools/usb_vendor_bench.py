@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+USB 厂商自定义批量接口回环吞吐量测试。
+
+复合设备 (usb_conf.h 中 USB_COMPOSITE_EN = 1) 的接口4是厂商自定义批量接口 (EP6 OUT, EP5 IN),
+固件的 UsbVendorPro() 把收到的数据原样发回。本脚本持续发送随机数据并读回，校验内容并统计吞吐量
+(单向字节数 / 秒)。在途数据量不超过 --window，设备接收FIFO满时OUT端点回应NAK, 不会丢数据。
+
+Windows 需要先用 Zadig 等工具为接口4安装 WinUSB 驱动; Linux 需要有访问该USB设备的权限。
+
+用法:
+    python usb_vendor_bench.py
+    python usb_vendor_bench.py --bytes 4000000 --window 2048
+
+依赖: pyusb (pip install pyusb) 和 libusb
+"""
+
+import argparse
+import os
+import sys
+import time
+
+import usb.core
+import usb.util
+
+VID = 0x0483
+PID = 0x5741        # 复合设备的PID (usb_conf.h 中 USB_PID_COMPOSITE); 固件需要 USB_COMPOSITE_EN = 1
+INTERFACE = 4
+EP_OUT = 0x06
+EP_IN = 0x85
+
+
+def run(total, window, chunk, timeout):
+    dev = usb.core.find(idVendor=VID, idProduct=PID)
+    if dev is None:
+        print("找不到设备 %04X:%04X" % (VID, PID))
+        return 1
+    usb.util.claim_interface(dev, INTERFACE)
+
+    data = os.urandom(total)
+    sent = 0
+    recv = 0
+    t0 = time.perf_counter()
+    last = t0
+
+    while recv < total:
+        if sent < total and sent - recv < window:
+            n = min(chunk, total - sent, window - (sent - recv))
+            sent += dev.write(EP_OUT, data[sent:sent + n], int(timeout * 1000))
+
+        try:
+            got = bytes(dev.read(EP_IN, 4096, 10))
+        except usb.core.USBTimeoutError:
+            got = b""
+        if got:
+            if got != data[recv:recv + len(got)]:
+                for i, b in enumerate(got):
+                    if b != data[recv + i]:
+                        print("数据错误: 偏移 %d, 期望 0x%02X, 收到 0x%02X" % (recv + i, data[recv + i], b))
+                        return 1
+            recv += len(got)
+            last = time.perf_counter()
+        elif time.perf_counter() - last > timeout:
+            print("超时: 已发送 %d, 已收到 %d" % (sent, recv))
+            return 1
+
+    dt = time.perf_counter() - t0
+    usb.util.release_interface(dev, INTERFACE)
+    print("回环 %d 字节, 用时 %.3f 秒, 吞吐量 %.1f KB/s" % (total, dt, total / dt / 1024))
+    return 0
+
+
+def main():
+    ap = argparse.ArgumentParser(description="USB vendor bulk loopback throughput benchmark")
+    ap.add_argument("--bytes", type=int, default=1000000, help="测试数据总量 (默认 1000000)")
+    ap.add_argument("--window", type=int, default=2048, help="最多在途字节数 (默认 2048)")
+    ap.add_argument("--chunk", type=int, default=512, help="每次写入的字节数 (默认 512)")
+    ap.add_argument("--timeout", type=float, default=2.0, help="无数据超时, 秒 (默认 2)")
+    args = ap.parse_args()
+    return run(args.bytes, args.window, args.chunk, args.timeout)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -1,83 +1,152 @@
-#include "bsp.h"
-
-/*
-*********************************************************************************************************
-*	函 数 名: bsp_Init
-*	功能说明: 初始化硬件设备。只需要调用一次。该函数配置CPU寄存器和外设的寄存器并初始化一些全局变量。
-*			 全局变量。
-*	形    参：无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void bsp_Init(void)
-{
-	/*
-		由于ST固件库的启动文件已经执行了CPU系统时钟的初始化，所以不必再次重复配置系统时钟。
-		启动文件配置了CPU主时钟频率、内部Flash访问速度和可选的外部SRAM FSMC初始化。
-
-		系统时钟缺省配置为72MHz，如果需要更改，可以修改 system_stm32f103.c 文件
-	*/
-
-	/* 优先级分组设置为4 */
-	NVIC_PriorityGroupConfig(NVIC_PriorityGroup_4);
-	
-	bsp_InitLed();		/* 配置LED的GPIO端口 */
-	bsp_InitKey();		/* 初始化按键 */
-	
-	bsp_InitTimer();	/* 初始化系统滴答定时器 (此函数会开中断) */
-	
-	bsp_InitUart();		/* 初始化串口驱动 */
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: bsp_RunPer10ms
-*	功能说明: 该函数每隔10ms被Systick中断调用1次。详见 bsp_timer.c的定时中断服务程序。一些处理时间要求不严格的
-*			任务可以放在此函数。比如：按键扫描、蜂鸣器鸣叫控制等。
-*	形    参：无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void bsp_RunPer10ms(void)
-{
-	bsp_KeyScan10ms();		/* 每10ms扫描按键一次 */
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: bsp_RunPer1ms
-*	功能说明: 该函数每隔1ms被Systick中断调用1次。详见 bsp_timer.c的定时中断服务程序。一些需要周期性处理的事务
-*			 可以放在此函数。比如：触摸坐标扫描。
-*	形    参: 无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-extern void GT811_Timer1ms(void);
-void bsp_RunPer1ms(void)
-{
-	;
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: bsp_Idle
-*	功能说明: 空闲时执行的函数。一般主程序在for和while循环程序体中需要插入 CPU_IDLE() 宏来调用本函数。
-*			 本函数缺省为空操作。用户可以添加喂狗、设置CPU进入休眠模式的功能。
-*	形    参：无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-extern void SaveScreenToBmp(uint16_t _index);
-void bsp_Idle(void)
-{
-	/* --- 喂狗 */
-
-	/* --- 让CPU进入休眠，由Systick定时中断唤醒或者其他中断唤醒 */
-
-	/* 例如 emWin 图形库，可以插入图形库需要的轮询函数 */
-	//GUI_Exec();
-
-	/* 例如 uIP 协议，可以插入uip轮询函数 */
-
-
-}
+#include "bsp.h"
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_Init
+*	功能说明: 初始化硬件设备。只需要调用一次。该函数配置CPU寄存器和外设的寄存器并初始化一些全局变量。
+*			 全局变量。
+*	形    参：无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_Init(void)
+{
+	/*
+		由于ST固件库的启动文件已经执行了CPU系统时钟的初始化，所以不必再次重复配置系统时钟。
+		启动文件配置了CPU主时钟频率、内部Flash访问速度和可选的外部SRAM FSMC初始化。
+
+		系统时钟缺省配置为72MHz，如果需要更改，可以修改 system_stm32f103.c 文件
+	*/
+
+	/* 优先级分组设置为4 */
+	NVIC_PriorityGroupConfig(NVIC_PriorityGroup_4);
+	
+	bsp_InitLed();		/* 配置LED的GPIO端口 */
+	bsp_InitKey();		/* 初始化按键 */
+	
+	bsp_InitTimer();	/* 初始化系统滴答定时器 (此函数会开中断) */
+	
+	bsp_InitUart();		/* 初始化串口驱动 */
+	bsp_InitLog();		/* 初始化日志缓冲区 */
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_RunPer10ms
+*	功能说明: 该函数每隔10ms被Systick中断调用1次。详见 bsp_timer.c的定时中断服务程序。一些处理时间要求不严格的
+*			任务可以放在此函数。比如：按键扫描、蜂鸣器鸣叫控制等。
+*			低功耗模式(TMR_TICKLESS_EN)下，bsp_Per10msIsIdle() 返回1时调用周期会延长。
+*	形    参：无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_RunPer10ms(void)
+{
+	bsp_KeyScan10ms();		/* 每10ms扫描按键一次 */
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_Per10msIsIdle
+*	功能说明: 判断 bsp_RunPer10ms() 中的任务是否空闲。空闲时低功耗模式可以降低调用频率。
+*			 在 bsp_RunPer10ms() 中增加任务时，需要在这里增加对应的判断。
+*	形    参：无
+*	返 回 值: 1 表示空闲，0 表示需要每10ms调用
+*********************************************************************************************************
+*/
+uint8_t bsp_Per10msIsIdle(void)
+{
+	if (bsp_KeyIsIdle() == 0)
+	{
+		return 0;
+	}
+
+	/* 例如蜂鸣器，在 bsp_RunPer10ms() 中调用了 BEEP_Pro() 时需要判断 */
+	//if (BEEP_IsIdle() == 0) return 0;
+
+	return 1;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_IdleCanSleep
+*	功能说明: 判断主程序是否还有待处理的数据。低功耗模式(TMR_TICKLESS_EN)下由 bsp_TicklessIdle() 在关中断
+*			 状态下调用，返回0时不休眠。主程序每次只读取接收FIFO中的一部分 (UsbCmdPro 64字节,
+*			 UsbVendorPro 128字节, UsbIapPro 256字节, USB桥每次一段连续数据)，剩余数据不会再产生中断唤醒CPU，
+*			 读空之前不能休眠。中断中置位的标志 (MODBUS 帧接收完毕) 可能在主程序检查之后才置位, 也在这里判断。
+*			 增加其他分批读取的FIFO时，需要在这里增加对应的判断。
+*	形    参：无
+*	返 回 值: 1 表示可以休眠，0 表示不能休眠
+*********************************************************************************************************
+*/
+extern uint8_t usb_RxIsEmpty(void);
+extern uint8_t MODS_RxIsEmpty(void);
+uint8_t bsp_IdleCanSleep(void)
+{
+	if (usb_RxIsEmpty() == 0)
+	{
+		return 0;
+	}
+
+	/* 串口接收FIFO。COM3 由 MODS_Poll() 清空, 见下面的 MODBUS 判断 */
+	if (comRxIsEmpty(COM1) == 0 || comRxIsEmpty(COM2) == 0)
+	{
+		return 0;
+	}
+
+	/* MODBUS 收到完整的一帧, 等待 MODS_Poll() 处理 */
+	if (MODS_RxIsEmpty() == 0)
+	{
+		return 0;
+	}
+
+	return 1;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_RunPer1ms
+*	功能说明: 该函数每隔1ms被Systick中断调用1次。详见 bsp_timer.c的定时中断服务程序。一些需要周期性处理的事务
+*			 可以放在此函数。比如：触摸坐标扫描。
+*			 低功耗模式(TMR_TICKLESS_EN)下，休眠期间跳过的节拍不调用本函数。
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+extern void GT811_Timer1ms(void);
+void bsp_RunPer1ms(void)
+{
+	;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_Idle
+*	功能说明: 空闲时执行的函数。一般主程序在for和while循环程序体中需要插入 CPU_IDLE() 宏来调用本函数。
+*			 本函数缺省为空操作。用户可以添加喂狗、设置CPU进入休眠模式的功能。
+*	形    参：无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+extern void SaveScreenToBmp(uint16_t _index);
+void bsp_Idle(void)
+{
+	/* --- 喂狗 */
+
+	/* --- 发送日志 */
+#if LOG_EN == 1
+	bsp_LogPoll();
+#endif
+
+	/* --- 让CPU进入休眠，由Systick定时中断唤醒或者其他中断唤醒 */
+#if TMR_TICKLESS_EN == 1
+	bsp_TicklessIdle();
+#endif
+
+	/* 例如 emWin 图形库，可以插入图形库需要的轮询函数 */
+	//GUI_Exec();
+
+	/* 例如 uIP 协议，可以插入uip轮询函数 */
+
+
+}
@@ -1,121 +1,153 @@
-/*
-*********************************************************************************************************
-*
-*    模块名称 : 按键驱动模块
-*    文件名称 : bsp_key.h
-*    版    本 : V1.0
-*    说    明 : 头文件
-*
-*    Copyright (C), 2013-2014, 安富莱电子 www.armfly.com
-*
-*********************************************************************************************************
-*/
-
-#ifndef __BSP_KEY_H
-#define __BSP_KEY_H
-
-#include "bsp.h"
-
-/* 根据应用程序的功能重命名按键宏 */
-#define KEY_DOWN_S          KEY_1_DOWN
-#define KEY_UP_S            KEY_1_UP
-#define KEY_LONG_DOWN_S     KEY_1_LONG_DOWN
-#define KEY_LONG_UP_S       KEY_1_LONG_UP
-#define KEY_AUTO_S          KEY_1_AUTO_UP
-#define KEY_DB_S            KEY_1_DB_UP
-
-#define KEY_DOWN_C 		    KEY_2_DOWN
-#define KEY_UP_C 		    KEY_2_UP
-#define KEY_LONG_DOWN_C     KEY_2_LONG_DOWN
-#define KEY_LONG_UP_C 	    KEY_2_LONG_UP
-#define KEY_AUTO_C          KEY_2_AUTO_UP
-#define KEY_DB_C            KEY_2_DB_UP
-
-/* 按键ID, 主要用于bsp_KeyState()函数的入口参数 */
-typedef enum
-{
-	KID_K1 = 0,
-	KID_K2,
-	KID_K3,
-} KEY_ID_E;
-
-/*
-    按键滤波时间50ms, 单位10ms。
-    只有连续检测到50ms状态不变才认为有效，包括弹起和按下两种事件
-    即使按键电路不做硬件滤波，该滤波机制也可以保证可靠地检测到按键事件
-*/
-#define KEY_FILTER_TIME         3
-#define KEY_LONG_TIME           60  /* 单位10ms， 持续1秒，认为长按事件 */
-
-#define KEY_DB_CLICK_TIME       25  /* 双击检测时长，单位ms */
-
-/*
-    每个按键对应1个全局的结构体变量。
-*/
-typedef struct
-{
-    /* 下面是一个函数指针，指向判断按键手否按下的函数 */
-    uint8_t (*IsKeyDownFunc)(void);     /* 按键按下的判断函数,1表示按下 */
-
-    uint8_t Count;          /* 滤波器计数器 */
-    uint16_t LongCount;     /* 长按计数器 */
-    uint16_t LongTime;      /* 按键按下持续时间, 0表示不检测长按 */
-    uint8_t State;          /* 按键当前状态（按下还是弹起） */
-    uint8_t RepeatSpeed;    /* 连续按键周期 */
-    uint8_t RepeatCount;    /* 连续按键计数器 */
-
-    uint16_t DelayCount;    /* 延迟计数器，用于双击检测 */
-    uint8_t ClickCount;     /* 单击次数 */
-    int32_t LastTime;       /* 上次按键时刻 */
-} KEY_T;
-
-/*
-    定义键值代码, 必须按如下次序定时每个键的按下、弹起和长按事件
-
-    推荐使用enum, 不用#define，原因：
-    (1) 便于新增键值,方便调整顺序，使代码看起来舒服点
-    (2) 编译器可帮我们避免键值重复。
-*/
-#define KEY_MSG_STEP    6   /* 按键消息代码步长(每个键有几个事件代码，顺序排列） */
-typedef enum
-{
-    KEY_NONE = 0,       /* 0 表示按键事件 */
-
-    KEY_1_DOWN,         /* 1键按下 */
-    KEY_1_UP,           /* 1键弹起单击 */
-    KEY_1_LONG_DOWN,    /* 1键长按 */
-    KEY_1_LONG_UP,      /* 1键长按后的弹起 */
-    KEY_1_AUTO_UP,      /* 1键长按后自动发码 */
-    KEY_1_DB_UP,        /* 1键双击 */
-
-    KEY_2_DOWN,         /* 2键按下 */
-    KEY_2_UP,           /* 2键弹起 */
-    KEY_2_LONG_DOWN,    /* 2键长按 */
-    KEY_2_LONG_UP,      /* 2键长按后的弹起 */
-    KEY_2_AUTO_UP,      /* 2键长按后自动发码 */
-    KEY_2_DB_UP,        /* 2键双击 */
-} KEY_ENUM;
-
-/* 按键FIFO用到变量 */
-#define KEY_FIFO_SIZE 10
-typedef struct
-{
-    uint8_t Buf[KEY_FIFO_SIZE]; /* 键值缓冲区 */
-    uint8_t Read;               /* 缓冲区读指针1 */
-    uint8_t Write;              /* 缓冲区写指针 */
-    uint8_t Read2;              /* 缓冲区读指针2 */
-} KEY_FIFO_T;
-
-/* 供外部调用的函数声明 */
-void bsp_InitKey(void);
-void bsp_KeyScan10ms(void);
-void bsp_PutKey(uint8_t _KeyCode);
-uint8_t bsp_GetKey(void);
-uint8_t bsp_GetKey2(void);
-uint8_t bsp_GetKeyState(KEY_ID_E _ucKeyID);
-void bsp_SetKeyParam(uint8_t _ucKeyID, uint16_t _LongTime, uint8_t _RepeatSpeed);
-void bsp_ClearKey(void);
-
-#endif
-
-/***************************** 安富莱电子 www.armfly.com (END OF FILE) *********************************/
+/*
+*********************************************************************************************************
+*
+*    模块名称 : 按键驱动模块
+*    文件名称 : bsp_key.h
+*    版    本 : V1.0
+*    说    明 : 头文件
+*
+*    Copyright (C), 2013-2014, 安富莱电子 www.armfly.com
+*
+*********************************************************************************************************
+*/
+
+#ifndef __BSP_KEY_H
+#define __BSP_KEY_H
+
+#include "bsp.h"
+
+/* 根据应用程序的功能重命名按键宏 */
+#define KEY_DOWN_S          KEY_1_DOWN
+#define KEY_UP_S            KEY_1_UP
+#define KEY_LONG_DOWN_S     KEY_1_LONG_DOWN
+#define KEY_LONG_UP_S       KEY_1_LONG_UP
+#define KEY_AUTO_S          KEY_1_AUTO_UP
+#define KEY_DB_S            KEY_1_DB_UP
+
+#define KEY_DOWN_C 		    KEY_2_DOWN
+#define KEY_UP_C 		    KEY_2_UP
+#define KEY_LONG_DOWN_C     KEY_2_LONG_DOWN
+#define KEY_LONG_UP_C 	    KEY_2_LONG_UP
+#define KEY_AUTO_C          KEY_2_AUTO_UP
+#define KEY_DB_C            KEY_2_DB_UP
+
+/* 按键ID, 主要用于bsp_KeyState()函数的入口参数 */
+typedef enum
+{
+	KID_K1 = 0,
+	KID_K2,
+	KID_K3,
+} KEY_ID_E;
+
+/*
+    按键滤波时间40ms。所有按键用2位垂直计数器同时滤波(见 bsp_key.c)，连续4次扫描(40ms)
+    状态都和原来不同才认为有效，包括弹起和按下两种事件。滤波次数由计数器位数决定，不能配置。
+    即使按键电路不做硬件滤波，该滤波机制也可以保证可靠地检测到按键事件
+*/
+/*
+    1 表示按键空闲时停止扫描，由按键引脚的外部中断(EXTI, 上升沿和下降沿)唤醒。唤醒后每10ms扫描，
+    所有按键弹起且长按、双击计时结束后再次停止。按键不动作时不占用CPU，低功耗模式下可以长时间休眠
+    (见 bsp_timer.h 中的 TMR_IDLE_PER10MS_TIME)。
+    同一引脚号只能有一个端口连接EXTI线，s_gpio_list 中引脚号重复时自动退回每10ms轮询。
+*/
+#define KEY_EXTI_EN             1
+
+#define KEY_LONG_TIME           60  /* 单位10ms， 持续1秒，认为长按事件 */
+
+#define KEY_DB_CLICK_TIME       25  /* 双击检测时长，单位ms */
+
+/*
+    每个按键对应1个全局的结构体变量。滤波状态按位存放在 bsp_key.c 中，这里只有长按、连发和双击的计时。
+*/
+typedef struct
+{
+    uint16_t LongTime;      /* 按键按下持续时间, 0表示不检测长按 */
+    uint16_t Timer;         /* 长按或连发倒计时, 单位10ms, 0表示不在计时 */
+    uint8_t State;          /* 按键当前状态: 0 弹起, 1 按下, 2 长按 */
+    uint8_t RepeatSpeed;    /* 连续按键周期 */
+    uint8_t DelayCount;     /* 延迟计数器，用于双击检测 */
+    uint8_t ClickCount;     /* 单击次数 */
+} KEY_T;
+
+/*
+    定义键值代码, 必须按如下次序定时每个键的按下、弹起和长按事件
+
+    推荐使用enum, 不用#define，原因：
+    (1) 便于新增键值,方便调整顺序，使代码看起来舒服点
+    (2) 编译器可帮我们避免键值重复。
+*/
+#define KEY_MSG_STEP    6   /* 按键消息代码步长(每个键有几个事件代码，顺序排列） */
+typedef enum
+{
+    KEY_NONE = 0,       /* 0 表示按键事件 */
+
+    KEY_1_DOWN,         /* 1键按下 */
+    KEY_1_UP,           /* 1键弹起单击 */
+    KEY_1_LONG_DOWN,    /* 1键长按 */
+    KEY_1_LONG_UP,      /* 1键长按后的弹起 */
+    KEY_1_AUTO_UP,      /* 1键长按后自动发码 */
+    KEY_1_DB_UP,        /* 1键双击 */
+
+    KEY_2_DOWN,         /* 2键按下 */
+    KEY_2_UP,           /* 2键弹起 */
+    KEY_2_LONG_DOWN,    /* 2键长按 */
+    KEY_2_LONG_UP,      /* 2键长按后的弹起 */
+    KEY_2_AUTO_UP,      /* 2键长按后自动发码 */
+    KEY_2_DB_UP,        /* 2键双击 */
+} KEY_ENUM;
+
+/* 事件类型, 键值 = KEY_MSG_STEP * 按键ID + 事件类型 */
+typedef enum
+{
+    KEY_EVT_NONE = 0,
+    KEY_EVT_DOWN,       /* 按下 */
+    KEY_EVT_UP,         /* 弹起单击 */
+    KEY_EVT_LONG_DOWN,  /* 长按 */
+    KEY_EVT_LONG_UP,    /* 长按后的弹起 */
+    KEY_EVT_AUTO_UP,    /* 长按后自动发码 */
+    KEY_EVT_DB_UP,      /* 双击 */
+} KEY_EVT_E;
+
+/* 按键事件 */
+typedef struct
+{
+    uint32_t TimeUs;            /* 检测到事件的时刻, bsp_GetTimeUs64() 的低32位, 约71分钟回零 */
+    uint8_t Code;               /* 键值 KEY_1_DOWN 等 */
+    uint8_t KeyId;              /* 按键ID */
+    uint8_t Type;               /* 事件类型 KEY_EVT_E */
+} KEY_EVENT_T;
+
+/*
+    按键事件队列。一个写入者(bsp_KeyScan10ms() 所在的上下文), 任意个读者, 每个读者有自己的读索引。
+    写入者不等待读者, 队列满时覆盖最旧的事件; 落后的读者读取时跳过被覆盖的事件并计数。
+    读写都不需要关中断。
+*/
+#define KEY_EVT_SIZE    16      /* 必须是2的整数次幂, 每个读者最多缓存 KEY_EVT_SIZE - 1 个事件 */
+typedef struct
+{
+    KEY_EVENT_T Buf[KEY_EVT_SIZE];
+    __IO uint32_t Head;         /* 写索引, 自由增长, 只由写入者修改 */
+} KEY_QUEUE_T;
+
+typedef struct
+{
+    uint32_t Tail;              /* 读索引, 自由增长 */
+    uint32_t Dropped;           /* 读取前被覆盖而丢失的事件个数, 可由读者清零 */
+} KEY_READER_T;
+
+/* 供外部调用的函数声明 */
+void bsp_InitKey(void);
+void bsp_KeyScan10ms(void);
+void bsp_PutKey(uint8_t _KeyCode);
+uint8_t bsp_GetKey(void);
+uint8_t bsp_GetKey2(void);
+uint8_t bsp_GetKeyState(KEY_ID_E _ucKeyID);
+void bsp_SetKeyParam(uint8_t _ucKeyID, uint16_t _LongTime, uint8_t _RepeatSpeed);
+void bsp_ClearKey(void);
+void bsp_KeyInitReader(KEY_READER_T *_pReader);
+uint8_t bsp_KeyReadEvent(KEY_READER_T *_pReader, KEY_EVENT_T *_pEvent);
+uint8_t bsp_KeyIsIdle(void);
+
+#endif
+
+/***************************** 安富莱电子 www.armfly.com (END OF FILE) *********************************/
@@ -0,0 +1,80 @@
+/*
+*********************************************************************************************************
+*
+*	模块名称 : 二进制日志模块
+*	文件名称 : bsp_log.h
+*	版    本 : V1.0
+*	说    明 : 头文件
+*
+*	Copyright (C), 2013-2014, 安富莱电子 www.armfly.com
+*
+*********************************************************************************************************
+*/
+
+#ifndef __BSP_LOG_H
+#define __BSP_LOG_H
+
+#include "stm32f10x.h"
+#include "usb_conf.h"
+
+/*
+	延迟格式化的二进制日志。bsp_Log() 只记录格式字符串的地址(在Flash中)、时间戳和参数的原始值,
+	不做格式化; 主程序空闲时由 bsp_LogPoll() 通过串口发出, PC端用 Tools/log_decode.py 和
+	编译生成的 .axf 文件还原成文字, 格式化规则和 nanoprintf 相同。
+	串口上的 printf 文字和日志帧可以混合, 解码程序原样显示帧以外的字节。
+
+	限制:
+	(1) 格式字符串必须是常量字符串 (在Flash中), 最多 LOG_MAX_ARGS 个参数。
+	(2) 参数都按32位记录: 整数(%d %u %x %c 等, 不支持 %ll)、指针(%p)。不支持 %f, 请换算成整数。
+	(3) %s 只能用常量字符串 (例如 __FILE__、__FUNCTION__), 由PC端从 .axf 文件中读取。
+*/
+#define LOG_EN			1
+
+#define LOG_COM			COM1	/* 日志输出的串口 */
+
+/*
+	USB复合设备 (usb_conf.h 中 USB_COMPOSITE_EN = 1) 时, 日志从CDC虚拟串口2 (USB_COM2, 调试打印通道) 发出,
+	不再占用串口 LOG_COM; 串口桥接 (USB_BRIDGE_EN = 1) 占用 USB_COM2 时仍从 LOG_COM 发出。
+	bsp_LogFlush() 不依赖中断, 总是以查询方式从 LOG_COM 发出。printf 的文字 (fputc) 总是从串口1发出。
+*/
+#if USB_COMPOSITE_EN == 1 && USB_BRIDGE_EN == 0
+	#define LOG_USB_EN	1
+#else
+	#define LOG_USB_EN	0
+#endif
+#define LOG_BUF_SIZE	1024	/* 日志缓冲区字节数, 必须是2的整数次幂 */
+#define LOG_MAX_ARGS	6		/* 每条日志最多的参数个数 */
+
+/*
+	日志帧, 多字节数据都是小端:
+	同步字节 0xA5, 参数个数 n, 格式字符串地址(4), 时刻us(4), 参数(4 * n), 校验和(1)
+	校验和 = 从参数个数到最后一个参数所有字节之和取反。
+	格式字符串地址为 0 的帧表示缓冲区满丢弃的日志条数 (1个参数)。
+*/
+#define LOG_SYNC		0xA5
+#define LOG_HEAD_SIZE	10
+#define LOG_FRAME_SIZE(n)	(LOG_HEAD_SIZE + 4 * (n) + 1)
+
+#if LOG_EN == 1
+	/* 参数个数由宏计算, bsp_Log("x=%d y=%d\r\n", x, y) */
+	#define bsp_Log(...)		bsp_LogWrite(LOG_NARGS(__VA_ARGS__), __VA_ARGS__)
+	#define LOG_NARGS(...)		LOG_NARGS_(__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0, 0)
+	#define LOG_NARGS_(_fmt, _1, _2, _3, _4, _5, _6, _n, ...)	_n
+#else
+	#define bsp_Log(...)
+#endif
+
+/* 提供给其他C文件调用的函数 */
+void bsp_InitLog(void);
+void bsp_LogWrite(uint8_t _ucArgs, const char *_pFmt, ...);
+void bsp_LogPoll(void);
+#if LOG_EN == 1
+	void bsp_LogFlush(void);
+#else
+	#define bsp_LogFlush()	comFlushTxPoll(LOG_COM)		/* 没有日志, 只发完串口中已有的 printf 文字 */
+#endif
+uint32_t bsp_LogGetDropped(void);
+
+#endif
+
+/***************************** 安富莱电子 www.armfly.com (END OF FILE) *********************************/
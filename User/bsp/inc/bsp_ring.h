@@ -0,0 +1,54 @@
+/*
+*********************************************************************************************************
+*
+*	模块名称 : 环形缓冲区模块
+*	文件名称 : bsp_ring.h
+*	版    本 : V1.0
+*	说    明 : 头文件
+*
+*	Copyright (C), 2013-2014, 安富莱电子 www.armfly.com
+*
+*********************************************************************************************************
+*/
+
+#ifndef __BSP_RING_H
+#define __BSP_RING_H
+
+#include "stm32f10x.h"
+
+/*
+	单生产者/单消费者(SPSC)无锁环形缓冲区。
+	usHead 只由生产者修改, usTail 只由消费者修改, 两个索引都是自由增长的16位计数, 用时再和 usMask 相与。
+	因此一端在中断中、另一端在主程序中访问时不需要关中断。
+	缓冲区大小必须是2的整数次幂, 且不能超过 32768。
+*/
+typedef struct
+{
+	uint8_t *pBuf;				/* 缓冲区 */
+	uint16_t usSize;			/* 缓冲区大小, 2的整数次幂 */
+	uint16_t usMask;			/* usSize - 1 */
+	__IO uint16_t usHead;		/* 写索引, 只由生产者修改 */
+	__IO uint16_t usTail;		/* 读索引, 只由消费者修改 */
+}RING_T;
+
+/* 提供给其他C文件调用的函数 */
+void bsp_RingInit(RING_T *_pRing, uint8_t *_pBuf, uint16_t _usSize);
+uint16_t bsp_RingCount(RING_T *_pRing);
+uint16_t bsp_RingFree(RING_T *_pRing);
+
+/* 生产者调用的函数 */
+uint16_t bsp_RingPut(RING_T *_pRing, const uint8_t *_pData, uint16_t _usLen);
+uint8_t bsp_RingPutByte(RING_T *_pRing, uint8_t _ucByte);
+uint16_t bsp_RingReserveSpan(RING_T *_pRing, uint8_t **_ppData);
+void bsp_RingCommit(RING_T *_pRing, uint16_t _usLen);
+
+/* 消费者调用的函数 */
+uint16_t bsp_RingGet(RING_T *_pRing, uint8_t *_pData, uint16_t _usLen);
+uint8_t bsp_RingGetByte(RING_T *_pRing, uint8_t *_pByte);
+uint16_t bsp_RingPeekSpan(RING_T *_pRing, uint8_t **_ppData);
+void bsp_RingConsume(RING_T *_pRing, uint16_t _usLen);
+void bsp_RingClear(RING_T *_pRing);
+
+#endif
+
+/***************************** 安富莱电子 www.armfly.com (END OF FILE) *********************************/
@@ -1,56 +1,142 @@
-/*
-*********************************************************************************************************
-*
-*	模块名称 : 定时器模块
-*	文件名称 : bsp_timer.h
-*	版    本 : V1.3
-*	说    明 : 头文件
-*
-*	Copyright (C), 2015-2016, 安富莱电子 www.armfly.com
-*
-*********************************************************************************************************
-*/
-
-#ifndef __BSP_TIMER_H
-#define __BSP_TIMER_H
-
-#include "bsp.h"
-/*
-	在此定义若干个软件定时器全局变量
-	注意，必须增加__IO 即 volatile，因为这个变量在中断和主程序中同时被访问，有可能造成编译器错误优化。
-*/
-#define TMR_COUNT	4		/* 软件定时器的个数 （定时器ID范围 0 - 3) */
-
-/* 定时器结构体，成员变量必须是 volatile, 否则C编译器优化时可能有问题 */
-typedef enum
-{
-	TMR_ONCE_MODE = 0,		/* 一次工作模式 */
-	TMR_AUTO_MODE = 1		/* 自动定时工作模式 */
-}TMR_MODE_E;
-
-/* 定时器结构体，成员变量必须是 volatile, 否则C编译器优化时可能有问题 */
-typedef struct
-{
-	volatile uint8_t Mode;		/* 计数器模式，1次性 */
-	volatile uint8_t Flag;		/* 定时到达标志  */
-	volatile uint32_t Count;	        /* 计数器 */
-	volatile uint32_t PreLoad;	    /* 计数器预装值 */
-}SOFT_TMR;
-
-/* 提供给其他C文件调用的函数 */
-void bsp_InitTimer(void);
-void bsp_DelayMS(uint32_t n);
-void bsp_DelayUS(uint32_t n);
-void bsp_StartTimer(uint8_t _id, uint32_t _period);
-void bsp_StartAutoTimer(uint8_t _id, uint32_t _period);
-void bsp_StopTimer(uint8_t _id);
-uint8_t bsp_CheckTimer(uint8_t _id);
-int32_t bsp_GetRunTime(void);
-int32_t bsp_CheckRunTime(int32_t _LastTime);
-
-void bsp_InitHardTimer(void);
-void bsp_StartHardTimer(uint8_t _CC, uint32_t _uiTimeOut, void * _pCallBack);
-
-#endif
-
-/***************************** 安富莱电子 www.armfly.com (END OF FILE) *********************************/
+/*
+*********************************************************************************************************
+*
+*	模块名称 : 定时器模块
+*	文件名称 : bsp_timer.h
+*	版    本 : V1.6
+*	说    明 : 头文件
+*
+*	Copyright (C), 2015-2016, 安富莱电子 www.armfly.com
+*
+*********************************************************************************************************
+*/
+
+#ifndef __BSP_TIMER_H
+#define __BSP_TIMER_H
+
+#include "bsp.h"
+/*
+	在此定义若干个软件定时器全局变量
+	注意，必须增加__IO 即 volatile，因为这个变量在中断和主程序中同时被访问，有可能造成编译器错误优化。
+*/
+#define TMR_COUNT	4		/* 兼容接口(按ID访问)的软件定时器个数 （定时器ID范围 0 - 3) */
+#define TMR_POOL_SIZE	32	/* 可动态分配的软件定时器个数 (bsp_CreateTimer) */
+
+/*
+	软件定时器由分层时间轮管理，每1ms的处理时间与定时器个数无关。
+	时间轮共 TMR_WHEEL_LEVELS 层，每层 2^TMR_WHEEL_BITS 个槽:
+		第0层每槽1ms, 第1层每槽64ms, 第2层每槽4.096秒, 第3层每槽262秒, 可直接表示约4.6小时。
+	更长的定时先放在最高层, 到时再重新计算。
+*/
+#define TMR_WHEEL_BITS		6
+#define TMR_WHEEL_SIZE		(1 << TMR_WHEEL_BITS)
+#define TMR_WHEEL_MASK		(TMR_WHEEL_SIZE - 1)
+#define TMR_WHEEL_LEVELS	4
+
+/*
+	低功耗(tickless)模式。1 表示 bsp_Idle() 中根据最近的定时器到期时刻重新设置 SysTick，
+	CPU 执行 WFI 休眠，唤醒后补偿运行时间和软件定时器。
+	SysTick 是24位计数器，72MHz 时一次最多休眠约 233ms。
+	主程序每次循环只从接收FIFO读取一部分数据时，剩余的数据不会再产生中断唤醒CPU，
+	要等到下一个定时器到期才能处理。增加这样的FIFO时需要同时修改 bsp.c 中的 bsp_IdleCanSleep()。
+*/
+#define TMR_TICKLESS_EN		1
+/*
+	bsp_Per10msIsIdle() 返回1时, bsp_RunPer10ms() 的最长调用周期，单位ms。
+	0 表示空闲时不再定时调用，休眠时间只受软件定时器限制。bsp_RunPer10ms() 中的任务必须能被中断唤醒，
+	例如按键使用外部中断(bsp_key.h 中的 KEY_EXTI_EN = 1)。按键使用轮询时可以设为 100。
+*/
+#define TMR_IDLE_PER10MS_TIME	0
+
+/* 低功耗休眠统计 */
+typedef struct
+{
+	uint32_t Wakeups;			/* 累计唤醒次数 (每次从 WFI 退出计1次) */
+	uint32_t SleepMs;			/* 累计休眠时间，单位ms */
+	uint16_t WakeupsPerSec;		/* 最近1秒的唤醒次数 */
+	uint16_t SleepPermille;		/* 最近1秒在 WFI 中的时间比例，单位 0.1%。可作为待机电流的估算依据 */
+}IDLE_STAT_T;
+
+/* 定时器结构体，成员变量必须是 volatile, 否则C编译器优化时可能有问题 */
+typedef enum
+{
+	TMR_ONCE_MODE = 0,		/* 一次工作模式 */
+	TMR_AUTO_MODE = 1		/* 自动定时工作模式 */
+}TMR_MODE_E;
+
+/* 定时器结构体，成员变量必须是 volatile, 否则C编译器优化时可能有问题 */
+typedef struct _SOFT_TMR
+{
+	struct _SOFT_TMR *pNext;		/* 同一个时间轮槽中的下一个定时器 */
+	struct _SOFT_TMR **ppPrev;		/* 指向前一个定时器的 pNext (或槽头), 用于O(1)删除; 0 表示未运行 */
+	uint32_t Expire;				/* 到期时刻, 单位1ms */
+	uint32_t PreLoad;				/* 定时周期，自动模式重装用 */
+	void (*CallBack)(void *_pArg);	/* 定时到后的回调函数, 在SysTick中断中执行; 0 表示只设置 Flag */
+	void *pArg;						/* 回调函数的参数 */
+	volatile uint8_t Mode;			/* 计数器模式，1次性 */
+	volatile uint8_t Flag;			/* 定时到达标志  */
+	uint8_t InUse;					/* 1 表示已经分配 */
+}SOFT_TMR;
+
+/*
+	us级硬件定时。所有定时按到期时刻排队，共用硬件定时器的CC1通道，个数不限。
+	HARD_TMR_T 由调用者分配(一般是静态变量)，运行期间不能释放。
+*/
+#define HARD_TMR_MIN_US		2		/* 距离到期小于这个时间就直接执行，来不及设置比较值 */
+#define HARD_TMR_LATE_US	20		/* 回调函数晚于到期时刻超过这个时间，计为1次延迟 */
+
+typedef struct _HARD_TMR
+{
+	struct _HARD_TMR *pNext;		/* 队列中的下一个定时器 */
+	uint32_t Expire;				/* 到期时刻, 32位硬件定时器计数值, 单位1us */
+	uint32_t Period;				/* 周期, 单位1us; 0 表示单次定时 */
+	void (*CallBack)(void *_pArg);	/* 到期后在 TIMx 中断中执行的回调函数 */
+	void *pArg;						/* 回调函数的参数 */
+	volatile uint8_t Active;		/* 1 表示在队列中 */
+}HARD_TMR_T;
+
+/* 硬件定时统计 */
+typedef struct
+{
+	uint32_t Fired;			/* 执行回调函数的次数 */
+	uint32_t LateCount;		/* 晚于到期时刻超过 HARD_TMR_LATE_US 的次数 */
+	uint32_t LateMax;		/* 最大延迟, 单位1us */
+	uint32_t LateSum;		/* 延迟累计, 单位1us。平均延迟 = LateSum / Fired */
+	uint32_t Missed;		/* 周期定时落后超过1个周期而跳过的次数 */
+}HARD_TMR_STAT_T;
+
+/* 提供给其他C文件调用的函数 */
+void bsp_InitTimer(void);
+void bsp_DelayMS(uint32_t n);
+void bsp_DelayUS(uint32_t n);
+void bsp_StartTimer(uint8_t _id, uint32_t _period);
+void bsp_StartAutoTimer(uint8_t _id, uint32_t _period);
+void bsp_StopTimer(uint8_t _id);
+uint8_t bsp_CheckTimer(uint8_t _id);
+int32_t bsp_GetRunTime(void);
+uint64_t bsp_GetRunTime64(void);
+uint64_t bsp_GetTimeUs64(void);
+
+/* 动态分配的软件定时器, 用句柄访问 */
+SOFT_TMR *bsp_CreateTimer(void (*_pCallBack)(void *_pArg), void *_pArg);
+void bsp_DeleteTimer(SOFT_TMR *_pTmr);
+void bsp_StartTimerEx(SOFT_TMR *_pTmr, uint32_t _period, TMR_MODE_E _mode);
+void bsp_StopTimerEx(SOFT_TMR *_pTmr);
+uint8_t bsp_CheckTimerEx(SOFT_TMR *_pTmr);
+int32_t bsp_CheckRunTime(int32_t _LastTime);
+
+void bsp_InitHardTimer(void);
+void bsp_StartHardTimer(uint8_t _CC, uint32_t _uiTimeOut, void * _pCallBack);
+uint16_t bsp_GetHardTimerCount(void);
+uint32_t bsp_GetHardTimerCount32(void);
+void bsp_StartHardTimerEx(HARD_TMR_T *_pTmr, uint32_t _uiDelay, uint32_t _uiPeriod,
+	void (*_pCallBack)(void *_pArg), void *_pArg);
+void bsp_StopHardTimerEx(HARD_TMR_T *_pTmr);
+void bsp_GetHardTimerStat(HARD_TMR_STAT_T *_pStat);
+
+void bsp_TicklessIdle(void);
+void bsp_GetIdleStat(IDLE_STAT_T *_pStat);
+
+#endif
+
+/***************************** 安富莱电子 www.armfly.com (END OF FILE) *********************************/
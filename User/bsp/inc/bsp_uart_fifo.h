@@ -1,136 +1,175 @@
-/*
-*********************************************************************************************************
-*
-*	模块名称 : 串口中断+FIFO驱动模块
-*	文件名称 : bsp_uart_fifo.h
-*	版    本 : V1.0
-*	说    明 : 头文件
-*
-*	Copyright (C), 2013-2014, 安富莱电子 www.armfly.com
-*
-*********************************************************************************************************
-*/
-
-#ifndef _BSP_USART_FIFO_H_
-#define _BSP_USART_FIFO_H_
-
-#include "bsp.h"
-/*
-	如果需要更改串口对应的管脚，请自行修改 bsp_uart_fifo.c文件中的 static void InitHardUart(void)函数
-*/
-
-/* 定义使能的串口, 0 表示不使能（不增加代码大小）， 1表示使能 */
-/*
-	安富莱STM32-V4 串口分配：
-	【串口1】 RS232 芯片第1路。
-		PA9/USART1_TX	  --- 打印调试口
-		PA10/USART1_RX
-
-	【串口2】GPRS 模块 
-		PA2/USART2_TX
-		PA3/USART2_RX 
-
-	【串口3】 RS485 通信 - TTL 跳线 和 排针
-		PB10/USART3_TX
-		PB11/USART3_RX
-		PB2/BOOT1/RS485_TX_EN
-
-	【串口4】 --- 不做串口用。
-	【串口5】 --- 不做串口用。
-*/
-#define	UART1_FIFO_EN	1
-#define	UART2_FIFO_EN	1
-#define	UART3_FIFO_EN	1
-#define	UART4_FIFO_EN	0
-#define	UART5_FIFO_EN	0
-
-/* RS485芯片发送使能GPIO, PB2 */
-#define RCC_RS485_TXEN 	 RCC_APB2Periph_GPIOB
-#define PORT_RS485_TXEN  GPIOB
-#define PIN_RS485_TXEN	 GPIO_Pin_2
-
-#define RS485_RX_EN()	PORT_RS485_TXEN->BRR = PIN_RS485_TXEN
-#define RS485_TX_EN()	PORT_RS485_TXEN->BSRR = PIN_RS485_TXEN
-
-
-/* 定义端口号 */
-typedef enum
-{
-	COM1 = 0,	/* USART1  PA9, PA10 */
-	COM2 = 1,	/* USART2, PA2, PA3 */
-	COM3 = 2,	/* USART3, PB10, PB11 */
-	COM4 = 3,	/* UART4, PC10, PC11 */
-	COM5 = 4,	/* UART5, PC12, PD2 */
-}COM_PORT_E;
-
-/* 定义串口波特率和FIFO缓冲区大小，分为发送缓冲区和接收缓冲区, 支持全双工 */
-#if UART1_FIFO_EN == 1
-	#define UART1_BAUD			115200
-	#define UART1_TX_BUF_SIZE	1*1024
-	#define UART1_RX_BUF_SIZE	1*1024
-#endif
-
-#if UART2_FIFO_EN == 1
-	#define UART2_BAUD			115200
-	#define UART2_TX_BUF_SIZE	1*1024
-	#define UART2_RX_BUF_SIZE	1*1024
-#endif
-
-#if UART3_FIFO_EN == 1
-	#define UART3_BAUD			9600
-	#define UART3_TX_BUF_SIZE	1*1024
-	#define UART3_RX_BUF_SIZE	1*1024
-#endif
-
-#if UART4_FIFO_EN == 1
-	#define UART4_BAUD			115200
-	#define UART4_TX_BUF_SIZE	1*1024
-	#define UART4_RX_BUF_SIZE	1*1024
-#endif
-
-#if UART5_FIFO_EN == 1
-	#define UART5_BAUD			115200
-	#define UART5_TX_BUF_SIZE	1*1024
-	#define UART5_RX_BUF_SIZE	1*1024
-#endif
-
-/* 串口设备结构体 */
-typedef struct
-{
-	USART_TypeDef *uart;		/* STM32内部串口设备指针 */
-	uint8_t *pTxBuf;			/* 发送缓冲区 */
-	uint8_t *pRxBuf;			/* 接收缓冲区 */
-	uint16_t usTxBufSize;		/* 发送缓冲区大小 */
-	uint16_t usRxBufSize;		/* 接收缓冲区大小 */
-	__IO uint16_t usTxWrite;			/* 发送缓冲区写指针 */
-	__IO uint16_t usTxRead;			/* 发送缓冲区读指针 */
-	__IO uint16_t usTxCount;			/* 等待发送的数据个数 */
-
-	__IO uint16_t usRxWrite;			/* 接收缓冲区写指针 */
-	__IO uint16_t usRxRead;			/* 接收缓冲区读指针 */
-	__IO uint16_t usRxCount;			/* 还未读取的新数据个数 */
-
-	void (*SendBefor)(void); 	/* 开始发送之前的回调函数指针（主要用于RS485切换到发送模式） */
-	void (*SendOver)(void); 	/* 发送完毕的回调函数指针（主要用于RS485将发送模式切换为接收模式） */
-	void (*ReciveNew)(uint8_t _byte);	/* 串口收到数据的回调函数指针 */
-}UART_T;
-
-void bsp_InitUart(void);
-void comSendBuf(COM_PORT_E _ucPort, uint8_t *_ucaBuf, uint16_t _usLen);
-void comSendChar(COM_PORT_E _ucPort, uint8_t _ucByte);
-uint8_t comGetChar(COM_PORT_E _ucPort, uint8_t *_pByte);
-
-void comClearTxFifo(COM_PORT_E _ucPort);
-void comClearRxFifo(COM_PORT_E _ucPort);
-
-void RS485_SendBuf(uint8_t *_ucaBuf, uint16_t _usLen);
-void RS485_SendStr(char *_pBuf);
-
-void bsp_Set485Baud(uint32_t _baud);
-
-void bsp_SetUart1Baud(uint32_t _baud);
-void bsp_SetUart2Baud(uint32_t _baud);
-
-#endif
-
-/***************************** 安富莱电子 www.armfly.com (END OF FILE) *********************************/
+/*
+*********************************************************************************************************
+*
+*	模块名称 : 串口中断+FIFO驱动模块
+*	文件名称 : bsp_uart_fifo.h
+*	版    本 : V1.0
+*	说    明 : 头文件
+*
+*	Copyright (C), 2013-2014, 安富莱电子 www.armfly.com
+*
+*********************************************************************************************************
+*/
+
+#ifndef _BSP_USART_FIFO_H_
+#define _BSP_USART_FIFO_H_
+
+#include "bsp.h"
+/*
+	如果需要更改串口对应的管脚，请自行修改 bsp_uart_fifo.c文件中的 static void InitHardUart(void)函数
+*/
+
+/* 定义使能的串口, 0 表示不使能（不增加代码大小）， 1表示使能 */
+/*
+	安富莱STM32-V4 串口分配：
+	【串口1】 RS232 芯片第1路。
+		PA9/USART1_TX	  --- 打印调试口
+		PA10/USART1_RX
+
+	【串口2】GPRS 模块 
+		PA2/USART2_TX
+		PA3/USART2_RX 
+
+	【串口3】 RS485 通信 - TTL 跳线 和 排针
+		PB10/USART3_TX
+		PB11/USART3_RX
+		PB2/BOOT1/RS485_TX_EN
+
+	【串口4】 --- 不做串口用。
+	【串口5】 --- 不做串口用。
+*/
+#define	UART1_FIFO_EN	1
+#define	UART2_FIFO_EN	1
+#define	UART3_FIFO_EN	1
+#define	UART4_FIFO_EN	0
+#define	UART5_FIFO_EN	0
+
+/* RS485芯片发送使能GPIO, PB2 */
+#define RCC_RS485_TXEN 	 RCC_APB2Periph_GPIOB
+#define PORT_RS485_TXEN  GPIOB
+#define PIN_RS485_TXEN	 GPIO_Pin_2
+
+#define RS485_RX_EN()	PORT_RS485_TXEN->BRR = PIN_RS485_TXEN
+#define RS485_TX_EN()	PORT_RS485_TXEN->BSRR = PIN_RS485_TXEN
+
+/*
+	串口2 的 DTR/RTS 控制线输出GPIO, 低电平有效, USB转串口桥接 (usb_bridge.c) 使用。请根据实际接线修改。
+	USART2 占用 PA2/PA3, PA0 是按键 K1。
+*/
+#define RCC_COM2_DTR	RCC_APB2Periph_GPIOA
+#define PORT_COM2_DTR	GPIOA
+#define PIN_COM2_DTR	GPIO_Pin_4
+
+#define RCC_COM2_RTS	RCC_APB2Periph_GPIOA
+#define PORT_COM2_RTS	GPIOA
+#define PIN_COM2_RTS	GPIO_Pin_1
+
+
+/* 定义端口号 */
+typedef enum
+{
+	COM1 = 0,	/* USART1  PA9, PA10 */
+	COM2 = 1,	/* USART2, PA2, PA3 */
+	COM3 = 2,	/* USART3, PB10, PB11 */
+	COM4 = 3,	/* UART4, PC10, PC11 */
+	COM5 = 4,	/* UART5, PC12, PD2 */
+}COM_PORT_E;
+
+/* 定义串口波特率和FIFO缓冲区大小，分为发送缓冲区和接收缓冲区, 支持全双工。缓冲区大小必须是2的整数次幂 */
+#if UART1_FIFO_EN == 1
+	#define UART1_BAUD			115200
+	#define UART1_TX_BUF_SIZE	1*1024
+	#define UART1_RX_BUF_SIZE	1*1024
+	#define UART1_TX_DMA_EN		1		/* 1表示用DMA发送, 0表示用TXE中断逐字节发送 */
+	#define UART1_RX_DMA_EN		1		/* 1表示用循环DMA接收, 0表示用RXNE中断逐字节接收 */
+#endif
+
+#if UART2_FIFO_EN == 1
+	#define UART2_BAUD			115200
+	#define UART2_TX_BUF_SIZE	1*1024
+	#define UART2_RX_BUF_SIZE	1*1024
+	#define UART2_TX_DMA_EN		1		/* 1表示用DMA发送, 0表示用TXE中断逐字节发送 */
+	#define UART2_RX_DMA_EN		1		/* 1表示用循环DMA接收, 0表示用RXNE中断逐字节接收 */
+#endif
+
+#if UART3_FIFO_EN == 1
+	#define UART3_BAUD			9600
+	#define UART3_TX_BUF_SIZE	1*1024
+	#define UART3_RX_BUF_SIZE	1*1024
+	#define UART3_TX_DMA_EN		1		/* 1表示用DMA发送, 0表示用TXE中断逐字节发送 */
+	#define UART3_RX_DMA_EN		1		/* 1表示用循环DMA接收, 0表示用RXNE中断逐字节接收 */
+#endif
+
+#if UART4_FIFO_EN == 1
+	#define UART4_BAUD			115200
+	#define UART4_TX_BUF_SIZE	1*1024
+	#define UART4_RX_BUF_SIZE	1*1024
+	#define UART4_TX_DMA_EN		0		/* 1表示用DMA发送, 0表示用TXE中断逐字节发送 */
+	#define UART4_RX_DMA_EN		0		/* 1表示用循环DMA接收, 0表示用RXNE中断逐字节接收 */
+#endif
+
+#if UART5_FIFO_EN == 1
+	#define UART5_BAUD			115200
+	#define UART5_TX_BUF_SIZE	1*1024
+	#define UART5_RX_BUF_SIZE	1*1024
+#endif
+
+/* 串口设备结构体 */
+typedef struct
+{
+	USART_TypeDef *uart;		/* STM32内部串口设备指针 */
+	RING_T tTxRing;				/* 发送FIFO, 主程序写入, 中断(或DMA)取出 */
+	RING_T tRxRing;				/* 接收FIFO, 中断(或DMA)写入, 主程序取出 */
+
+	DMA_Channel_TypeDef *TxDma;	/* 发送DMA通道, 0 表示采用TXE中断发送 */
+	__IO uint16_t usTxDmaLen;		/* DMA正在发送的字节数, 0 表示DMA空闲 */
+	DMA_Channel_TypeDef *RxDma;	/* 接收DMA通道(循环模式), 0 表示采用RXNE中断接收 */
+	uint32_t ulRxDmaFlagHT;		/* 接收DMA通道的半满标志 (DMAx_FLAG_HTn) */
+	uint32_t ulRxDmaFlagTC;		/* 接收DMA通道的全满标志 (DMAx_FLAG_TCn) */
+	__IO uint32_t ulRxOverrun;	/* DMA接收覆盖了未读数据的次数, 只由中断修改 */
+
+	void (*SendBefor)(void); 	/* 开始发送之前的回调函数指针（主要用于RS485切换到发送模式） */
+	void (*SendOver)(void); 	/* 发送完毕的回调函数指针（主要用于RS485将发送模式切换为接收模式） */
+	void (*ReciveNew)(uint8_t *_pBuf, uint16_t _usLen);	/* 串口收到数据的回调函数指针, 每次传入一段连续的新数据, _pBuf 只在回调期间有效 */
+
+	void (*TxLow)(void);		/* 发送缓冲区有空闲的回调函数指针（非阻塞发送未能全部写入时，通知应用程序继续发送） */
+	uint16_t usTxLowMark;		/* 发送缓冲区的低水位, 待发送数据不多于这个值时执行 TxLow 回调 */
+	__IO uint8_t ucTxLowArmed;	/* 1 表示等待执行 TxLow 回调 */
+}UART_T;
+
+void bsp_InitUart(void);
+void comSendBuf(COM_PORT_E _ucPort, uint8_t *_ucaBuf, uint16_t _usLen);
+void comSendChar(COM_PORT_E _ucPort, uint8_t _ucByte);
+uint8_t comGetChar(COM_PORT_E _ucPort, uint8_t *_pByte);
+uint16_t comRead(COM_PORT_E _ucPort, uint8_t *_pBuf, uint16_t _usSize);
+uint16_t comWrite(COM_PORT_E _ucPort, uint8_t *_pBuf, uint16_t _usLen);
+uint16_t comSendBufNoWait(COM_PORT_E _ucPort, uint8_t *_ucaBuf, uint16_t _usLen);
+uint16_t comGetTxFree(COM_PORT_E _ucPort);
+void comSetTxLowCallback(COM_PORT_E _ucPort, uint16_t _usLowMark, void (*_pCallback)(void));
+void comSetReciveNewCallback(COM_PORT_E _ucPort, void (*_pCallback)(uint8_t *_pBuf, uint16_t _usLen));
+
+/* 零拷贝接口: 直接访问FIFO中的连续区域 */
+uint16_t comPeekSpan(COM_PORT_E _ucPort, uint8_t **_ppData);
+void comConsume(COM_PORT_E _ucPort, uint16_t _usLen);
+uint16_t comReserveSpan(COM_PORT_E _ucPort, uint8_t **_ppData);
+void comCommit(COM_PORT_E _ucPort, uint16_t _usLen);
+
+void comClearTxFifo(COM_PORT_E _ucPort);
+void comClearRxFifo(COM_PORT_E _ucPort);
+uint16_t comPollRxDma(COM_PORT_E _ucPort);
+uint32_t comGetRxOverrun(COM_PORT_E _ucPort);
+uint8_t comRxIsEmpty(COM_PORT_E _ucPort);
+void comFlushTxPoll(COM_PORT_E _ucPort);
+
+void RS485_SendBuf(uint8_t *_ucaBuf, uint16_t _usLen);
+void RS485_SendStr(char *_pBuf);
+
+void bsp_Set485Baud(uint32_t _baud);
+
+void bsp_SetUart1Baud(uint32_t _baud);
+void bsp_SetUart2Baud(uint32_t _baud);
+void bsp_SetUart2Param(uint32_t _baud, uint16_t _usWordLength, uint16_t _usStopBits, uint16_t _usParity);
+
+#endif
+
+/***************************** 安富莱电子 www.armfly.com (END OF FILE) *********************************/
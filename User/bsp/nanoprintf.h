@@ -84,7 +84,9 @@ NPF_VISIBILITY int npf_vpprintf(npf_putc pc, void *pc_ctx, char const *format,
 
 /* Public Configuration */
 
-/* Pick reasonable defaults if nothing's been configured. */
+/* Pick reasonable defaults if nothing's been configured. Float support is
+   off: it drags software floating point into every call site and nothing in
+   this project prints floats. */
 #if !defined(NANOPRINTF_USE_FIELD_WIDTH_FORMAT_SPECIFIERS) && \
     !defined(NANOPRINTF_USE_PRECISION_FORMAT_SPECIFIERS) &&   \
     !defined(NANOPRINTF_USE_FLOAT_FORMAT_SPECIFIERS) &&       \
@@ -92,7 +94,7 @@ NPF_VISIBILITY int npf_vpprintf(npf_putc pc, void *pc_ctx, char const *format,
     !defined(NANOPRINTF_USE_WRITEBACK_FORMAT_SPECIFIERS)
 #define NANOPRINTF_USE_FIELD_WIDTH_FORMAT_SPECIFIERS 1
 #define NANOPRINTF_USE_PRECISION_FORMAT_SPECIFIERS 1
-#define NANOPRINTF_USE_FLOAT_FORMAT_SPECIFIERS 1
+#define NANOPRINTF_USE_FLOAT_FORMAT_SPECIFIERS 0
 #define NANOPRINTF_USE_LARGE_FORMAT_SPECIFIERS 0
 #define NANOPRINTF_USE_WRITEBACK_FORMAT_SPECIFIERS 0
 #endif
@@ -532,32 +534,42 @@ void npf__bufputc_nop(int c, void *ctx) {
 }
 
 int npf__itoa_rev(char *buf, npf__int_t i) {
-    char *dst = buf;
-    if (i == 0) {
-        *dst++ = '0';
-    } else {
-        int const neg = (i < 0) ? -1 : 1;
-        while (i) {
-            *dst++ = (char)('0' + (neg * (i % 10)));
-            i /= 10;
-        }
-    }
-    return (int)(dst - buf);
+    /* convert the magnitude, the caller prints the sign. 0 - i in unsigned
+       arithmetic is also right for the most negative value. */
+    npf__uint_t const u =
+        (i < 0) ? ((npf__uint_t)0 - (npf__uint_t)i) : (npf__uint_t)i;
+    return npf__utoa_rev(buf, u, 10, NPF_FMT_SPEC_CONV_CASE_LOWER);
 }
 
 int npf__utoa_rev(char *buf, npf__uint_t i, unsigned base,
                   npf__format_spec_conversion_case_t cc) {
     char *dst = buf;
-    if (i == 0) {
-        *dst++ = '0';
+    if (base == 10) {
+        uint32_t v;
+        /* digits above 32 bits (only with 64-bit npf__uint_t) */
+        while ((i >> 16) >> 16) {
+            npf__uint_t const q = i / 10;
+            *dst++ = (char)('0' + (unsigned)(i - q * 10));
+            i = q;
+        }
+        /* v / 10 == (v * 0xCCCCCCCD) >> 35 for every 32-bit v. One UMULL
+           replaces the UDIV + MLS that a run-time base costs per digit. */
+        v = (uint32_t)i;
+        do {
+            uint32_t const q = (uint32_t)(((uint64_t)v * 0xCCCCCCCDu) >> 35);
+            *dst++ = (char)('0' + (v - q * 10));
+            v = q;
+        } while (v);
     } else {
+        /* base 8 or 16: shift and mask */
+        unsigned const shift = (base == 16) ? 4 : 3;
         unsigned const base_c =
             (cc == NPF_FMT_SPEC_CONV_CASE_LOWER) ? 'a' : 'A';
-        while (i) {
-            unsigned const d = (unsigned)(i % base);
-            i /= base;
+        do {
+            unsigned const d = (unsigned)(i & (base - 1));
+            i >>= shift;
             *dst++ = (d < 10) ? (char)('0' + d) : (char)(base_c + (d - 10));
-        }
+        } while (i);
     }
     return (int)(dst - buf);
 }
@@ -757,6 +769,10 @@ int npf_vpprintf(npf_putc pc, void *pc_ctx, char const *format, va_list vlist) {
                 int frac_chars = 0, inf_or_nan = 0;
 #endif
 
+                /* only signed conversions set the sign; don't carry it over
+                   from a previous '%d' into '%u', '%c' etc. */
+                sign = 0;
+
 #if NANOPRINTF_USE_FIELD_WIDTH_FORMAT_SPECIFIERS == 1
                 if (fs.field_width_type == NPF_FMT_SPEC_FIELD_WIDTH_STAR) {
                     /* If '*' was used as field width, read it from args. */
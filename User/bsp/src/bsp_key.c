@@ -1,559 +1,807 @@
-#include "bsp_key.h"
-
-#define DOUBLE_CLICK_ENABLE     0   /* 1表示启用双击检测， 会影响单击体验变慢 */
-
-#define HARD_KEY_NUM            3                       /* 实体按键个数 */
-#define KEY_COUNT               (HARD_KEY_NUM + 2)      /* 2个独立建 + 2个组合按键 */
-
-/* 依次定义GPIO */
-typedef struct
-{
-	uint32_t clk;
-    GPIO_TypeDef *gpio;
-    uint16_t pin;
-    uint8_t ActiveLevel; /* 激活电平 */
-} X_GPIO_T;
-
-/*
-**	三个独立按键K0，K1，K2。两个组合按键K0K1，K1K2
-**	#define KEY_COUNT    5
-*/
-static const X_GPIO_T s_gpio_list[HARD_KEY_NUM] = {
-	{RCC_APB2Periph_GPIOC, GPIOC, GPIO_Pin_13, 0},	/* K0 */
-	{RCC_APB2Periph_GPIOA, GPIOA, GPIO_Pin_0, 0},	/* K1 */
-	{RCC_APB2Periph_GPIOG, GPIOG, GPIO_Pin_8, 0},	/* K2 */
-};
-
-static KEY_T s_tBtn[KEY_COUNT];
-static KEY_FIFO_T s_tKey;		/* 按键FIFO变量,结构体 */
-
-static void bsp_InitKeyVar(void);
-static void bsp_InitKeyHard(void);
-static void bsp_DetectKey(uint8_t i);
-
-/* 用于按键超时进入屏保 */
-static int32_t s_KeyTimeOutCount = 0;
-static uint8_t s_LcdOn = 1;
-
-/*
-*********************************************************************************************************
-*    函 数 名: KeyPinActive
-*    功能说明: 判断按键是否按下
-*    形    参: 无
-*    返 回 值: 返回值1 表示按下(导通），0表示未按下（释放）
-*********************************************************************************************************
-*/
-static uint8_t KeyPinActive(uint8_t _id)
-{
-    uint8_t level;
-
-	level = !(s_gpio_list[_id].gpio->IDR & s_gpio_list[_id].pin);
-
-	return (level == s_gpio_list[_id].ActiveLevel);
-}
-
-
-/*
-*********************************************************************************************************
-*    函 数 名: IsKeyDownFunc
-*    功能说明: 判断按键是否按下。单键和组合键区分。单键事件不允许有其他键按下。
-*    形    参: 无
-*    返 回 值: 返回值1 表示按下(导通），0表示未按下（释放）
-*********************************************************************************************************
-*/
-static uint8_t IsKeyDownFunc(uint8_t _id)
-{
-    /* 实体单键 */
-    if (_id < HARD_KEY_NUM)
-    {
-        uint8_t i;
-        uint8_t count = 0;
-        uint8_t save = 255;
-
-        /* 判断有几个键按下 */
-        for (i = 0; i < HARD_KEY_NUM; i++)
-        {
-            if (KeyPinActive(i))
-            {
-                count++;
-                save = i;
-            }
-        }
-
-        if (count == 1 && save == _id)
-        {
-            return 1; /* 只有1个键按下时才有效 */
-        }
-
-        return 0;
-    }
-	
-	/* 组合键 K1K2 */
-	if (_id == HARD_KEY_NUM + 0)
-	{
-		if (KeyPinActive(KID_K1) && KeyPinActive(KID_K2))
-		{
-			return 1;
-		}
-		else
-		{
-			return 0;
-		}
-	}
-	
-	/* 组合键 K2K3 */
-	if (_id == HARD_KEY_NUM + 1)
-	{
-		if (KeyPinActive(KID_K2) && KeyPinActive(KID_K3))
-		{
-			return 1;
-		}
-		else
-		{
-			return 0;
-		}
-	}
-
-    return 0;
-}
-
-/*
-*********************************************************************************************************
-*    函 数 名: bsp_InitKey
-*    功能说明: 初始化按键. 该函数被 bsp_Init() 调用。
-*    形    参: 无
-*    返 回 值: 无
-*********************************************************************************************************
-*/
-void bsp_InitKey(void)
-{
-    bsp_InitKeyVar();   /* 初始化按键变量 */
-    bsp_InitKeyHard();  /* 初始化按键硬件 */
-}
-
-/*
-*********************************************************************************************************
-*    函 数 名: bsp_InitKeyHard
-*    功能说明: 配置按键对应的GPIO
-*    形    参:  无
-*    返 回 值: 无
-*********************************************************************************************************
-*/
-static void bsp_InitKeyHard(void)
-{
-    GPIO_InitTypeDef gpio_init;
-
-    /* 第1步：配置所有的按键GPIO为浮动输入模式(实际上CPU复位后就是输入状态) */
-    gpio_init.GPIO_Mode = GPIO_Mode_IN_FLOATING;               /* 设置输入 */
-    gpio_init.GPIO_Speed = GPIO_Speed_50MHz;    /* GPIO速度等级 */
-
-    for (uint8_t i = 0; i < HARD_KEY_NUM; i++)
-    {
-    	/* 第2步：打开GPIO时钟 */
-    	RCC_APB2PeriphClockCmd(s_gpio_list[i].clk, ENABLE);
-		
-        gpio_init.GPIO_Pin = s_gpio_list[i].pin;
-        GPIO_Init(s_gpio_list[i].gpio, &gpio_init);
-    }
-}
-/*
-*********************************************************************************************************
-*    函 数 名: bsp_InitKeyVar
-*    功能说明: 初始化按键变量
-*    形    参:  无
-*    返 回 值: 无
-*********************************************************************************************************
-*/
-static void bsp_InitKeyVar(void)
-{
-    uint8_t i;
-
-    /* 对按键FIFO读写指针清零 */
-    s_tKey.Read = 0;
-    s_tKey.Write = 0;
-    s_tKey.Read2 = 0;
-
-    /* 给每个按键结构体成员变量赋一组缺省值 */
-    for (i = 0; i < KEY_COUNT; i++)
-    {
-        s_tBtn[i].LongTime = KEY_LONG_TIME;         /* 长按时间 0 表示不检测长按键事件 */
-        s_tBtn[i].Count = KEY_FILTER_TIME / 2;      /* 计数器设置为滤波时间的一半 */
-        s_tBtn[i].State = 0;                        /* 按键缺省状态，0为未按下 */
-        s_tBtn[i].RepeatSpeed = 0;                  /* 按键连发的速度，0表示不支持连发 */
-        s_tBtn[i].RepeatCount = 0;                  /* 连发计数器 */
-        s_tBtn[i].DelayCount = 0;
-        s_tBtn[i].ClickCount = 0;
-        s_tBtn[i].LastTime = 0;
-    }
-
-    /* 如果需要单独更改某个按键的参数，可以在此单独重新赋值 */
-
-    /* 摇杆上下左右，支持长按1秒后，自动连发 */
-    bsp_SetKeyParam(KID_K1, KEY_LONG_TIME, 0);
-    bsp_SetKeyParam(KID_K2, KEY_LONG_TIME, 0);
-    bsp_SetKeyParam(KID_K3, KEY_LONG_TIME, 0);
-}
-
-/*
-*********************************************************************************************************
-*    函 数 名: bsp_PutKey
-*    功能说明: 将1个键值压入按键FIFO缓冲区。可用于模拟一个按键。
-*    形    参:  _KeyCode : 按键代码
-*    返 回 值: 无
-*********************************************************************************************************
-*/
-void bsp_PutKey(uint8_t _KeyCode)
-{
-    s_tKey.Buf[s_tKey.Write] = _KeyCode;
-
-    if (++s_tKey.Write >= KEY_FIFO_SIZE)
-    {
-        s_tKey.Write = 0;
-    }
-}
-
-/*
-*********************************************************************************************************
-*    函 数 名: bsp_GetKey
-*    功能说明: 从按键FIFO缓冲区读取一个键值。
-*    形    参: 无
-*    返 回 值: 按键代码
-*********************************************************************************************************
-*/
-uint8_t bsp_GetKey(void)
-{
-    uint8_t ret;
-
-    if (s_tKey.Read == s_tKey.Write)
-    {
-        return KEY_NONE;
-    }
-    else
-    {
-        ret = s_tKey.Buf[s_tKey.Read];
-
-        if (++s_tKey.Read >= KEY_FIFO_SIZE)
-        {
-            s_tKey.Read = 0;
-        }
-        return ret;
-    }
-}
-
-/*
-*********************************************************************************************************
-*    函 数 名: bsp_GetKey2
-*    功能说明: 从按键FIFO缓冲区读取一个键值。独立的读指针。
-*    形    参:  无
-*    返 回 值: 按键代码
-*********************************************************************************************************
-*/
-uint8_t bsp_GetKey2(void)
-{
-    uint8_t ret;
-
-    if (s_tKey.Read2 == s_tKey.Write)
-    {
-        return KEY_NONE;
-    }
-    else
-    {
-        ret = s_tKey.Buf[s_tKey.Read2];
-
-        if (++s_tKey.Read2 >= KEY_FIFO_SIZE)
-        {
-            s_tKey.Read2 = 0;
-        }
-        return ret;
-    }
-}
-
-/*
-*********************************************************************************************************
-*    函 数 名: bsp_SetKeyParam
-*    功能说明: 设置按键参数
-*    形    参：_ucKeyID : 按键ID，从0开始
-*            _LongTime : 长按事件时间
-*             _RepeatSpeed : 连发速度
-*    返 回 值: 无
-*********************************************************************************************************
-*/
-void bsp_SetKeyParam(uint8_t _ucKeyID, uint16_t _LongTime, uint8_t _RepeatSpeed)
-{
-    s_tBtn[_ucKeyID].LongTime = _LongTime;             /* 长按时间 0 表示不检测长按键事件 */
-    s_tBtn[_ucKeyID].RepeatSpeed = _RepeatSpeed; /* 按键连发的速度，0表示不支持连发 */
-    s_tBtn[_ucKeyID].RepeatCount = 0;                         /* 连发计数器 */
-}
-
-/*
-*********************************************************************************************************
-*    函 数 名: bsp_ClearKey
-*    功能说明: 清空按键FIFO缓冲区
-*    形    参：无
-*    返 回 值: 按键代码
-*********************************************************************************************************
-*/
-void bsp_ClearKey(void)
-{
-    s_tKey.Read = s_tKey.Write;
-}
-
-/*
-*********************************************************************************************************
-*    函 数 名: bsp_DetectKey
-*    功能说明: 检测一个按键。非阻塞状态，必须被周期性的调用。
-*    形    参: IO的id， 从0开始编码
-*    返 回 值: 无
-*********************************************************************************************************
-*/
-static void bsp_DetectKey(uint8_t i)
-{
-    KEY_T *pBtn;
-
-    pBtn = &s_tBtn[i];
-    if (IsKeyDownFunc(i))
-    {
-        if (pBtn->Count < KEY_FILTER_TIME)
-        {
-            pBtn->Count = KEY_FILTER_TIME;
-        }
-        else if (pBtn->Count < 2 * KEY_FILTER_TIME)
-        {
-            pBtn->Count++;
-        }
-        else
-        {
-            if (pBtn->State == 0)
-            {
-                pBtn->State = 1;
-
-                /* 发送按钮按下的消息 */
-                bsp_PutKey((uint8_t)(KEY_MSG_STEP * i + KEY_1_DOWN));
-            }
-
-            if (pBtn->LongTime > 0)
-            {
-                if (pBtn->LongCount < pBtn->LongTime)
-                {
-                    /* 发送长按消息 */
-                    if (++pBtn->LongCount == pBtn->LongTime)
-                    {
-                        pBtn->State = 2;
-
-                        /* 键值放入按键FIFO */
-                        bsp_PutKey((uint8_t)(KEY_MSG_STEP * i + KEY_1_LONG_DOWN));
-                    }
-                }
-                else
-                {
-                    if (pBtn->RepeatSpeed > 0)
-                    {
-                        if (++pBtn->RepeatCount >= pBtn->RepeatSpeed)
-                        {
-                            pBtn->RepeatCount = 0;
-                            /* 常按键后，每隔10ms发送1个按键弹起事件 */
-                            //bsp_PutKey((uint8_t)(4 * i + 1));  这是发按键按下事件
-                            bsp_PutKey((uint8_t)(KEY_MSG_STEP * i + KEY_1_AUTO_UP));
-                        }
-                    }
-                }
-            }
-        }
-    }
-    else
-    {
-        if (pBtn->Count > KEY_FILTER_TIME)
-        {
-            pBtn->Count = KEY_FILTER_TIME;
-        }
-        else if (pBtn->Count != 0)
-        {
-            pBtn->Count--;
-        }
-        else
-        {
-            if (pBtn->State != 0)
-            {
-                /* 2019-12-05 H7-TOOL增加，第4个事件, 长按后的弹起 */
-                if (pBtn->LongTime == 0)
-                {
-                    /* 发送短按弹起的消息 */
-                    bsp_PutKey((uint8_t)(KEY_MSG_STEP * i + KEY_1_UP));
-                }
-                else
-                {
-                    if (pBtn->State == 2)
-                    {
-                        /* 发送长按弹起的消息 */
-                        bsp_PutKey((uint8_t)(KEY_MSG_STEP * i + KEY_1_LONG_UP));
-
-                        #if DOUBLE_CLICK_ENABLE == 1
-                            s_tBtn[i].LastTime = bsp_GetRunTime();  /* 记录按键弹起时刻 */
-                        #endif
-                    }
-                    else
-                    {
-                        #if DOUBLE_CLICK_ENABLE == 1
-                        /* 发送短按弹起的消息 */
-                            //if (bsp_CheckRunTime(s_tBtn[i].LastTime) < 500)
-                            if (pBtn->DelayCount > 0)
-                            {
-                                if (pBtn->ClickCount == 1)
-                                {
-                                    bsp_PutKey((uint8_t)(KEY_MSG_STEP * i + KEY_1_DB_UP));  /* 双击事件 */
-                                    pBtn->ClickCount = 0;
-                                }
-                                else
-                                {
-                                    bsp_PutKey((uint8_t)(KEY_MSG_STEP * i + KEY_1_UP));     /* 单击弹起事件 */
-                                    pBtn->ClickCount = 0;
-                                }
-                                pBtn->DelayCount = 80;
-                            }
-                            else
-                            {
-                                pBtn->ClickCount++;
-                                pBtn->DelayCount = KEY_DB_CLICK_TIME;
-                            }
-                            s_tBtn[i].LastTime = bsp_GetRunTime();  /* 记录按键弹起时刻 */
-                        #else
-                            bsp_PutKey((uint8_t)(KEY_MSG_STEP * i + KEY_1_UP));     /* 单击弹起事件 */
-                        #endif
-                    }
-                }
-                pBtn->State = 0;
-            }
-        }
-
-        pBtn->LongCount = 0;
-        pBtn->RepeatCount = 0;
-    }
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: bsp_DetectFastIO
-*	功能说明: 检测高速的输入IO. 1ms刷新一次
-*	形    参: IO的id， 从0开始编码
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-static void bsp_DetectFastIO(uint8_t i)
-{
-	KEY_T *pBtn;
-
-	pBtn = &s_tBtn[i];
-	if (IsKeyDownFunc(i))
-	{
-		if (pBtn->State == 0)
-		{
-			pBtn->State = 1;
-
-			/* 发送按钮按下的消息 */
-			bsp_PutKey((uint8_t)(3 * i + 1));
-		}
-
-		if (pBtn->LongTime > 0)
-		{
-			if (pBtn->LongCount < pBtn->LongTime)
-			{
-				/* 发送按钮持续按下的消息 */
-				if (++pBtn->LongCount == pBtn->LongTime)
-				{
-					/* 键值放入按键FIFO */
-					bsp_PutKey((uint8_t)(3 * i + 3));
-				}
-			}
-			else
-			{
-				if (pBtn->RepeatSpeed > 0)
-				{
-					if (++pBtn->RepeatCount >= pBtn->RepeatSpeed)
-					{
-						pBtn->RepeatCount = 0;
-						/* 常按键后，每隔10ms发送1个按键 */
-						bsp_PutKey((uint8_t)(3 * i + 1));
-					}
-				}
-			}
-		}
-	}
-	else
-	{
-		if (pBtn->State == 1)
-		{
-			pBtn->State = 0;
-
-			/* 发送按钮弹起的消息 */
-			bsp_PutKey((uint8_t)(3 * i + 2));
-		}
-
-		pBtn->LongCount = 0;
-		pBtn->RepeatCount = 0;
-	}
-}
-
-/*
-*********************************************************************************************************
-*    函 数 名: bsp_KeyScan10ms
-*    功能说明: 扫描所有按键。非阻塞，被systick中断周期性的调用，10ms一次
-*    形    参: 无
-*    返 回 值: 无
-*********************************************************************************************************
-*/
-void bsp_KeyScan10ms(void)
-{
-    uint8_t i;
-
-    for (i = 0; i < KEY_COUNT; i++)
-    {
-        #if DOUBLE_CLICK_ENABLE == 1
-            /* 超时判断 */
-            if (s_tBtn[i].DelayCount > 0)
-            {
-                if (--s_tBtn[i].DelayCount == 0)
-                {
-                    if (s_tBtn[i].ClickCount == 1)
-                    {
-                        bsp_PutKey((uint8_t)(KEY_MSG_STEP * i + KEY_1_UP));   /* 单击弹起 */
-                    }
-                    s_tBtn[i].ClickCount = 0;
-                }
-            }
-        #endif
-
-        /* 检测按键 */
-        bsp_DetectKey(i);
-    }
-
-    if (s_KeyTimeOutCount > 0)
-    {
-        if (--s_KeyTimeOutCount == 0)
-        {
-//            LCD_SetBackLight(0);        /* 关闭背光 */
-//            g_LcdSleepReq = 1;          /* 控制LCD休眠, 在bsp_Idle执行. 不可以在此调用 LCD_DispOff() */
-            s_LcdOn = 0;                /* 屏幕关闭 */
-        }
-    }
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: bsp_KeyScan1ms
-*	功能说明: 扫描所有按键。非阻塞，被systick中断周期性的调用，1ms一次.
-*	形    参: 无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void bsp_KeyScan1ms(void)
-{
-	uint8_t i;
-
-	for (i = 0; i < KEY_COUNT; i++)
-	{
-		bsp_DetectFastIO(i);
-	}
-}
-
-/***************************** 安富莱电子 www.armfly.com (END OF FILE) *********************************/
-
+#include "bsp_key.h"
+
+#define DOUBLE_CLICK_ENABLE     0   /* 1表示启用双击检测， 会影响单击体验变慢 */
+
+#define HARD_KEY_NUM            3                       /* 实体按键个数 */
+#define KEY_COUNT               (HARD_KEY_NUM + 2)      /* 2个独立建 + 2个组合按键 */
+
+#if KEY_COUNT > 32
+	#error "按键状态按位存放在32位变量中, KEY_COUNT 不能超过32"
+#endif
+
+/* 依次定义GPIO */
+typedef struct
+{
+	uint32_t clk;
+    GPIO_TypeDef *gpio;
+    uint16_t pin;
+    uint8_t ActiveLevel; /* 激活电平 */
+} X_GPIO_T;
+
+/*
+**	三个独立按键K0，K1，K2。两个组合按键K0K1，K1K2
+**	#define KEY_COUNT    5
+*/
+static const X_GPIO_T s_gpio_list[HARD_KEY_NUM] = {
+	{RCC_APB2Periph_GPIOC, GPIOC, GPIO_Pin_13, 0},	/* K0 */
+	{RCC_APB2Periph_GPIOA, GPIOA, GPIO_Pin_0, 0},	/* K1 */
+	{RCC_APB2Periph_GPIOG, GPIOG, GPIO_Pin_8, 0},	/* K2 */
+};
+
+/* 组合键, 依次对应按键ID HARD_KEY_NUM, HARD_KEY_NUM + 1 ... 掩码中的实体按键同时按下时有效 */
+static const uint32_t s_ulComboMask[KEY_COUNT - HARD_KEY_NUM] = {
+	(1UL << KID_K1) | (1UL << KID_K2),		/* K1K2 */
+	(1UL << KID_K2) | (1UL << KID_K3),		/* K2K3 */
+};
+
+/* 按键引脚查表, 由 bsp_InitKeyHard() 根据 s_gpio_list 生成。每次扫描每个GPIO端口只读一次IDR */
+#define KEY_PORT_MAX            7           /* GPIOA - GPIOG */
+static GPIO_TypeDef *s_KeyPort[KEY_PORT_MAX];   /* 按键用到的GPIO端口, 不重复 */
+static uint8_t s_ucKeyPortNum;
+static uint8_t s_ucKeyPortIdx[HARD_KEY_NUM];    /* 按键所在端口在 s_KeyPort[] 中的序号 */
+static uint8_t s_ucKeyPinPos[HARD_KEY_NUM];     /* 按键引脚号 0-15 */
+static uint32_t s_ulKeyInvert;                  /* ActiveLevel 为1的按键, 和 KeyPinActive() 原来的判断相同 */
+
+/*
+    垂直计数器消抖: 每个按键占下面每个变量的1位, 所有按键用几条位运算同时完成滤波。
+    s_ulKeyCnt1:s_ulKeyCnt0 是每个按键的2位计数器, 采样值和 s_ulKeyState 不同时计数, 相同时清零,
+    连续4次(40ms)不同才翻转 s_ulKeyState。
+*/
+static uint32_t s_ulKeyState;       /* 滤波后的按键状态, 1表示按下 */
+static uint32_t s_ulKeyCnt0;        /* 计数器低位 */
+static uint32_t s_ulKeyCnt1;        /* 计数器高位 */
+static uint32_t s_ulKeyTimer;       /* 长按、连发或双击正在计时的按键 */
+
+#if KEY_EXTI_EN == 1
+	static uint16_t s_usKeyExtiMask;        /* 按键用到的EXTI线。0 表示不能使用外部中断, 一直轮询 */
+	static volatile uint8_t s_ucKeyArmed;   /* 1 表示已停止扫描, 等待按键外部中断唤醒 */
+#endif
+
+static KEY_T s_tBtn[KEY_COUNT];
+static KEY_QUEUE_T s_tKey;		/* 按键事件队列 */
+static KEY_READER_T s_tKeyReader1;	/* bsp_GetKey() 的读指针 */
+static KEY_READER_T s_tKeyReader2;	/* bsp_GetKey2() 的读指针 */
+
+static void bsp_InitKeyVar(void);
+static void bsp_InitKeyHard(void);
+static void bsp_DetectKey(uint8_t i, uint32_t _ulToggle);
+static uint8_t KeyIsSettled(void);
+static void KeyPutEvent(uint8_t _id, uint8_t _type);
+#if KEY_EXTI_EN == 1
+	static void bsp_InitKeyExti(void);
+	static void bsp_KeyExtiArm(void);
+#endif
+
+/* 用于按键超时进入屏保 */
+static int32_t s_KeyTimeOutCount = 0;
+static uint8_t s_LcdOn = 1;
+
+/*
+*********************************************************************************************************
+*    函 数 名: KeyReadHard
+*    功能说明: 读取实体按键引脚的当前状态(未滤波), 不区分单键和组合键
+*    形    参: 无
+*    返 回 值: 按位表示的实体按键状态, bit n 对应 s_gpio_list[n], 1表示按下
+*********************************************************************************************************
+*/
+static uint32_t KeyReadHard(void)
+{
+    uint16_t idr[KEY_PORT_MAX];
+    uint32_t hard;
+    uint8_t i;
+
+    for (i = 0; i < s_ucKeyPortNum; i++)
+    {
+        idr[i] = (uint16_t)s_KeyPort[i]->IDR;
+    }
+
+    hard = 0;
+    for (i = 0; i < HARD_KEY_NUM; i++)
+    {
+        hard |= (uint32_t)((idr[s_ucKeyPortIdx[i]] >> s_ucKeyPinPos[i]) & 1) << i;
+    }
+    return hard ^ s_ulKeyInvert;
+}
+
+/*
+*********************************************************************************************************
+*    函 数 名: KeyReadAll
+*    功能说明: 读取所有按键的当前状态(未滤波)。单键和组合键区分, 单键事件不允许有其他键按下。
+*    形    参: 无
+*    返 回 值: 按位表示的按键状态, bit n 对应按键ID n, 1表示按下
+*********************************************************************************************************
+*/
+static uint32_t KeyReadAll(void)
+{
+    uint32_t hard;
+    uint32_t all;
+    uint8_t i;
+
+    hard = KeyReadHard();
+
+    /* 实体单键, 只有1个键按下时才有效 */
+    all = ((hard & (hard - 1)) == 0) ? hard : 0;
+
+    /* 组合键 */
+    for (i = 0; i < KEY_COUNT - HARD_KEY_NUM; i++)
+    {
+        if ((hard & s_ulComboMask[i]) == s_ulComboMask[i])
+        {
+            all |= 1UL << (HARD_KEY_NUM + i);
+        }
+    }
+
+    return all;
+}
+
+/*
+*********************************************************************************************************
+*    函 数 名: bsp_InitKey
+*    功能说明: 初始化按键. 该函数被 bsp_Init() 调用。
+*    形    参: 无
+*    返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_InitKey(void)
+{
+    bsp_InitKeyVar();   /* 初始化按键变量 */
+    bsp_InitKeyHard();  /* 初始化按键硬件 */
+}
+
+/*
+*********************************************************************************************************
+*    函 数 名: bsp_InitKeyHard
+*    功能说明: 配置按键对应的GPIO, 生成按键引脚查表
+*    形    参:  无
+*    返 回 值: 无
+*********************************************************************************************************
+*/
+static void bsp_InitKeyHard(void)
+{
+    GPIO_InitTypeDef gpio_init;
+    uint8_t j;
+
+    /* 第1步：配置所有的按键GPIO为浮动输入模式(实际上CPU复位后就是输入状态) */
+    gpio_init.GPIO_Mode = GPIO_Mode_IN_FLOATING;               /* 设置输入 */
+    gpio_init.GPIO_Speed = GPIO_Speed_50MHz;    /* GPIO速度等级 */
+
+    s_ucKeyPortNum = 0;
+    s_ulKeyInvert = 0;
+    for (uint8_t i = 0; i < HARD_KEY_NUM; i++)
+    {
+    	/* 第2步：打开GPIO时钟 */
+    	RCC_APB2PeriphClockCmd(s_gpio_list[i].clk, ENABLE);
+		
+        gpio_init.GPIO_Pin = s_gpio_list[i].pin;
+        GPIO_Init(s_gpio_list[i].gpio, &gpio_init);
+
+        /* 第3步：记录按键所在端口和引脚号, 同一端口的按键共用一次IDR读取 */
+        for (j = 0; j < s_ucKeyPortNum; j++)
+        {
+            if (s_KeyPort[j] == s_gpio_list[i].gpio)
+            {
+                break;
+            }
+        }
+        if (j == s_ucKeyPortNum)
+        {
+            s_KeyPort[s_ucKeyPortNum++] = s_gpio_list[i].gpio;
+        }
+        s_ucKeyPortIdx[i] = j;
+        s_ucKeyPinPos[i] = (uint8_t)(31 - __CLZ(s_gpio_list[i].pin));
+
+        if (s_gpio_list[i].ActiveLevel)
+        {
+            s_ulKeyInvert |= 1UL << i;
+        }
+    }
+
+#if KEY_EXTI_EN == 1
+    bsp_InitKeyExti();
+#endif
+}
+
+#if KEY_EXTI_EN == 1
+/*
+*********************************************************************************************************
+*    函 数 名: bsp_InitKeyExti
+*    功能说明: 配置按键引脚的外部中断, 上升沿和下降沿都触发。配置后中断是屏蔽的, 由 bsp_KeyExtiArm() 打开。
+*    形    参:  无
+*    返 回 值: 无
+*********************************************************************************************************
+*/
+static void bsp_InitKeyExti(void)
+{
+    EXTI_InitTypeDef exti_init;
+    IRQn_Type irq;
+    uint16_t mask;
+    uint8_t pos;
+    uint8_t i;
+
+    s_ucKeyArmed = 0;
+    s_usKeyExtiMask = 0;
+
+    /* 每条EXTI线只能选择一个端口, 引脚号重复时不使用外部中断 */
+    mask = 0;
+    for (i = 0; i < HARD_KEY_NUM; i++)
+    {
+        if (mask & s_gpio_list[i].pin)
+        {
+            return;
+        }
+        mask |= s_gpio_list[i].pin;
+    }
+
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_AFIO, ENABLE);
+
+    exti_init.EXTI_Mode = EXTI_Mode_Interrupt;
+    exti_init.EXTI_Trigger = EXTI_Trigger_Rising_Falling;  /* 按下和弹起都唤醒 */
+    exti_init.EXTI_LineCmd = ENABLE;
+
+    for (i = 0; i < HARD_KEY_NUM; i++)
+    {
+        pos = s_ucKeyPinPos[i];
+        GPIO_EXTILineConfig((uint8_t)(((uint32_t)s_gpio_list[i].gpio - GPIOA_BASE) / (GPIOB_BASE - GPIOA_BASE)), pos);
+
+        exti_init.EXTI_Line = s_gpio_list[i].pin;       /* EXTI_Linex 和 GPIO_Pin_x 的值相同 */
+        EXTI_Init(&exti_init);
+
+        if (pos <= 4)
+        {
+            irq = (IRQn_Type)(EXTI0_IRQn + pos);
+        }
+        else if (pos <= 9)
+        {
+            irq = EXTI9_5_IRQn;
+        }
+        else
+        {
+            irq = EXTI15_10_IRQn;
+        }
+
+        /*
+            和 SysTick 相同的最低优先级, 中断服务程序和 bsp_KeyScan10ms() 不会互相打断。
+            直接写优先级寄存器, 不受 NVIC_PriorityGroupConfig() 分组的影响 (bsp_InitUsb() 设置为分组1,
+            NVIC_Init() 的抢占优先级只能是0-1)。
+        */
+        NVIC_SetPriority(irq, (1 << __NVIC_PRIO_BITS) - 1);
+        NVIC_EnableIRQ(irq);
+    }
+
+    /* 先屏蔽, 按键扫描稳定后再打开 */
+    EXTI->IMR &= ~(uint32_t)mask;
+    EXTI->PR = mask;
+    s_usKeyExtiMask = mask;
+}
+
+/*
+*********************************************************************************************************
+*    函 数 名: bsp_KeyExtiArm
+*    功能说明: 停止按键扫描, 打开按键外部中断。在 bsp_KeyScan10ms() 中所有按键稳定后调用。
+*    形    参:  无
+*    返 回 值: 无
+*********************************************************************************************************
+*/
+static void bsp_KeyExtiArm(void)
+{
+    /*
+        清除扫描期间记录的边沿, 再采样一次, 避免漏掉最后一次采样到清除之间按下的按键。
+        按实体引脚判断: KeyReadAll() 在多个键同时按下(不是组合键)时返回0, 此时不能停止扫描。
+    */
+    EXTI->PR = s_usKeyExtiMask;
+    if (KeyReadHard() != 0)
+    {
+        return;
+    }
+
+    s_ucKeyArmed = 1;
+    EXTI->IMR |= s_usKeyExtiMask;
+}
+
+/*
+*********************************************************************************************************
+*    函 数 名: bsp_KeyExtiISR
+*    功能说明: 按键外部中断服务程序。屏蔽按键外部中断, 恢复每10ms扫描, 由扫描完成消抖和按键事件。
+*    形    参:  无
+*    返 回 值: 无
+*********************************************************************************************************
+*/
+static void bsp_KeyExtiISR(void)
+{
+    if (EXTI->PR & s_usKeyExtiMask)
+    {
+        EXTI->IMR &= ~(uint32_t)s_usKeyExtiMask;
+        EXTI->PR = s_usKeyExtiMask;
+        s_ucKeyArmed = 0;
+    }
+}
+
+/*
+*********************************************************************************************************
+*    函 数 名: EXTIx_IRQHandler
+*    功能说明: 外部中断服务程序。其他模块也使用外部中断时, 需要在这里增加对应的处理。
+*    形    参:  无
+*    返 回 值: 无
+*********************************************************************************************************
+*/
+void EXTI0_IRQHandler(void)
+{
+    bsp_KeyExtiISR();
+}
+
+void EXTI1_IRQHandler(void)
+{
+    bsp_KeyExtiISR();
+}
+
+void EXTI2_IRQHandler(void)
+{
+    bsp_KeyExtiISR();
+}
+
+void EXTI3_IRQHandler(void)
+{
+    bsp_KeyExtiISR();
+}
+
+void EXTI4_IRQHandler(void)
+{
+    bsp_KeyExtiISR();
+}
+
+void EXTI9_5_IRQHandler(void)
+{
+    bsp_KeyExtiISR();
+}
+
+void EXTI15_10_IRQHandler(void)
+{
+    bsp_KeyExtiISR();
+}
+#endif
+/*
+*********************************************************************************************************
+*    函 数 名: bsp_InitKeyVar
+*    功能说明: 初始化按键变量
+*    形    参:  无
+*    返 回 值: 无
+*********************************************************************************************************
+*/
+static void bsp_InitKeyVar(void)
+{
+    uint8_t i;
+
+    /* 按键事件队列清零 */
+    s_tKey.Head = 0;
+    bsp_KeyInitReader(&s_tKeyReader1);
+    bsp_KeyInitReader(&s_tKeyReader2);
+
+    /* 所有按键弹起, 滤波计数器清零 */
+    s_ulKeyState = 0;
+    s_ulKeyCnt0 = 0;
+    s_ulKeyCnt1 = 0;
+    s_ulKeyTimer = 0;
+
+    /* 给每个按键结构体成员变量赋一组缺省值 */
+    for (i = 0; i < KEY_COUNT; i++)
+    {
+        s_tBtn[i].LongTime = KEY_LONG_TIME;         /* 长按时间 0 表示不检测长按键事件 */
+        s_tBtn[i].State = 0;                        /* 按键缺省状态，0为未按下 */
+        s_tBtn[i].RepeatSpeed = 0;                  /* 按键连发的速度，0表示不支持连发 */
+        s_tBtn[i].Timer = 0;                        /* 长按和连发计时 */
+        s_tBtn[i].DelayCount = 0;
+        s_tBtn[i].ClickCount = 0;
+    }
+
+    /* 如果需要单独更改某个按键的参数，可以在此单独重新赋值 */
+
+    /* 摇杆上下左右，支持长按1秒后，自动连发 */
+    bsp_SetKeyParam(KID_K1, KEY_LONG_TIME, 0);
+    bsp_SetKeyParam(KID_K2, KEY_LONG_TIME, 0);
+    bsp_SetKeyParam(KID_K3, KEY_LONG_TIME, 0);
+}
+
+/*
+*********************************************************************************************************
+*    函 数 名: KeyPutEvent
+*    功能说明: 将1个按键事件写入事件队列, 记录当前时刻。队列满时覆盖最旧的事件, 落后的读者在读取时
+*              统计丢失的个数。队列只有一个写入者: bsp_KeyScan10ms() 所在的上下文。
+*    形    参: _id : 按键ID
+*              _type : 事件类型 KEY_EVT_DOWN 等
+*    返 回 值: 无
+*********************************************************************************************************
+*/
+static void KeyPutEvent(uint8_t _id, uint8_t _type)
+{
+    KEY_EVENT_T *pEvent;
+    uint32_t head;
+
+    head = s_tKey.Head;
+    pEvent = &s_tKey.Buf[head & (KEY_EVT_SIZE - 1)];
+    pEvent->TimeUs = (uint32_t)bsp_GetTimeUs64();
+    pEvent->Code = (uint8_t)(KEY_MSG_STEP * _id + _type);
+    pEvent->KeyId = _id;
+    pEvent->Type = _type;
+
+    __DMB();                /* 先写完事件, 再移动写索引 */
+    s_tKey.Head = head + 1;
+}
+
+/*
+*********************************************************************************************************
+*    函 数 名: bsp_PutKey
+*    功能说明: 将1个键值压入按键事件队列。可用于模拟一个按键。
+*              队列的写索引只能由一个执行环境修改, 模拟按键时请在 bsp_KeyScan10ms() 所在的上下文中调用。
+*    形    参:  _KeyCode : 按键代码
+*    返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_PutKey(uint8_t _KeyCode)
+{
+    if (_KeyCode == KEY_NONE)
+    {
+        return;
+    }
+    KeyPutEvent((uint8_t)((_KeyCode - 1) / KEY_MSG_STEP), (uint8_t)((_KeyCode - 1) % KEY_MSG_STEP + 1));
+}
+
+/*
+*********************************************************************************************************
+*    函 数 名: bsp_KeyInitReader
+*    功能说明: 初始化一个按键事件读者。读者从调用时刻开始接收事件, 各读者互不影响。
+*              读者个数不限, KEY_READER_T 由调用者分配(一般是静态变量)。写入者不访问读者, 读者不需要注销。
+*    形    参: _pReader : 读者
+*    返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_KeyInitReader(KEY_READER_T *_pReader)
+{
+    _pReader->Tail = s_tKey.Head;
+    _pReader->Dropped = 0;
+}
+
+/*
+*********************************************************************************************************
+*    函 数 名: bsp_KeyReadEvent
+*    功能说明: 读取一个按键事件。每个读者只能在一个执行环境中读取, 不需要关中断。
+*              读者落后超过 KEY_EVT_SIZE - 1 个事件时, 跳到最旧的有效事件, 丢失的个数累加到 Dropped。
+*    形    参: _pReader : 读者
+*              _pEvent : 读到的事件
+*    返 回 值: 1 表示读到事件, 0 表示没有新事件
+*********************************************************************************************************
+*/
+uint8_t bsp_KeyReadEvent(KEY_READER_T *_pReader, KEY_EVENT_T *_pEvent)
+{
+    uint32_t head;
+    uint32_t tail;
+
+    tail = _pReader->Tail;
+    for (;;)
+    {
+        head = s_tKey.Head;
+        if (head == tail)
+        {
+            return 0;
+        }
+
+        /* 写入者下一次写的位置是 head, 至少保留1个, 复制期间不会被覆盖 */
+        if (head - tail > KEY_EVT_SIZE - 1)
+        {
+            _pReader->Dropped += head - tail - (KEY_EVT_SIZE - 1);
+            tail = head - (KEY_EVT_SIZE - 1);
+        }
+
+        __DMB();
+        *_pEvent = s_tKey.Buf[tail & (KEY_EVT_SIZE - 1)];
+        __DMB();
+
+        /* 复制期间写入者又写了很多事件, 这个事件可能已经被覆盖, 重读 */
+        if (s_tKey.Head - tail <= KEY_EVT_SIZE - 1)
+        {
+            break;
+        }
+    }
+
+    _pReader->Tail = tail + 1;
+    return 1;
+}
+
+/*
+*********************************************************************************************************
+*    函 数 名: bsp_GetKey
+*    功能说明: 从按键事件队列读取一个键值。
+*    形    参: 无
+*    返 回 值: 按键代码
+*********************************************************************************************************
+*/
+uint8_t bsp_GetKey(void)
+{
+    KEY_EVENT_T event;
+
+    if (bsp_KeyReadEvent(&s_tKeyReader1, &event) == 0)
+    {
+        return KEY_NONE;
+    }
+    return event.Code;
+}
+
+/*
+*********************************************************************************************************
+*    函 数 名: bsp_GetKey2
+*    功能说明: 从按键事件队列读取一个键值。独立的读指针, 和 bsp_GetKey() 互不影响。
+*    形    参:  无
+*    返 回 值: 按键代码
+*********************************************************************************************************
+*/
+uint8_t bsp_GetKey2(void)
+{
+    KEY_EVENT_T event;
+
+    if (bsp_KeyReadEvent(&s_tKeyReader2, &event) == 0)
+    {
+        return KEY_NONE;
+    }
+    return event.Code;
+}
+
+/*
+*********************************************************************************************************
+*    函 数 名: bsp_SetKeyParam
+*    功能说明: 设置按键参数
+*    形    参：_ucKeyID : 按键ID，从0开始
+*            _LongTime : 长按事件时间
+*             _RepeatSpeed : 连发速度
+*    返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_SetKeyParam(uint8_t _ucKeyID, uint16_t _LongTime, uint8_t _RepeatSpeed)
+{
+    s_tBtn[_ucKeyID].LongTime = _LongTime;             /* 长按时间 0 表示不检测长按键事件 */
+    s_tBtn[_ucKeyID].RepeatSpeed = _RepeatSpeed; /* 按键连发的速度，0表示不支持连发 */
+}
+
+/*
+*********************************************************************************************************
+*    函 数 名: bsp_ClearKey
+*    功能说明: 清空 bsp_GetKey() 未读的键值。不影响其他读者。
+*    形    参：无
+*    返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_ClearKey(void)
+{
+    s_tKeyReader1.Tail = s_tKey.Head;
+}
+
+/*
+*********************************************************************************************************
+*    函 数 名: bsp_GetKeyState
+*    功能说明: 读取按键滤波后的状态
+*    形    参: _ucKeyID : 按键ID，从0开始
+*    返 回 值: 1 表示按下， 0 表示未按下
+*********************************************************************************************************
+*/
+uint8_t bsp_GetKeyState(KEY_ID_E _ucKeyID)
+{
+    return (uint8_t)((s_ulKeyState >> _ucKeyID) & 1);
+}
+
+/*
+*********************************************************************************************************
+*    函 数 名: KeyIsSettled
+*    功能说明: 判断按键是否稳定：所有按键都已弹起且滤波完成，没有计时中的事件。
+*    形    参：无
+*    返 回 值: 1 表示稳定
+*********************************************************************************************************
+*/
+static uint8_t KeyIsSettled(void)
+{
+    if (s_KeyTimeOutCount > 0)
+    {
+        return 0;
+    }
+
+    if ((s_ulKeyState | s_ulKeyCnt0 | s_ulKeyCnt1 | s_ulKeyTimer) != 0)
+    {
+        return 0;
+    }
+    return 1;
+}
+
+/*
+*********************************************************************************************************
+*    函 数 名: bsp_KeyIsIdle
+*    功能说明: 判断按键扫描是否处于空闲状态。
+*              KEY_EXTI_EN = 1 时空闲表示扫描已停止、等待按键外部中断，不需要调用 bsp_KeyScan10ms()；
+*              否则表示所有按键稳定，bsp_KeyScan10ms() 可以降低扫描频率(见 bsp_timer.h 中的 TMR_IDLE_PER10MS_TIME)。
+*              用于低功耗休眠。
+*    形    参：无
+*    返 回 值: 1 表示空闲，0 表示需要继续每10ms扫描
+*********************************************************************************************************
+*/
+uint8_t bsp_KeyIsIdle(void)
+{
+#if KEY_EXTI_EN == 1
+    return s_ucKeyArmed;
+#else
+    return KeyIsSettled();
+#endif
+}
+
+/*
+*********************************************************************************************************
+*    函 数 名: bsp_DetectKey
+*    功能说明: 处理一个按键的事件。只对滤波后状态变化或正在计时的按键调用。
+*    形    参: i : 按键ID， 从0开始编码
+*              _ulToggle : 本次扫描滤波后状态变化的按键, 按位表示
+*    返 回 值: 无
+*********************************************************************************************************
+*/
+static void bsp_DetectKey(uint8_t i, uint32_t _ulToggle)
+{
+    KEY_T *pBtn;
+    uint32_t bit;
+
+    pBtn = &s_tBtn[i];
+    bit = 1UL << i;
+
+    #if DOUBLE_CLICK_ENABLE == 1
+        /* 超时判断 */
+        if (pBtn->DelayCount > 0)
+        {
+            if (--pBtn->DelayCount == 0)
+            {
+                if (pBtn->ClickCount == 1)
+                {
+                    KeyPutEvent(i, KEY_EVT_UP);   /* 单击弹起 */
+                }
+                pBtn->ClickCount = 0;
+            }
+        }
+    #endif
+
+    if (_ulToggle & bit)
+    {
+        if (s_ulKeyState & bit)
+        {
+            pBtn->State = 1;
+
+            /* 发送按钮按下的消息 */
+            KeyPutEvent(i, KEY_EVT_DOWN);
+
+            pBtn->Timer = pBtn->LongTime;   /* 开始长按计时, 0表示不检测长按 */
+        }
+        else
+        {
+            /* 2019-12-05 H7-TOOL增加，第4个事件, 长按后的弹起 */
+            if (pBtn->LongTime == 0)
+            {
+                /* 发送短按弹起的消息 */
+                KeyPutEvent(i, KEY_EVT_UP);
+            }
+            else if (pBtn->State == 2)
+            {
+                /* 发送长按弹起的消息 */
+                KeyPutEvent(i, KEY_EVT_LONG_UP);
+            }
+            else
+            {
+                #if DOUBLE_CLICK_ENABLE == 1
+                    if (pBtn->DelayCount > 0)
+                    {
+                        if (pBtn->ClickCount == 1)
+                        {
+                            KeyPutEvent(i, KEY_EVT_DB_UP);  /* 双击事件 */
+                        }
+                        else
+                        {
+                            KeyPutEvent(i, KEY_EVT_UP);     /* 单击弹起事件 */
+                        }
+                        pBtn->ClickCount = 0;
+                        pBtn->DelayCount = 80;
+                    }
+                    else
+                    {
+                        pBtn->ClickCount++;
+                        pBtn->DelayCount = KEY_DB_CLICK_TIME;
+                    }
+                #else
+                    KeyPutEvent(i, KEY_EVT_UP);     /* 单击弹起事件 */
+                #endif
+            }
+            pBtn->State = 0;
+            pBtn->Timer = 0;
+        }
+    }
+    else if (pBtn->Timer > 0)
+    {
+        if (--pBtn->Timer == 0)
+        {
+            if (pBtn->State == 1)
+            {
+                pBtn->State = 2;
+
+                /* 发送长按消息 */
+                KeyPutEvent(i, KEY_EVT_LONG_DOWN);
+            }
+            else
+            {
+                /* 常按键后，每隔 RepeatSpeed 发送1个自动发码事件 */
+                KeyPutEvent(i, KEY_EVT_AUTO_UP);
+            }
+            pBtn->Timer = pBtn->RepeatSpeed;    /* 0表示不支持连发, 停止计时 */
+        }
+    }
+
+    /* 更新计时标志, 计时结束的按键以后不再处理, 直到状态再次变化 */
+    if (pBtn->Timer > 0 || pBtn->DelayCount > 0)
+    {
+        s_ulKeyTimer |= bit;
+    }
+    else
+    {
+        s_ulKeyTimer &= ~bit;
+    }
+}
+
+/*
+*********************************************************************************************************
+*    函 数 名: bsp_KeyScan10ms
+*    功能说明: 扫描所有按键。非阻塞，被systick中断周期性的调用，10ms一次。
+*              所有按键用垂直计数器同时滤波, 只有状态变化或正在计时的按键才调用 bsp_DetectKey(),
+*              按键都不动作时执行时间和按键个数基本无关。
+*              KEY_EXTI_EN = 1 时按键稳定后停止扫描, 直到按键外部中断唤醒。
+*    形    参: 无
+*    返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_KeyScan10ms(void)
+{
+    uint32_t delta;
+    uint32_t toggle;
+    uint32_t pending;
+    uint8_t i;
+
+#if KEY_EXTI_EN == 1
+    if (s_ucKeyArmed)
+    {
+        return;     /* 等待按键外部中断 */
+    }
+#endif
+
+    /* 采样值和滤波后状态不同的位计数, 相同的位清零。计数器从3回到0时翻转状态 */
+    delta = KeyReadAll() ^ s_ulKeyState;
+    s_ulKeyCnt1 = (s_ulKeyCnt1 ^ s_ulKeyCnt0) & delta;
+    s_ulKeyCnt0 = ~s_ulKeyCnt0 & delta;
+    toggle = delta & ~(s_ulKeyCnt0 | s_ulKeyCnt1);
+    s_ulKeyState ^= toggle;
+
+    /* 只处理状态变化和正在计时的按键 */
+    pending = toggle | s_ulKeyTimer;
+    while (pending)
+    {
+        i = (uint8_t)(31 - __CLZ(pending));
+        pending &= ~(1UL << i);
+
+        bsp_DetectKey(i, toggle);
+    }
+
+    if (s_KeyTimeOutCount > 0)
+    {
+        if (--s_KeyTimeOutCount == 0)
+        {
+//            LCD_SetBackLight(0);        /* 关闭背光 */
+//            g_LcdSleepReq = 1;          /* 控制LCD休眠, 在bsp_Idle执行. 不可以在此调用 LCD_DispOff() */
+            s_LcdOn = 0;                /* 屏幕关闭 */
+        }
+    }
+
+#if KEY_EXTI_EN == 1
+    if (s_usKeyExtiMask != 0 && KeyIsSettled())
+    {
+        bsp_KeyExtiArm();
+    }
+#endif
+}
+
+/***************************** 安富莱电子 www.armfly.com (END OF FILE) *********************************/
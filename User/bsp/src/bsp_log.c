@@ -0,0 +1,312 @@
+/*
+*********************************************************************************************************
+*
+*	模块名称 : 二进制日志模块
+*	文件名称 : bsp_log.c
+*	版    本 : V1.3
+*	说    明 : 延迟格式化的日志。记录时只保存格式字符串地址、时间戳和32位参数, 约几十个时钟周期;
+*				格式化由PC端的 Tools/log_decode.py 完成。帧格式见 bsp_log.h。
+*
+*				任意中断和主程序都可以调用 bsp_Log(), 写缓冲区时短暂关中断; 只有主程序调用 bsp_LogPoll()
+*				(由 bsp_Idle() 调用), 每次只发送串口发送缓冲区放得下的完整帧, 每帧的取出和发送也短暂关中断。缓冲区满时丢弃新日志并计数,
+*				丢弃的条数作为一条特殊日志发出。
+*
+*	修改记录 :
+*		版本号  日期        作者     说明
+*		V1.0    2026-10-17          正式发布
+*		V1.1    2026-10-17          增加 bsp_LogFlush, 死机前以查询方式发出全部日志。
+*		V1.2    2026-10-17          bsp_LogFlush 用自己的帧缓冲区; bsp_LogPoll 关中断取出并发送每一帧,
+*									在中断中执行 bsp_LogFlush 时不会和它同时修改 s_ucLogOut。
+*		V1.3    2026-10-17          USB复合设备时日志从 USB_COM2 发出 (LOG_USB_EN)。
+*
+*	Copyright (C), 2013-2014, 安富莱电子 www.armfly.com
+*
+*********************************************************************************************************
+*/
+
+#include "bsp.h"
+#include <stdarg.h>
+
+#if LOG_EN == 1
+
+/* bsp_LogPoll() 的输出通道, 见 bsp_log.h 中 LOG_USB_EN 的说明 */
+#if LOG_USB_EN == 1
+	#include "hw_config.h"
+
+	#define LogTxFree()				usb_PortTxFree(USB_COM2)
+	#define LogTxSend(_pBuf, _usLen)	usb_PortSend(USB_COM2, _pBuf, _usLen, USB_TX_PARTIAL)
+#else
+	#define LogTxFree()				comGetTxFree(LOG_COM)
+	#define LogTxSend(_pBuf, _usLen)	comSendBufNoWait(LOG_COM, _pBuf, _usLen)
+#endif
+
+static RING_T s_tLogRing;
+static uint8_t s_ucLogBuf[LOG_BUF_SIZE];
+static volatile uint32_t s_ulLogDropped;	/* 缓冲区满丢弃的日志条数, 只由 bsp_LogWrite() 修改 */
+static uint32_t s_ulLogReported;			/* 已经发出丢弃通知的条数 */
+
+/* bsp_LogPoll() 取出但串口放不下、等待发送的帧, 只在关中断时访问 */
+static uint8_t s_ucLogOut[LOG_FRAME_SIZE(LOG_MAX_ARGS)];
+static uint16_t s_usLogOutLen;
+
+/*
+*********************************************************************************************************
+*	函 数 名: LogPutWord
+*	功能说明: 按小端格式写入32位数
+*	形    参: _pBuf : 缓冲区
+*			  _ulValue : 数值
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void LogPutWord(uint8_t *_pBuf, uint32_t _ulValue)
+{
+	_pBuf[0] = (uint8_t)_ulValue;
+	_pBuf[1] = (uint8_t)(_ulValue >> 8);
+	_pBuf[2] = (uint8_t)(_ulValue >> 16);
+	_pBuf[3] = (uint8_t)(_ulValue >> 24);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: LogSetHead
+*	功能说明: 填写帧头, 计算校验和
+*	形    参: _pBuf : 帧缓冲区, 参数已经填好
+*			  _ucArgs : 参数个数
+*			  _ulFmt : 格式字符串地址
+*	返 回 值: 帧长度
+*********************************************************************************************************
+*/
+static uint16_t LogSetHead(uint8_t *_pBuf, uint8_t _ucArgs, uint32_t _ulFmt)
+{
+	uint16_t usLen;
+	uint16_t i;
+	uint8_t ucSum;
+
+	_pBuf[0] = LOG_SYNC;
+	_pBuf[1] = _ucArgs;
+	LogPutWord(&_pBuf[2], _ulFmt);
+	LogPutWord(&_pBuf[6], (uint32_t)bsp_GetTimeUs64());
+
+	usLen = LOG_FRAME_SIZE(_ucArgs);
+	ucSum = 0;
+	for (i = 1; i < usLen - 1; i++)
+	{
+		ucSum += _pBuf[i];
+	}
+	_pBuf[usLen - 1] = (uint8_t)~ucSum;
+	return usLen;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_InitLog
+*	功能说明: 初始化日志缓冲区。应在 bsp_Log() 第一次调用前执行, 之前的日志被丢弃。
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_InitLog(void)
+{
+	bsp_RingInit(&s_tLogRing, s_ucLogBuf, LOG_BUF_SIZE);
+	s_ulLogDropped = 0;
+	s_ulLogReported = 0;
+	s_usLogOutLen = 0;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_LogWrite
+*	功能说明: 记录一条日志。一般用 bsp_Log() 宏调用, 由宏计算参数个数。可以在中断服务程序中调用。
+*	形    参: _ucArgs : 参数个数, 超过 LOG_MAX_ARGS 的部分被忽略
+*			  _pFmt : 格式字符串, 必须是常量字符串
+*			  ... : 参数, 每个都按32位读取
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_LogWrite(uint8_t _ucArgs, const char *_pFmt, ...)
+{
+	uint8_t aFrame[LOG_FRAME_SIZE(LOG_MAX_ARGS)];
+	va_list ap;
+	uint16_t usLen;
+	uint32_t ulPrimask;
+	uint8_t i;
+
+	if (_ucArgs > LOG_MAX_ARGS)
+	{
+		_ucArgs = LOG_MAX_ARGS;
+	}
+
+	va_start(ap, _pFmt);
+	for (i = 0; i < _ucArgs; i++)
+	{
+		LogPutWord(&aFrame[LOG_HEAD_SIZE + 4 * i], va_arg(ap, uint32_t));
+	}
+	va_end(ap);
+
+	usLen = LogSetHead(aFrame, _ucArgs, (uint32_t)_pFmt);
+
+	/*
+		多个中断都可能写日志, 写缓冲区时关中断。可能在关中断状态下被调用(例如 bsp_StepTick() 中的
+		10ms任务), 所以保存并恢复 PRIMASK, 不能用 DISABLE_INT() / ENABLE_INT()。
+	*/
+	ulPrimask = __get_PRIMASK();
+	__disable_irq();
+	if (bsp_RingFree(&s_tLogRing) >= usLen)
+	{
+		bsp_RingPut(&s_tLogRing, aFrame, usLen);
+	}
+	else
+	{
+		s_ulLogDropped++;
+	}
+	__set_PRIMASK(ulPrimask);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: LogGetFrame
+*	功能说明: 取出下一帧。有丢弃的日志时先生成报告丢弃条数的帧, 否则从缓冲区取出一帧。必须关中断调用,
+*			  缓冲区的读索引总是停在帧的边界上。
+*	形    参: _pFrame : 存放帧的缓冲区, 至少 LOG_FRAME_SIZE(LOG_MAX_ARGS) 字节
+*	返 回 值: 帧长度, 0 表示没有日志
+*********************************************************************************************************
+*/
+static uint16_t LogGetFrame(uint8_t *_pFrame)
+{
+	uint32_t ulDropped;
+	uint16_t usLen;
+
+	ulDropped = s_ulLogDropped - s_ulLogReported;
+	if (ulDropped > 0)
+	{
+		LogPutWord(&_pFrame[LOG_HEAD_SIZE], ulDropped);
+		s_ulLogReported += ulDropped;
+		return LogSetHead(_pFrame, 1, 0);
+	}
+
+	/* 帧是整体写入缓冲区的, 有帧头就有完整的帧 */
+	if (bsp_RingGet(&s_tLogRing, _pFrame, 2) == 0)
+	{
+		return 0;
+	}
+	usLen = LOG_FRAME_SIZE(_pFrame[1]);
+	bsp_RingGet(&s_tLogRing, &_pFrame[2], usLen - 2);
+	return usLen;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: LogSendNext
+*	功能说明: 发送 s_ucLogOut 中的帧, 没有时先取出下一帧。必须关中断调用。
+*	形    参: 无
+*	返 回 值: 1 表示发送了一帧, 0 表示没有日志或发送缓冲区放不下
+*********************************************************************************************************
+*/
+static uint8_t LogSendNext(void)
+{
+	if (s_usLogOutLen == 0)
+	{
+		s_usLogOutLen = LogGetFrame(s_ucLogOut);
+		if (s_usLogOutLen == 0)
+		{
+			return 0;
+		}
+	}
+
+	if (LogTxFree() < s_usLogOutLen)
+	{
+		return 0;
+	}
+	LogTxSend(s_ucLogOut, s_usLogOutLen);
+	s_usLogOutLen = 0;
+	return 1;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_LogPoll
+*	功能说明: 把缓冲区中的日志发送到串口 (LOG_USB_EN = 1 时发送到 USB_COM2)。非阻塞, 只发送放得下的完整帧。
+*			  由 bsp_Idle() 调用, 不能在中断中调用。
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_LogPoll(void)
+{
+	uint32_t ulPrimask;
+	uint8_t ucSent;
+
+	do
+	{
+		/*
+			bsp_LogFlush() 可能在中断中打断这里。每一帧的取出和发送都在关中断状态下完成 (最多几十个字节),
+			它看到的 s_ucLogOut 和缓冲区读索引总是一致的。
+		*/
+		ulPrimask = __get_PRIMASK();
+		DISABLE_INT();
+		ucSent = LogSendNext();
+		__set_PRIMASK(ulPrimask);
+	} while (ucSent);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_LogFlush
+*	功能说明: 以查询方式把缓冲区中的全部日志发到串口, 等待发送完毕后返回。不依赖中断, 关中断或在中断中
+*			  也能执行。用于 BSP_Printf() 之后死机的地方, 否则错误信息留在缓冲区中, 永远不会发出。
+*			  取出的帧放在自己的栈上, 不使用 bsp_LogPoll() 的 s_ucLogOut。
+*			  LOG_USB_EN = 1 时也从串口 LOG_COM 发出, 已经写入USB发送FIFO的日志不再重发。
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_LogFlush(void)
+{
+	uint8_t aFrame[LOG_FRAME_SIZE(LOG_MAX_ARGS)];
+	uint32_t ulPrimask;
+	uint16_t usLen;
+
+	ulPrimask = __get_PRIMASK();
+	DISABLE_INT();
+
+	/* bsp_LogPoll() 已经取出、因为串口放不下还没发送的帧是最早的, 先发 */
+	usLen = s_usLogOutLen;
+	s_usLogOutLen = 0;
+	if (usLen == 0)
+	{
+		usLen = LogGetFrame(aFrame);
+	}
+	else
+	{
+		memcpy(aFrame, s_ucLogOut, usLen);
+	}
+
+	while (usLen != 0)
+	{
+		if (comGetTxFree(LOG_COM) < usLen)
+		{
+			comFlushTxPoll(LOG_COM);	/* 查询方式发完, 腾出空间 */
+		}
+		comSendBufNoWait(LOG_COM, aFrame, usLen);
+		usLen = LogGetFrame(aFrame);
+	}
+	comFlushTxPoll(LOG_COM);
+	__set_PRIMASK(ulPrimask);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_LogGetDropped
+*	功能说明: 读取缓冲区满丢弃的日志条数
+*	形    参: 无
+*	返 回 值: 累计条数
+*********************************************************************************************************
+*/
+uint32_t bsp_LogGetDropped(void)
+{
+	return s_ulLogDropped;
+}
+
+#endif
+
+/***************************** 安富莱电子 www.armfly.com (END OF FILE) *********************************/
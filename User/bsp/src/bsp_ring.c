@@ -0,0 +1,310 @@
+/*
+*********************************************************************************************************
+*
+*	模块名称 : 环形缓冲区模块
+*	文件名称 : bsp_ring.c
+*	版    本 : V1.0
+*	说    明 : 单生产者/单消费者无锁环形缓冲区。供串口FIFO、USB虚拟串口FIFO、按键FIFO使用。
+*
+*				生产者只写 usHead, 消费者只写 usTail。先写数据再发布 usHead, 先读数据再释放 usTail,
+*				中间用 __DMB() 保证访问顺序, 所以中断和主程序分别作为两端时不需要关中断。
+*
+*	修改记录 :
+*		版本号  日期        作者     说明
+*		V1.0    2026-10-17          正式发布
+*
+*	Copyright (C), 2013-2014, 安富莱电子 www.armfly.com
+*
+*********************************************************************************************************
+*/
+
+#include "bsp_ring.h"
+#include <string.h>
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_RingInit
+*	功能说明: 初始化环形缓冲区
+*	形    参: _pRing : 环形缓冲区
+*			  _pBuf : 数据缓冲区
+*			  _usSize : 缓冲区大小, 必须是2的整数次幂 (最大 32768)
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_RingInit(RING_T *_pRing, uint8_t *_pBuf, uint16_t _usSize)
+{
+	assert_param(_usSize != 0 && (_usSize & (_usSize - 1)) == 0 && _usSize <= 32768);
+
+	_pRing->pBuf = _pBuf;
+	_pRing->usSize = _usSize;
+	_pRing->usMask = _usSize - 1;
+	_pRing->usHead = 0;
+	_pRing->usTail = 0;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_RingCount
+*	功能说明: 读取缓冲区中的数据个数。生产者和消费者都可以调用。
+*	形    参: _pRing : 环形缓冲区
+*	返 回 值: 数据个数
+*********************************************************************************************************
+*/
+uint16_t bsp_RingCount(RING_T *_pRing)
+{
+	return (uint16_t)(_pRing->usHead - _pRing->usTail);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_RingFree
+*	功能说明: 读取缓冲区的剩余空间。生产者和消费者都可以调用。
+*	形    参: _pRing : 环形缓冲区
+*	返 回 值: 剩余空间字节数
+*********************************************************************************************************
+*/
+uint16_t bsp_RingFree(RING_T *_pRing)
+{
+	return _pRing->usSize - (uint16_t)(_pRing->usHead - _pRing->usTail);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_RingReserveSpan
+*	功能说明: 取得从写索引开始的一段连续空闲空间, 生产者可以直接在其中填写数据, 再调用 bsp_RingCommit 发布。
+*	形    参: _pRing : 环形缓冲区
+*			  _ppData : 返回连续空闲空间的首地址
+*	返 回 值: 连续空闲空间字节数, 0 表示缓冲区满
+*********************************************************************************************************
+*/
+uint16_t bsp_RingReserveSpan(RING_T *_pRing, uint8_t **_ppData)
+{
+	uint16_t usHead;
+	uint16_t usFree;
+	uint16_t usSpan;
+
+	usHead = _pRing->usHead;
+	usFree = _pRing->usSize - (uint16_t)(usHead - _pRing->usTail);
+	usSpan = _pRing->usSize - (usHead & _pRing->usMask);	/* 写索引到缓冲区末尾 */
+	if (usSpan > usFree)
+	{
+		usSpan = usFree;
+	}
+
+	*_ppData = &_pRing->pBuf[usHead & _pRing->usMask];
+	return usSpan;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_RingCommit
+*	功能说明: 发布生产者已经写入的数据
+*	形    参: _pRing : 环形缓冲区
+*			  _usLen : 数据个数, 不能超过剩余空间
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_RingCommit(RING_T *_pRing, uint16_t _usLen)
+{
+	__DMB();	/* 数据写完之后才能让消费者看到新的写索引 */
+	_pRing->usHead = _pRing->usHead + _usLen;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_RingPut
+*	功能说明: 写入一组数据。空间不够时只写入能放下的部分, 不等待。
+*	形    参: _pRing : 环形缓冲区
+*			  _pData : 数据
+*			  _usLen : 数据长度
+*	返 回 值: 实际写入的字节数
+*********************************************************************************************************
+*/
+uint16_t bsp_RingPut(RING_T *_pRing, const uint8_t *_pData, uint16_t _usLen)
+{
+	uint16_t usHead;
+	uint16_t usFree;
+	uint16_t usPos;
+	uint16_t usSpan;
+
+	usHead = _pRing->usHead;
+	usFree = _pRing->usSize - (uint16_t)(usHead - _pRing->usTail);
+	if (_usLen > usFree)
+	{
+		_usLen = usFree;
+	}
+	if (_usLen == 0)
+	{
+		return 0;
+	}
+
+	usPos = usHead & _pRing->usMask;
+	usSpan = _pRing->usSize - usPos;
+	if (usSpan > _usLen)
+	{
+		usSpan = _usLen;
+	}
+	memcpy(&_pRing->pBuf[usPos], _pData, usSpan);
+	memcpy(_pRing->pBuf, &_pData[usSpan], _usLen - usSpan);	/* 回绕部分 */
+
+	__DMB();
+	_pRing->usHead = usHead + _usLen;
+	return _usLen;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_RingPutByte
+*	功能说明: 写入1个字节
+*	形    参: _pRing : 环形缓冲区
+*			  _ucByte : 数据
+*	返 回 值: 1 表示成功, 0 表示缓冲区满
+*********************************************************************************************************
+*/
+uint8_t bsp_RingPutByte(RING_T *_pRing, uint8_t _ucByte)
+{
+	uint16_t usHead;
+
+	usHead = _pRing->usHead;
+	if ((uint16_t)(usHead - _pRing->usTail) >= _pRing->usSize)
+	{
+		return 0;
+	}
+
+	_pRing->pBuf[usHead & _pRing->usMask] = _ucByte;
+	__DMB();
+	_pRing->usHead = usHead + 1;
+	return 1;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_RingPeekSpan
+*	功能说明: 取得从读索引开始的一段连续数据, 消费者可以直接使用, 处理完毕后调用 bsp_RingConsume 释放。
+*	形    参: _pRing : 环形缓冲区
+*			  _ppData : 返回连续数据的首地址
+*	返 回 值: 连续数据的字节数, 0 表示没有数据
+*********************************************************************************************************
+*/
+uint16_t bsp_RingPeekSpan(RING_T *_pRing, uint8_t **_ppData)
+{
+	uint16_t usTail;
+	uint16_t usCount;
+	uint16_t usSpan;
+
+	usTail = _pRing->usTail;
+	usCount = (uint16_t)(_pRing->usHead - usTail);
+	__DMB();	/* 先读写索引, 再读数据 */
+	usSpan = _pRing->usSize - (usTail & _pRing->usMask);	/* 读索引到缓冲区末尾 */
+	if (usSpan > usCount)
+	{
+		usSpan = usCount;
+	}
+
+	*_ppData = &_pRing->pBuf[usTail & _pRing->usMask];
+	return usSpan;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_RingConsume
+*	功能说明: 释放消费者已经处理完的数据
+*	形    参: _pRing : 环形缓冲区
+*			  _usLen : 数据个数, 不能超过缓冲区中的数据个数
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_RingConsume(RING_T *_pRing, uint16_t _usLen)
+{
+	__DMB();	/* 数据读完之后才能让生产者覆盖这段空间 */
+	_pRing->usTail = _pRing->usTail + _usLen;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_RingGet
+*	功能说明: 读取一组数据。数据不够时只读取现有的部分, 不等待。DMA接收覆盖未读数据时, 数据个数可能
+*			  超过缓冲区大小, 最多只读取缓冲区大小的字节数。
+*	形    参: _pRing : 环形缓冲区
+*			  _pData : 存放读取数据的缓冲区
+*			  _usLen : 最多读取的字节数
+*	返 回 值: 实际读取的字节数
+*********************************************************************************************************
+*/
+uint16_t bsp_RingGet(RING_T *_pRing, uint8_t *_pData, uint16_t _usLen)
+{
+	uint16_t usTail;
+	uint16_t usCount;
+	uint16_t usPos;
+	uint16_t usSpan;
+
+	usTail = _pRing->usTail;
+	usCount = (uint16_t)(_pRing->usHead - usTail);
+	if (_usLen > usCount)
+	{
+		_usLen = usCount;
+	}
+	if (_usLen > _pRing->usSize)
+	{
+		_usLen = _pRing->usSize;	/* 不读出缓冲区之外 */
+	}
+	if (_usLen == 0)
+	{
+		return 0;
+	}
+
+	__DMB();
+	usPos = usTail & _pRing->usMask;
+	usSpan = _pRing->usSize - usPos;
+	if (usSpan > _usLen)
+	{
+		usSpan = _usLen;
+	}
+	memcpy(_pData, &_pRing->pBuf[usPos], usSpan);
+	memcpy(&_pData[usSpan], _pRing->pBuf, _usLen - usSpan);	/* 回绕部分 */
+
+	__DMB();
+	_pRing->usTail = usTail + _usLen;
+	return _usLen;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_RingGetByte
+*	功能说明: 读取1个字节
+*	形    参: _pRing : 环形缓冲区
+*			  _pByte : 存放读取数据的指针
+*	返 回 值: 1 表示读到数据, 0 表示没有数据
+*********************************************************************************************************
+*/
+uint8_t bsp_RingGetByte(RING_T *_pRing, uint8_t *_pByte)
+{
+	uint16_t usTail;
+
+	usTail = _pRing->usTail;
+	if (_pRing->usHead == usTail)
+	{
+		return 0;
+	}
+
+	__DMB();
+	*_pByte = _pRing->pBuf[usTail & _pRing->usMask];
+	__DMB();
+	_pRing->usTail = usTail + 1;
+	return 1;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_RingClear
+*	功能说明: 丢弃缓冲区中的全部数据。由消费者调用; 生产者调用时必须关中断。
+*	形    参: _pRing : 环形缓冲区
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_RingClear(RING_T *_pRing)
+{
+	_pRing->usTail = _pRing->usHead;
+}
+
+/***************************** 安富莱电子 www.armfly.com (END OF FILE) *********************************/
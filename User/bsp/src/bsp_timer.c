@@ -1,665 +1,1513 @@
-/*
-*********************************************************************************************************
-*
-*	模块名称 : 定时器模块
-*	文件名称 : bsp_timer.c
-*	版    本 : V1.3
-*	说    明 : 配置systick定时器作为系统滴答定时器。缺省定时周期为1ms。
-*
-*				实现了多个软件定时器供主程序使用(精度1ms)， 可以通过修改 TMR_COUNT 增减定时器个数
-*				实现了ms级别延迟函数（精度1ms） 和us级延迟函数
-*				实现了系统运行时间函数（1ms单位）
-*
-*	修改记录 :
-*		版本号  日期        作者     说明
-*		V1.0    2013-02-01 armfly  正式发布
-*		V1.1    2013-06-21 armfly  增加us级延迟函数 bsp_DelayUS
-*		V1.2    2014-09-07 armfly  增加TIM4 硬件定时中断，实现us级别定时.20us - 16秒
-*		V1.3    2015-04-06 armfly  增加 bsp_CheckRunTime(int32_t _LastTime) 用来计算时间差值
-*		V1.4	2015-05-22 armfly  完善 bsp_InitHardTimer() ，增加条件编译选择TIM2-5
-*
-*	Copyright (C), 2015-2016, 安富莱电子 www.armfly.com
-*
-*********************************************************************************************************
-*/
-
-#include "bsp_timer.h"
-
-/*
-	定义用于硬件定时器的TIM， 可以使 TIM2 - TIM5
-	TIM3 和TIM4 是16位
-	TIM2 和TIM5 是16位 (103是16位, 407是32位)
-*/
-#define USE_TIM2
-//#define USE_TIM3
-//#define USE_TIM4
-//#define USE_TIM5
-
-#ifdef USE_TIM2
-	#define TIM_HARD		TIM2
-	#define TIM_HARD_IRQn	TIM2_IRQn
-	#define TIM_HARD_RCC	RCC_APB1Periph_TIM2
-#endif
-
-#ifdef USE_TIM3
-	#define TIM_HARD		TIM3
-	#define TIM_HARD_IRQn	TIM3_IRQn
-	#define TIM_HARD_RCC	RCC_APB1Periph_TIM3
-#endif
-
-#ifdef USE_TIM4
-	#define TIM_HARD		TIM4
-	#define TIM_HARD_IRQn	TIM4_IRQn
-	#define TIM_HARD_RCC	RCC_APB1Periph_TIM4
-#endif
-
-#ifdef USE_TIM5
-	#define TIM_HARD		TIM5
-	#define TIM_HARD_IRQn	TIM5_IRQn
-	#define TIM_HARD_RCC	RCC_APB1Periph_TIM5
-#endif
-
-/* 这2个全局变量转用于 bsp_DelayMS() 函数 */
-static volatile uint32_t s_uiDelayCount = 0;
-static volatile uint8_t s_ucTimeOutFlag = 0;
-
-/* 定于软件定时器结构体变量 */
-static SOFT_TMR s_tTmr[TMR_COUNT];
-
-/*
-	全局运行时间，单位1ms
-	最长可以表示 24.85天，如果你的产品连续运行时间超过这个数，则必须考虑溢出问题
-*/
-__IO int32_t g_iRunTime = 0;
-
-static void bsp_SoftTimerDec(SOFT_TMR *_tmr);
-
-/* 保存 TIM定时中断到后执行的回调函数指针 */
-static void (*s_TIM_CallBack1)(void);
-static void (*s_TIM_CallBack2)(void);
-static void (*s_TIM_CallBack3)(void);
-static void (*s_TIM_CallBack4)(void);
-
-/*
-*********************************************************************************************************
-*	函 数 名: bsp_InitTimer
-*	功能说明: 配置systick中断，并初始化软件定时器变量
-*	形    参:  无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void bsp_InitTimer(void)
-{
-	uint8_t i;
-
-	/* 清零所有的软件定时器 */
-	for (i = 0; i < TMR_COUNT; i++)
-	{
-		s_tTmr[i].Count = 0;
-		s_tTmr[i].PreLoad = 0;
-		s_tTmr[i].Flag = 0;
-		s_tTmr[i].Mode = TMR_ONCE_MODE;	/* 缺省是1次性工作模式 */
-	}
-
-	/*
-		配置systic中断周期为1ms，并启动systick中断。
-
-    	SystemCoreClock 是固件中定义的系统内核时钟，对于STM32F4XX,一般为 168MHz
-
-    	SysTick_Config() 函数的形参表示内核时钟多少个周期后触发一次Systick定时中断.
-	    	-- SystemCoreClock / 1000  表示定时频率为 1000Hz， 也就是定时周期为  1ms
-	    	-- SystemCoreClock / 500   表示定时频率为 500Hz，  也就是定时周期为  2ms
-	    	-- SystemCoreClock / 2000  表示定时频率为 2000Hz， 也就是定时周期为  500us
-
-    	对于常规的应用，我们一般取定时周期1ms。对于低速CPU或者低功耗应用，可以设置定时周期为 10ms
-    */
-	SysTick_Config(SystemCoreClock / 1000);
-	
-#if defined (USE_TIM2) || defined (USE_TIM3)  || defined (USE_TIM4)	|| defined (USE_TIM5)
-	bsp_InitHardTimer();
-#endif
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: SysTick_ISR
-*	功能说明: SysTick中断服务程序，每隔1ms进入1次
-*	形    参:  无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-extern void bsp_RunPer1ms(void);
-extern void bsp_RunPer10ms(void);
-void SysTick_ISR(void)
-{
-	static uint8_t s_count = 0;
-	uint8_t i;
-
-	/* 每隔1ms进来1次 （仅用于 bsp_DelayMS） */
-	if (s_uiDelayCount > 0)
-	{
-		if (--s_uiDelayCount == 0)
-		{
-			s_ucTimeOutFlag = 1;
-		}
-	}
-
-	/* 每隔1ms，对软件定时器的计数器进行减一操作 */
-	for (i = 0; i < TMR_COUNT; i++)
-	{
-		bsp_SoftTimerDec(&s_tTmr[i]);
-	}
-
-	/* 全局运行时间每1ms增1 */
-	g_iRunTime++;
-	if (g_iRunTime == 0x7FFFFFFF)	/* 这个变量是 int32_t 类型，最大数为 0x7FFFFFFF */
-	{
-		g_iRunTime = 0;
-	}
-
-	bsp_RunPer1ms();		/* 每隔1ms调用一次此函数，此函数在 bsp.c */
-
-	if (++s_count >= 10)
-	{
-		s_count = 0;
-
-		bsp_RunPer10ms();	/* 每隔10ms调用一次此函数，此函数在 bsp.c */
-	}
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: bsp_SoftTimerDec
-*	功能说明: 每隔1ms对所有定时器变量减1。必须被SysTick_ISR周期性调用。
-*	形    参:  _tmr : 定时器变量指针
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-static void bsp_SoftTimerDec(SOFT_TMR *_tmr)
-{
-	if (_tmr->Count > 0)
-	{
-		/* 如果定时器变量减到1则设置定时器到达标志 */
-		if (--_tmr->Count == 0)
-		{
-			_tmr->Flag = 1;
-
-			/* 如果是自动模式，则自动重装计数器 */
-			if(_tmr->Mode == TMR_AUTO_MODE)
-			{
-				_tmr->Count = _tmr->PreLoad;
-			}
-		}
-	}
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: bsp_DelayMS
-*	功能说明: ms级延迟，延迟精度为正负1ms
-*	形    参:  n : 延迟长度，单位1 ms。 n 应大于2
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void bsp_DelayMS(uint32_t n)
-{
-	if (n == 0)
-	{
-		return;
-	}
-	else if (n == 1)
-	{
-		n = 2;
-	}
-
-	DISABLE_INT();  			/* 关中断 */
-
-	s_uiDelayCount = n;
-	s_ucTimeOutFlag = 0;
-
-	ENABLE_INT();  				/* 开中断 */
-
-	while (1)
-	{
-		bsp_Idle();				/* CPU空闲执行的操作， 见 bsp.c 和 bsp.h 文件 */
-
-		/*
-			等待延迟时间到
-			注意：编译器认为 s_ucTimeOutFlag = 0，所以可能优化错误，因此 s_ucTimeOutFlag 变量必须申明为 volatile
-		*/
-		if (s_ucTimeOutFlag == 1)
-		{
-			break;
-		}
-	}
-}
-
-/*
-*********************************************************************************************************
-*    函 数 名: bsp_DelayUS
-*    功能说明: us级延迟。 必须在systick定时器启动后才能调用此函数。
-*    形    参:  n : 延迟长度，单位1 us
-*    返 回 值: 无
-*********************************************************************************************************
-*/
-void bsp_DelayUS(uint32_t n)
-{
-    uint32_t ticks;
-    uint32_t told;
-    uint32_t tnow;
-    uint32_t tcnt = 0;
-    uint32_t reload;
-       
-	reload = SysTick->LOAD;                
-    ticks = n * (SystemCoreClock / 1000000);	 /* 需要的节拍数 */  
-    
-    tcnt = 0;
-    told = SysTick->VAL;             /* 刚进入时的计数器值 */
-
-    while (1)
-    {
-        tnow = SysTick->VAL;    
-        if (tnow != told)
-        {    
-            /* SYSTICK是一个递减的计数器 */    
-            if (tnow < told)
-            {
-                tcnt += told - tnow;    
-            }
-            /* 重新装载递减 */
-            else
-            {
-                tcnt += reload - tnow + told;    
-            }        
-            told = tnow;
-
-            /* 时间超过/等于要延迟的时间,则退出 */
-            if (tcnt >= ticks)
-            {
-            	break;
-            }
-        }  
-    }
-} 
-
-
-/*
-*********************************************************************************************************
-*	函 数 名: bsp_StartTimer
-*	功能说明: 启动一个定时器，并设置定时周期。
-*	形    参:  	_id     : 定时器ID，值域【0,TMR_COUNT-1】。用户必须自行维护定时器ID，以避免定时器ID冲突。
-*				_period : 定时周期，单位1ms
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void bsp_StartTimer(uint8_t _id, uint32_t _period)
-{
-	if (_id >= TMR_COUNT)
-	{
-		/* 打印出错的源代码文件名、函数名称 */
-		BSP_Printf("Error: file %s, function %s()\r\n", __FILE__, __FUNCTION__);
-		while(1); /* 参数异常，死机等待看门狗复位 */
-	}
-
-	DISABLE_INT();  			/* 关中断 */
-
-	s_tTmr[_id].Count = _period;		/* 实时计数器初值 */
-	s_tTmr[_id].PreLoad = _period;		/* 计数器自动重装值，仅自动模式起作用 */
-	s_tTmr[_id].Flag = 0;				/* 定时时间到标志 */
-	s_tTmr[_id].Mode = TMR_ONCE_MODE;	/* 1次性工作模式 */
-
-	ENABLE_INT();  				/* 开中断 */
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: bsp_StartAutoTimer
-*	功能说明: 启动一个自动定时器，并设置定时周期。
-*	形    参:  	_id     : 定时器ID，值域【0,TMR_COUNT-1】。用户必须自行维护定时器ID，以避免定时器ID冲突。
-*				_period : 定时周期，单位10ms
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void bsp_StartAutoTimer(uint8_t _id, uint32_t _period)
-{
-	if (_id >= TMR_COUNT)
-	{
-		/* 打印出错的源代码文件名、函数名称 */
-		BSP_Printf("Error: file %s, function %s()\r\n", __FILE__, __FUNCTION__);
-		while(1); /* 参数异常，死机等待看门狗复位 */
-	}
-
-	DISABLE_INT();  		/* 关中断 */
-
-	s_tTmr[_id].Count = _period;			/* 实时计数器初值 */
-	s_tTmr[_id].PreLoad = _period;		/* 计数器自动重装值，仅自动模式起作用 */
-	s_tTmr[_id].Flag = 0;				/* 定时时间到标志 */
-	s_tTmr[_id].Mode = TMR_AUTO_MODE;	/* 自动工作模式 */
-
-	ENABLE_INT();  			/* 开中断 */
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: bsp_StopTimer
-*	功能说明: 停止一个定时器
-*	形    参:  	_id     : 定时器ID，值域【0,TMR_COUNT-1】。用户必须自行维护定时器ID，以避免定时器ID冲突。
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void bsp_StopTimer(uint8_t _id)
-{
-	if (_id >= TMR_COUNT)
-	{
-		/* 打印出错的源代码文件名、函数名称 */
-		BSP_Printf("Error: file %s, function %s()\r\n", __FILE__, __FUNCTION__);
-		while(1); /* 参数异常，死机等待看门狗复位 */
-	}
-
-	DISABLE_INT();  	/* 关中断 */
-
-	s_tTmr[_id].Count = 0;				/* 实时计数器初值 */
-	s_tTmr[_id].Flag = 0;				/* 定时时间到标志 */
-	s_tTmr[_id].Mode = TMR_ONCE_MODE;	/* 自动工作模式 */
-
-	ENABLE_INT();  		/* 开中断 */
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: bsp_CheckTimer
-*	功能说明: 检测定时器是否超时
-*	形    参:  	_id     : 定时器ID，值域【0,TMR_COUNT-1】。用户必须自行维护定时器ID，以避免定时器ID冲突。
-*				_period : 定时周期，单位1ms
-*	返 回 值: 返回 0 表示定时未到， 1表示定时到
-*********************************************************************************************************
-*/
-uint8_t bsp_CheckTimer(uint8_t _id)
-{
-	if (_id >= TMR_COUNT)
-	{
-		return 0;
-	}
-
-	if (s_tTmr[_id].Flag == 1)
-	{
-		s_tTmr[_id].Flag = 0;
-		return 1;
-	}
-	else
-	{
-		return 0;
-	}
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: bsp_GetRunTime
-*	功能说明: 获取CPU运行时间，单位1ms。最长可以表示 24.85天，如果你的产品连续运行时间超过这个数，则必须考虑溢出问题
-*	形    参:  无
-*	返 回 值: CPU运行时间，单位1ms
-*********************************************************************************************************
-*/
-int32_t bsp_GetRunTime(void)
-{
-	int32_t runtime;
-
-	DISABLE_INT();  	/* 关中断 */
-
-	runtime = g_iRunTime;	/* 这个变量在Systick中断中被改写，因此需要关中断进行保护 */
-
-	ENABLE_INT();  		/* 开中断 */
-
-	return runtime;
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: bsp_CheckRunTime
-*	功能说明: 计算当前运行时间和给定时刻之间的差值。处理了计数器循环。
-*	形    参:  _LastTime 上个时刻
-*	返 回 值: 当前时间和过去时间的差值，单位1ms
-*********************************************************************************************************
-*/
-int32_t bsp_CheckRunTime(int32_t _LastTime)
-{
-	int32_t now_time;
-	int32_t time_diff;
-
-	DISABLE_INT();  	/* 关中断 */
-
-	now_time = g_iRunTime;	/* 这个变量在Systick中断中被改写，因此需要关中断进行保护 */
-
-	ENABLE_INT();  		/* 开中断 */
-	
-	if (now_time >= _LastTime)
-	{
-		time_diff = now_time - _LastTime;
-	}
-	else
-	{
-		time_diff = 0x7FFFFFFF - _LastTime + now_time;
-	}
-
-	return time_diff;
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: SysTick_Handler
-*	功能说明: 系统嘀嗒定时器中断服务程序。启动文件中引用了该函数。
-*	形    参:  无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void SysTick_Handler(void)
-{
-	SysTick_ISR();
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: bsp_InitHardTimer
-*	功能说明: 配置 TIMx，用于us级别硬件定时。TIMx将自由运行，永不停止.
-*			TIMx可以用TIM2 - TIM5 之间的TIM, 这些TIM有4个通道, 挂在 APB1 上，输入时钟=SystemCoreClock / 2
-*	形    参: 无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-#if defined (USE_TIM2) || defined (USE_TIM3)  || defined (USE_TIM4)	|| defined (USE_TIM5)
-void bsp_InitHardTimer(void)
-{
-	TIM_TimeBaseInitTypeDef  TIM_TimeBaseStructure;
-	uint32_t usPeriod;
-	uint16_t usPrescaler;
-	uint32_t uiTIMxCLK;
-
-  	/* 使能TIM时钟 */
-	RCC_APB1PeriphClockCmd(TIM_HARD_RCC, ENABLE);
-
-    /*-----------------------------------------------------------------------
-		system_stm32f4xx.c 文件中 void SetSysClock(void) 函数对时钟的配置如下：
-
-		HCLK = SYSCLK / 1     (AHB1Periph)
-		PCLK2 = HCLK / 2      (APB2Periph)
-		PCLK1 = HCLK / 4      (APB1Periph)
-
-		因为APB1 prescaler != 1, 所以 APB1上的TIMxCLK = PCLK1 x 2 = SystemCoreClock / 2;
-		因为APB2 prescaler != 1, 所以 APB2上的TIMxCLK = PCLK2 x 2 = SystemCoreClock;
-
-		APB1 定时器有 TIM2, TIM3 ,TIM4, TIM5, TIM6, TIM7, TIM12, TIM13,TIM14
-		APB2 定时器有 TIM1, TIM8 ,TIM9, TIM10, TIM11
-
-	----------------------------------------------------------------------- */
-	uiTIMxCLK = SystemCoreClock / 2;
-
-	usPrescaler = uiTIMxCLK / 1000000 ;	/* 分频到周期 1us */
-	
-#if defined (USE_TIM2) || defined (USE_TIM5) 
-	//usPeriod = 0xFFFFFFFF;	/* 407支持32位定时器 */
-	usPeriod = 0xFFFF;	/* 103支持16位 */
-#else
-	usPeriod = 0xFFFF;
-#endif
-	/* Time base configuration */
-	TIM_TimeBaseStructure.TIM_Period = usPeriod;
-	TIM_TimeBaseStructure.TIM_Prescaler = usPrescaler;
-	TIM_TimeBaseStructure.TIM_ClockDivision = 0;
-	TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
-
-	TIM_TimeBaseInit(TIM_HARD, &TIM_TimeBaseStructure);
-
-	//TIM_ARRPreloadConfig(TIMx, ENABLE);
-
-	/* TIMx enable counter */
-	TIM_Cmd(TIM_HARD, ENABLE);
-
-	/* 配置TIM定时中断 (Update) */
-	{
-		NVIC_InitTypeDef NVIC_InitStructure;	/* 中断结构体在 misc.h 中定义 */
-
-		NVIC_InitStructure.NVIC_IRQChannel = TIM_HARD_IRQn;
-
-		NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 4;	/* 比串口优先级低 */
-		NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
-		NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
-		NVIC_Init(&NVIC_InitStructure);
-	}
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: bsp_StartHardTimer
-*	功能说明: 使用TIM2-5做单次定时器使用, 定时时间到后执行回调函数。可以同时启动4个定时器，互不干扰。
-*             定时精度正负10us （主要耗费在调用本函数的执行时间，函数内部进行了补偿减小误差）
-*			 TIM2和TIM5 是16位定时器。
-*			 TIM3和TIM4 是16位定时器。
-*	形    参: _CC : 捕获通道几，1，2，3, 4
-*             _uiTimeOut : 超时时间, 单位 1us.       对于16位定时器，最大 65.5ms; 对于32位定时器，最大 4294秒
-*             _pCallBack : 定时时间到后，被执行的函数
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void bsp_StartHardTimer(uint8_t _CC, uint32_t _uiTimeOut, void * _pCallBack)
-{
-    uint32_t cnt_now;
-    uint32_t cnt_tar;
-
-    /*
-        执行下面这个语句，时长 = 18us (通过逻辑分析仪测量IO翻转)
-        bsp_StartTimer2(3, 500, (void *)test1);
-    */
-    if (_uiTimeOut < 5)
-    {
-        ;
-    }
-    else
-    {
-        _uiTimeOut -= 5;
-    }
-
-    cnt_now = TIM_GetCounter(TIM_HARD);    	/* 读取当前的计数器值 */
-    cnt_tar = cnt_now + _uiTimeOut;			/* 计算捕获的计数器值 */
-    if (_CC == 1)
-    {
-        s_TIM_CallBack1 = (void (*)(void))_pCallBack;
-
-        TIM_SetCompare1(TIM_HARD, cnt_tar);      	/* 设置捕获比较计数器CC1 */
-        TIM_ClearITPendingBit(TIM_HARD, TIM_IT_CC1);
-		TIM_ITConfig(TIM_HARD, TIM_IT_CC1, ENABLE);	/* 使能CC1中断 */
-
-    }
-    else if (_CC == 2)
-    {
-		s_TIM_CallBack2 = (void (*)(void))_pCallBack;
-
-        TIM_SetCompare2(TIM_HARD, cnt_tar);      	/* 设置捕获比较计数器CC2 */
-		TIM_ClearITPendingBit(TIM_HARD, TIM_IT_CC2);
-		TIM_ITConfig(TIM_HARD, TIM_IT_CC2, ENABLE);	/* 使能CC2中断 */
-    }
-    else if (_CC == 3)
-    {
-        s_TIM_CallBack3 = (void (*)(void))_pCallBack;
-
-        TIM_SetCompare3(TIM_HARD, cnt_tar);      	/* 设置捕获比较计数器CC3 */
-        TIM_ClearITPendingBit(TIM_HARD, TIM_IT_CC3);
-		TIM_ITConfig(TIM_HARD, TIM_IT_CC3, ENABLE);	/* 使能CC3中断 */
-    }
-    else if (_CC == 4)
-    {
-        s_TIM_CallBack4 = (void (*)(void))_pCallBack;
-
-        TIM_SetCompare4(TIM_HARD, cnt_tar);      	/* 设置捕获比较计数器CC4 */
-		TIM_ClearITPendingBit(TIM_HARD, TIM_IT_CC4);
-		TIM_ITConfig(TIM_HARD, TIM_IT_CC4, ENABLE);	/* 使能CC4中断 */
-    }
-	else
-    {
-        return;
-    }
-}
-#endif
-
-/*
-*********************************************************************************************************
-*	函 数 名: TIMx_IRQHandler
-*	功能说明: TIM 中断服务程序
-*	形    参：无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-
-#ifdef USE_TIM2
-void TIM2_IRQHandler(void)
-#endif
-
-#ifdef USE_TIM3
-void TIM3_IRQHandler(void)
-#endif
-
-#ifdef USE_TIM4
-void TIM4_IRQHandler(void)
-#endif
-
-#ifdef USE_TIM5
-void TIM5_IRQHandler(void)
-#endif
-{
-    if (TIM_GetITStatus(TIM_HARD, TIM_IT_CC1))
-    {
-        TIM_ClearITPendingBit(TIM_HARD, TIM_IT_CC1);
-        TIM_ITConfig(TIM_HARD, TIM_IT_CC1, DISABLE);	/* 禁能CC1中断 */
-
-        /* 先关闭中断，再执行回调函数。因为回调函数可能需要重启定时器 */
-        s_TIM_CallBack1();
-    }
-
-    if (TIM_GetITStatus(TIM_HARD, TIM_IT_CC2))
-    {
-        TIM_ClearITPendingBit(TIM_HARD, TIM_IT_CC2);
-        TIM_ITConfig(TIM_HARD, TIM_IT_CC2, DISABLE);	/* 禁能CC2中断 */
-
-        /* 先关闭中断，再执行回调函数。因为回调函数可能需要重启定时器 */
-        s_TIM_CallBack2();
-    }
-
-    if (TIM_GetITStatus(TIM_HARD, TIM_IT_CC3))
-    {
-        TIM_ClearITPendingBit(TIM_HARD, TIM_IT_CC3);
-        TIM_ITConfig(TIM_HARD, TIM_IT_CC3, DISABLE);	/* 禁能CC3中断 */
-
-        /* 先关闭中断，再执行回调函数。因为回调函数可能需要重启定时器 */
-        s_TIM_CallBack3();
-    }
-
-    if (TIM_GetITStatus(TIM_HARD, TIM_IT_CC4))
-    {
-        TIM_ClearITPendingBit(TIM_HARD, TIM_IT_CC4);
-        TIM_ITConfig(TIM_HARD, TIM_IT_CC4, DISABLE);	/* 禁能CC4中断 */
-
-        /* 先关闭中断，再执行回调函数。因为回调函数可能需要重启定时器 */
-        s_TIM_CallBack4();
-    }
-}
-
-/***************************** 安富莱电子 www.armfly.com (END OF FILE) *********************************/
+/*
+*********************************************************************************************************
+*
+*	模块名称 : 定时器模块
+*	文件名称 : bsp_timer.c
+*	版    本 : V1.3
+*	说    明 : 配置systick定时器作为系统滴答定时器。缺省定时周期为1ms。
+*
+*				实现了多个软件定时器供主程序使用(精度1ms)。软件定时器由分层时间轮管理，每1ms的中断处理时间
+*				与定时器个数无关。可以用 bsp_CreateTimer() 动态分配定时器(最多 TMR_POOL_SIZE 个)，
+*				也可以用兼容的 bsp_StartTimer() 等按ID访问的函数 (TMR_COUNT 个)
+*				实现了ms级别延迟函数（精度1ms） 和us级延迟函数
+*				实现了系统运行时间函数（1ms单位）
+*
+*	修改记录 :
+*		版本号  日期        作者     说明
+*		V1.0    2013-02-01 armfly  正式发布
+*		V1.1    2013-06-21 armfly  增加us级延迟函数 bsp_DelayUS
+*		V1.2    2014-09-07 armfly  增加TIM4 硬件定时中断，实现us级别定时.20us - 16秒
+*		V1.3    2015-04-06 armfly  增加 bsp_CheckRunTime(int32_t _LastTime) 用来计算时间差值
+*		V1.4	2015-05-22 armfly  完善 bsp_InitHardTimer() ，增加条件编译选择TIM2-5
+*		V1.5	2026-10-17         修正 STM32F103 硬件定时器的分频系数(1us); 增加 bsp_GetHardTimerCount()
+*		V1.6	2026-10-17         软件定时器改用分层时间轮, 支持回调函数和动态分配的定时器句柄
+*		V1.7	2026-10-17         增加低功耗 tickless 休眠 bsp_TicklessIdle() 和休眠统计 bsp_GetIdleStat()
+*		V1.8	2026-10-17         增加64位运行时间 bsp_GetRunTime64() 和 us 级时间 bsp_GetTimeUs64(), 读取无需关中断;
+*								   g_iRunTime 改为在 0x80000000 处回零; 延迟函数改用64位时间
+*		V1.9	2026-10-17         硬件定时器用更新中断扩展为32位, 增加不限个数的us级单次/周期定时队列
+*								   (bsp_StartHardTimerEx), 所有定时共用CC1通道; bsp_StartHardTimer() 改为兼容接口
+*		V2.0	2026-10-17         TMR_IDLE_PER10MS_TIME 可以设为0, 空闲时不再定时调用 bsp_RunPer10ms()
+*		V2.1	2026-10-17         休眠唤醒后补做的 bsp_RunPer10ms() 推迟到下一个 SysTick 中断, 不在关中断状态下执行;
+*								   bsp_IdleCanSleep() 返回0时不休眠
+*		V2.2	2026-10-17         参数错误死机前调用 bsp_LogFlush(), 错误信息不再留在日志缓冲区中
+*		V2.3	2026-10-17         bsp_DelayUS 恢复为累加 SysTick->VAL 计数, 关中断时和中断服务程序中也能使用
+*
+*	Copyright (C), 2015-2016, 安富莱电子 www.armfly.com
+*
+*********************************************************************************************************
+*/
+
+#include "bsp_timer.h"
+
+/*
+	定义用于硬件定时器的TIM， 可以使 TIM2 - TIM5
+	TIM3 和TIM4 是16位
+	TIM2 和TIM5 是16位 (103是16位, 407是32位)
+*/
+#define USE_TIM2
+//#define USE_TIM3
+//#define USE_TIM4
+//#define USE_TIM5
+
+#ifdef USE_TIM2
+	#define TIM_HARD		TIM2
+	#define TIM_HARD_IRQn	TIM2_IRQn
+	#define TIM_HARD_RCC	RCC_APB1Periph_TIM2
+#endif
+
+#ifdef USE_TIM3
+	#define TIM_HARD		TIM3
+	#define TIM_HARD_IRQn	TIM3_IRQn
+	#define TIM_HARD_RCC	RCC_APB1Periph_TIM3
+#endif
+
+#ifdef USE_TIM4
+	#define TIM_HARD		TIM4
+	#define TIM_HARD_IRQn	TIM4_IRQn
+	#define TIM_HARD_RCC	RCC_APB1Periph_TIM4
+#endif
+
+#ifdef USE_TIM5
+	#define TIM_HARD		TIM5
+	#define TIM_HARD_IRQn	TIM5_IRQn
+	#define TIM_HARD_RCC	RCC_APB1Periph_TIM5
+#endif
+
+/* bsp_DelayMS() 的结束时刻(64位运行时间，单位1ms)，0 表示没有在延迟。低功耗休眠据此计算唤醒时刻 */
+static volatile uint64_t s_ullDelayEnd = 0;
+
+/*
+	64位运行时间，单位1ms。只在 SysTick 中断中修改。
+	采用双缓冲: 写入序号 s_uiTimeSeq 之外的那一份，再递增序号发布。读的一方比较前后两次序号，
+	不一致则重读。读的一方无需关中断，在比 SysTick 优先级高的中断中读取也不会读到写了一半的值。
+*/
+static uint64_t s_ullTimeMs[2] = {0, 0};
+static __IO uint32_t s_uiTimeSeq = 0;
+static uint32_t s_uiTickCycles;		/* 1ms 对应的 SysTick 计数值 */
+
+/* 定于软件定时器结构体变量 */
+static SOFT_TMR s_tTmr[TMR_COUNT];			/* 兼容接口使用的定时器, 按ID访问 */
+static SOFT_TMR s_tTmrPool[TMR_POOL_SIZE];	/* 动态分配的定时器 */
+
+/* 分层时间轮。s_uiWheelTime 是时间轮已经处理到的时刻, 单位1ms */
+static SOFT_TMR *s_pWheel[TMR_WHEEL_LEVELS][TMR_WHEEL_SIZE];
+static uint32_t s_uiWheelTime = 0;
+
+/* 距离上次调用 bsp_RunPer10ms() 的时间，单位1ms。休眠时可能一次跳过多个1ms */
+static uint16_t s_usPer10msCount = 0;
+
+#if TMR_TICKLESS_EN == 1
+	static uint32_t s_uiMaxIdleTicks;	/* SysTick 24位计数器一次最多能休眠的 ms 数 */
+	static IDLE_STAT_T s_tIdle;			/* 休眠统计 */
+	static uint32_t s_uiStatWakeups;	/* 本统计周期内的唤醒次数 */
+	static uint32_t s_uiStatSleepUs;	/* 本统计周期内的休眠时间，单位 us */
+	static uint64_t s_ullStatStart;		/* 本统计周期的开始时刻 */
+#endif
+
+/*
+	全局运行时间，单位1ms。等于64位运行时间的低31位, 24.85天后回零。
+	长时间运行的产品请用 bsp_GetRunTime64() 或者用 bsp_CheckRunTime() 计算时间差。
+*/
+__IO int32_t g_iRunTime = 0;
+
+static void bsp_TimeAdvance(uint32_t _uiTicks);
+static void bsp_SoftTimerTick(void);
+static void bsp_TmrInsert(SOFT_TMR *_pTmr);
+static void bsp_TmrRemove(SOFT_TMR *_pTmr);
+static void bsp_TmrStart(SOFT_TMR *_pTmr, uint32_t _period, uint8_t _mode);
+#if TMR_TICKLESS_EN == 1
+	static uint32_t bsp_GetIdleTicks(uint32_t _uiMax);
+	static void bsp_StepTick(uint32_t _uiTicks);
+	static void bsp_IdleStatUpdate(uint32_t _uiSleepCycles);
+#endif
+
+#if defined (USE_TIM2) || defined (USE_TIM3)  || defined (USE_TIM4)	|| defined (USE_TIM5)
+	/*
+		硬件定时器的高16位，由更新(溢出)中断累加，和 TIMx 计数器组成32位的us计数值。
+		所有硬件定时按到期时刻排序在 s_pHardList 中，由比较通道CC1在队首到期时产生中断。
+	*/
+	static __IO uint16_t s_usHardHigh = 0;
+	static HARD_TMR_T * volatile s_pHardList = 0;
+	static HARD_TMR_STAT_T s_tHardStat;
+
+	/* 兼容接口 bsp_StartHardTimer() 的4个通道 */
+	static HARD_TMR_T s_tHardCC[4];
+
+	static uint8_t bsp_HardTmrProgram(void);
+	static void bsp_HardTmrInsert(HARD_TMR_T *_pTmr);
+	static void bsp_HardTmrRemove(HARD_TMR_T *_pTmr);
+#endif
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_InitTimer
+*	功能说明: 配置systick中断，并初始化软件定时器变量
+*	形    参:  无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_InitTimer(void)
+{
+	uint8_t i;
+
+	/* 清零所有的软件定时器 */
+	memset(s_pWheel, 0, sizeof(s_pWheel));
+	memset(s_tTmrPool, 0, sizeof(s_tTmrPool));
+	for (i = 0; i < TMR_COUNT; i++)
+	{
+		s_tTmr[i].ppPrev = 0;
+		s_tTmr[i].PreLoad = 0;
+		s_tTmr[i].CallBack = 0;
+		s_tTmr[i].Flag = 0;
+		s_tTmr[i].Mode = TMR_ONCE_MODE;	/* 缺省是1次性工作模式 */
+		s_tTmr[i].InUse = 1;
+	}
+
+	/*
+		配置systic中断周期为1ms，并启动systick中断。
+
+    	SystemCoreClock 是固件中定义的系统内核时钟，对于STM32F4XX,一般为 168MHz
+
+    	SysTick_Config() 函数的形参表示内核时钟多少个周期后触发一次Systick定时中断.
+	    	-- SystemCoreClock / 1000  表示定时频率为 1000Hz， 也就是定时周期为  1ms
+	    	-- SystemCoreClock / 500   表示定时频率为 500Hz，  也就是定时周期为  2ms
+	    	-- SystemCoreClock / 2000  表示定时频率为 2000Hz， 也就是定时周期为  500us
+
+    	对于常规的应用，我们一般取定时周期1ms。对于低速CPU或者低功耗应用，可以设置定时周期为 10ms
+    */
+	s_uiTickCycles = SystemCoreClock / 1000;
+	SysTick_Config(SystemCoreClock / 1000);
+
+#if TMR_TICKLESS_EN == 1
+	s_uiMaxIdleTicks = SysTick_LOAD_RELOAD_Msk / s_uiTickCycles;
+	memset(&s_tIdle, 0, sizeof(s_tIdle));
+	s_uiStatWakeups = 0;
+	s_uiStatSleepUs = 0;
+	s_ullStatStart = 0;
+#endif
+	
+#if defined (USE_TIM2) || defined (USE_TIM3)  || defined (USE_TIM4)	|| defined (USE_TIM5)
+	bsp_InitHardTimer();
+#endif
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: SysTick_ISR
+*	功能说明: SysTick中断服务程序，每隔1ms进入1次
+*	形    参:  无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+extern void bsp_RunPer1ms(void);
+extern void bsp_RunPer10ms(void);
+extern uint8_t bsp_Per10msIsIdle(void);
+void SysTick_ISR(void)
+{
+	/* 全局运行时间每1ms增1。先于软件定时器更新，定时器回调函数中读到的是本节拍的时间 */
+	bsp_TimeAdvance(1);
+
+	/* 每隔1ms，时间轮前进一格，处理到期的软件定时器 */
+	bsp_SoftTimerTick();
+
+	bsp_RunPer1ms();		/* 每隔1ms调用一次此函数，此函数在 bsp.c */
+
+	if (++s_usPer10msCount >= 10)
+	{
+		s_usPer10msCount = 0;
+
+		bsp_RunPer10ms();	/* 每隔10ms调用一次此函数，此函数在 bsp.c */
+	}
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_TimeAdvance
+*	功能说明: 64位运行时间前进若干ms。只能在 SysTick 中断或者关中断状态下调用(只有一个写入者)。
+*	形    参:  _uiTicks : 前进的ms数
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void bsp_TimeAdvance(uint32_t _uiTicks)
+{
+	uint32_t uiSeq;
+	uint64_t ullNow;
+
+	uiSeq = s_uiTimeSeq;
+	ullNow = s_ullTimeMs[uiSeq & 1] + _uiTicks;
+
+	s_ullTimeMs[(uiSeq + 1) & 1] = ullNow;	/* 写入读的一方当前不使用的那一份 */
+	__DMB();
+	s_uiTimeSeq = uiSeq + 1;				/* 发布 */
+
+	g_iRunTime = (int32_t)((uint32_t)ullNow & 0x7FFFFFFF);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_SoftTimerTick
+*	功能说明: 时间轮前进1格，处理到期的定时器。必须被SysTick_ISR每1ms调用一次。
+*	形    参:  无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void bsp_SoftTimerTick(void)
+{
+	SOFT_TMR *pList;
+	SOFT_TMR *pTmr;
+	uint8_t ucIndex;
+	uint8_t ucLevel;
+
+	/*
+		第0层的槽号回到0时，把上一层当前槽的定时器重新分配到下层 (逐层进行)。
+		每个定时器在整个定时过程中最多被搬移 TMR_WHEEL_LEVELS - 1 次。
+	*/
+	ucIndex = s_uiWheelTime & TMR_WHEEL_MASK;
+	for (ucLevel = 1; ucIndex == 0 && ucLevel < TMR_WHEEL_LEVELS; ucLevel++)
+	{
+		ucIndex = (s_uiWheelTime >> (ucLevel * TMR_WHEEL_BITS)) & TMR_WHEEL_MASK;
+
+		pList = s_pWheel[ucLevel][ucIndex];
+		s_pWheel[ucLevel][ucIndex] = 0;
+		while ((pTmr = pList) != 0)
+		{
+			pList = pTmr->pNext;
+			bsp_TmrInsert(pTmr);
+		}
+	}
+
+	/* 取出第0层当前槽中的定时器，全部到期 */
+	ucIndex = s_uiWheelTime & TMR_WHEEL_MASK;
+	pList = s_pWheel[0][ucIndex];
+	s_pWheel[0][ucIndex] = 0;
+	if (pList != 0)
+	{
+		pList->ppPrev = &pList;		/* 回调函数中可能停止链表中的其他定时器 */
+	}
+	s_uiWheelTime++;
+
+	while ((pTmr = pList) != 0)
+	{
+		bsp_TmrRemove(pTmr);
+
+		pTmr->Flag = 1;		/* 设置定时器到达标志 */
+
+		/* 如果是自动模式，则自动重装计数器。按到期时刻累加，不会累积误差 */
+		if (pTmr->Mode == TMR_AUTO_MODE)
+		{
+			pTmr->Expire += pTmr->PreLoad;
+			bsp_TmrInsert(pTmr);
+		}
+
+		if (pTmr->CallBack != 0)
+		{
+			pTmr->CallBack(pTmr->pArg);
+		}
+	}
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_TmrInsert
+*	功能说明: 根据到期时刻把定时器挂到时间轮对应的槽。调用者必须关中断(或者在SysTick中断中)。
+*	形    参:  _pTmr : 定时器指针
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void bsp_TmrInsert(SOFT_TMR *_pTmr)
+{
+	uint32_t uiExpire;
+	uint32_t uiDiff;
+	uint8_t ucLevel;
+	SOFT_TMR **ppSlot;
+
+	uiExpire = _pTmr->Expire;
+	uiDiff = uiExpire - s_uiWheelTime;
+
+	if ((int32_t)uiDiff < 0)
+	{
+		uiExpire = s_uiWheelTime;	/* 已经过期，下一次节拍处理 */
+		uiDiff = 0;
+	}
+	else if (uiDiff >= ((uint32_t)TMR_WHEEL_MASK << ((TMR_WHEEL_LEVELS - 1) * TMR_WHEEL_BITS)))
+	{
+		/* 超过时间轮范围，先放在最高层最远的槽(不能与当前槽重合)，到时按实际到期时刻重新计算 */
+		uiDiff = (uint32_t)TMR_WHEEL_MASK << ((TMR_WHEEL_LEVELS - 1) * TMR_WHEEL_BITS);
+		uiExpire = s_uiWheelTime + uiDiff;
+	}
+
+	for (ucLevel = 0; ucLevel < TMR_WHEEL_LEVELS - 1; ucLevel++)
+	{
+		if (uiDiff < (1UL << ((ucLevel + 1) * TMR_WHEEL_BITS)))
+		{
+			break;
+		}
+	}
+
+	ppSlot = &s_pWheel[ucLevel][(uiExpire >> (ucLevel * TMR_WHEEL_BITS)) & TMR_WHEEL_MASK];
+	_pTmr->pNext = *ppSlot;
+	if (_pTmr->pNext != 0)
+	{
+		_pTmr->pNext->ppPrev = &_pTmr->pNext;
+	}
+	_pTmr->ppPrev = ppSlot;
+	*ppSlot = _pTmr;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_TmrRemove
+*	功能说明: 把定时器从时间轮中摘下。调用者必须关中断(或者在SysTick中断中)。
+*	形    参:  _pTmr : 定时器指针
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void bsp_TmrRemove(SOFT_TMR *_pTmr)
+{
+	if (_pTmr->ppPrev == 0)
+	{
+		return;		/* 未运行 */
+	}
+
+	*_pTmr->ppPrev = _pTmr->pNext;
+	if (_pTmr->pNext != 0)
+	{
+		_pTmr->pNext->ppPrev = _pTmr->ppPrev;
+	}
+	_pTmr->pNext = 0;
+	_pTmr->ppPrev = 0;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_TmrStart
+*	功能说明: (重新)启动一个定时器
+*	形    参:  _pTmr : 定时器指针
+*			  _period : 定时周期，单位1ms
+*			  _mode : TMR_ONCE_MODE 或 TMR_AUTO_MODE
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void bsp_TmrStart(SOFT_TMR *_pTmr, uint32_t _period, uint8_t _mode)
+{
+	if (_period == 0)
+	{
+		_period = 1;
+	}
+
+	DISABLE_INT();  			/* 关中断 */
+
+	bsp_TmrRemove(_pTmr);
+	_pTmr->PreLoad = _period;		/* 计数器自动重装值，仅自动模式起作用 */
+	_pTmr->Flag = 0;				/* 定时时间到标志 */
+	_pTmr->Mode = _mode;
+	/* 下一次节拍处理 s_uiWheelTime 时刻，因此 _period 个节拍后到期的时刻是 s_uiWheelTime + _period - 1 */
+	_pTmr->Expire = s_uiWheelTime + _period - 1;
+	bsp_TmrInsert(_pTmr);
+
+	ENABLE_INT();  				/* 开中断 */
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_DelayMS
+*	功能说明: ms级延迟。按 bsp_GetTimeUs64() 计时，保证至少延迟 n ms。不能在中断服务程序中调用。
+*	形    参:  n : 延迟长度，单位1 ms
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_DelayMS(uint32_t n)
+{
+	uint64_t ullEnd;
+
+	if (n == 0)
+	{
+		return;
+	}
+
+	ullEnd = bsp_GetTimeUs64() + (uint64_t)n * 1000;
+
+	/* 到达这个1ms节拍时一定已经延迟够了，低功耗休眠在此之前不必唤醒 */
+	s_ullDelayEnd = bsp_GetRunTime64() + n + 1;
+
+	while (bsp_GetTimeUs64() < ullEnd)
+	{
+		bsp_Idle();				/* CPU空闲执行的操作， 见 bsp.c 和 bsp.h 文件 */
+	}
+
+	s_ullDelayEnd = 0;
+}
+
+/*
+*********************************************************************************************************
+*    函 数 名: bsp_DelayUS
+*    功能说明: us级延迟。 必须在systick定时器启动后才能调用此函数。
+*    形    参:  n : 延迟长度，单位1 us
+*    返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_DelayUS(uint32_t n)
+{
+    uint32_t ticks;
+    uint32_t told;
+    uint32_t tnow;
+    uint32_t tcnt = 0;
+    uint32_t reload;
+       
+	reload = SysTick->LOAD;                
+    ticks = n * (SystemCoreClock / 1000000);	 /* 需要的节拍数 */  
+    
+    tcnt = 0;
+    told = SysTick->VAL;             /* 刚进入时的计数器值 */
+
+    while (1)
+    {
+        tnow = SysTick->VAL;    
+        if (tnow != told)
+        {    
+            /* SYSTICK是一个递减的计数器 */    
+            if (tnow < told)
+            {
+                tcnt += told - tnow;    
+            }
+            /* 重新装载递减 */
+            else
+            {
+                tcnt += reload - tnow + told;    
+            }        
+            told = tnow;
+
+            /* 时间超过/等于要延迟的时间,则退出 */
+            if (tcnt >= ticks)
+            {
+            	break;
+            }
+        }  
+    }
+} 
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_StartTimer
+*	功能说明: 启动一个定时器，并设置定时周期。
+*	形    参:  	_id     : 定时器ID，值域【0,TMR_COUNT-1】。用户必须自行维护定时器ID，以避免定时器ID冲突。
+*				_period : 定时周期，单位1ms
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_StartTimer(uint8_t _id, uint32_t _period)
+{
+	if (_id >= TMR_COUNT)
+	{
+		/* 打印出错的源代码文件名、函数名称 */
+		BSP_Printf("Error: file %s, function %s()\r\n", __FILE__, __FUNCTION__);
+		bsp_LogFlush();	/* 日志是在空闲时发送的, 死机前立即发出 */
+		while(1); /* 参数异常，死机等待看门狗复位 */
+	}
+
+	bsp_TmrStart(&s_tTmr[_id], _period, TMR_ONCE_MODE);	/* 1次性工作模式 */
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_StartAutoTimer
+*	功能说明: 启动一个自动定时器，并设置定时周期。
+*	形    参:  	_id     : 定时器ID，值域【0,TMR_COUNT-1】。用户必须自行维护定时器ID，以避免定时器ID冲突。
+*				_period : 定时周期，单位10ms
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_StartAutoTimer(uint8_t _id, uint32_t _period)
+{
+	if (_id >= TMR_COUNT)
+	{
+		/* 打印出错的源代码文件名、函数名称 */
+		BSP_Printf("Error: file %s, function %s()\r\n", __FILE__, __FUNCTION__);
+		bsp_LogFlush();	/* 日志是在空闲时发送的, 死机前立即发出 */
+		while(1); /* 参数异常，死机等待看门狗复位 */
+	}
+
+	bsp_TmrStart(&s_tTmr[_id], _period, TMR_AUTO_MODE);	/* 自动工作模式 */
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_StopTimer
+*	功能说明: 停止一个定时器
+*	形    参:  	_id     : 定时器ID，值域【0,TMR_COUNT-1】。用户必须自行维护定时器ID，以避免定时器ID冲突。
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_StopTimer(uint8_t _id)
+{
+	if (_id >= TMR_COUNT)
+	{
+		/* 打印出错的源代码文件名、函数名称 */
+		BSP_Printf("Error: file %s, function %s()\r\n", __FILE__, __FUNCTION__);
+		bsp_LogFlush();	/* 日志是在空闲时发送的, 死机前立即发出 */
+		while(1); /* 参数异常，死机等待看门狗复位 */
+	}
+
+	bsp_StopTimerEx(&s_tTmr[_id]);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_CheckTimer
+*	功能说明: 检测定时器是否超时
+*	形    参:  	_id     : 定时器ID，值域【0,TMR_COUNT-1】。用户必须自行维护定时器ID，以避免定时器ID冲突。
+*				_period : 定时周期，单位1ms
+*	返 回 值: 返回 0 表示定时未到， 1表示定时到
+*********************************************************************************************************
+*/
+uint8_t bsp_CheckTimer(uint8_t _id)
+{
+	if (_id >= TMR_COUNT)
+	{
+		return 0;
+	}
+
+	return bsp_CheckTimerEx(&s_tTmr[_id]);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_CreateTimer
+*	功能说明: 分配一个软件定时器。
+*	形    参:  _pCallBack : 定时到后的回调函数，在SysTick中断中执行，应尽快返回; 0 表示用 bsp_CheckTimerEx() 查询
+*				_pArg : 回调函数的参数
+*	返 回 值: 定时器句柄, 0 表示已经没有空闲的定时器
+*********************************************************************************************************
+*/
+SOFT_TMR *bsp_CreateTimer(void (*_pCallBack)(void *_pArg), void *_pArg)
+{
+	SOFT_TMR *pTmr = 0;
+	uint8_t i;
+
+	DISABLE_INT();  	/* 关中断 */
+
+	for (i = 0; i < TMR_POOL_SIZE; i++)
+	{
+		if (s_tTmrPool[i].InUse == 0)
+		{
+			pTmr = &s_tTmrPool[i];
+			pTmr->InUse = 1;
+			break;
+		}
+	}
+
+	ENABLE_INT();  		/* 开中断 */
+
+	if (pTmr != 0)
+	{
+		pTmr->pNext = 0;
+		pTmr->ppPrev = 0;
+		pTmr->CallBack = _pCallBack;
+		pTmr->pArg = _pArg;
+		pTmr->Flag = 0;
+		pTmr->Mode = TMR_ONCE_MODE;
+	}
+	return pTmr;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_DeleteTimer
+*	功能说明: 停止并释放一个软件定时器
+*	形    参:  _pTmr : 定时器句柄
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_DeleteTimer(SOFT_TMR *_pTmr)
+{
+	if (_pTmr == 0)
+	{
+		return;
+	}
+
+	DISABLE_INT();  	/* 关中断 */
+
+	bsp_TmrRemove(_pTmr);
+	_pTmr->InUse = 0;
+
+	ENABLE_INT();  		/* 开中断 */
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_StartTimerEx
+*	功能说明: 启动一个定时器。如果定时器已经在运行，则重新开始计时。
+*	形    参:  _pTmr : 定时器句柄
+*				_period : 定时周期，单位1ms
+*				_mode : TMR_ONCE_MODE 一次性, TMR_AUTO_MODE 自动重装
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_StartTimerEx(SOFT_TMR *_pTmr, uint32_t _period, TMR_MODE_E _mode)
+{
+	if (_pTmr == 0)
+	{
+		return;
+	}
+
+	bsp_TmrStart(_pTmr, _period, _mode);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_StopTimerEx
+*	功能说明: 停止一个定时器
+*	形    参:  _pTmr : 定时器句柄
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_StopTimerEx(SOFT_TMR *_pTmr)
+{
+	if (_pTmr == 0)
+	{
+		return;
+	}
+
+	DISABLE_INT();  	/* 关中断 */
+
+	bsp_TmrRemove(_pTmr);
+	_pTmr->Flag = 0;				/* 定时时间到标志 */
+	_pTmr->Mode = TMR_ONCE_MODE;
+
+	ENABLE_INT();  		/* 开中断 */
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_CheckTimerEx
+*	功能说明: 检测定时器是否超时。读取后清除到达标志。
+*	形    参:  _pTmr : 定时器句柄
+*	返 回 值: 返回 0 表示定时未到， 1表示定时到
+*********************************************************************************************************
+*/
+uint8_t bsp_CheckTimerEx(SOFT_TMR *_pTmr)
+{
+	if (_pTmr == 0)
+	{
+		return 0;
+	}
+
+	if (_pTmr->Flag == 1)
+	{
+		_pTmr->Flag = 0;
+		return 1;
+	}
+	else
+	{
+		return 0;
+	}
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_GetRunTime
+*	功能说明: 获取CPU运行时间，单位1ms。最长可以表示 24.85天，之后回零。计算时间差请用 bsp_CheckRunTime()，
+*			 需要长时间计时请用 bsp_GetRunTime64()
+*	形    参:  无
+*	返 回 值: CPU运行时间，单位1ms
+*********************************************************************************************************
+*/
+int32_t bsp_GetRunTime(void)
+{
+	return g_iRunTime;		/* 32位变量，读操作是原子的，不需要关中断 */
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_GetRunTime64
+*	功能说明: 获取CPU运行时间，单位1ms。64位，不会溢出。不需要关中断，可以在任意中断中调用。
+*	形    参:  无
+*	返 回 值: CPU运行时间，单位1ms
+*********************************************************************************************************
+*/
+uint64_t bsp_GetRunTime64(void)
+{
+	uint32_t uiSeq;
+	uint64_t ullMs;
+
+	do
+	{
+		uiSeq = s_uiTimeSeq;
+		__DMB();
+		ullMs = s_ullTimeMs[uiSeq & 1];
+		__DMB();
+	} while (uiSeq != s_uiTimeSeq);		/* 读取期间 SysTick 中断更新了时间，重读 */
+
+	return ullMs;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_GetTimeUs64
+*	功能说明: 获取CPU运行时间，单位1us。由64位ms运行时间和 SysTick 当前计数值合成，单调递增。
+*			  不需要关中断，可以在任意中断中调用。关中断超过1ms时时间会停止增长。
+*	形    参:  无
+*	返 回 值: CPU运行时间，单位1us
+*********************************************************************************************************
+*/
+uint64_t bsp_GetTimeUs64(void)
+{
+	uint32_t uiSeq;
+	uint32_t uiVal;
+	uint32_t uiCycles;
+	uint64_t ullMs;
+
+	do
+	{
+		uiSeq = s_uiTimeSeq;
+		__DMB();
+		ullMs = s_ullTimeMs[uiSeq & 1];
+		uiVal = SysTick->VAL;
+
+		/*
+			SysTick 已经归零但是中断还没有执行(在更高优先级的中断中或者关中断时)，ms 还没有加1。
+			归零可能发生在读 VAL 之后，因此要重读 VAL。
+		*/
+		if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)
+		{
+			uiVal = SysTick->VAL;
+			ullMs++;
+		}
+		__DMB();
+	} while (uiSeq != s_uiTimeSeq);
+
+	/* SysTick 是递减计数器，本节拍已经过去的计数值 */
+	uiCycles = (uiVal < s_uiTickCycles) ? (s_uiTickCycles - 1 - uiVal) : 0;
+
+	return ullMs * 1000 + uiCycles / (s_uiTickCycles / 1000);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_CheckRunTime
+*	功能说明: 计算当前运行时间和给定时刻之间的差值。处理了计数器循环。
+*	形    参:  _LastTime 上个时刻
+*	返 回 值: 当前时间和过去时间的差值，单位1ms
+*********************************************************************************************************
+*/
+int32_t bsp_CheckRunTime(int32_t _LastTime)
+{
+	/* 运行时间在 0x80000000 处回零，相减后取低31位即可处理回零 */
+	return (int32_t)(((uint32_t)g_iRunTime - (uint32_t)_LastTime) & 0x7FFFFFFF);
+}
+
+#if TMR_TICKLESS_EN == 1
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_GetIdleTicks
+*	功能说明: 计算可以连续跳过多少个1ms节拍：最近的软件定时器到期(包括时间轮的逐层搬移)、bsp_DelayMS()
+*			  和 bsp_RunPer10ms() 中的周期任务(按键扫描等)。必须在关中断状态下调用。
+*	形    参: _uiMax : 最大值
+*	返 回 值: 到下一个必须处理的节拍为止的节拍数，>= 1。返回 1 表示下一个节拍就要处理，不能跳过。
+*********************************************************************************************************
+*/
+static uint32_t bsp_GetIdleTicks(uint32_t _uiMax)
+{
+	uint32_t uiTicks;
+	uint32_t uiTime;
+	uint32_t uiLimit;
+	uint8_t ucLevel;
+
+	/* bsp_DelayMS() 正在计时 */
+	if (s_ullDelayEnd != 0)
+	{
+		uiLimit = (s_ullDelayEnd > s_ullTimeMs[s_uiTimeSeq & 1]) ? (uint32_t)(s_ullDelayEnd - s_ullTimeMs[s_uiTimeSeq & 1]) : 1;
+		if (uiLimit < _uiMax)
+		{
+			_uiMax = uiLimit;
+		}
+	}
+
+	/* 10ms周期任务。空闲时(按键全部弹起等)可以延长到 TMR_IDLE_PER10MS_TIME, 为0时不限制 */
+	uiLimit = bsp_Per10msIsIdle() ? TMR_IDLE_PER10MS_TIME : 10;
+	if (uiLimit > 0)
+	{
+		uiLimit = (s_usPer10msCount < uiLimit) ? (uiLimit - s_usPer10msCount) : 1;
+		if (uiLimit < _uiMax)
+		{
+			_uiMax = uiLimit;
+		}
+	}
+
+	/*
+		第 uiTicks 个节拍处理的是时刻 s_uiWheelTime + uiTicks - 1。
+		第0层的槽最多向前看一圈(之后的槽由上层搬移下来)，每到一层的边界检查上层对应的槽是否有定时器需要搬移。
+	*/
+	for (uiTicks = 1; uiTicks < _uiMax; uiTicks++)
+	{
+		uiTime = s_uiWheelTime + uiTicks - 1;
+
+		if (uiTicks <= TMR_WHEEL_SIZE && s_pWheel[0][uiTime & TMR_WHEEL_MASK] != 0)
+		{
+			break;		/* 有定时器到期 */
+		}
+
+		for (ucLevel = 1; ucLevel < TMR_WHEEL_LEVELS; ucLevel++)
+		{
+			if ((uiTime & ((1UL << (ucLevel * TMR_WHEEL_BITS)) - 1)) != 0)
+			{
+				ucLevel = TMR_WHEEL_LEVELS;		/* 不在本层边界，更上层也不会搬移 */
+				break;
+			}
+			if (s_pWheel[ucLevel][(uiTime >> (ucLevel * TMR_WHEEL_BITS)) & TMR_WHEEL_MASK] != 0)
+			{
+				break;
+			}
+		}
+		if (ucLevel < TMR_WHEEL_LEVELS)
+		{
+			break;		/* 有定时器需要搬移 */
+		}
+	}
+	return uiTicks;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_StepTick
+*	功能说明: 休眠唤醒后补偿跳过的节拍。被跳过的节拍内没有软件定时器到期(见 bsp_GetIdleTicks)。
+*			  必须在关中断状态下调用。跳过的10ms任务不在这里执行, 留给开中断后的下一个 SysTick 中断。
+*	形    参: _uiTicks : 跳过的节拍数
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void bsp_StepTick(uint32_t _uiTicks)
+{
+	uint32_t i;
+
+	if (_uiTicks == 0)
+	{
+		return;
+	}
+
+	bsp_TimeAdvance(_uiTicks);
+
+	/* 时间轮逐格前进，保证上层的定时器按时搬移。跳过的格中没有到期的定时器，开销很小 */
+	for (i = 0; i < _uiTicks; i++)
+	{
+		bsp_SoftTimerTick();
+	}
+
+	/*
+		跳过的10ms任务只补做1次。按键扫描等任务耗时较长, 不能在关中断状态下执行, 也不能在主程序中执行
+		(会和 SysTick 中断重入), 所以让下一个 SysTick 中断执行: 休眠到期时 SysTick 中断已经挂起,
+		开中断后立即执行; 被其他中断唤醒时不超过1ms。
+	*/
+	s_usPer10msCount += _uiTicks;
+	if (s_usPer10msCount >= 10)
+	{
+		s_usPer10msCount = 9;
+	}
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_IdleStatUpdate
+*	功能说明: 累计休眠统计，每隔1秒更新一次唤醒频率和休眠比例
+*	形    参: _uiSleepCycles : 本次在 WFI 中的时间，单位为 SysTick 计数值
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void bsp_IdleStatUpdate(uint32_t _uiSleepCycles)
+{
+	uint32_t uiElapsed;
+	uint32_t uiSleepUs;
+	uint64_t ullNow;
+
+	uiSleepUs = _uiSleepCycles / (s_uiTickCycles / 1000);
+	s_tIdle.Wakeups++;
+	s_uiStatWakeups++;
+	s_uiStatSleepUs += uiSleepUs;
+
+	ullNow = s_ullTimeMs[s_uiTimeSeq & 1];
+	uiElapsed = (uint32_t)(ullNow - s_ullStatStart);
+	if (uiElapsed >= 1000)
+	{
+		s_tIdle.SleepMs += s_uiStatSleepUs / 1000;
+		s_tIdle.WakeupsPerSec = (s_uiStatWakeups * 1000) / uiElapsed;
+		s_tIdle.SleepPermille = s_uiStatSleepUs / uiElapsed;
+		s_uiStatWakeups = 0;
+		s_uiStatSleepUs = 0;
+		s_ullStatStart = ullNow;
+	}
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_TicklessIdle
+*	功能说明: 低功耗休眠。根据最近需要处理的节拍重新设置 SysTick 的重装值，执行 WFI 使CPU休眠，
+*			  被 SysTick 或其他中断唤醒后，补偿运行时间和软件定时器。由 bsp_Idle() 调用。
+*			  外设中断(串口、USB、硬件定时器等)照常唤醒CPU，主程序在唤醒后继续轮询。
+*			  主程序还有待处理的数据时(bsp_IdleCanSleep() 返回0)不休眠。
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+extern uint8_t bsp_IdleCanSleep(void);
+void bsp_TicklessIdle(void)
+{
+	uint32_t uiTicks;
+	uint32_t uiReload;
+	uint32_t uiVal;
+	uint32_t uiElapsed;
+	uint32_t uiDone;
+
+	DISABLE_INT();  	/* 关中断。中断挂起时 WFI 仍会返回，开中断后再执行中断服务程序 */
+
+	/* 在关中断状态下检查, 检查之后到达的数据会挂起中断, WFI 立即返回 */
+	if (bsp_IdleCanSleep() == 0)
+	{
+		ENABLE_INT();
+		return;
+	}
+
+	uiTicks = bsp_GetIdleTicks(s_uiMaxIdleTicks);
+	if (uiTicks < 2 || (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk))
+	{
+		/* 下一个节拍就要处理，按正常节拍休眠 */
+		uiVal = SysTick->VAL;
+		(void)SysTick->CTRL;		/* 读操作清除 COUNTFLAG */
+		__DSB();
+		__WFI();
+		if (SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk)
+		{
+			uiElapsed = uiVal + (s_uiTickCycles - 1 - SysTick->VAL);
+		}
+		else
+		{
+			uiElapsed = uiVal - SysTick->VAL;
+		}
+		bsp_IdleStatUpdate(uiElapsed);
+
+		ENABLE_INT();  		/* 开中断 */
+		return;
+	}
+
+	/* 停止 SysTick，本节拍剩余的计数加上 uiTicks - 1 个完整节拍 */
+	SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk;
+	uiReload = SysTick->VAL + (uiTicks - 1) * s_uiTickCycles;
+	SysTick->LOAD = uiReload;
+	SysTick->VAL = 0;
+	SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+
+	__DSB();
+	__WFI();
+	__ISB();
+
+	/* 先停止 SysTick 再读 COUNTFLAG，避免读数期间计数器归零 */
+	SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk;
+	if (SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk)
+	{
+		/*
+			休眠到期，SysTick 中断已经挂起，开中断后由 SysTick_ISR 处理最后1个节拍。
+			计数器已重装并继续计数了 uiReload - VAL，从下一节拍中扣除。
+		*/
+		uiVal = SysTick->VAL;
+		uiElapsed = uiReload + (uiReload - uiVal);
+		uiDone = uiTicks - 1;
+		uiVal = uiReload - uiVal;
+		SysTick->LOAD = (uiVal < s_uiTickCycles - 1) ? (s_uiTickCycles - 1 - uiVal) : (s_uiTickCycles - 1);
+	}
+	else
+	{
+		/* 被其他中断唤醒，计算已经过去的完整节拍数，SysTick 在下一个节拍边界触发 */
+		uiElapsed = uiReload - SysTick->VAL;
+		uiVal = uiElapsed + (s_uiTickCycles - uiReload % s_uiTickCycles) % s_uiTickCycles;	/* 从本节拍开始计算 */
+		uiDone = uiVal / s_uiTickCycles;
+		SysTick->LOAD = (uiDone + 1) * s_uiTickCycles - uiVal;
+	}
+
+	/* 重新启动 SysTick，之后恢复 1ms 的重装值 */
+	SysTick->VAL = 0;
+	SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+	SysTick->LOAD = s_uiTickCycles - 1;
+
+	bsp_StepTick(uiDone);
+	bsp_IdleStatUpdate(uiElapsed);
+
+	ENABLE_INT();  		/* 开中断 */
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_GetIdleStat
+*	功能说明: 读取低功耗休眠统计
+*	形    参: _pStat : 结果存放地址
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_GetIdleStat(IDLE_STAT_T *_pStat)
+{
+	DISABLE_INT();  	/* 关中断 */
+	*_pStat = s_tIdle;
+	ENABLE_INT();  		/* 开中断 */
+}
+#endif
+
+/*
+*********************************************************************************************************
+*	函 数 名: SysTick_Handler
+*	功能说明: 系统嘀嗒定时器中断服务程序。启动文件中引用了该函数。
+*	形    参:  无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void SysTick_Handler(void)
+{
+	SysTick_ISR();
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_InitHardTimer
+*	功能说明: 配置 TIMx，用于us级别硬件定时。TIMx将自由运行，永不停止. 更新中断把计数器扩展为32位。
+*			TIMx可以用TIM2 - TIM5 之间的TIM, 这些TIM有4个通道, 挂在 APB1 上，输入时钟=SystemCoreClock / 2
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+#if defined (USE_TIM2) || defined (USE_TIM3)  || defined (USE_TIM4)	|| defined (USE_TIM5)
+void bsp_InitHardTimer(void)
+{
+	TIM_TimeBaseInitTypeDef  TIM_TimeBaseStructure;
+	uint32_t usPeriod;
+	uint16_t usPrescaler;
+	uint32_t uiTIMxCLK;
+
+  	/* 使能TIM时钟 */
+	RCC_APB1PeriphClockCmd(TIM_HARD_RCC, ENABLE);
+
+    /*-----------------------------------------------------------------------
+		system_stm32f10x.c 文件中 void SetSysClockTo72(void) 函数对时钟的配置如下：
+
+		HCLK = SYSCLK / 1     (AHBPeriph)
+		PCLK2 = HCLK / 1      (APB2Periph)
+		PCLK1 = HCLK / 2      (APB1Periph)
+
+		因为APB1 prescaler != 1, 所以 APB1上的TIMxCLK = PCLK1 x 2 = SystemCoreClock;
+		因为APB2 prescaler = 1, 所以 APB2上的TIMxCLK = PCLK2 = SystemCoreClock;
+
+		APB1 定时器有 TIM2, TIM3 ,TIM4, TIM5, TIM6, TIM7
+		APB2 定时器有 TIM1, TIM8
+
+	----------------------------------------------------------------------- */
+	uiTIMxCLK = SystemCoreClock;
+
+	usPrescaler = uiTIMxCLK / 1000000 - 1;	/* 分频到周期 1us, 实际分频系数 = 预分频寄存器 + 1 */
+	
+#if defined (USE_TIM2) || defined (USE_TIM5) 
+	//usPeriod = 0xFFFFFFFF;	/* 407支持32位定时器 */
+	usPeriod = 0xFFFF;	/* 103支持16位 */
+#else
+	usPeriod = 0xFFFF;
+#endif
+	/* Time base configuration */
+	TIM_TimeBaseStructure.TIM_Period = usPeriod;
+	TIM_TimeBaseStructure.TIM_Prescaler = usPrescaler;
+	TIM_TimeBaseStructure.TIM_ClockDivision = 0;
+	TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
+
+	TIM_TimeBaseInit(TIM_HARD, &TIM_TimeBaseStructure);
+
+	//TIM_ARRPreloadConfig(TIMx, ENABLE);
+
+	s_usHardHigh = 0;
+	s_pHardList = 0;
+	memset(&s_tHardStat, 0, sizeof(s_tHardStat));
+	memset(s_tHardCC, 0, sizeof(s_tHardCC));
+
+	/* 更新中断用于扩展计数器的高16位。TIM_TimeBaseInit() 产生了更新事件，先清除标志 */
+	TIM_ClearITPendingBit(TIM_HARD, TIM_IT_Update);
+	TIM_ITConfig(TIM_HARD, TIM_IT_Update, ENABLE);
+
+	/* TIMx enable counter */
+	TIM_Cmd(TIM_HARD, ENABLE);
+
+	/* 配置TIM定时中断 (Update) */
+	{
+		NVIC_InitTypeDef NVIC_InitStructure;	/* 中断结构体在 misc.h 中定义 */
+
+		NVIC_InitStructure.NVIC_IRQChannel = TIM_HARD_IRQn;
+
+		NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 4;	/* 比串口优先级低 */
+		NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+		NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+		NVIC_Init(&NVIC_InitStructure);
+	}
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_GetHardTimerCount32
+*	功能说明: 读取32位的硬件定时器计数值，单位1us，约71分钟回绕。不需要关中断。
+*			  在比 TIMx 优先级高的中断中或者关中断时调用，溢出中断可能还没有执行，通过溢出标志补偿。
+*	形    参: 无
+*	返 回 值: 计数值
+*********************************************************************************************************
+*/
+uint32_t bsp_GetHardTimerCount32(void)
+{
+	uint16_t usHigh;
+	uint16_t usLow;
+	uint16_t usFlag;
+
+	do
+	{
+		usHigh = s_usHardHigh;
+		usLow = TIM_HARD->CNT;
+		usFlag = TIM_HARD->SR & TIM_SR_UIF;
+	} while (usHigh != s_usHardHigh);	/* 读取期间执行了溢出中断，重读 */
+
+	/* 已经溢出但是中断还没有执行。CNT 较小说明是溢出之后读的 */
+	if (usFlag && usLow < 0x8000)
+	{
+		usHigh++;
+	}
+
+	return ((uint32_t)usHigh << 16) | usLow;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_HardTmrInsert
+*	功能说明: 按到期时刻把定时器插入队列，到期时刻相同的排在后面。调用者必须关中断。
+*	形    参: _pTmr : 定时器
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void bsp_HardTmrInsert(HARD_TMR_T *_pTmr)
+{
+	HARD_TMR_T **ppNode;
+
+	ppNode = (HARD_TMR_T **)&s_pHardList;
+	while (*ppNode != 0 && (int32_t)((*ppNode)->Expire - _pTmr->Expire) <= 0)
+	{
+		ppNode = &(*ppNode)->pNext;
+	}
+	_pTmr->pNext = *ppNode;
+	*ppNode = _pTmr;
+	_pTmr->Active = 1;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_HardTmrRemove
+*	功能说明: 把定时器从队列中摘下。调用者必须关中断。
+*	形    参: _pTmr : 定时器
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void bsp_HardTmrRemove(HARD_TMR_T *_pTmr)
+{
+	HARD_TMR_T **ppNode;
+
+	if (_pTmr->Active == 0)
+	{
+		return;
+	}
+
+	for (ppNode = (HARD_TMR_T **)&s_pHardList; *ppNode != 0; ppNode = &(*ppNode)->pNext)
+	{
+		if (*ppNode == _pTmr)
+		{
+			*ppNode = _pTmr->pNext;
+			break;
+		}
+	}
+	_pTmr->pNext = 0;
+	_pTmr->Active = 0;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_HardTmrProgram
+*	功能说明: 按队首的到期时刻设置CC1。距离到期超过16位计数范围时不设置，由溢出中断再次检查。
+*			  调用者必须关中断。
+*	形    参: 无
+*	返 回 值: 1 表示队首已经到期(或即将到期，来不及设置比较值)，需要立即处理
+*********************************************************************************************************
+*/
+static uint8_t bsp_HardTmrProgram(void)
+{
+	HARD_TMR_T *pHead;
+	int32_t iDiff;
+
+	pHead = s_pHardList;
+	if (pHead == 0)
+	{
+		TIM_ITConfig(TIM_HARD, TIM_IT_CC1, DISABLE);
+		return 0;
+	}
+
+	iDiff = (int32_t)(pHead->Expire - bsp_GetHardTimerCount32());
+	if (iDiff <= HARD_TMR_MIN_US)
+	{
+		return 1;
+	}
+
+	if (iDiff <= 0xFFFF)
+	{
+		TIM_SetCompare1(TIM_HARD, (uint16_t)pHead->Expire);
+		TIM_ClearITPendingBit(TIM_HARD, TIM_IT_CC1);
+		TIM_ITConfig(TIM_HARD, TIM_IT_CC1, ENABLE);
+
+		/* 设置比较值期间计数器可能已经越过了比较值 */
+		if ((int32_t)(pHead->Expire - bsp_GetHardTimerCount32()) <= 0)
+		{
+			return 1;
+		}
+	}
+	else
+	{
+		TIM_ITConfig(TIM_HARD, TIM_IT_CC1, DISABLE);
+	}
+	return 0;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_StartHardTimerEx
+*	功能说明: 启动一个us级硬件定时。定时器个数不限，到期后在 TIMx 中断中执行回调函数。
+*			  如果定时器已经在运行，则重新开始计时。可以在主程序和中断服务程序(包括回调函数)中调用。
+*	形    参: _pTmr : 定时器，由调用者分配，运行期间不能释放
+*			  _uiDelay : 首次到期的延迟, 单位 1us，最大 0x7FFFFFFF
+*			  _uiPeriod : 周期, 单位 1us。 0 表示单次定时
+*			  _pCallBack : 定时时间到后，被执行的函数
+*			  _pArg : 回调函数的参数
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_StartHardTimerEx(HARD_TMR_T *_pTmr, uint32_t _uiDelay, uint32_t _uiPeriod,
+	void (*_pCallBack)(void *_pArg), void *_pArg)
+{
+	DISABLE_INT();  	/* 关中断 */
+
+	bsp_HardTmrRemove(_pTmr);
+	_pTmr->Expire = bsp_GetHardTimerCount32() + _uiDelay;
+	_pTmr->Period = _uiPeriod;
+	_pTmr->CallBack = _pCallBack;
+	_pTmr->pArg = _pArg;
+	bsp_HardTmrInsert(_pTmr);
+
+	if (s_pHardList == _pTmr)
+	{
+		if (bsp_HardTmrProgram())
+		{
+			NVIC_SetPendingIRQ(TIM_HARD_IRQn);	/* 已经到期，由中断服务程序执行回调函数 */
+		}
+	}
+
+	ENABLE_INT();  		/* 开中断 */
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_StopHardTimerEx
+*	功能说明: 取消一个硬件定时。回调函数还没有执行就不会再执行。
+*	形    参: _pTmr : 定时器
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_StopHardTimerEx(HARD_TMR_T *_pTmr)
+{
+	DISABLE_INT();  	/* 关中断 */
+
+	if (_pTmr->Active)
+	{
+		bsp_HardTmrRemove(_pTmr);
+		if (bsp_HardTmrProgram())	/* 队首可能变了 */
+		{
+			NVIC_SetPendingIRQ(TIM_HARD_IRQn);
+		}
+	}
+
+	ENABLE_INT();  		/* 开中断 */
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_GetHardTimerStat
+*	功能说明: 读取硬件定时的统计数据，用于评估中断延迟
+*	形    参: _pStat : 结果存放地址
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_GetHardTimerStat(HARD_TMR_STAT_T *_pStat)
+{
+	DISABLE_INT();  	/* 关中断 */
+	*_pStat = s_tHardStat;
+	ENABLE_INT();  		/* 开中断 */
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_HardTmrCallCC
+*	功能说明: 兼容接口的回调函数，参数是原来的无参数回调函数
+*	形    参: _pArg : 回调函数
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void bsp_HardTmrCallCC(void *_pArg)
+{
+	((void (*)(void))_pArg)();
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_StartHardTimer
+*	功能说明: 使用TIM2-5做单次定时器使用, 定时时间到后执行回调函数。可以同时启动4个定时器，互不干扰。
+*			 兼容接口，内部使用 bsp_StartHardTimerEx()，4个通道号只是4个独立的定时器，不再对应硬件比较通道。
+*	形    参: _CC : 定时器编号，1，2，3, 4
+*             _uiTimeOut : 超时时间, 单位 1us. 最大 0x7FFFFFFF
+*             _pCallBack : 定时时间到后，被执行的函数
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_StartHardTimer(uint8_t _CC, uint32_t _uiTimeOut, void * _pCallBack)
+{
+	if (_CC < 1 || _CC > 4)
+	{
+		return;
+	}
+
+	bsp_StartHardTimerEx(&s_tHardCC[_CC - 1], _uiTimeOut, 0, bsp_HardTmrCallCC, _pCallBack);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_GetHardTimerCount
+*	功能说明: 读取硬件定时器的计数值。计数器以1us为单位自由运行, 16位回绕, 用于测量短时间间隔:
+*			  (uint16_t)(后一次读数 - 前一次读数) 就是间隔的us数, 最大 65.5ms。更长的间隔请用 bsp_GetHardTimerCount32()
+*	形    参: 无
+*	返 回 值: 计数值
+*********************************************************************************************************
+*/
+uint16_t bsp_GetHardTimerCount(void)
+{
+	return TIM_GetCounter(TIM_HARD);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_HardTmrService
+*	功能说明: 执行所有已经到期的硬件定时，然后按新的队首设置CC1。在 TIMx 中断中调用。
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void bsp_HardTmrService(void)
+{
+	HARD_TMR_T *pTmr;
+	uint32_t uiNow;
+	uint32_t uiLate;
+	void (*pCallBack)(void *_pArg);
+	void *pArg;
+
+	while (1)
+	{
+		DISABLE_INT();  	/* 关中断。更高优先级的中断中可能启动或取消定时 */
+
+		pTmr = s_pHardList;
+		if (pTmr == 0 || (int32_t)(pTmr->Expire - bsp_GetHardTimerCount32()) > HARD_TMR_MIN_US)
+		{
+			if (bsp_HardTmrProgram() == 0)
+			{
+				ENABLE_INT();
+				break;
+			}
+			pTmr = s_pHardList;		/* 设置比较值期间到期了 */
+		}
+
+		/* 出队，周期定时重新入队。落后超过1个周期时跳过错过的周期 */
+		uiNow = bsp_GetHardTimerCount32();
+		uiLate = uiNow - pTmr->Expire;
+		if ((int32_t)uiLate < 0)
+		{
+			uiLate = 0;		/* 提前不超过 HARD_TMR_MIN_US */
+		}
+		s_pHardList = pTmr->pNext;
+		pTmr->pNext = 0;
+		pTmr->Active = 0;
+		pCallBack = pTmr->CallBack;
+		pArg = pTmr->pArg;
+
+		if (pTmr->Period > 0)
+		{
+			pTmr->Expire += pTmr->Period;
+			while ((int32_t)(pTmr->Expire - uiNow) <= 0)
+			{
+				pTmr->Expire += pTmr->Period;
+				s_tHardStat.Missed++;
+			}
+			bsp_HardTmrInsert(pTmr);
+		}
+
+		/* 延迟统计 */
+		s_tHardStat.Fired++;
+		s_tHardStat.LateSum += uiLate;
+		if (uiLate > s_tHardStat.LateMax)
+		{
+			s_tHardStat.LateMax = uiLate;
+		}
+		if (uiLate > HARD_TMR_LATE_US)
+		{
+			s_tHardStat.LateCount++;
+		}
+
+		ENABLE_INT();  		/* 开中断 */
+
+		/* 先出队，再执行回调函数。因为回调函数可能需要重启定时器 */
+		if (pCallBack != 0)
+		{
+			pCallBack(pArg);
+		}
+	}
+}
+#endif
+
+/*
+*********************************************************************************************************
+*	函 数 名: TIMx_IRQHandler
+*	功能说明: TIM 中断服务程序。更新中断累加计数器高16位，CC1中断执行到期的硬件定时。
+*	形    参：无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+
+#ifdef USE_TIM2
+void TIM2_IRQHandler(void)
+#endif
+
+#ifdef USE_TIM3
+void TIM3_IRQHandler(void)
+#endif
+
+#ifdef USE_TIM4
+void TIM4_IRQHandler(void)
+#endif
+
+#ifdef USE_TIM5
+void TIM5_IRQHandler(void)
+#endif
+{
+	if (TIM_GetITStatus(TIM_HARD, TIM_IT_Update))
+	{
+		TIM_ClearITPendingBit(TIM_HARD, TIM_IT_Update);
+		s_usHardHigh++;
+	}
+
+	if (TIM_GetITStatus(TIM_HARD, TIM_IT_CC1))
+	{
+		TIM_ClearITPendingBit(TIM_HARD, TIM_IT_CC1);
+	}
+
+	/* 每次溢出也检查一次，距离到期超过16位范围的定时在这里设置比较值 */
+	bsp_HardTmrService();
+}
+
+/***************************** 安富莱电子 www.armfly.com (END OF FILE) *********************************/
@@ -1,1105 +1,2113 @@
-/*
-*********************************************************************************************************
-*
-*	模块名称 : 串口中断+FIFO驱动模块
-*	文件名称 : bsp_uart_fifo.c
-*	版    本 : V1.0
-*	说    明 : 采用串口中断+FIFO模式实现多个串口的同时访问
-*	修改记录 :
-*		版本号  日期       作者    说明
-*		V1.0    2013-02-01 armfly  正式发布
-*		V1.1    2013-06-09 armfly  FiFo结构增加TxCount成员变量，方便判断缓冲区满; 增加 清FiFo的函数
-*		V1.2	2014-09-29 armfly  增加RS485 MODBUS接口。接收到新字节后，直接执行回调函数。
-*
-*	Copyright (C), 2013-2014, 安富莱电子 www.armfly.com
-*
-*********************************************************************************************************
-*/
-
-#include "bsp_uart_fifo.h"
-
-
-/* 定义每个串口结构体变量 */
-#if UART1_FIFO_EN == 1
-	static UART_T g_tUart1;
-	static uint8_t g_TxBuf1[UART1_TX_BUF_SIZE];		/* 发送缓冲区 */
-	static uint8_t g_RxBuf1[UART1_RX_BUF_SIZE];		/* 接收缓冲区 */
-#endif
-
-#if UART2_FIFO_EN == 1
-	static UART_T g_tUart2;
-	static uint8_t g_TxBuf2[UART2_TX_BUF_SIZE];		/* 发送缓冲区 */
-	static uint8_t g_RxBuf2[UART2_RX_BUF_SIZE];		/* 接收缓冲区 */
-#endif
-
-#if UART3_FIFO_EN == 1
-	static UART_T g_tUart3;
-	static uint8_t g_TxBuf3[UART3_TX_BUF_SIZE];		/* 发送缓冲区 */
-	static uint8_t g_RxBuf3[UART3_RX_BUF_SIZE];		/* 接收缓冲区 */
-#endif
-
-#if UART4_FIFO_EN == 1
-	static UART_T g_tUart4;
-	static uint8_t g_TxBuf4[UART4_TX_BUF_SIZE];		/* 发送缓冲区 */
-	static uint8_t g_RxBuf4[UART4_RX_BUF_SIZE];		/* 接收缓冲区 */
-#endif
-
-#if UART5_FIFO_EN == 1
-	static UART_T g_tUart5;
-	static uint8_t g_TxBuf5[UART5_TX_BUF_SIZE];		/* 发送缓冲区 */
-	static uint8_t g_RxBuf5[UART5_RX_BUF_SIZE];		/* 接收缓冲区 */
-#endif
-
-static void UartVarInit(void);
-
-static void InitHardUart(void);
-static void UartSend(UART_T *_pUart, uint8_t *_ucaBuf, uint16_t _usLen);
-static uint8_t UartGetChar(UART_T *_pUart, uint8_t *_pByte);
-static void UartIRQ(UART_T *_pUart);
-static void ConfigUartNVIC(void);
-
-void RS485_InitTXE(void);
-
-/*
-*********************************************************************************************************
-*	函 数 名: bsp_InitUart
-*	功能说明: 初始化串口硬件，并对全局变量赋初值.
-*	形    参:  无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void bsp_InitUart(void)
-{
-	UartVarInit();		/* 必须先初始化全局变量,再配置硬件 */
-
-	InitHardUart();		/* 配置串口的硬件参数(波特率等) */
-
-	RS485_InitTXE();	/* 配置RS485芯片的发送使能硬件，配置为推挽输出 */
-
-	ConfigUartNVIC();	/* 配置串口中断 */
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: ComToUart
-*	功能说明: 将COM端口号转换为UART指针
-*	形    参: _ucPort: 端口号(COM1 - COM6)
-*	返 回 值: uart指针
-*********************************************************************************************************
-*/
-UART_T *ComToUart(COM_PORT_E _ucPort)
-{
-	if (_ucPort == COM1)
-	{
-		#if UART1_FIFO_EN == 1
-			return &g_tUart1;
-		#else
-			return 0;
-		#endif
-	}
-	else if (_ucPort == COM2)
-	{
-		#if UART2_FIFO_EN == 1
-			return &g_tUart2;
-		#else
-			return;
-		#endif
-	}
-	else if (_ucPort == COM3)
-	{
-		#if UART3_FIFO_EN == 1
-			return &g_tUart3;
-		#else
-			return 0;
-		#endif
-	}
-	else if (_ucPort == COM4)
-	{
-		#if UART4_FIFO_EN == 1
-			return &g_tUart4;
-		#else
-			return 0;
-		#endif
-	}
-	else if (_ucPort == COM5)
-	{
-		#if UART5_FIFO_EN == 1
-			return &g_tUart5;
-		#else
-			return 0;
-		#endif
-	}
-	else
-	{
-		/* 不做任何处理 */
-		return 0;
-	}
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: comSendBuf
-*	功能说明: 向串口发送一组数据。数据放到发送缓冲区后立即返回，由中断服务程序在后台完成发送
-*	形    参: _ucPort: 端口号(COM1 - COM6)
-*			  _ucaBuf: 待发送的数据缓冲区
-*			  _usLen : 数据长度
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void comSendBuf(COM_PORT_E _ucPort, uint8_t *_ucaBuf, uint16_t _usLen)
-{
-	UART_T *pUart;
-	/* 获取串口结构 */
-	pUart = ComToUart(_ucPort);
-	if (pUart == 0)
-	{
-		return;
-	}
-
-	if (pUart->SendBefor != 0)
-	{
-		pUart->SendBefor();		/* 如果是RS485通信，可以在这个函数中将RS485设置为发送模式 */
-	}
-
-	UartSend(pUart, _ucaBuf, _usLen);
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: comSendChar
-*	功能说明: 向串口发送1个字节。数据放到发送缓冲区后立即返回，由中断服务程序在后台完成发送
-*	形    参: _ucPort: 端口号(COM1 - COM6)
-*			  _ucByte: 待发送的数据
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void comSendChar(COM_PORT_E _ucPort, uint8_t _ucByte)
-{
-	comSendBuf(_ucPort, &_ucByte, 1);
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: comGetChar
-*	功能说明: 从串口缓冲区读取1字节，非阻塞。无论有无数据均立即返回
-*	形    参: _ucPort: 端口号(COM1 - COM6)
-*			  _pByte: 接收到的数据存放在这个地址
-*	返 回 值: 0 表示无数据, 1 表示读取到有效字节
-*********************************************************************************************************
-*/
-uint8_t comGetChar(COM_PORT_E _ucPort, uint8_t *_pByte)
-{
-	UART_T *pUart;
-
-	pUart = ComToUart(_ucPort);
-	if (pUart == 0)
-	{
-		return 0;
-	}
-
-	return UartGetChar(pUart, _pByte);
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: comClearTxFifo
-*	功能说明: 清零串口发送缓冲区
-*	形    参: _ucPort: 端口号(COM1 - COM6)
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void comClearTxFifo(COM_PORT_E _ucPort)
-{
-	UART_T *pUart;
-
-	pUart = ComToUart(_ucPort);
-	if (pUart == 0)
-	{
-		return;
-	}
-
-	pUart->usTxWrite = 0;
-	pUart->usTxRead = 0;
-	pUart->usTxCount = 0;
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: comClearRxFifo
-*	功能说明: 清零串口接收缓冲区
-*	形    参: _ucPort: 端口号(COM1 - COM6)
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void comClearRxFifo(COM_PORT_E _ucPort)
-{
-	UART_T *pUart;
-
-	pUart = ComToUart(_ucPort);
-	if (pUart == 0)
-	{
-		return;
-	}
-
-	pUart->usRxWrite = 0;
-	pUart->usRxRead = 0;
-	pUart->usRxCount = 0;
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: bsp_SetUart1Baud
-*	功能说明: 修改UART1波特率
-*	形    参: 无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void bsp_SetUart1Baud(uint32_t _baud)
-{
-	USART_InitTypeDef USART_InitStructure;
-
-	/* 第2步： 配置串口硬件参数 */
-	USART_InitStructure.USART_BaudRate = _baud;	/* 波特率 */
-	USART_InitStructure.USART_WordLength = USART_WordLength_8b;
-	USART_InitStructure.USART_StopBits = USART_StopBits_1;
-	USART_InitStructure.USART_Parity = USART_Parity_No ;
-	USART_InitStructure.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
-	USART_InitStructure.USART_Mode = USART_Mode_Rx | USART_Mode_Tx;
-	USART_Init(USART2, &USART_InitStructure);
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: bsp_SetUart2Baud
-*	功能说明: 修改UART2波特率
-*	形    参: 无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void bsp_SetUart2Baud(uint32_t _baud)
-{
-	USART_InitTypeDef USART_InitStructure;
-
-	/* 第2步： 配置串口硬件参数 */
-	USART_InitStructure.USART_BaudRate = _baud;	/* 波特率 */
-	USART_InitStructure.USART_WordLength = USART_WordLength_8b;
-	USART_InitStructure.USART_StopBits = USART_StopBits_1;
-	USART_InitStructure.USART_Parity = USART_Parity_No ;
-	USART_InitStructure.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
-	USART_InitStructure.USART_Mode = USART_Mode_Rx | USART_Mode_Tx;
-	USART_Init(USART2, &USART_InitStructure);
-}
-
-
-/* 如果是RS485通信，请按如下格式编写函数， 我们仅举了 USART3作为RS485的例子 */
-
-/*
-*********************************************************************************************************
-*	函 数 名: RS485_InitTXE
-*	功能说明: 配置RS485发送使能口线 TXE
-*	形    参: 无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void RS485_InitTXE(void)
-{
-	GPIO_InitTypeDef GPIO_InitStructure;
-
-	RCC_APB2PeriphClockCmd(RCC_RS485_TXEN, ENABLE);	/* 打开GPIO时钟 */
-
-	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
-	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_PP;	/* 推挽输出模式 */
-	GPIO_InitStructure.GPIO_Pin = PIN_RS485_TXEN;
-	GPIO_Init(PORT_RS485_TXEN, &GPIO_InitStructure);
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: bsp_Set485Baud
-*	功能说明: 修改UART3波特率
-*	形    参: 无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void bsp_Set485Baud(uint32_t _baud)
-{
-	USART_InitTypeDef USART_InitStructure;
-
-	/* 第2步： 配置串口硬件参数 */
-	USART_InitStructure.USART_BaudRate = _baud;	/* 波特率 */
-	USART_InitStructure.USART_WordLength = USART_WordLength_8b;
-	USART_InitStructure.USART_StopBits = USART_StopBits_1;
-	USART_InitStructure.USART_Parity = USART_Parity_No ;
-	USART_InitStructure.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
-	USART_InitStructure.USART_Mode = USART_Mode_Rx | USART_Mode_Tx;
-	USART_Init(USART3, &USART_InitStructure);
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: RS485_SendBefor
-*	功能说明: 发送数据前的准备工作。对于RS485通信，请设置RS485芯片为发送状态，
-*			  并修改 UartVarInit()中的函数指针等于本函数名，比如 g_tUart2.SendBefor = RS485_SendBefor
-*	形    参: 无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void RS485_SendBefor(void)
-{
-	RS485_TX_EN();	/* 切换RS485收发芯片为发送模式 */
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: RS485_SendOver
-*	功能说明: 发送一串数据结束后的善后处理。对于RS485通信，请设置RS485芯片为接收状态，
-*			  并修改 UartVarInit()中的函数指针等于本函数名，比如 g_tUart2.SendOver = RS485_SendOver
-*	形    参: 无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void RS485_SendOver(void)
-{
-	RS485_RX_EN();	/* 切换RS485收发芯片为接收模式 */
-}
-
-
-/*
-*********************************************************************************************************
-*	函 数 名: RS485_SendBuf
-*	功能说明: 通过RS485芯片发送一串数据。注意，本函数不等待发送完毕。
-*	形    参: 无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void RS485_SendBuf(uint8_t *_ucaBuf, uint16_t _usLen)
-{
-	comSendBuf(COM3, _ucaBuf, _usLen);
-}
-
-
-/*
-*********************************************************************************************************
-*	函 数 名: RS485_SendStr
-*	功能说明: 向485总线发送一个字符串
-*	形    参: _pBuf 数据缓冲区
-*			 _ucLen 数据长度
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void RS485_SendStr(char *_pBuf)
-{
-	RS485_SendBuf((uint8_t *)_pBuf, strlen(_pBuf));
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: RS485_ReciveNew
-*	功能说明: 接收到新的数据
-*	形    参: _byte 接收到的新数据
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-extern void MODBUS_ReciveNew(uint8_t _byte);
-void RS485_ReciveNew(uint8_t _byte)
-{
-	//MODBUS_ReciveNew(_byte);
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: UartVarInit
-*	功能说明: 初始化串口相关的变量
-*	形    参: 无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-static void UartVarInit(void)
-{
-#if UART1_FIFO_EN == 1
-	g_tUart1.uart = USART1;						/* STM32 串口设备 */
-	g_tUart1.pTxBuf = g_TxBuf1;					/* 发送缓冲区指针 */
-	g_tUart1.pRxBuf = g_RxBuf1;					/* 接收缓冲区指针 */
-	g_tUart1.usTxBufSize = UART1_TX_BUF_SIZE;	/* 发送缓冲区大小 */
-	g_tUart1.usRxBufSize = UART1_RX_BUF_SIZE;	/* 接收缓冲区大小 */
-	g_tUart1.usTxWrite = 0;						/* 发送FIFO写索引 */
-	g_tUart1.usTxRead = 0;						/* 发送FIFO读索引 */
-	g_tUart1.usRxWrite = 0;						/* 接收FIFO写索引 */
-	g_tUart1.usRxRead = 0;						/* 接收FIFO读索引 */
-	g_tUart1.usRxCount = 0;						/* 接收到的新数据个数 */
-	g_tUart1.usTxCount = 0;						/* 待发送的数据个数 */
-	g_tUart1.SendBefor = 0;						/* 发送数据前的回调函数 */
-	g_tUart1.SendOver = 0;						/* 发送完毕后的回调函数 */
-	g_tUart1.ReciveNew = 0;						/* 接收到新数据后的回调函数 */
-#endif
-
-#if UART2_FIFO_EN == 1
-	g_tUart2.uart = USART2;						/* STM32 串口设备 */
-	g_tUart2.pTxBuf = g_TxBuf2;					/* 发送缓冲区指针 */
-	g_tUart2.pRxBuf = g_RxBuf2;					/* 接收缓冲区指针 */
-	g_tUart2.usTxBufSize = UART2_TX_BUF_SIZE;	/* 发送缓冲区大小 */
-	g_tUart2.usRxBufSize = UART2_RX_BUF_SIZE;	/* 接收缓冲区大小 */
-	g_tUart2.usTxWrite = 0;						/* 发送FIFO写索引 */
-	g_tUart2.usTxRead = 0;						/* 发送FIFO读索引 */
-	g_tUart2.usRxWrite = 0;						/* 接收FIFO写索引 */
-	g_tUart2.usRxRead = 0;						/* 接收FIFO读索引 */
-	g_tUart2.usRxCount = 0;						/* 接收到的新数据个数 */
-	g_tUart2.usTxCount = 0;						/* 待发送的数据个数 */
-	g_tUart2.SendBefor = 0;						/* 发送数据前的回调函数 */
-	g_tUart2.SendOver = 0;						/* 发送完毕后的回调函数 */
-	g_tUart2.ReciveNew = 0;						/* 接收到新数据后的回调函数 */
-#endif
-
-#if UART3_FIFO_EN == 1
-	g_tUart3.uart = USART3;						/* STM32 串口设备 */
-	g_tUart3.pTxBuf = g_TxBuf3;					/* 发送缓冲区指针 */
-	g_tUart3.pRxBuf = g_RxBuf3;					/* 接收缓冲区指针 */
-	g_tUart3.usTxBufSize = UART3_TX_BUF_SIZE;	/* 发送缓冲区大小 */
-	g_tUart3.usRxBufSize = UART3_RX_BUF_SIZE;	/* 接收缓冲区大小 */
-	g_tUart3.usTxWrite = 0;						/* 发送FIFO写索引 */
-	g_tUart3.usTxRead = 0;						/* 发送FIFO读索引 */
-	g_tUart3.usRxWrite = 0;						/* 接收FIFO写索引 */
-	g_tUart3.usRxRead = 0;						/* 接收FIFO读索引 */
-	g_tUart3.usRxCount = 0;						/* 接收到的新数据个数 */
-	g_tUart3.usTxCount = 0;						/* 待发送的数据个数 */
-	g_tUart3.SendBefor = RS485_SendBefor;		/* 发送数据前的回调函数 */
-	g_tUart3.SendOver = RS485_SendOver;			/* 发送完毕后的回调函数 */
-	g_tUart3.ReciveNew = RS485_ReciveNew;		/* 接收到新数据后的回调函数 */
-#endif
-
-#if UART4_FIFO_EN == 1
-	g_tUart4.uart = UART4;						/* STM32 串口设备 */
-	g_tUart4.pTxBuf = g_TxBuf4;					/* 发送缓冲区指针 */
-	g_tUart4.pRxBuf = g_RxBuf4;					/* 接收缓冲区指针 */
-	g_tUart4.usTxBufSize = UART4_TX_BUF_SIZE;	/* 发送缓冲区大小 */
-	g_tUart4.usRxBufSize = UART4_RX_BUF_SIZE;	/* 接收缓冲区大小 */
-	g_tUart4.usTxWrite = 0;						/* 发送FIFO写索引 */
-	g_tUart4.usTxRead = 0;						/* 发送FIFO读索引 */
-	g_tUart4.usRxWrite = 0;						/* 接收FIFO写索引 */
-	g_tUart4.usRxRead = 0;						/* 接收FIFO读索引 */
-	g_tUart4.usRxCount = 0;						/* 接收到的新数据个数 */
-	g_tUart4.usTxCount = 0;						/* 待发送的数据个数 */
-	g_tUart4.SendBefor = 0;						/* 发送数据前的回调函数 */
-	g_tUart4.SendOver = 0;						/* 发送完毕后的回调函数 */
-	g_tUart4.ReciveNew = 0;						/* 接收到新数据后的回调函数 */
-#endif
-
-#if UART5_FIFO_EN == 1
-	g_tUart5.uart = UART5;						/* STM32 串口设备 */
-	g_tUart5.pTxBuf = g_TxBuf5;					/* 发送缓冲区指针 */
-	g_tUart5.pRxBuf = g_RxBuf5;					/* 接收缓冲区指针 */
-	g_tUart5.usTxBufSize = UART5_TX_BUF_SIZE;	/* 发送缓冲区大小 */
-	g_tUart5.usRxBufSize = UART5_RX_BUF_SIZE;	/* 接收缓冲区大小 */
-	g_tUart5.usTxWrite = 0;						/* 发送FIFO写索引 */
-	g_tUart5.usTxRead = 0;						/* 发送FIFO读索引 */
-	g_tUart5.usRxWrite = 0;						/* 接收FIFO写索引 */
-	g_tUart5.usRxRead = 0;						/* 接收FIFO读索引 */
-	g_tUart5.usRxCount = 0;						/* 接收到的新数据个数 */
-	g_tUart5.usTxCount = 0;						/* 待发送的数据个数 */
-	g_tUart5.SendBefor = 0;						/* 发送数据前的回调函数 */
-	g_tUart5.SendOver = 0;						/* 发送完毕后的回调函数 */
-	g_tUart5.ReciveNew = 0;						/* 接收到新数据后的回调函数 */
-#endif
-
-
-#if UART6_FIFO_EN == 1
-	g_tUart6.uart = USART6;						/* STM32 串口设备 */
-	g_tUart6.pTxBuf = g_TxBuf6;					/* 发送缓冲区指针 */
-	g_tUart6.pRxBuf = g_RxBuf6;					/* 接收缓冲区指针 */
-	g_tUart6.usTxBufSize = UART6_TX_BUF_SIZE;	/* 发送缓冲区大小 */
-	g_tUart6.usRxBufSize = UART6_RX_BUF_SIZE;	/* 接收缓冲区大小 */
-	g_tUart6.usTxWrite = 0;						/* 发送FIFO写索引 */
-	g_tUart6.usTxRead = 0;						/* 发送FIFO读索引 */
-	g_tUart6.usRxWrite = 0;						/* 接收FIFO写索引 */
-	g_tUart6.usRxRead = 0;						/* 接收FIFO读索引 */
-	g_tUart6.usRxCount = 0;						/* 接收到的新数据个数 */
-	g_tUart6.usTxCount = 0;						/* 待发送的数据个数 */
-	g_tUart6.SendBefor = 0;						/* 发送数据前的回调函数 */
-	g_tUart6.SendOver = 0;						/* 发送完毕后的回调函数 */
-	g_tUart6.ReciveNew = 0;						/* 接收到新数据后的回调函数 */
-#endif
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: InitHardUart
-*	功能说明: 配置串口的硬件参数（波特率，数据位，停止位，起始位，校验位，中断使能）适合于STM32-F4开发板
-*	形    参: 无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-static void InitHardUart(void)
-{
-	GPIO_InitTypeDef GPIO_InitStructure;
-	USART_InitTypeDef USART_InitStructure;
-
-#if UART1_FIFO_EN == 1		/* 串口1 TX = PA9   RX = PA10 或 TX = PB6   RX = PB7*/
-
-	/* 第1步：打开GPIO和USART部件的时钟 */
-	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOA | RCC_APB2Periph_AFIO, ENABLE);
-	RCC_APB2PeriphClockCmd(RCC_APB2Periph_USART1, ENABLE);
-
-	/* 第2步：将USART Tx的GPIO配置为推挽复用模式 */
-	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_9;
-	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;
-	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
-	GPIO_Init(GPIOA, &GPIO_InitStructure);
-
-	/* 第3步：将USART Rx的GPIO配置为浮空输入模式
-		由于CPU复位后，GPIO缺省都是浮空输入模式，因此下面这个步骤不是必须的
-		但是，我还是建议加上便于阅读，并且防止其它地方修改了这个口线的设置参数
-	*/
-	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_10;
-	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IN_FLOATING;
-	GPIO_Init(GPIOA, &GPIO_InitStructure);
-	
-	/* 第4步： 配置串口硬件参数 */
-	USART_InitStructure.USART_BaudRate = UART1_BAUD;	/* 波特率 */
-	USART_InitStructure.USART_WordLength = USART_WordLength_8b;
-	USART_InitStructure.USART_StopBits = USART_StopBits_1;
-	USART_InitStructure.USART_Parity = USART_Parity_No ;
-	USART_InitStructure.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
-	USART_InitStructure.USART_Mode = USART_Mode_Rx | USART_Mode_Tx;
-	USART_Init(USART1, &USART_InitStructure);
-
-	USART_ITConfig(USART1, USART_IT_RXNE, ENABLE);	/* 使能接收中断 */
-	/*
-		USART_ITConfig(USART1, USART_IT_TXE, ENABLE);
-		注意: 不要在此处打开发送中断
-		发送中断使能在SendUart()函数打开
-	*/
-	USART_Cmd(USART1, ENABLE);		/* 使能串口 */
-
-	/* CPU的小缺陷：串口配置好，如果直接Send，则第1个字节发送不出去
-		如下语句解决第1个字节无法正确发送出去的问题 */
-	USART_ClearFlag(USART1, USART_FLAG_TC);     /* 清发送完成标志，Transmission Complete flag */
-#endif
-
-#if UART2_FIFO_EN == 1		/* 串口2 TX = PA2， RX = PA3  */
-	/* 第1步：打开GPIO和USART部件的时钟 */
-	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOA | RCC_APB2Periph_AFIO, ENABLE);
-	RCC_APB1PeriphClockCmd(RCC_APB1Periph_USART2, ENABLE);
-
-	/* 第2步：将USART Tx的GPIO配置为推挽复用模式 */
-	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_2;
-	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;
-	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
-	GPIO_Init(GPIOA, &GPIO_InitStructure);
-
-	/* 第3步：将USART Rx的GPIO配置为浮空输入模式
-		由于CPU复位后，GPIO缺省都是浮空输入模式，因此下面这个步骤不是必须的
-		但是，我还是建议加上便于阅读，并且防止其它地方修改了这个口线的设置参数
-	*/
-	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_3;
-	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IN_FLOATING;
-	GPIO_Init(GPIOA, &GPIO_InitStructure);
-	/*  第3步已经做了，因此这步可以不做
-		GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
-	*/
-	GPIO_Init(GPIOA, &GPIO_InitStructure);
-
-	/* 第4步： 配置串口硬件参数 */
-	USART_InitStructure.USART_BaudRate = UART2_BAUD;	/* 波特率 */
-	USART_InitStructure.USART_WordLength = USART_WordLength_8b;
-	USART_InitStructure.USART_StopBits = USART_StopBits_1;
-	USART_InitStructure.USART_Parity = USART_Parity_No ;
-	USART_InitStructure.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
-	USART_InitStructure.USART_Mode = USART_Mode_Tx | USART_Mode_Rx;		/* 仅选择接收模式 */
-	USART_Init(USART2, &USART_InitStructure);
-
-	USART_ITConfig(USART2, USART_IT_RXNE, ENABLE);	/* 使能接收中断 */
-	/*
-		USART_ITConfig(USART1, USART_IT_TXE, ENABLE);
-		注意: 不要在此处打开发送中断
-		发送中断使能在SendUart()函数打开
-	*/
-	USART_Cmd(USART2, ENABLE);		/* 使能串口 */
-
-	/* CPU的小缺陷：串口配置好，如果直接Send，则第1个字节发送不出去
-		如下语句解决第1个字节无法正确发送出去的问题 */
-	USART_ClearFlag(USART2, USART_FLAG_TC);     /* 清发送完成标志，Transmission Complete flag */
-#endif
-
-#if UART3_FIFO_EN == 1			/* 串口3 TX = PB10   RX = PB11 */
-
-	/* 配置 PB2为推挽输出，用于切换 RS485芯片的收发状态 */
-	{
-		RCC_APB2PeriphClockCmd(RCC_RS485_TXEN, ENABLE);
-
-		GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_PP;
-		GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
-		GPIO_InitStructure.GPIO_Pin = PIN_RS485_TXEN;
-		GPIO_Init(PORT_RS485_TXEN, &GPIO_InitStructure);
-	}
-
-	/* 第1步： 开启GPIO和UART时钟 */
-	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOB | RCC_APB2Periph_AFIO, ENABLE);
-	RCC_APB1PeriphClockCmd(RCC_APB1Periph_USART3, ENABLE);
-
-	/* 第2步：将USART Tx的GPIO配置为推挽复用模式 */
-	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_10;
-	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;
-	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
-	GPIO_Init(GPIOB, &GPIO_InitStructure);
-
-	/* 第3步：将USART Rx的GPIO配置为浮空输入模式
-		由于CPU复位后，GPIO缺省都是浮空输入模式，因此下面这个步骤不是必须的
-		但是，我还是建议加上便于阅读，并且防止其它地方修改了这个口线的设置参数
-	*/
-	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_11;
-	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IN_FLOATING;
-	GPIO_Init(GPIOB, &GPIO_InitStructure);
-	/*  第3步已经做了，因此这步可以不做
-		GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
-	*/
-	GPIO_Init(GPIOB, &GPIO_InitStructure);
-
-	/* 第4步： 配置串口硬件参数 */
-	USART_InitStructure.USART_BaudRate = UART3_BAUD;	/* 波特率 */
-	USART_InitStructure.USART_WordLength = USART_WordLength_8b;
-	USART_InitStructure.USART_StopBits = USART_StopBits_1;
-	USART_InitStructure.USART_Parity = USART_Parity_No ;
-	USART_InitStructure.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
-	USART_InitStructure.USART_Mode = USART_Mode_Rx | USART_Mode_Tx;
-	USART_Init(USART3, &USART_InitStructure);
-
-	USART_ITConfig(USART3, USART_IT_RXNE, ENABLE);	/* 使能接收中断 */
-	/*
-		USART_ITConfig(USART1, USART_IT_TXE, ENABLE);
-		注意: 不要在此处打开发送中断
-		发送中断使能在SendUart()函数打开
-	*/
-	USART_Cmd(USART3, ENABLE);		/* 使能串口 */
-
-	/* CPU的小缺陷：串口配置好，如果直接Send，则第1个字节发送不出去
-		如下语句解决第1个字节无法正确发送出去的问题 */
-	USART_ClearFlag(USART3, USART_FLAG_TC);     /* 清发送完成标志，Transmission Complete flag */
-#endif
-
-#if UART4_FIFO_EN == 1			/* 串口4 TX = PC10   RX = PC11 */
-	/* 第1步： 开启GPIO和UART时钟 */
-	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOC | RCC_APB2Periph_AFIO, ENABLE);
-	RCC_APB1PeriphClockCmd(RCC_APB1Periph_UART4, ENABLE);
-
-	/* 第2步：将USART Tx的GPIO配置为推挽复用模式 */
-	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_10;
-	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;
-	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
-	GPIO_Init(GPIOC, &GPIO_InitStructure);
-
-	/* 第3步：将USART Rx的GPIO配置为浮空输入模式
-		由于CPU复位后，GPIO缺省都是浮空输入模式，因此下面这个步骤不是必须的
-		但是，我还是建议加上便于阅读，并且防止其它地方修改了这个口线的设置参数
-	*/
-	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_11;
-	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IN_FLOATING;
-	GPIO_Init(GPIOC, &GPIO_InitStructure);
-
-	/* 第4步： 配置串口硬件参数 */
-	USART_InitStructure.USART_BaudRate = UART4_BAUD;	/* 波特率 */
-	USART_InitStructure.USART_WordLength = USART_WordLength_8b;
-	USART_InitStructure.USART_StopBits = USART_StopBits_1;
-	USART_InitStructure.USART_Parity = USART_Parity_No ;
-	USART_InitStructure.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
-	USART_InitStructure.USART_Mode = USART_Mode_Rx | USART_Mode_Tx;
-	USART_Init(UART4, &USART_InitStructure);
-
-	USART_ITConfig(UART4, USART_IT_RXNE, ENABLE);	/* 使能接收中断 */
-	/*
-		USART_ITConfig(USART1, USART_IT_TXE, ENABLE);
-		注意: 不要在此处打开发送中断
-		发送中断使能在SendUart()函数打开
-	*/
-	USART_Cmd(UART4, ENABLE);		/* 使能串口 */
-
-	/* CPU的小缺陷：串口配置好，如果直接Send，则第1个字节发送不出去
-		如下语句解决第1个字节无法正确发送出去的问题 */
-	USART_ClearFlag(UART4, USART_FLAG_TC);     /* 清发送完成标志，Transmission Complete flag */
-#endif
-
-#if UART5_FIFO_EN == 1			/* 串口5 TX = PC12   RX = PD2 */
-	/* 第1步： 开启GPIO和UART时钟 */
-	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOC | RCC_APB2Periph_GPIOD | RCC_APB2Periph_AFIO, ENABLE);
-	RCC_APB1PeriphClockCmd(RCC_APB1Periph_UART5, ENABLE);
-
-	/* 第2步：将USART Tx的GPIO配置为推挽复用模式 */
-	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_12;
-	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;
-	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
-	GPIO_Init(GPIOC, &GPIO_InitStructure);
-
-	/* 第3步：将USART Rx的GPIO配置为浮空输入模式
-		由于CPU复位后，GPIO缺省都是浮空输入模式，因此下面这个步骤不是必须的
-		但是，我还是建议加上便于阅读，并且防止其它地方修改了这个口线的设置参数
-	*/
-	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_2;
-	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IN_FLOATING;
-	GPIO_Init(GPIOD, &GPIO_InitStructure);
-
-
-	/* 第4步： 配置串口硬件参数 */
-	USART_InitStructure.USART_BaudRate = UART5_BAUD;	/* 波特率 */
-	USART_InitStructure.USART_WordLength = USART_WordLength_8b;
-	USART_InitStructure.USART_StopBits = USART_StopBits_1;
-	USART_InitStructure.USART_Parity = USART_Parity_No ;
-	USART_InitStructure.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
-	USART_InitStructure.USART_Mode = USART_Mode_Rx | USART_Mode_Tx;
-	USART_Init(UART5, &USART_InitStructure);
-
-	USART_ITConfig(UART5, USART_IT_RXNE, ENABLE);	/* 使能接收中断 */
-	/*
-		USART_ITConfig(USART1, USART_IT_TXE, ENABLE);
-		注意: 不要在此处打开发送中断
-		发送中断使能在SendUart()函数打开
-	*/
-	USART_Cmd(UART5, ENABLE);		/* 使能串口 */
-
-	/* CPU的小缺陷：串口配置好，如果直接Send，则第1个字节发送不出去
-		如下语句解决第1个字节无法正确发送出去的问题 */
-	USART_ClearFlag(UART5, USART_FLAG_TC);     /* 清发送完成标志，Transmission Complete flag */
-#endif
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: ConfigUartNVIC
-*	功能说明: 配置串口硬件中断.
-*	形    参:  无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-static void ConfigUartNVIC(void)
-{
-	NVIC_InitTypeDef NVIC_InitStructure;
-
-	/* Configure the NVIC Preemption Priority Bits */
-	/*	NVIC_PriorityGroupConfig(NVIC_PriorityGroup_0);  --- 在 bsp.c 中 bsp_Init() 中配置中断优先级组 */
-
-#if UART1_FIFO_EN == 1
-	/* 使能串口1中断 */
-	NVIC_InitStructure.NVIC_IRQChannel = USART1_IRQn;
-	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
-	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
-	NVIC_Init(&NVIC_InitStructure);
-#endif
-
-#if UART2_FIFO_EN == 1
-	/* 使能串口2中断 */
-	NVIC_InitStructure.NVIC_IRQChannel = USART2_IRQn;
-	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;
-	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
-	NVIC_Init(&NVIC_InitStructure);
-#endif
-
-#if UART3_FIFO_EN == 1
-	/* 使能串口3中断t */
-	NVIC_InitStructure.NVIC_IRQChannel = USART3_IRQn;
-	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 2;
-	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
-	NVIC_Init(&NVIC_InitStructure);
-#endif
-
-#if UART4_FIFO_EN == 1
-	/* 使能串口4中断t */
-	NVIC_InitStructure.NVIC_IRQChannel = UART4_IRQn;
-	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 3;
-	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
-	NVIC_Init(&NVIC_InitStructure);
-#endif
-
-#if UART5_FIFO_EN == 1
-	/* 使能串口5中断t */
-	NVIC_InitStructure.NVIC_IRQChannel = UART5_IRQn;
-	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 4;
-	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
-	NVIC_Init(&NVIC_InitStructure);
-#endif
-
-#if UART6_FIFO_EN == 1
-	/* 使能串口6中断t */
-	NVIC_InitStructure.NVIC_IRQChannel = USART6_IRQn;
-	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 5;
-	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
-	NVIC_Init(&NVIC_InitStructure);
-#endif
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: UartSend
-*	功能说明: 填写数据到UART发送缓冲区,并启动发送中断。中断处理函数发送完毕后，自动关闭发送中断
-*	形    参:  无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-static void UartSend(UART_T *_pUart, uint8_t *_ucaBuf, uint16_t _usLen)
-{
-	uint16_t i;
-
-	for (i = 0; i < _usLen; i++)
-	{
-		/* 如果发送缓冲区已经满了，则等待缓冲区空 */
-		while (1)
-		{
-			__IO uint16_t usCount;
-
-			DISABLE_INT();
-			usCount = _pUart->usTxCount;
-			ENABLE_INT();
-
-			if (usCount < _pUart->usTxBufSize)
-			{
-				break;
-			}
-			USART_ITConfig(_pUart->uart, USART_IT_TXE, ENABLE);
-		}
-
-		/* 将新数据填入发送缓冲区 */
-		_pUart->pTxBuf[_pUart->usTxWrite] = _ucaBuf[i];
-
-		DISABLE_INT();
-		if (++_pUart->usTxWrite >= _pUart->usTxBufSize)
-		{
-			_pUart->usTxWrite = 0;
-		}
-		_pUart->usTxCount++;
-		ENABLE_INT();
-	}
-
-	USART_ITConfig(_pUart->uart, USART_IT_TXE, ENABLE);
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: UartGetChar
-*	功能说明: 从串口接收缓冲区读取1字节数据 （用于主程序调用）
-*	形    参: _pUart : 串口设备
-*			  _pByte : 存放读取数据的指针
-*	返 回 值: 0 表示无数据  1表示读取到数据
-*********************************************************************************************************
-*/
-static uint8_t UartGetChar(UART_T *_pUart, uint8_t *_pByte)
-{
-	uint16_t usCount;
-
-	/* usRxWrite 变量在中断函数中被改写，主程序读取该变量时，必须进行临界区保护 */
-	DISABLE_INT();
-	usCount = _pUart->usRxCount;
-	ENABLE_INT();
-
-	/* 如果读和写索引相同，则返回0 */
-	//if (_pUart->usRxRead == usRxWrite)
-	if (usCount == 0)	/* 已经没有数据 */
-	{
-		return 0;
-	}
-	else
-	{
-		*_pByte = _pUart->pRxBuf[_pUart->usRxRead];		/* 从串口接收FIFO取1个数据 */
-
-		/* 改写FIFO读索引 */
-		DISABLE_INT();
-		if (++_pUart->usRxRead >= _pUart->usRxBufSize)
-		{
-			_pUart->usRxRead = 0;
-		}
-		_pUart->usRxCount--;
-		ENABLE_INT();
-		return 1;
-	}
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: UartIRQ
-*	功能说明: 供中断服务程序调用，通用串口中断处理函数
-*	形    参: _pUart : 串口设备
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-static void UartIRQ(UART_T *_pUart)
-{
-	/* 处理接收中断  */
-	if (USART_GetITStatus(_pUart->uart, USART_IT_RXNE) != RESET)
-	{
-		/* 从串口接收数据寄存器读取数据存放到接收FIFO */
-		uint8_t ch;
-
-		ch = USART_ReceiveData(_pUart->uart);
-		_pUart->pRxBuf[_pUart->usRxWrite] = ch;
-		if (++_pUart->usRxWrite >= _pUart->usRxBufSize)
-		{
-			_pUart->usRxWrite = 0;
-		}
-		if (_pUart->usRxCount < _pUart->usRxBufSize)
-		{
-			_pUart->usRxCount++;
-		}
-
-		/* 回调函数,通知应用程序收到新数据,一般是发送1个消息或者设置一个标记 */
-		//if (_pUart->usRxWrite == _pUart->usRxRead)
-		//if (_pUart->usRxCount == 1)
-		{
-			if (_pUart->ReciveNew)
-			{
-				_pUart->ReciveNew(ch);
-			}
-		}
-	}
-
-	/* 处理发送缓冲区空中断 */
-	if (USART_GetITStatus(_pUart->uart, USART_IT_TXE) != RESET)
-	{
-		//if (_pUart->usTxRead == _pUart->usTxWrite)
-		if (_pUart->usTxCount == 0)
-		{
-			/* 发送缓冲区的数据已取完时， 禁止发送缓冲区空中断 （注意：此时最后1个数据还未真正发送完毕）*/
-			USART_ITConfig(_pUart->uart, USART_IT_TXE, DISABLE);
-
-			/* 使能数据发送完毕中断 */
-			USART_ITConfig(_pUart->uart, USART_IT_TC, ENABLE);
-		}
-		else
-		{
-			/* 从发送FIFO取1个字节写入串口发送数据寄存器 */
-			USART_SendData(_pUart->uart, _pUart->pTxBuf[_pUart->usTxRead]);
-			if (++_pUart->usTxRead >= _pUart->usTxBufSize)
-			{
-				_pUart->usTxRead = 0;
-			}
-			_pUart->usTxCount--;
-		}
-
-	}
-	/* 数据bit位全部发送完毕的中断 */
-	else if (USART_GetITStatus(_pUart->uart, USART_IT_TC) != RESET)
-	{
-		//if (_pUart->usTxRead == _pUart->usTxWrite)
-		if (_pUart->usTxCount == 0)
-		{
-			/* 如果发送FIFO的数据全部发送完毕，禁止数据发送完毕中断 */
-			USART_ITConfig(_pUart->uart, USART_IT_TC, DISABLE);
-
-			/* 回调函数, 一般用来处理RS485通信，将RS485芯片设置为接收模式，避免抢占总线 */
-			if (_pUart->SendOver)
-			{
-				_pUart->SendOver();
-			}
-		}
-		else
-		{
-			/* 正常情况下，不会进入此分支 */
-
-			/* 如果发送FIFO的数据还未完毕，则从发送FIFO取1个数据写入发送数据寄存器 */
-			USART_SendData(_pUart->uart, _pUart->pTxBuf[_pUart->usTxRead]);
-			if (++_pUart->usTxRead >= _pUart->usTxBufSize)
-			{
-				_pUart->usTxRead = 0;
-			}
-			_pUart->usTxCount--;
-		}
-	}
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: USART1_IRQHandler  USART2_IRQHandler USART3_IRQHandler UART4_IRQHandler UART5_IRQHandler
-*	功能说明: USART中断服务程序
-*	形    参: 无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-#if UART1_FIFO_EN == 1
-void USART1_IRQHandler(void)
-{
-	UartIRQ(&g_tUart1);
-}
-#endif
-
-#if UART2_FIFO_EN == 1
-void USART2_IRQHandler(void)
-{
-	UartIRQ(&g_tUart2);
-}
-#endif
-
-#if UART3_FIFO_EN == 1
-void USART3_IRQHandler(void)
-{
-	UartIRQ(&g_tUart3);
-}
-#endif
-
-#if UART4_FIFO_EN == 1
-void UART4_IRQHandler(void)
-{
-	UartIRQ(&g_tUart4);
-}
-#endif
-
-#if UART5_FIFO_EN == 1
-void UART5_IRQHandler(void)
-{
-	UartIRQ(&g_tUart5);
-}
-#endif
-
-#if UART6_FIFO_EN == 1
-void USART6_IRQHandler(void)
-{
-	UartIRQ(&g_tUart6);
-}
-#endif
-
-/*
-*********************************************************************************************************
-*	函 数 名: fputc
-*	功能说明: 重定义putc函数，这样可以使用printf函数从串口1打印输出
-*	形    参: 无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-int fputc(int ch, FILE *f)
-{
-#if 1	/* 将需要printf的字符通过串口中断FIFO发送出去，printf函数会立即返回 */
-	comSendChar(COM1, ch);
-
-	return ch;
-#else	/* 采用阻塞方式发送每个字符,等待数据发送完毕 */
-	/* 写一个字节到USART1 */
-	USART_SendData(USART1, (uint8_t) ch);
-
-	/* 等待发送结束 */
-	while (USART_GetFlagStatus(USART1, USART_FLAG_TC) == RESET)
-	{}
-
-	return ch;
-#endif
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: fgetc
-*	功能说明: 重定义getc函数，这样可以使用getchar函数从串口1输入数据
-*	形    参: 无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-int fgetc(FILE *f)
-{
-
-#if 1	/* 从串口接收FIFO中取1个数据, 只有取到数据才返回 */
-	uint8_t ucData;
-
-	while(comGetChar(COM1, &ucData) == 0);
-
-	return ucData;
-#else
-	/* 等待串口1输入数据 */
-	while (USART_GetFlagStatus(USART1, USART_FLAG_RXNE) == RESET);
-
-	return (int)USART_ReceiveData(USART1);
-#endif
-}
-
-/***************************** 安富莱电子 www.armfly.com (END OF FILE) *********************************/
+/*
+*********************************************************************************************************
+*
+*	模块名称 : 串口中断+FIFO驱动模块
+*	文件名称 : bsp_uart_fifo.c
+*	版    本 : V1.0
+*	说    明 : 采用串口中断+FIFO模式实现多个串口的同时访问
+*	修改记录 :
+*		版本号  日期       作者    说明
+*		V1.0    2013-02-01 armfly  正式发布
+*		V1.1    2013-06-09 armfly  FiFo结构增加TxCount成员变量，方便判断缓冲区满; 增加 清FiFo的函数
+*		V1.2	2014-09-29 armfly  增加RS485 MODBUS接口。接收到新字节后，直接执行回调函数。
+*		V1.3	2026-10-17         增加DMA发送模式(UARTx_TX_DMA_EN)，发送过程不再逐字节进中断。
+*		V1.4	2026-10-17         增加循环DMA接收模式(UARTx_RX_DMA_EN)，由IDLE中断和DMA半满/全满中断发布新数据;
+*								   ReciveNew 回调改为每段数据调用一次; 增加 comGetBuf 函数。
+*		V1.5	2026-10-17         FIFO改用无锁环形缓冲区(bsp_ring.c)，去掉计数变量，读写FIFO不再关中断。
+*		V1.6	2026-10-17         comGetBuf 更名为 comRead; 增加 comWrite 批量写函数;
+*								   增加零拷贝接口 comPeekSpan/comConsume, comReserveSpan/comCommit。
+*		V1.7	2026-10-17         增加非阻塞发送函数 comSendBufNoWait, 查询发送缓冲区空闲 comGetTxFree,
+*								   发送缓冲区低水位回调 comSetTxLowCallback。
+*		V1.8	2026-10-17         RS485_ReciveNew 接入 MODBUS 从站; 增加 comPollRxDma 函数。
+*		V1.9	2026-10-17         增加 comSetReciveNewCallback, bsp_SetUart2Param; 修正 bsp_SetUart1Baud 配置的是USART2。
+*		V2.0	2026-10-17         DMA接收检测整圈覆盖 (根据半满/全满标志), 丢弃被覆盖的数据并计数; 增加 comGetRxOverrun。
+*		V2.1	2026-10-17         comWrite 改为非阻塞, 返回实际写入的字节数。
+*		V2.2	2026-10-17         UartTxStart 保存并恢复 PRIMASK, 可以在中断中调用。
+*		V2.3	2026-10-17         增加 comFlushTxPoll, 不依赖中断发完发送FIFO, 用于死机前输出错误信息。
+*		V2.4	2026-10-17         读取接收FIFO时, 丢弃被覆盖数据和读取使用同一次读到的写索引。
+*		V2.5	2026-10-17         comClearTxFifo 中止发送时执行 SendOver 回调, RS485 不会停在发送状态。
+*		V2.6	2026-10-17         增加 comRxIsEmpty, 供低功耗模式判断能否休眠。
+*
+*	Copyright (C), 2013-2014, 安富莱电子 www.armfly.com
+*
+*********************************************************************************************************
+*/
+
+#include "bsp_uart_fifo.h"
+
+
+/* 定义每个串口结构体变量 */
+#if UART1_FIFO_EN == 1
+	static UART_T g_tUart1;
+	static uint8_t g_TxBuf1[UART1_TX_BUF_SIZE];		/* 发送缓冲区 */
+	static uint8_t g_RxBuf1[UART1_RX_BUF_SIZE];		/* 接收缓冲区 */
+#endif
+
+#if UART2_FIFO_EN == 1
+	static UART_T g_tUart2;
+	static uint8_t g_TxBuf2[UART2_TX_BUF_SIZE];		/* 发送缓冲区 */
+	static uint8_t g_RxBuf2[UART2_RX_BUF_SIZE];		/* 接收缓冲区 */
+#endif
+
+#if UART3_FIFO_EN == 1
+	static UART_T g_tUart3;
+	static uint8_t g_TxBuf3[UART3_TX_BUF_SIZE];		/* 发送缓冲区 */
+	static uint8_t g_RxBuf3[UART3_RX_BUF_SIZE];		/* 接收缓冲区 */
+#endif
+
+#if UART4_FIFO_EN == 1
+	static UART_T g_tUart4;
+	static uint8_t g_TxBuf4[UART4_TX_BUF_SIZE];		/* 发送缓冲区 */
+	static uint8_t g_RxBuf4[UART4_RX_BUF_SIZE];		/* 接收缓冲区 */
+#endif
+
+#if UART5_FIFO_EN == 1
+	static UART_T g_tUart5;
+	static uint8_t g_TxBuf5[UART5_TX_BUF_SIZE];		/* 发送缓冲区 */
+	static uint8_t g_RxBuf5[UART5_RX_BUF_SIZE];		/* 接收缓冲区 */
+#endif
+
+static void UartVarInit(void);
+
+static void InitHardUart(void);
+static void UartSend(UART_T *_pUart, uint8_t *_ucaBuf, uint16_t _usLen);
+static uint8_t UartGetChar(UART_T *_pUart, uint8_t *_pByte);
+static uint16_t UartGetBuf(UART_T *_pUart, uint8_t *_pBuf, uint16_t _usSize);
+static void UartIRQ(UART_T *_pUart);
+static void ConfigUartNVIC(void);
+static void InitUartDma(void);
+static void UartTxStart(UART_T *_pUart);
+static void UartTxDmaStart(UART_T *_pUart);
+static void UartTxDmaIRQ(UART_T *_pUart);
+static void UartRxDmaIRQ(UART_T *_pUart);
+static uint16_t UartRxDropOverrun(UART_T *_pUart);
+static void UartTxLowCheck(UART_T *_pUart);
+
+void RS485_InitTXE(void);
+void RS485_ReciveNew(uint8_t *_pBuf, uint16_t _usLen);
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_InitUart
+*	功能说明: 初始化串口硬件，并对全局变量赋初值.
+*	形    参:  无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_InitUart(void)
+{
+	UartVarInit();		/* 必须先初始化全局变量,再配置硬件 */
+
+	InitHardUart();		/* 配置串口的硬件参数(波特率等) */
+
+	InitUartDma();		/* 配置串口收发DMA通道 */
+
+	RS485_InitTXE();	/* 配置RS485芯片的发送使能硬件，配置为推挽输出 */
+
+	ConfigUartNVIC();	/* 配置串口中断 */
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: ComToUart
+*	功能说明: 将COM端口号转换为UART指针
+*	形    参: _ucPort: 端口号(COM1 - COM6)
+*	返 回 值: uart指针
+*********************************************************************************************************
+*/
+UART_T *ComToUart(COM_PORT_E _ucPort)
+{
+	if (_ucPort == COM1)
+	{
+		#if UART1_FIFO_EN == 1
+			return &g_tUart1;
+		#else
+			return 0;
+		#endif
+	}
+	else if (_ucPort == COM2)
+	{
+		#if UART2_FIFO_EN == 1
+			return &g_tUart2;
+		#else
+			return;
+		#endif
+	}
+	else if (_ucPort == COM3)
+	{
+		#if UART3_FIFO_EN == 1
+			return &g_tUart3;
+		#else
+			return 0;
+		#endif
+	}
+	else if (_ucPort == COM4)
+	{
+		#if UART4_FIFO_EN == 1
+			return &g_tUart4;
+		#else
+			return 0;
+		#endif
+	}
+	else if (_ucPort == COM5)
+	{
+		#if UART5_FIFO_EN == 1
+			return &g_tUart5;
+		#else
+			return 0;
+		#endif
+	}
+	else
+	{
+		/* 不做任何处理 */
+		return 0;
+	}
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: comSendBuf
+*	功能说明: 向串口发送一组数据。数据放到发送缓冲区后立即返回，由中断服务程序在后台完成发送
+*	形    参: _ucPort: 端口号(COM1 - COM6)
+*			  _ucaBuf: 待发送的数据缓冲区
+*			  _usLen : 数据长度
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void comSendBuf(COM_PORT_E _ucPort, uint8_t *_ucaBuf, uint16_t _usLen)
+{
+	UART_T *pUart;
+	/* 获取串口结构 */
+	pUart = ComToUart(_ucPort);
+	if (pUart == 0)
+	{
+		return;
+	}
+
+	if (pUart->SendBefor != 0)
+	{
+		pUart->SendBefor();		/* 如果是RS485通信，可以在这个函数中将RS485设置为发送模式 */
+	}
+
+	UartSend(pUart, _ucaBuf, _usLen);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: comSendBufNoWait
+*	功能说明: 向串口发送一组数据，不等待。发送缓冲区放不下时只写入能放下的部分，并在后台发送使缓冲区
+*			  降到低水位时执行 TxLow 回调（见 comSetTxLowCallback），应用程序可以据此继续发送剩余数据。
+*	形    参: _ucPort: 端口号(COM1 - COM6)
+*			  _ucaBuf: 待发送的数据缓冲区
+*			  _usLen : 数据长度
+*	返 回 值: 写入发送缓冲区的字节数
+*********************************************************************************************************
+*/
+uint16_t comSendBufNoWait(COM_PORT_E _ucPort, uint8_t *_ucaBuf, uint16_t _usLen)
+{
+	UART_T *pUart;
+	uint16_t usPut;
+
+	pUart = ComToUart(_ucPort);
+	if (pUart == 0)
+	{
+		return 0;
+	}
+
+	/* 先设置回调标志再写数据，保证发送中断一定能看到标志，不会漏掉通知 */
+	if (bsp_RingFree(&pUart->tTxRing) < _usLen)
+	{
+		pUart->ucTxLowArmed = 1;
+	}
+
+	usPut = bsp_RingPut(&pUart->tTxRing, _ucaBuf, _usLen);
+	if (usPut > 0)
+	{
+		if (pUart->SendBefor != 0)
+		{
+			pUart->SendBefor();		/* 如果是RS485通信，可以在这个函数中将RS485设置为发送模式 */
+		}
+		UartTxStart(pUart);
+	}
+	return usPut;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: comGetTxFree
+*	功能说明: 查询串口发送缓冲区的空闲字节数
+*	形    参: _ucPort: 端口号(COM1 - COM6)
+*	返 回 值: 空闲字节数
+*********************************************************************************************************
+*/
+uint16_t comGetTxFree(COM_PORT_E _ucPort)
+{
+	UART_T *pUart;
+
+	pUart = ComToUart(_ucPort);
+	if (pUart == 0)
+	{
+		return 0;
+	}
+
+	return bsp_RingFree(&pUart->tTxRing);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: comSetTxLowCallback
+*	功能说明: 设置发送缓冲区低水位回调函数。comSendBufNoWait 未能全部写入后，待发送数据降到低水位时，
+*			  在串口(或DMA)中断中执行一次回调。回调函数应尽快返回，一般只设置一个标志。
+*	形    参: _ucPort: 端口号(COM1 - COM6)
+*			  _usLowMark: 低水位, 待发送数据不多于这个值时执行回调
+*			  _pCallback: 回调函数, 0 表示不需要通知
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void comSetTxLowCallback(COM_PORT_E _ucPort, uint16_t _usLowMark, void (*_pCallback)(void))
+{
+	UART_T *pUart;
+
+	pUart = ComToUart(_ucPort);
+	if (pUart == 0)
+	{
+		return;
+	}
+
+	DISABLE_INT();
+	pUart->ucTxLowArmed = 0;
+	pUart->usTxLowMark = _usLowMark;
+	pUart->TxLow = _pCallback;
+	ENABLE_INT();
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: comSetReciveNewCallback
+*	功能说明: 设置串口收到新数据的回调函数。在串口(或DMA)中断中执行, 每次传入一段连续的新数据。
+*			  _pBuf 只在回调函数执行期间有效: DMA接收时指向接收FIFO, 中断接收时指向中断服务程序中
+*			  的临时变量 (每次1字节)。需要保留的数据应在回调中复制; 数据同时也在接收FIFO中,
+*			  回调函数可以直接用 comPeekSpan/comConsume 取走。
+*	形    参: _ucPort: 端口号(COM1 - COM6)
+*			  _pCallback: 回调函数, 0 表示不需要通知
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void comSetReciveNewCallback(COM_PORT_E _ucPort, void (*_pCallback)(uint8_t *_pBuf, uint16_t _usLen))
+{
+	UART_T *pUart;
+
+	pUart = ComToUart(_ucPort);
+	if (pUart == 0)
+	{
+		return;
+	}
+
+	DISABLE_INT();
+	pUart->ReciveNew = _pCallback;
+	ENABLE_INT();
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: comSendChar
+*	功能说明: 向串口发送1个字节。数据放到发送缓冲区后立即返回，由中断服务程序在后台完成发送
+*	形    参: _ucPort: 端口号(COM1 - COM6)
+*			  _ucByte: 待发送的数据
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void comSendChar(COM_PORT_E _ucPort, uint8_t _ucByte)
+{
+	comSendBuf(_ucPort, &_ucByte, 1);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: comGetChar
+*	功能说明: 从串口缓冲区读取1字节，非阻塞。无论有无数据均立即返回
+*	形    参: _ucPort: 端口号(COM1 - COM6)
+*			  _pByte: 接收到的数据存放在这个地址
+*	返 回 值: 0 表示无数据, 1 表示读取到有效字节
+*********************************************************************************************************
+*/
+uint8_t comGetChar(COM_PORT_E _ucPort, uint8_t *_pByte)
+{
+	UART_T *pUart;
+
+	pUart = ComToUart(_ucPort);
+	if (pUart == 0)
+	{
+		return 0;
+	}
+
+	return UartGetChar(pUart, _pByte);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: comRead
+*	功能说明: 从串口缓冲区读取一批数据，非阻塞。无论有无数据均立即返回。连续区域整段拷贝。
+*	形    参: _ucPort: 端口号(COM1 - COM6)
+*			  _pBuf: 接收到的数据存放在这个缓冲区
+*			  _usSize: 缓冲区大小，最多读取这么多字节
+*	返 回 值: 实际读取的字节数, 0 表示无数据
+*********************************************************************************************************
+*/
+uint16_t comRead(COM_PORT_E _ucPort, uint8_t *_pBuf, uint16_t _usSize)
+{
+	UART_T *pUart;
+
+	pUart = ComToUart(_ucPort);
+	if (pUart == 0)
+	{
+		return 0;
+	}
+
+	return UartGetBuf(pUart, _pBuf, _usSize);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: comWrite
+*	功能说明: 向串口发送一组数据，不等待，和 comRead 对应。发送缓冲区放不下时只写入能放下的部分，
+*			  剩余数据由调用者稍后再写。和 comSendBufNoWait 不同, 不会设置 TxLow 回调。
+*	形    参: _ucPort: 端口号(COM1 - COM6)
+*			  _pBuf: 待发送的数据缓冲区
+*			  _usLen : 数据长度
+*	返 回 值: 写入发送缓冲区的字节数, 可能小于 _usLen。端口无效或缓冲区满时返回0
+*********************************************************************************************************
+*/
+uint16_t comWrite(COM_PORT_E _ucPort, uint8_t *_pBuf, uint16_t _usLen)
+{
+	UART_T *pUart;
+	uint16_t usPut;
+
+	pUart = ComToUart(_ucPort);
+	if (pUart == 0)
+	{
+		return 0;
+	}
+
+	usPut = bsp_RingPut(&pUart->tTxRing, _pBuf, _usLen);
+	if (usPut > 0)
+	{
+		if (pUart->SendBefor != 0)
+		{
+			pUart->SendBefor();		/* 如果是RS485通信，可以在这个函数中将RS485设置为发送模式 */
+		}
+		UartTxStart(pUart);
+	}
+	return usPut;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: comPeekSpan
+*	功能说明: 取得接收FIFO中从读位置开始的一段连续数据，数据仍留在FIFO中。协议解析程序可以直接在
+*			  FIFO中处理数据，处理完毕后调用 comConsume 释放。数据回绕时需要调用两次才能取完。
+*	形    参: _ucPort: 端口号(COM1 - COM6)
+*			  _ppData: 返回连续数据的首地址
+*	返 回 值: 连续数据的字节数, 0 表示无数据
+*********************************************************************************************************
+*/
+uint16_t comPeekSpan(COM_PORT_E _ucPort, uint8_t **_ppData)
+{
+	UART_T *pUart;
+	uint16_t usCount;
+	uint16_t usSpan;
+
+	pUart = ComToUart(_ucPort);
+	if (pUart == 0)
+	{
+		return 0;
+	}
+
+	usCount = UartRxDropOverrun(pUart);
+	usSpan = bsp_RingPeekSpan(&pUart->tRxRing, _ppData);
+	if (usSpan > usCount)
+	{
+		usSpan = usCount;
+	}
+	return usSpan;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: comConsume
+*	功能说明: 释放接收FIFO中已经处理完的数据
+*	形    参: _ucPort: 端口号(COM1 - COM6)
+*			  _usLen: 释放的字节数, 不能超过 comPeekSpan 返回的长度
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void comConsume(COM_PORT_E _ucPort, uint16_t _usLen)
+{
+	UART_T *pUart;
+
+	pUart = ComToUart(_ucPort);
+	if (pUart == 0)
+	{
+		return;
+	}
+
+	bsp_RingConsume(&pUart->tRxRing, _usLen);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: comReserveSpan
+*	功能说明: 取得发送FIFO中从写位置开始的一段连续空闲空间。格式化程序可以直接在其中填写数据，
+*			  再调用 comCommit 启动发送。
+*	形    参: _ucPort: 端口号(COM1 - COM6)
+*			  _ppData: 返回连续空闲空间的首地址
+*	返 回 值: 连续空闲空间的字节数, 0 表示发送缓冲区满
+*********************************************************************************************************
+*/
+uint16_t comReserveSpan(COM_PORT_E _ucPort, uint8_t **_ppData)
+{
+	UART_T *pUart;
+
+	pUart = ComToUart(_ucPort);
+	if (pUart == 0)
+	{
+		return 0;
+	}
+
+	return bsp_RingReserveSpan(&pUart->tTxRing, _ppData);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: comCommit
+*	功能说明: 提交 comReserveSpan 取得的空间中已经填写的数据，并启动后台发送
+*	形    参: _ucPort: 端口号(COM1 - COM6)
+*			  _usLen: 填写的字节数, 不能超过 comReserveSpan 返回的长度
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void comCommit(COM_PORT_E _ucPort, uint16_t _usLen)
+{
+	UART_T *pUart;
+
+	pUart = ComToUart(_ucPort);
+	if (pUart == 0 || _usLen == 0)
+	{
+		return;
+	}
+
+	if (pUart->SendBefor != 0)
+	{
+		pUart->SendBefor();		/* 如果是RS485通信，可以在这个函数中将RS485设置为发送模式 */
+	}
+
+	bsp_RingCommit(&pUart->tTxRing, _usLen);
+	UartTxStart(pUart);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: comClearTxFifo
+*	功能说明: 清零串口发送缓冲区。正在进行的发送被中止时执行 SendOver 回调 (RS485切换到接收模式)。
+*	形    参: _ucPort: 端口号(COM1 - COM6)
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void comClearTxFifo(COM_PORT_E _ucPort)
+{
+	UART_T *pUart;
+	uint8_t ucBusy;
+
+	pUart = ComToUart(_ucPort);
+	if (pUart == 0)
+	{
+		return;
+	}
+
+	/* 发送FIFO的读索引属于中断，主程序清空时必须关中断 */
+	DISABLE_INT();
+	ucBusy = (bsp_RingCount(&pUart->tTxRing) != 0 || pUart->usTxDmaLen != 0);
+	if (pUart->TxDma != 0)
+	{
+		DMA_Cmd(pUart->TxDma, DISABLE);		/* 丢弃DMA正在发送的数据 */
+		pUart->usTxDmaLen = 0;
+	}
+	bsp_RingClear(&pUart->tTxRing);
+	if (ucBusy)
+	{
+		/* DMA已经停止, 不会再打开TC中断, 在这里结束发送 */
+		USART_ITConfig(pUart->uart, USART_IT_TXE, DISABLE);
+		USART_ITConfig(pUart->uart, USART_IT_TC, DISABLE);
+		if (pUart->SendOver)
+		{
+			pUart->SendOver();
+		}
+	}
+	ENABLE_INT();
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: comClearRxFifo
+*	功能说明: 清零串口接收缓冲区
+*	形    参: _ucPort: 端口号(COM1 - COM6)
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void comClearRxFifo(COM_PORT_E _ucPort)
+{
+	UART_T *pUart;
+
+	pUart = ComToUart(_ucPort);
+	if (pUart == 0)
+	{
+		return;
+	}
+
+	/* 主程序是接收FIFO的消费者，只需将读索引追上写索引，不用关中断 */
+	bsp_RingClear(&pUart->tRxRing);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: comPollRxDma
+*	功能说明: 立即发布接收DMA已经写入、但还未通过IDLE或半满/全满中断发布的数据，并执行 ReciveNew 回调。
+*			  用于协议超时判断前确认总线上是否还有数据，可在中断中调用。
+*	形    参: _ucPort: 端口号(COM1 - COM6)
+*	返 回 值: 新发布的字节数。非DMA接收模式返回0
+*********************************************************************************************************
+*/
+uint16_t comPollRxDma(COM_PORT_E _ucPort)
+{
+	UART_T *pUart;
+	uint16_t usHead;
+
+	pUart = ComToUart(_ucPort);
+	if (pUart == 0 || pUart->RxDma == 0)
+	{
+		return 0;
+	}
+
+	/* 接收FIFO的写索引属于串口中断，这里必须关中断 */
+	DISABLE_INT();
+	usHead = pUart->tRxRing.usHead;
+	UartRxDmaIRQ(pUart);
+	usHead = pUart->tRxRing.usHead - usHead;
+	ENABLE_INT();
+
+	return usHead;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: comGetRxOverrun
+*	功能说明: 读取DMA接收覆盖未读数据的次数。主程序来不及读取, 或中断被长时间屏蔽使DMA转了整整一圈时增加。
+*	形    参: _ucPort: 端口号(COM1 - COM6)
+*	返 回 值: 覆盖次数。非DMA接收模式返回0
+*********************************************************************************************************
+*/
+uint32_t comGetRxOverrun(COM_PORT_E _ucPort)
+{
+	UART_T *pUart;
+
+	pUart = ComToUart(_ucPort);
+	if (pUart == 0)
+	{
+		return 0;
+	}
+
+	return pUart->ulRxOverrun;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: comRxIsEmpty
+*	功能说明: 判断串口接收FIFO是否已读空。bsp_Idle() 在低功耗模式下据此决定能否休眠。可以在关中断时调用。
+*	形    参: _ucPort: 端口号(COM1 - COM6)
+*	返 回 值: 1 表示为空 (或端口未使用), 0 表示还有未读的数据
+*********************************************************************************************************
+*/
+uint8_t comRxIsEmpty(COM_PORT_E _ucPort)
+{
+	UART_T *pUart;
+
+	pUart = ComToUart(_ucPort);
+	if (pUart == 0)
+	{
+		return 1;
+	}
+
+	return (bsp_RingCount(&pUart->tRxRing) == 0);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: comFlushTxPoll
+*	功能说明: 以查询方式发完发送FIFO中的全部数据, 等待最后1个字节移出。不依赖串口和DMA中断,
+*			  关中断或在中断中也能执行, 用于死机前输出错误信息 (见 bsp_LogFlush())。不执行 SendOver 回调。
+*	形    参: _ucPort: 端口号(COM1 - COM6)
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void comFlushTxPoll(COM_PORT_E _ucPort)
+{
+	UART_T *pUart;
+	uint32_t ulPrimask;
+	uint8_t ucByte;
+
+	pUart = ComToUart(_ucPort);
+	if (pUart == 0)
+	{
+		return;
+	}
+
+	ulPrimask = __get_PRIMASK();
+	DISABLE_INT();
+
+	/* DMA不受中断屏蔽影响, 等它发完正在发送的一段, 再由CPU接着发送 */
+	if (pUart->TxDma != 0 && pUart->usTxDmaLen != 0)
+	{
+		while (DMA_GetCurrDataCounter(pUart->TxDma) != 0);
+		DMA_Cmd(pUart->TxDma, DISABLE);
+		bsp_RingConsume(&pUart->tTxRing, pUart->usTxDmaLen);
+		pUart->usTxDmaLen = 0;
+	}
+	USART_ITConfig(pUart->uart, USART_IT_TXE, DISABLE);
+	USART_ITConfig(pUart->uart, USART_IT_TC, DISABLE);
+
+	while (bsp_RingGetByte(&pUart->tTxRing, &ucByte))
+	{
+		while (USART_GetFlagStatus(pUart->uart, USART_FLAG_TXE) == RESET);
+		USART_SendData(pUart->uart, ucByte);
+	}
+	while (USART_GetFlagStatus(pUart->uart, USART_FLAG_TC) == RESET);
+
+	__set_PRIMASK(ulPrimask);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_SetUart1Baud
+*	功能说明: 修改UART1波特率
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_SetUart1Baud(uint32_t _baud)
+{
+	USART_InitTypeDef USART_InitStructure;
+
+	/* 第2步： 配置串口硬件参数 */
+	USART_InitStructure.USART_BaudRate = _baud;	/* 波特率 */
+	USART_InitStructure.USART_WordLength = USART_WordLength_8b;
+	USART_InitStructure.USART_StopBits = USART_StopBits_1;
+	USART_InitStructure.USART_Parity = USART_Parity_No ;
+	USART_InitStructure.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
+	USART_InitStructure.USART_Mode = USART_Mode_Rx | USART_Mode_Tx;
+	USART_Init(USART1, &USART_InitStructure);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_SetUart2Baud
+*	功能说明: 修改UART2波特率, 8个数据位, 1个停止位, 无校验
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_SetUart2Baud(uint32_t _baud)
+{
+	bsp_SetUart2Param(_baud, USART_WordLength_8b, USART_StopBits_1, USART_Parity_No);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_SetUart2Param
+*	功能说明: 修改UART2波特率和帧格式。串口工作中也可以调用, USART_Init 不改变中断和DMA的使能位。
+*	形    参: _baud : 波特率
+*			  _usWordLength : USART_WordLength_8b 或 USART_WordLength_9b (含校验位)
+*			  _usStopBits : USART_StopBits_1, USART_StopBits_1_5, USART_StopBits_2
+*			  _usParity : USART_Parity_No, USART_Parity_Even, USART_Parity_Odd
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_SetUart2Param(uint32_t _baud, uint16_t _usWordLength, uint16_t _usStopBits, uint16_t _usParity)
+{
+	USART_InitTypeDef USART_InitStructure;
+
+	USART_InitStructure.USART_BaudRate = _baud;	/* 波特率 */
+	USART_InitStructure.USART_WordLength = _usWordLength;
+	USART_InitStructure.USART_StopBits = _usStopBits;
+	USART_InitStructure.USART_Parity = _usParity;
+	USART_InitStructure.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
+	USART_InitStructure.USART_Mode = USART_Mode_Rx | USART_Mode_Tx;
+	USART_Init(USART2, &USART_InitStructure);
+}
+
+
+/* 如果是RS485通信，请按如下格式编写函数， 我们仅举了 USART3作为RS485的例子 */
+
+/*
+*********************************************************************************************************
+*	函 数 名: RS485_InitTXE
+*	功能说明: 配置RS485发送使能口线 TXE
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void RS485_InitTXE(void)
+{
+	GPIO_InitTypeDef GPIO_InitStructure;
+
+	RCC_APB2PeriphClockCmd(RCC_RS485_TXEN, ENABLE);	/* 打开GPIO时钟 */
+
+	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_PP;	/* 推挽输出模式 */
+	GPIO_InitStructure.GPIO_Pin = PIN_RS485_TXEN;
+	GPIO_Init(PORT_RS485_TXEN, &GPIO_InitStructure);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_Set485Baud
+*	功能说明: 修改UART3波特率
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_Set485Baud(uint32_t _baud)
+{
+	USART_InitTypeDef USART_InitStructure;
+
+	/* 第2步： 配置串口硬件参数 */
+	USART_InitStructure.USART_BaudRate = _baud;	/* 波特率 */
+	USART_InitStructure.USART_WordLength = USART_WordLength_8b;
+	USART_InitStructure.USART_StopBits = USART_StopBits_1;
+	USART_InitStructure.USART_Parity = USART_Parity_No ;
+	USART_InitStructure.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
+	USART_InitStructure.USART_Mode = USART_Mode_Rx | USART_Mode_Tx;
+	USART_Init(USART3, &USART_InitStructure);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: RS485_SendBefor
+*	功能说明: 发送数据前的准备工作。对于RS485通信，请设置RS485芯片为发送状态，
+*			  并修改 UartVarInit()中的函数指针等于本函数名，比如 g_tUart2.SendBefor = RS485_SendBefor
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void RS485_SendBefor(void)
+{
+	RS485_TX_EN();	/* 切换RS485收发芯片为发送模式 */
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: RS485_SendOver
+*	功能说明: 发送一串数据结束后的善后处理。对于RS485通信，请设置RS485芯片为接收状态，
+*			  并修改 UartVarInit()中的函数指针等于本函数名，比如 g_tUart2.SendOver = RS485_SendOver
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void RS485_SendOver(void)
+{
+	RS485_RX_EN();	/* 切换RS485收发芯片为接收模式 */
+}
+
+
+/*
+*********************************************************************************************************
+*	函 数 名: RS485_SendBuf
+*	功能说明: 通过RS485芯片发送一串数据。注意，本函数不等待发送完毕。
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void RS485_SendBuf(uint8_t *_ucaBuf, uint16_t _usLen)
+{
+	comSendBuf(COM3, _ucaBuf, _usLen);
+}
+
+
+/*
+*********************************************************************************************************
+*	函 数 名: RS485_SendStr
+*	功能说明: 向485总线发送一个字符串
+*	形    参: _pBuf 数据缓冲区
+*			 _ucLen 数据长度
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void RS485_SendStr(char *_pBuf)
+{
+	RS485_SendBuf((uint8_t *)_pBuf, strlen(_pBuf));
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: RS485_ReciveNew
+*	功能说明: 接收到新的数据
+*	形    参: _pBuf 接收到的新数据, 在串口接收FIFO内
+*			  _usLen 数据长度
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+extern void MODBUS_ReciveNew(uint8_t *_pBuf, uint16_t _usLen);
+void RS485_ReciveNew(uint8_t *_pBuf, uint16_t _usLen)
+{
+	MODBUS_ReciveNew(_pBuf, _usLen);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: UartVarInit
+*	功能说明: 初始化串口相关的变量
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void UartVarInit(void)
+{
+#if UART1_FIFO_EN == 1
+	g_tUart1.uart = USART1;						/* STM32 串口设备 */
+	bsp_RingInit(&g_tUart1.tTxRing, g_TxBuf1, UART1_TX_BUF_SIZE);	/* 发送FIFO */
+	bsp_RingInit(&g_tUart1.tRxRing, g_RxBuf1, UART1_RX_BUF_SIZE);	/* 接收FIFO */
+	g_tUart1.SendBefor = 0;						/* 发送数据前的回调函数 */
+	g_tUart1.SendOver = 0;						/* 发送完毕后的回调函数 */
+	g_tUart1.ReciveNew = 0;						/* 接收到新数据后的回调函数 */
+	g_tUart1.TxLow = 0;							/* 发送缓冲区有空闲后的回调函数 */
+	g_tUart1.usTxLowMark = 0;					/* 发送缓冲区低水位 */
+	g_tUart1.ucTxLowArmed = 0;
+	g_tUart1.usTxDmaLen = 0;					/* DMA正在发送的字节数 */
+#if UART1_TX_DMA_EN == 1
+	g_tUart1.TxDma = DMA1_Channel4;				/* 发送DMA通道 */
+#else
+	g_tUart1.TxDma = 0;						/* 采用TXE中断发送 */
+#endif
+#if UART1_RX_DMA_EN == 1
+	g_tUart1.RxDma = DMA1_Channel5;				/* 接收DMA通道 */
+	g_tUart1.ulRxDmaFlagHT = DMA1_FLAG_HT5;
+	g_tUart1.ulRxDmaFlagTC = DMA1_FLAG_TC5;
+#else
+	g_tUart1.RxDma = 0;						/* 采用RXNE中断接收 */
+	g_tUart1.ulRxDmaFlagHT = 0;
+	g_tUart1.ulRxDmaFlagTC = 0;
+#endif
+	g_tUart1.ulRxOverrun = 0;
+#endif
+
+#if UART2_FIFO_EN == 1
+	g_tUart2.uart = USART2;						/* STM32 串口设备 */
+	bsp_RingInit(&g_tUart2.tTxRing, g_TxBuf2, UART2_TX_BUF_SIZE);	/* 发送FIFO */
+	bsp_RingInit(&g_tUart2.tRxRing, g_RxBuf2, UART2_RX_BUF_SIZE);	/* 接收FIFO */
+	g_tUart2.SendBefor = 0;						/* 发送数据前的回调函数 */
+	g_tUart2.SendOver = 0;						/* 发送完毕后的回调函数 */
+	g_tUart2.ReciveNew = 0;						/* 接收到新数据后的回调函数 */
+	g_tUart2.TxLow = 0;							/* 发送缓冲区有空闲后的回调函数 */
+	g_tUart2.usTxLowMark = 0;					/* 发送缓冲区低水位 */
+	g_tUart2.ucTxLowArmed = 0;
+	g_tUart2.usTxDmaLen = 0;					/* DMA正在发送的字节数 */
+#if UART2_TX_DMA_EN == 1
+	g_tUart2.TxDma = DMA1_Channel7;				/* 发送DMA通道 */
+#else
+	g_tUart2.TxDma = 0;						/* 采用TXE中断发送 */
+#endif
+#if UART2_RX_DMA_EN == 1
+	g_tUart2.RxDma = DMA1_Channel6;				/* 接收DMA通道 */
+	g_tUart2.ulRxDmaFlagHT = DMA1_FLAG_HT6;
+	g_tUart2.ulRxDmaFlagTC = DMA1_FLAG_TC6;
+#else
+	g_tUart2.RxDma = 0;						/* 采用RXNE中断接收 */
+	g_tUart2.ulRxDmaFlagHT = 0;
+	g_tUart2.ulRxDmaFlagTC = 0;
+#endif
+	g_tUart2.ulRxOverrun = 0;
+#endif
+
+#if UART3_FIFO_EN == 1
+	g_tUart3.uart = USART3;						/* STM32 串口设备 */
+	bsp_RingInit(&g_tUart3.tTxRing, g_TxBuf3, UART3_TX_BUF_SIZE);	/* 发送FIFO */
+	bsp_RingInit(&g_tUart3.tRxRing, g_RxBuf3, UART3_RX_BUF_SIZE);	/* 接收FIFO */
+	g_tUart3.SendBefor = RS485_SendBefor;		/* 发送数据前的回调函数 */
+	g_tUart3.SendOver = RS485_SendOver;			/* 发送完毕后的回调函数 */
+	g_tUart3.ReciveNew = RS485_ReciveNew;		/* 接收到新数据后的回调函数 */
+	g_tUart3.TxLow = 0;							/* 发送缓冲区有空闲后的回调函数 */
+	g_tUart3.usTxLowMark = 0;					/* 发送缓冲区低水位 */
+	g_tUart3.ucTxLowArmed = 0;
+	g_tUart3.usTxDmaLen = 0;					/* DMA正在发送的字节数 */
+#if UART3_TX_DMA_EN == 1
+	g_tUart3.TxDma = DMA1_Channel2;				/* 发送DMA通道 */
+#else
+	g_tUart3.TxDma = 0;						/* 采用TXE中断发送 */
+#endif
+#if UART3_RX_DMA_EN == 1
+	g_tUart3.RxDma = DMA1_Channel3;				/* 接收DMA通道 */
+	g_tUart3.ulRxDmaFlagHT = DMA1_FLAG_HT3;
+	g_tUart3.ulRxDmaFlagTC = DMA1_FLAG_TC3;
+#else
+	g_tUart3.RxDma = 0;						/* 采用RXNE中断接收 */
+	g_tUart3.ulRxDmaFlagHT = 0;
+	g_tUart3.ulRxDmaFlagTC = 0;
+#endif
+	g_tUart3.ulRxOverrun = 0;
+#endif
+
+#if UART4_FIFO_EN == 1
+	g_tUart4.uart = UART4;						/* STM32 串口设备 */
+	bsp_RingInit(&g_tUart4.tTxRing, g_TxBuf4, UART4_TX_BUF_SIZE);	/* 发送FIFO */
+	bsp_RingInit(&g_tUart4.tRxRing, g_RxBuf4, UART4_RX_BUF_SIZE);	/* 接收FIFO */
+	g_tUart4.SendBefor = 0;						/* 发送数据前的回调函数 */
+	g_tUart4.SendOver = 0;						/* 发送完毕后的回调函数 */
+	g_tUart4.ReciveNew = 0;						/* 接收到新数据后的回调函数 */
+	g_tUart4.TxLow = 0;							/* 发送缓冲区有空闲后的回调函数 */
+	g_tUart4.usTxLowMark = 0;					/* 发送缓冲区低水位 */
+	g_tUart4.ucTxLowArmed = 0;
+	g_tUart4.usTxDmaLen = 0;					/* DMA正在发送的字节数 */
+#if UART4_TX_DMA_EN == 1
+	g_tUart4.TxDma = DMA2_Channel5;				/* 发送DMA通道 */
+#else
+	g_tUart4.TxDma = 0;						/* 采用TXE中断发送 */
+#endif
+#if UART4_RX_DMA_EN == 1
+	g_tUart4.RxDma = DMA2_Channel3;				/* 接收DMA通道 */
+	g_tUart4.ulRxDmaFlagHT = DMA2_FLAG_HT3;
+	g_tUart4.ulRxDmaFlagTC = DMA2_FLAG_TC3;
+#else
+	g_tUart4.RxDma = 0;						/* 采用RXNE中断接收 */
+	g_tUart4.ulRxDmaFlagHT = 0;
+	g_tUart4.ulRxDmaFlagTC = 0;
+#endif
+	g_tUart4.ulRxOverrun = 0;
+#endif
+
+#if UART5_FIFO_EN == 1
+	g_tUart5.uart = UART5;						/* STM32 串口设备 */
+	bsp_RingInit(&g_tUart5.tTxRing, g_TxBuf5, UART5_TX_BUF_SIZE);	/* 发送FIFO */
+	bsp_RingInit(&g_tUart5.tRxRing, g_RxBuf5, UART5_RX_BUF_SIZE);	/* 接收FIFO */
+	g_tUart5.SendBefor = 0;						/* 发送数据前的回调函数 */
+	g_tUart5.SendOver = 0;						/* 发送完毕后的回调函数 */
+	g_tUart5.ReciveNew = 0;						/* 接收到新数据后的回调函数 */
+	g_tUart5.TxLow = 0;							/* 发送缓冲区有空闲后的回调函数 */
+	g_tUart5.usTxLowMark = 0;					/* 发送缓冲区低水位 */
+	g_tUart5.ucTxLowArmed = 0;
+	g_tUart5.usTxDmaLen = 0;					/* DMA正在发送的字节数 */
+	g_tUart5.TxDma = 0;						/* UART5没有DMA请求，只能采用TXE中断发送 */
+	g_tUart5.RxDma = 0;						/* UART5没有DMA请求，只能采用RXNE中断接收 */
+	g_tUart5.ulRxDmaFlagHT = 0;
+	g_tUart5.ulRxDmaFlagTC = 0;
+	g_tUart5.ulRxOverrun = 0;
+#endif
+
+
+#if UART6_FIFO_EN == 1
+	g_tUart6.uart = USART6;						/* STM32 串口设备 */
+	bsp_RingInit(&g_tUart6.tTxRing, g_TxBuf6, UART6_TX_BUF_SIZE);	/* 发送FIFO */
+	bsp_RingInit(&g_tUart6.tRxRing, g_RxBuf6, UART6_RX_BUF_SIZE);	/* 接收FIFO */
+	g_tUart6.SendBefor = 0;						/* 发送数据前的回调函数 */
+	g_tUart6.SendOver = 0;						/* 发送完毕后的回调函数 */
+	g_tUart6.ReciveNew = 0;						/* 接收到新数据后的回调函数 */
+	g_tUart6.TxLow = 0;							/* 发送缓冲区有空闲后的回调函数 */
+	g_tUart6.usTxLowMark = 0;					/* 发送缓冲区低水位 */
+	g_tUart6.ucTxLowArmed = 0;
+#endif
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: InitHardUart
+*	功能说明: 配置串口的硬件参数（波特率，数据位，停止位，起始位，校验位，中断使能）适合于STM32-F4开发板
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void InitHardUart(void)
+{
+	GPIO_InitTypeDef GPIO_InitStructure;
+	USART_InitTypeDef USART_InitStructure;
+
+#if UART1_FIFO_EN == 1		/* 串口1 TX = PA9   RX = PA10 或 TX = PB6   RX = PB7*/
+
+	/* 第1步：打开GPIO和USART部件的时钟 */
+	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOA | RCC_APB2Periph_AFIO, ENABLE);
+	RCC_APB2PeriphClockCmd(RCC_APB2Periph_USART1, ENABLE);
+
+	/* 第2步：将USART Tx的GPIO配置为推挽复用模式 */
+	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_9;
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;
+	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+	GPIO_Init(GPIOA, &GPIO_InitStructure);
+
+	/* 第3步：将USART Rx的GPIO配置为浮空输入模式
+		由于CPU复位后，GPIO缺省都是浮空输入模式，因此下面这个步骤不是必须的
+		但是，我还是建议加上便于阅读，并且防止其它地方修改了这个口线的设置参数
+	*/
+	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_10;
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IN_FLOATING;
+	GPIO_Init(GPIOA, &GPIO_InitStructure);
+	
+	/* 第4步： 配置串口硬件参数 */
+	USART_InitStructure.USART_BaudRate = UART1_BAUD;	/* 波特率 */
+	USART_InitStructure.USART_WordLength = USART_WordLength_8b;
+	USART_InitStructure.USART_StopBits = USART_StopBits_1;
+	USART_InitStructure.USART_Parity = USART_Parity_No ;
+	USART_InitStructure.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
+	USART_InitStructure.USART_Mode = USART_Mode_Rx | USART_Mode_Tx;
+	USART_Init(USART1, &USART_InitStructure);
+
+	USART_ITConfig(USART1, USART_IT_RXNE, ENABLE);	/* 使能接收中断 */
+	/*
+		USART_ITConfig(USART1, USART_IT_TXE, ENABLE);
+		注意: 不要在此处打开发送中断
+		发送中断使能在SendUart()函数打开
+	*/
+	USART_Cmd(USART1, ENABLE);		/* 使能串口 */
+
+	/* CPU的小缺陷：串口配置好，如果直接Send，则第1个字节发送不出去
+		如下语句解决第1个字节无法正确发送出去的问题 */
+	USART_ClearFlag(USART1, USART_FLAG_TC);     /* 清发送完成标志，Transmission Complete flag */
+#endif
+
+#if UART2_FIFO_EN == 1		/* 串口2 TX = PA2， RX = PA3  */
+	/* 第1步：打开GPIO和USART部件的时钟 */
+	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOA | RCC_APB2Periph_AFIO, ENABLE);
+	RCC_APB1PeriphClockCmd(RCC_APB1Periph_USART2, ENABLE);
+
+	/* 第2步：将USART Tx的GPIO配置为推挽复用模式 */
+	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_2;
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;
+	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+	GPIO_Init(GPIOA, &GPIO_InitStructure);
+
+	/* 第3步：将USART Rx的GPIO配置为浮空输入模式
+		由于CPU复位后，GPIO缺省都是浮空输入模式，因此下面这个步骤不是必须的
+		但是，我还是建议加上便于阅读，并且防止其它地方修改了这个口线的设置参数
+	*/
+	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_3;
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IN_FLOATING;
+	GPIO_Init(GPIOA, &GPIO_InitStructure);
+	/*  第3步已经做了，因此这步可以不做
+		GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+	*/
+	GPIO_Init(GPIOA, &GPIO_InitStructure);
+
+	/* 第4步： 配置串口硬件参数 */
+	USART_InitStructure.USART_BaudRate = UART2_BAUD;	/* 波特率 */
+	USART_InitStructure.USART_WordLength = USART_WordLength_8b;
+	USART_InitStructure.USART_StopBits = USART_StopBits_1;
+	USART_InitStructure.USART_Parity = USART_Parity_No ;
+	USART_InitStructure.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
+	USART_InitStructure.USART_Mode = USART_Mode_Tx | USART_Mode_Rx;		/* 仅选择接收模式 */
+	USART_Init(USART2, &USART_InitStructure);
+
+	USART_ITConfig(USART2, USART_IT_RXNE, ENABLE);	/* 使能接收中断 */
+	/*
+		USART_ITConfig(USART1, USART_IT_TXE, ENABLE);
+		注意: 不要在此处打开发送中断
+		发送中断使能在SendUart()函数打开
+	*/
+	USART_Cmd(USART2, ENABLE);		/* 使能串口 */
+
+	/* CPU的小缺陷：串口配置好，如果直接Send，则第1个字节发送不出去
+		如下语句解决第1个字节无法正确发送出去的问题 */
+	USART_ClearFlag(USART2, USART_FLAG_TC);     /* 清发送完成标志，Transmission Complete flag */
+#endif
+
+#if UART3_FIFO_EN == 1			/* 串口3 TX = PB10   RX = PB11 */
+
+	/* 配置 PB2为推挽输出，用于切换 RS485芯片的收发状态 */
+	{
+		RCC_APB2PeriphClockCmd(RCC_RS485_TXEN, ENABLE);
+
+		GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_PP;
+		GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+		GPIO_InitStructure.GPIO_Pin = PIN_RS485_TXEN;
+		GPIO_Init(PORT_RS485_TXEN, &GPIO_InitStructure);
+	}
+
+	/* 第1步： 开启GPIO和UART时钟 */
+	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOB | RCC_APB2Periph_AFIO, ENABLE);
+	RCC_APB1PeriphClockCmd(RCC_APB1Periph_USART3, ENABLE);
+
+	/* 第2步：将USART Tx的GPIO配置为推挽复用模式 */
+	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_10;
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;
+	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+	GPIO_Init(GPIOB, &GPIO_InitStructure);
+
+	/* 第3步：将USART Rx的GPIO配置为浮空输入模式
+		由于CPU复位后，GPIO缺省都是浮空输入模式，因此下面这个步骤不是必须的
+		但是，我还是建议加上便于阅读，并且防止其它地方修改了这个口线的设置参数
+	*/
+	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_11;
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IN_FLOATING;
+	GPIO_Init(GPIOB, &GPIO_InitStructure);
+	/*  第3步已经做了，因此这步可以不做
+		GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+	*/
+	GPIO_Init(GPIOB, &GPIO_InitStructure);
+
+	/* 第4步： 配置串口硬件参数 */
+	USART_InitStructure.USART_BaudRate = UART3_BAUD;	/* 波特率 */
+	USART_InitStructure.USART_WordLength = USART_WordLength_8b;
+	USART_InitStructure.USART_StopBits = USART_StopBits_1;
+	USART_InitStructure.USART_Parity = USART_Parity_No ;
+	USART_InitStructure.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
+	USART_InitStructure.USART_Mode = USART_Mode_Rx | USART_Mode_Tx;
+	USART_Init(USART3, &USART_InitStructure);
+
+	USART_ITConfig(USART3, USART_IT_RXNE, ENABLE);	/* 使能接收中断 */
+	/*
+		USART_ITConfig(USART1, USART_IT_TXE, ENABLE);
+		注意: 不要在此处打开发送中断
+		发送中断使能在SendUart()函数打开
+	*/
+	USART_Cmd(USART3, ENABLE);		/* 使能串口 */
+
+	/* CPU的小缺陷：串口配置好，如果直接Send，则第1个字节发送不出去
+		如下语句解决第1个字节无法正确发送出去的问题 */
+	USART_ClearFlag(USART3, USART_FLAG_TC);     /* 清发送完成标志，Transmission Complete flag */
+#endif
+
+#if UART4_FIFO_EN == 1			/* 串口4 TX = PC10   RX = PC11 */
+	/* 第1步： 开启GPIO和UART时钟 */
+	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOC | RCC_APB2Periph_AFIO, ENABLE);
+	RCC_APB1PeriphClockCmd(RCC_APB1Periph_UART4, ENABLE);
+
+	/* 第2步：将USART Tx的GPIO配置为推挽复用模式 */
+	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_10;
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;
+	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+	GPIO_Init(GPIOC, &GPIO_InitStructure);
+
+	/* 第3步：将USART Rx的GPIO配置为浮空输入模式
+		由于CPU复位后，GPIO缺省都是浮空输入模式，因此下面这个步骤不是必须的
+		但是，我还是建议加上便于阅读，并且防止其它地方修改了这个口线的设置参数
+	*/
+	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_11;
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IN_FLOATING;
+	GPIO_Init(GPIOC, &GPIO_InitStructure);
+
+	/* 第4步： 配置串口硬件参数 */
+	USART_InitStructure.USART_BaudRate = UART4_BAUD;	/* 波特率 */
+	USART_InitStructure.USART_WordLength = USART_WordLength_8b;
+	USART_InitStructure.USART_StopBits = USART_StopBits_1;
+	USART_InitStructure.USART_Parity = USART_Parity_No ;
+	USART_InitStructure.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
+	USART_InitStructure.USART_Mode = USART_Mode_Rx | USART_Mode_Tx;
+	USART_Init(UART4, &USART_InitStructure);
+
+	USART_ITConfig(UART4, USART_IT_RXNE, ENABLE);	/* 使能接收中断 */
+	/*
+		USART_ITConfig(USART1, USART_IT_TXE, ENABLE);
+		注意: 不要在此处打开发送中断
+		发送中断使能在SendUart()函数打开
+	*/
+	USART_Cmd(UART4, ENABLE);		/* 使能串口 */
+
+	/* CPU的小缺陷：串口配置好，如果直接Send，则第1个字节发送不出去
+		如下语句解决第1个字节无法正确发送出去的问题 */
+	USART_ClearFlag(UART4, USART_FLAG_TC);     /* 清发送完成标志，Transmission Complete flag */
+#endif
+
+#if UART5_FIFO_EN == 1			/* 串口5 TX = PC12   RX = PD2 */
+	/* 第1步： 开启GPIO和UART时钟 */
+	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOC | RCC_APB2Periph_GPIOD | RCC_APB2Periph_AFIO, ENABLE);
+	RCC_APB1PeriphClockCmd(RCC_APB1Periph_UART5, ENABLE);
+
+	/* 第2步：将USART Tx的GPIO配置为推挽复用模式 */
+	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_12;
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;
+	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+	GPIO_Init(GPIOC, &GPIO_InitStructure);
+
+	/* 第3步：将USART Rx的GPIO配置为浮空输入模式
+		由于CPU复位后，GPIO缺省都是浮空输入模式，因此下面这个步骤不是必须的
+		但是，我还是建议加上便于阅读，并且防止其它地方修改了这个口线的设置参数
+	*/
+	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_2;
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IN_FLOATING;
+	GPIO_Init(GPIOD, &GPIO_InitStructure);
+
+
+	/* 第4步： 配置串口硬件参数 */
+	USART_InitStructure.USART_BaudRate = UART5_BAUD;	/* 波特率 */
+	USART_InitStructure.USART_WordLength = USART_WordLength_8b;
+	USART_InitStructure.USART_StopBits = USART_StopBits_1;
+	USART_InitStructure.USART_Parity = USART_Parity_No ;
+	USART_InitStructure.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
+	USART_InitStructure.USART_Mode = USART_Mode_Rx | USART_Mode_Tx;
+	USART_Init(UART5, &USART_InitStructure);
+
+	USART_ITConfig(UART5, USART_IT_RXNE, ENABLE);	/* 使能接收中断 */
+	/*
+		USART_ITConfig(USART1, USART_IT_TXE, ENABLE);
+		注意: 不要在此处打开发送中断
+		发送中断使能在SendUart()函数打开
+	*/
+	USART_Cmd(UART5, ENABLE);		/* 使能串口 */
+
+	/* CPU的小缺陷：串口配置好，如果直接Send，则第1个字节发送不出去
+		如下语句解决第1个字节无法正确发送出去的问题 */
+	USART_ClearFlag(UART5, USART_FLAG_TC);     /* 清发送完成标志，Transmission Complete flag */
+#endif
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: ConfigUartNVIC
+*	功能说明: 配置串口硬件中断.
+*	形    参:  无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void ConfigUartNVIC(void)
+{
+	NVIC_InitTypeDef NVIC_InitStructure;
+
+	/* Configure the NVIC Preemption Priority Bits */
+	/*	NVIC_PriorityGroupConfig(NVIC_PriorityGroup_0);  --- 在 bsp.c 中 bsp_Init() 中配置中断优先级组 */
+
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0;
+
+#if UART1_FIFO_EN == 1
+	/* 使能串口1中断 */
+	NVIC_InitStructure.NVIC_IRQChannel = USART1_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+#endif
+
+#if UART2_FIFO_EN == 1
+	/* 使能串口2中断 */
+	NVIC_InitStructure.NVIC_IRQChannel = USART2_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+#endif
+
+#if UART3_FIFO_EN == 1
+	/* 使能串口3中断t */
+	NVIC_InitStructure.NVIC_IRQChannel = USART3_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 2;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+#endif
+
+#if UART4_FIFO_EN == 1
+	/* 使能串口4中断t */
+	NVIC_InitStructure.NVIC_IRQChannel = UART4_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 3;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+#endif
+
+#if UART5_FIFO_EN == 1
+	/* 使能串口5中断t */
+	NVIC_InitStructure.NVIC_IRQChannel = UART5_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 4;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+#endif
+
+#if UART6_FIFO_EN == 1
+	/* 使能串口6中断t */
+	NVIC_InitStructure.NVIC_IRQChannel = USART6_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 5;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+#endif
+
+	/* 发送DMA通道的传输完成中断，子优先级与对应的串口相同 */
+#if UART1_FIFO_EN == 1 && UART1_TX_DMA_EN == 1
+	NVIC_InitStructure.NVIC_IRQChannel = DMA1_Channel4_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+#endif
+
+#if UART2_FIFO_EN == 1 && UART2_TX_DMA_EN == 1
+	NVIC_InitStructure.NVIC_IRQChannel = DMA1_Channel7_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+#endif
+
+#if UART3_FIFO_EN == 1 && UART3_TX_DMA_EN == 1
+	NVIC_InitStructure.NVIC_IRQChannel = DMA1_Channel2_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 2;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+#endif
+
+#if UART4_FIFO_EN == 1 && UART4_TX_DMA_EN == 1
+	NVIC_InitStructure.NVIC_IRQChannel = DMA2_Channel4_5_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 3;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+#endif
+
+	/* 接收DMA通道的半满、全满中断 */
+#if UART1_FIFO_EN == 1 && UART1_RX_DMA_EN == 1
+	NVIC_InitStructure.NVIC_IRQChannel = DMA1_Channel5_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+#endif
+
+#if UART2_FIFO_EN == 1 && UART2_RX_DMA_EN == 1
+	NVIC_InitStructure.NVIC_IRQChannel = DMA1_Channel6_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+#endif
+
+#if UART3_FIFO_EN == 1 && UART3_RX_DMA_EN == 1
+	NVIC_InitStructure.NVIC_IRQChannel = DMA1_Channel3_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 2;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+#endif
+
+#if UART4_FIFO_EN == 1 && UART4_RX_DMA_EN == 1
+	NVIC_InitStructure.NVIC_IRQChannel = DMA2_Channel3_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 3;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+#endif
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: ConfigTxDma
+*	功能说明: 配置一个串口的发送DMA通道。内存地址和长度在每次启动DMA时再填写。
+*	形    参: _pUart : 串口设备
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void ConfigTxDma(UART_T *_pUart)
+{
+	DMA_InitTypeDef DMA_InitStructure;
+
+	DMA_DeInit(_pUart->TxDma);
+
+	DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&_pUart->uart->DR;
+	DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)_pUart->tTxRing.pBuf;
+	DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;			/* 内存 -> 串口 */
+	DMA_InitStructure.DMA_BufferSize = 1;
+	DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+	DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+	DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+	DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+	DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+	DMA_InitStructure.DMA_Priority = DMA_Priority_Medium;
+	DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+	DMA_Init(_pUart->TxDma, &DMA_InitStructure);
+
+	DMA_ITConfig(_pUart->TxDma, DMA_IT_TC, ENABLE);		/* 使能传输完成中断 */
+	USART_DMACmd(_pUart->uart, USART_DMAReq_Tx, ENABLE);	/* 串口TXE信号触发DMA请求 */
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: ConfigRxDma
+*	功能说明: 配置一个串口的接收DMA通道。DMA工作在循环模式，串口数据直接写入接收FIFO的缓冲区，
+*			  不再产生RXNE中断。由IDLE中断和DMA半满、全满中断发布DMA的写位置。
+*	形    参: _pUart : 串口设备
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void ConfigRxDma(UART_T *_pUart)
+{
+	DMA_InitTypeDef DMA_InitStructure;
+
+	DMA_DeInit(_pUart->RxDma);
+
+	DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&_pUart->uart->DR;
+	DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)_pUart->tRxRing.pBuf;
+	DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;			/* 串口 -> 内存 */
+	DMA_InitStructure.DMA_BufferSize = _pUart->tRxRing.usSize;
+	DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+	DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+	DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+	DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+	DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+	DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+	DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+	DMA_Init(_pUart->RxDma, &DMA_InitStructure);
+
+	DMA_ITConfig(_pUart->RxDma, DMA_IT_HT | DMA_IT_TC, ENABLE);	/* 半满和全满中断，保证长数据流不会被覆盖 */
+
+	USART_ITConfig(_pUart->uart, USART_IT_RXNE, DISABLE);	/* 关闭逐字节接收中断 */
+	USART_ITConfig(_pUart->uart, USART_IT_IDLE, ENABLE);	/* 总线空闲中断，表示一段数据接收结束 */
+	USART_DMACmd(_pUart->uart, USART_DMAReq_Rx, ENABLE);
+
+	DMA_Cmd(_pUart->RxDma, ENABLE);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: InitUartDma
+*	功能说明: 配置串口的收发DMA通道。STM32F103的DMA请求映射关系是固定的:
+*				USART1_TX --- DMA1 通道4		USART1_RX --- DMA1 通道5
+*				USART2_TX --- DMA1 通道7		USART2_RX --- DMA1 通道6
+*				USART3_TX --- DMA1 通道2		USART3_RX --- DMA1 通道3
+*				UART4_TX  --- DMA2 通道5		UART4_RX  --- DMA2 通道3 (仅大容量产品)
+*				UART5 没有DMA请求
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void InitUartDma(void)
+{
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
+
+#if UART1_FIFO_EN == 1 && UART1_TX_DMA_EN == 1
+	ConfigTxDma(&g_tUart1);
+#endif
+
+#if UART2_FIFO_EN == 1 && UART2_TX_DMA_EN == 1
+	ConfigTxDma(&g_tUart2);
+#endif
+
+#if UART3_FIFO_EN == 1 && UART3_TX_DMA_EN == 1
+	ConfigTxDma(&g_tUart3);
+#endif
+
+#if UART4_FIFO_EN == 1 && UART4_TX_DMA_EN == 1
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA2, ENABLE);
+	ConfigTxDma(&g_tUart4);
+#endif
+
+#if UART1_FIFO_EN == 1 && UART1_RX_DMA_EN == 1
+	ConfigRxDma(&g_tUart1);
+#endif
+
+#if UART2_FIFO_EN == 1 && UART2_RX_DMA_EN == 1
+	ConfigRxDma(&g_tUart2);
+#endif
+
+#if UART3_FIFO_EN == 1 && UART3_RX_DMA_EN == 1
+	ConfigRxDma(&g_tUart3);
+#endif
+
+#if UART4_FIFO_EN == 1 && UART4_RX_DMA_EN == 1
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA2, ENABLE);
+	ConfigRxDma(&g_tUart4);
+#endif
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: UartSend
+*	功能说明: 填写数据到UART发送缓冲区,并启动发送中断。中断处理函数发送完毕后，自动关闭发送中断
+*	形    参:  无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void UartSend(UART_T *_pUart, uint8_t *_ucaBuf, uint16_t _usLen)
+{
+	uint16_t usPut;
+
+	while (_usLen > 0)
+	{
+		/* 将新数据填入发送缓冲区。如果发送缓冲区已经满了，则启动发送并等待中断取走数据 */
+		usPut = bsp_RingPut(&_pUart->tTxRing, _ucaBuf, _usLen);
+		_ucaBuf += usPut;
+		_usLen -= usPut;
+
+		UartTxStart(_pUart);
+	}
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: UartTxStart
+*	功能说明: 启动后台发送。DMA模式下启动DMA通道，否则打开TXE中断，由中断服务程序逐字节发送。
+*	形    参: _pUart : 串口设备
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void UartTxStart(UART_T *_pUart)
+{
+	uint32_t ulPrimask;
+
+	if (_pUart->TxDma != 0)
+	{
+		/* 可能在中断中调用 (例如USB转串口桥接的回调), 保存并恢复 PRIMASK */
+		ulPrimask = __get_PRIMASK();
+		DISABLE_INT();
+		UartTxDmaStart(_pUart);
+		__set_PRIMASK(ulPrimask);
+	}
+	else
+	{
+		USART_ITConfig(_pUart->uart, USART_IT_TXE, ENABLE);
+	}
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: UartTxDmaStart
+*	功能说明: DMA空闲时，将发送FIFO中从读索引到缓冲区末尾的连续数据交给DMA发送。
+*			  数据在缓冲区末尾回绕时，回绕部分由DMA传输完成中断接力发送。
+*			  主程序和中断都会调用本函数，主程序调用时必须关中断。
+*	形    参: _pUart : 串口设备
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void UartTxDmaStart(UART_T *_pUart)
+{
+	uint8_t *pData;
+	uint16_t usLen;
+
+	if (_pUart->usTxDmaLen != 0)
+	{
+		return;		/* DMA正在发送 */
+	}
+
+	usLen = bsp_RingPeekSpan(&_pUart->tTxRing, &pData);
+	if (usLen == 0)
+	{
+		return;		/* 没有数据 */
+	}
+	_pUart->usTxDmaLen = usLen;
+
+	DMA_Cmd(_pUart->TxDma, DISABLE);
+	_pUart->TxDma->CMAR = (uint32_t)pData;
+	DMA_SetCurrDataCounter(_pUart->TxDma, usLen);
+
+	/* DMA写DR不会清除TC标志，必须先软件清零，否则TC中断会在最后1个字节移出之前进入 */
+	USART_ClearFlag(_pUart->uart, USART_FLAG_TC);
+	DMA_Cmd(_pUart->TxDma, ENABLE);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: UartTxDmaIRQ
+*	功能说明: 发送DMA传输完成中断处理。释放已发送的数据，如果FIFO中还有数据(包括回绕部分)则继续发送，
+*			  否则打开TC中断，等待最后1个字节移出后执行 SendOver 回调。
+*	形    参: _pUart : 串口设备
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void UartTxDmaIRQ(UART_T *_pUart)
+{
+	DMA_Cmd(_pUart->TxDma, DISABLE);
+
+	bsp_RingConsume(&_pUart->tTxRing, _pUart->usTxDmaLen);
+	_pUart->usTxDmaLen = 0;
+	UartTxLowCheck(_pUart);
+
+	if (bsp_RingCount(&_pUart->tTxRing) > 0)
+	{
+		UartTxDmaStart(_pUart);
+	}
+	else
+	{
+		USART_ITConfig(_pUart->uart, USART_IT_TC, ENABLE);
+	}
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: UartGetChar
+*	功能说明: 从串口接收缓冲区读取1字节数据 （用于主程序调用）
+*	形    参: _pUart : 串口设备
+*			  _pByte : 存放读取数据的指针
+*	返 回 值: 0 表示无数据  1表示读取到数据
+*********************************************************************************************************
+*/
+static uint8_t UartGetChar(UART_T *_pUart, uint8_t *_pByte)
+{
+	if (UartRxDropOverrun(_pUart) == 0)
+	{
+		return 0;
+	}
+
+	/* 主程序是接收FIFO唯一的消费者，读取时不需要关中断 */
+	return bsp_RingGetByte(&_pUart->tRxRing, _pByte);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: UartGetBuf
+*	功能说明: 从串口接收缓冲区读取一批数据 （用于主程序调用）
+*	形    参: _pUart : 串口设备
+*			  _pBuf : 存放读取数据的缓冲区
+*			  _usSize : 最多读取的字节数
+*	返 回 值: 实际读取的字节数
+*********************************************************************************************************
+*/
+static uint16_t UartGetBuf(UART_T *_pUart, uint8_t *_pBuf, uint16_t _usSize)
+{
+	uint16_t usCount;
+
+	/* 只读取丢弃时看到的数据, 之后DMA新写入的留到下次 */
+	usCount = UartRxDropOverrun(_pUart);
+	if (_usSize > usCount)
+	{
+		_usSize = usCount;
+	}
+	return bsp_RingGet(&_pUart->tRxRing, _pBuf, _usSize);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: UartRxDropOverrun
+*	功能说明: DMA接收模式下，如果主程序来不及读取，最旧的数据已经被DMA覆盖，此时FIFO中的数据个数会超过
+*			  缓冲区大小。由消费者丢弃被覆盖的部分，使读索引重新落在有效数据上。
+*			  写索引只读一次, 调用者随后的读取不能超过返回的字节数: 如果再读一次写索引, 中间DMA中断
+*			  又发布了数据, 读取的长度就和丢弃时的判断不一致。
+*	形    参: _pUart : 串口设备
+*	返 回 值: 丢弃后FIFO中的有效字节数
+*********************************************************************************************************
+*/
+static uint16_t UartRxDropOverrun(UART_T *_pUart)
+{
+	RING_T *pRing;
+	uint16_t usHead;
+	uint16_t usCount;
+
+	pRing = &_pUart->tRxRing;
+	usHead = pRing->usHead;
+	usCount = (uint16_t)(usHead - pRing->usTail);
+	if (usCount > pRing->usSize)
+	{
+		bsp_RingConsume(pRing, usCount - pRing->usSize);
+		usCount = pRing->usSize;
+	}
+	return usCount;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: UartTxLowCheck
+*	功能说明: 发送中断取走数据后调用。如果等待低水位通知，且待发送数据已经降到低水位，则执行 TxLow 回调。
+*	形    参: _pUart : 串口设备
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void UartTxLowCheck(UART_T *_pUart)
+{
+	if (_pUart->ucTxLowArmed && bsp_RingCount(&_pUart->tTxRing) <= _pUart->usTxLowMark)
+	{
+		_pUart->ucTxLowArmed = 0;
+		if (_pUart->TxLow)
+		{
+			_pUart->TxLow();
+		}
+	}
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: UartRxDmaPassed
+*	功能说明: 判断DMA写位置从 _usOld 前进 _usLen 字节时, 是否经过了位置 _usPoint (到达即算经过)。
+*	形    参: _pRing : 接收FIFO
+*			  _usOld : 上次发布的写位置
+*			  _usLen : 前进的字节数, 小于缓冲区大小
+*			  _usPoint : 半满位置(usSize/2) 或全满位置(0)
+*	返 回 值: 1 表示经过, 0 表示没有经过
+*********************************************************************************************************
+*/
+static uint8_t UartRxDmaPassed(RING_T *_pRing, uint16_t _usOld, uint16_t _usLen, uint16_t _usPoint)
+{
+	uint16_t usDist;
+
+	usDist = (_usPoint - _usOld) & _pRing->usMask;
+	return (usDist != 0 && usDist <= _usLen);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: UartRxDmaIRQ
+*	功能说明: 根据接收DMA的剩余计数计算写位置，发布新收到的数据，并对每段连续数据执行一次 ReciveNew 回调。
+*			  被串口IDLE中断和DMA半满、全满中断调用。
+*
+*			  剩余计数只能算出写位置对缓冲区大小取余的结果, DMA转了整整一圈时算出的长度为0或很短。
+*			  所以同时检查半满、全满标志: 标志置位了, 写位置却没有经过对应的点, 说明上次发布以后
+*			  DMA至少转了一圈。这时多发布一圈, 由主程序读取时的 UartRxDropOverrun 丢弃被覆盖的数据。
+*			  两次调用之间DMA前进不到1.5圈时可以可靠检出; 半满、全满中断每半圈进入一次, 只有中断
+*			  被屏蔽超过1.5圈的接收时间(1KB缓冲区115200bps约133ms)才会漏检。
+*	形    参: _pUart : 串口设备
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void UartRxDmaIRQ(UART_T *_pUart)
+{
+	RING_T *pRing;
+	uint16_t usPos;
+	uint16_t usOld;
+	uint16_t usLen;
+	uint16_t usNew;
+	uint32_t ulFlags;
+	uint32_t ulPassed;
+	uint32_t ulLap;
+
+	pRing = &_pUart->tRxRing;
+
+	/* 先读标志再读剩余计数, 读到的标志对应的位置都已经包含在 usPos 中 */
+	ulFlags = 0;
+	if (DMA_GetFlagStatus(_pUart->ulRxDmaFlagHT) != RESET)
+	{
+		ulFlags |= _pUart->ulRxDmaFlagHT;
+	}
+	if (DMA_GetFlagStatus(_pUart->ulRxDmaFlagTC) != RESET)
+	{
+		ulFlags |= _pUart->ulRxDmaFlagTC;
+	}
+
+	/* DMA已经把数据写入缓冲区，只需根据剩余计数算出新增的字节数，再发布写索引 */
+	usPos = pRing->usSize - DMA_GetCurrDataCounter(_pUart->RxDma);
+	usOld = pRing->usHead & pRing->usMask;
+	usLen = (usPos - usOld) & pRing->usMask;
+
+	ulPassed = 0;
+	if (UartRxDmaPassed(pRing, usOld, usLen, pRing->usSize / 2))
+	{
+		ulPassed |= _pUart->ulRxDmaFlagHT;
+	}
+	if (UartRxDmaPassed(pRing, usOld, usLen, 0))
+	{
+		ulPassed |= _pUart->ulRxDmaFlagTC;
+	}
+
+	ulLap = ulFlags & ~ulPassed;
+	if (ulLap)
+	{
+		/* 多发布一圈时, 与上次发布位置重合的点也算经过 */
+		if (usOld == pRing->usSize / 2)
+		{
+			ulPassed |= _pUart->ulRxDmaFlagHT;
+		}
+		else if (usOld == 0)
+		{
+			ulPassed |= _pUart->ulRxDmaFlagTC;
+		}
+	}
+
+	/* 本次经过的点, 标志可能在读标志之后才置位, 一起清除, 避免下次误判为整圈覆盖 */
+	if (ulFlags | ulPassed)
+	{
+		DMA_ClearFlag(ulFlags | ulPassed);
+	}
+
+	usNew = usLen;
+	if (ulLap)
+	{
+		/* DMA转了整整一圈, 缓冲区中全部是新数据, 最旧的从 usPos 开始 */
+		usLen += pRing->usSize;
+		usOld = usPos & pRing->usMask;
+		usNew = pRing->usSize;
+	}
+	if (usLen == 0)
+	{
+		return;		/* 没有新数据 */
+	}
+
+	bsp_RingCommit(pRing, usLen);
+	if (usLen != usNew || bsp_RingCount(pRing) > pRing->usSize)
+	{
+		_pUart->ulRxOverrun++;		/* 未读的数据被覆盖, 由 UartRxDropOverrun 丢弃 */
+	}
+
+	/* 回调函数,通知应用程序收到新数据。数据回绕时分两段通知 */
+	if (_pUart->ReciveNew)
+	{
+		if (usOld + usNew <= pRing->usSize)
+		{
+			_pUart->ReciveNew(&pRing->pBuf[usOld], usNew);
+		}
+		else
+		{
+			_pUart->ReciveNew(&pRing->pBuf[usOld], pRing->usSize - usOld);
+			_pUart->ReciveNew(pRing->pBuf, usNew - (pRing->usSize - usOld));
+		}
+	}
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: UartIRQ
+*	功能说明: 供中断服务程序调用，通用串口中断处理函数
+*	形    参: _pUart : 串口设备
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void UartIRQ(UART_T *_pUart)
+{
+	/* 处理接收中断  */
+	if (USART_GetITStatus(_pUart->uart, USART_IT_RXNE) != RESET)
+	{
+		/* 从串口接收数据寄存器读取数据存放到接收FIFO */
+		uint8_t ch;
+
+		ch = USART_ReceiveData(_pUart->uart);
+		bsp_RingPutByte(&_pUart->tRxRing, ch);		/* FIFO满时丢弃新数据 */
+
+		/* 回调函数,通知应用程序收到新数据,一般是发送1个消息或者设置一个标记 */
+		{
+			if (_pUart->ReciveNew)
+			{
+				_pUart->ReciveNew(&ch, 1);
+			}
+		}
+	}
+
+	/* 处理总线空闲中断 (DMA接收模式), 一段数据接收结束 */
+	if (USART_GetITStatus(_pUart->uart, USART_IT_IDLE) != RESET)
+	{
+		USART_ReceiveData(_pUart->uart);	/* 先读SR再读DR，清除IDLE标志 */
+		UartRxDmaIRQ(_pUart);
+	}
+
+	/* 处理发送缓冲区空中断 */
+	if (USART_GetITStatus(_pUart->uart, USART_IT_TXE) != RESET)
+	{
+		uint8_t ch;
+
+		if (bsp_RingGetByte(&_pUart->tTxRing, &ch) == 0)
+		{
+			/* 发送缓冲区的数据已取完时， 禁止发送缓冲区空中断 （注意：此时最后1个数据还未真正发送完毕）*/
+			USART_ITConfig(_pUart->uart, USART_IT_TXE, DISABLE);
+
+			/* 使能数据发送完毕中断 */
+			USART_ITConfig(_pUart->uart, USART_IT_TC, ENABLE);
+		}
+		else
+		{
+			/* 从发送FIFO取1个字节写入串口发送数据寄存器 */
+			USART_SendData(_pUart->uart, ch);
+			UartTxLowCheck(_pUart);
+		}
+
+	}
+	/* 数据bit位全部发送完毕的中断 */
+	else if (USART_GetITStatus(_pUart->uart, USART_IT_TC) != RESET)
+	{
+		uint8_t ch;
+
+		if (bsp_RingCount(&_pUart->tTxRing) == 0)
+		{
+			/* 如果发送FIFO的数据全部发送完毕，禁止数据发送完毕中断 */
+			USART_ITConfig(_pUart->uart, USART_IT_TC, DISABLE);
+
+			/* 回调函数, 一般用来处理RS485通信，将RS485芯片设置为接收模式，避免抢占总线 */
+			if (_pUart->SendOver)
+			{
+				_pUart->SendOver();
+			}
+		}
+		else if (_pUart->TxDma != 0)
+		{
+			/* DMA还在发送新写入的数据，等DMA传输完成中断再打开TC中断 */
+			USART_ITConfig(_pUart->uart, USART_IT_TC, DISABLE);
+		}
+		else
+		{
+			/* 正常情况下，不会进入此分支 */
+
+			/* 如果发送FIFO的数据还未完毕，则从发送FIFO取1个数据写入发送数据寄存器 */
+			if (bsp_RingGetByte(&_pUart->tTxRing, &ch))
+			{
+				USART_SendData(_pUart->uart, ch);
+			}
+		}
+	}
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: USART1_IRQHandler  USART2_IRQHandler USART3_IRQHandler UART4_IRQHandler UART5_IRQHandler
+*	功能说明: USART中断服务程序
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+#if UART1_FIFO_EN == 1
+void USART1_IRQHandler(void)
+{
+	UartIRQ(&g_tUart1);
+}
+#endif
+
+#if UART2_FIFO_EN == 1
+void USART2_IRQHandler(void)
+{
+	UartIRQ(&g_tUart2);
+}
+#endif
+
+#if UART3_FIFO_EN == 1
+void USART3_IRQHandler(void)
+{
+	UartIRQ(&g_tUart3);
+}
+#endif
+
+#if UART4_FIFO_EN == 1
+void UART4_IRQHandler(void)
+{
+	UartIRQ(&g_tUart4);
+}
+#endif
+
+#if UART5_FIFO_EN == 1
+void UART5_IRQHandler(void)
+{
+	UartIRQ(&g_tUart5);
+}
+#endif
+
+#if UART6_FIFO_EN == 1
+void USART6_IRQHandler(void)
+{
+	UartIRQ(&g_tUart6);
+}
+#endif
+
+/*
+*********************************************************************************************************
+*	函 数 名: DMA1_Channel4_IRQHandler  DMA1_Channel7_IRQHandler DMA1_Channel2_IRQHandler
+*			  DMA2_Channel4_5_IRQHandler
+*	功能说明: 串口发送DMA通道中断服务程序
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+#if UART1_FIFO_EN == 1 && UART1_TX_DMA_EN == 1
+void DMA1_Channel4_IRQHandler(void)
+{
+	if (DMA_GetITStatus(DMA1_IT_TC4) != RESET)
+	{
+		DMA_ClearITPendingBit(DMA1_IT_GL4);
+		UartTxDmaIRQ(&g_tUart1);
+	}
+}
+#endif
+
+#if UART2_FIFO_EN == 1 && UART2_TX_DMA_EN == 1
+void DMA1_Channel7_IRQHandler(void)
+{
+	if (DMA_GetITStatus(DMA1_IT_TC7) != RESET)
+	{
+		DMA_ClearITPendingBit(DMA1_IT_GL7);
+		UartTxDmaIRQ(&g_tUart2);
+	}
+}
+#endif
+
+#if UART3_FIFO_EN == 1 && UART3_TX_DMA_EN == 1
+void DMA1_Channel2_IRQHandler(void)
+{
+	if (DMA_GetITStatus(DMA1_IT_TC2) != RESET)
+	{
+		DMA_ClearITPendingBit(DMA1_IT_GL2);
+		UartTxDmaIRQ(&g_tUart3);
+	}
+}
+#endif
+
+#if UART4_FIFO_EN == 1 && UART4_TX_DMA_EN == 1
+void DMA2_Channel4_5_IRQHandler(void)
+{
+	if (DMA_GetITStatus(DMA2_IT_TC5) != RESET)
+	{
+		DMA_ClearITPendingBit(DMA2_IT_GL5);
+		UartTxDmaIRQ(&g_tUart4);
+	}
+}
+#endif
+
+/*
+*********************************************************************************************************
+*	函 数 名: DMA1_Channel5_IRQHandler  DMA1_Channel6_IRQHandler DMA1_Channel3_IRQHandler
+*			  DMA2_Channel3_IRQHandler
+*	功能说明: 串口接收DMA通道中断服务程序 (半满、全满)。标志不能在这里清除, UartRxDmaIRQ 要用来检测整圈覆盖。
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+#if UART1_FIFO_EN == 1 && UART1_RX_DMA_EN == 1
+void DMA1_Channel5_IRQHandler(void)
+{
+	UartRxDmaIRQ(&g_tUart1);	/* 由 UartRxDmaIRQ 读取并清除半满、全满标志 */
+}
+#endif
+
+#if UART2_FIFO_EN == 1 && UART2_RX_DMA_EN == 1
+void DMA1_Channel6_IRQHandler(void)
+{
+	UartRxDmaIRQ(&g_tUart2);	/* 由 UartRxDmaIRQ 读取并清除半满、全满标志 */
+}
+#endif
+
+#if UART3_FIFO_EN == 1 && UART3_RX_DMA_EN == 1
+void DMA1_Channel3_IRQHandler(void)
+{
+	UartRxDmaIRQ(&g_tUart3);	/* 由 UartRxDmaIRQ 读取并清除半满、全满标志 */
+}
+#endif
+
+#if UART4_FIFO_EN == 1 && UART4_RX_DMA_EN == 1
+void DMA2_Channel3_IRQHandler(void)
+{
+	UartRxDmaIRQ(&g_tUart4);	/* 由 UartRxDmaIRQ 读取并清除半满、全满标志 */
+}
+#endif
+
+/*
+*********************************************************************************************************
+*	函 数 名: fputc
+*	功能说明: 重定义putc函数，这样可以使用printf函数从串口1打印输出
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+int fputc(int ch, FILE *f)
+{
+#if 1	/* 将需要printf的字符通过串口中断FIFO发送出去，printf函数会立即返回 */
+	comSendChar(COM1, ch);
+
+	return ch;
+#else	/* 采用阻塞方式发送每个字符,等待数据发送完毕 */
+	/* 写一个字节到USART1 */
+	USART_SendData(USART1, (uint8_t) ch);
+
+	/* 等待发送结束 */
+	while (USART_GetFlagStatus(USART1, USART_FLAG_TC) == RESET)
+	{}
+
+	return ch;
+#endif
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: fgetc
+*	功能说明: 重定义getc函数，这样可以使用getchar函数从串口1输入数据
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+int fgetc(FILE *f)
+{
+
+#if 1	/* 从串口接收FIFO中取1个数据, 只有取到数据才返回 */
+	uint8_t ucData;
+
+	while(comGetChar(COM1, &ucData) == 0);
+
+	return ucData;
+#else
+	/* 等待串口1输入数据 */
+	while (USART_GetFlagStatus(USART1, USART_FLAG_RXNE) == RESET);
+
+	return (int)USART_ReceiveData(USART1);
+#endif
+}
+
+/***************************** 安富莱电子 www.armfly.com (END OF FILE) *********************************/
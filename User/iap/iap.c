@@ -0,0 +1,316 @@
+/*
+*********************************************************************************************************
+*
+*	模块名称 : 在应用编程(IAP)模块
+*	文件名称 : iap.c
+*	版    本 : V1.0
+*	说    明 : 应用程序通过USB虚拟串口接收新程序, 边接收边写入下载区, 校验通过后由 Bootloader 安装。
+*
+*				(1) iap_Start() 给出程序长度和CRC, 擦除升级信息页和下载区的前 IAP_ERASE_AHEAD 页;
+*				(2) iap_Write() 把收到的数据按半字写入下载区。数据进入第N页时擦除第 N + IAP_ERASE_AHEAD 页,
+*				    擦除总是提前于数据, 不需要在开始时一次擦除整个下载区(64K 约0.7秒)才能接收数据;
+*				(3) 编程和USB接收不能重叠: F103只有一个Flash bank, 擦除和编程期间CPU取指被暂停(代码和中断
+*				    向量表都在Flash中), USB中断要等到本次擦除/编程结束才能执行。这期间USB模块自己把1个包(双缓冲
+*				    时2个包)收进PMA, 之后OUT端点回应NAK, 主机重试, 数据不会丢失, 但接收停顿。升级时间是接收时间和
+*				    擦除/编程时间之和。接收FIFO只是让两次写Flash之间收到的数据可以成批写入;
+*				(4) iap_Finish() 用硬件CRC单元校验下载区, 正确时写升级信息页, 复位后 Bootloader 把下载区
+*				    复制到应用程序区 (见 iap_boot.c)。
+*
+*				Flash 擦除和编程期间所有中断都被推迟, 擦除一页约20ms, 期间串口等外设的中断也得不到响应。
+*				按手册典型值(擦除20ms/页, 编程52us/半字), 写入64K约需 32 * 20ms + 32768 * 52us = 2.3秒。
+*
+*	修改记录 :
+*		版本号  日期        作者     说明
+*		V1.0    2026-10-17 armfly  正式发布
+*
+*	Copyright (C), 2013-2014, 安富莱电子 www.armfly.com
+*
+*********************************************************************************************************
+*/
+
+#include "iap.h"
+
+#if IAP_EN == 1
+
+/* 接收状态 */
+typedef struct
+{
+	uint32_t ulSize;		/* 程序字节数 */
+	uint32_t ulCrc;			/* 主机给出的CRC32 */
+	uint32_t ulAddr;		/* 下一个写入地址 */
+	uint32_t ulErased;		/* 已擦除到的地址 */
+	uint32_t ulEnd;			/* 下载区需要擦除的结束地址(页对齐) */
+	uint8_t ucBusy;			/* 1 表示正在接收 */
+	uint8_t ucErr;			/* 接收过程中发生的错误, IAP_OK 表示无错误 */
+	uint8_t ucOdd;			/* 1 表示 ucOddByte 中有一个还没有写入的字节 */
+	uint8_t ucOddByte;		/* 半字的低字节, 等待高字节到达 */
+}IAP_T;
+
+static IAP_T s_tIap;
+
+static void IapEraseAhead(uint32_t _ulAddr);
+
+/*
+*********************************************************************************************************
+*	函 数 名: iap_Start
+*	功能说明: 开始接收新程序。作废下载区中等待安装的程序, 擦除下载区的前 IAP_ERASE_AHEAD 页。
+*	形    参: _ulSize : 程序字节数, 必须是4的整数倍 (硬件CRC按字计算), 不足时主机用0xFF补齐
+*			  _ulCrc : 硬件CRC单元算法的CRC32 (多项式0x04C11DB7, 初值0xFFFFFFFF, 按小端字输入, 不取反)
+*	返 回 值: IAP_OK, IAP_ERR_SIZE, IAP_ERR_FLASH
+*********************************************************************************************************
+*/
+uint8_t iap_Start(uint32_t _ulSize, uint32_t _ulCrc)
+{
+	if ((_ulSize == 0) || (_ulSize % 4) || (_ulSize > IAP_SLOT_SIZE))
+	{
+		return IAP_ERR_SIZE;
+	}
+
+	s_tIap.ulSize = _ulSize;
+	s_tIap.ulCrc = _ulCrc;
+	s_tIap.ulAddr = IAP_DL_ADDR;
+	s_tIap.ulErased = IAP_DL_ADDR;
+	s_tIap.ulEnd = IAP_DL_ADDR + (_ulSize + IAP_PAGE_SIZE - 1) / IAP_PAGE_SIZE * IAP_PAGE_SIZE;
+	s_tIap.ucOdd = 0;
+	s_tIap.ucErr = IAP_OK;
+
+	FLASH_Unlock();
+	if (iap_ErasePage(IAP_INFO_ADDR) != IAP_OK)
+	{
+		FLASH_Lock();
+		return IAP_ERR_FLASH;
+	}
+	s_tIap.ucBusy = 1;
+
+	IapEraseAhead(IAP_DL_ADDR);
+	return s_tIap.ucErr;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: iap_Write
+*	功能说明: 把收到的一段程序数据写入下载区。数据可以是任意长度, 奇数字节留到下一次和后续数据组成半字。
+*			  发生Flash错误后继续接收并丢弃数据, 由 iap_Finish() 报告错误, 主机不需要中途停止发送。
+*	形    参: _pBuf : 数据
+*			  _usLen : 数据长度
+*	返 回 值: 使用的字节数。超过 iap_Start() 给出的长度的部分不使用。
+*********************************************************************************************************
+*/
+uint16_t iap_Write(const uint8_t *_pBuf, uint16_t _usLen)
+{
+	uint8_t aHalf[2];
+	uint16_t usDone;
+	uint16_t usEven;
+
+	if (s_tIap.ucBusy == 0)
+	{
+		return 0;
+	}
+
+	if (_usLen > iap_GetRemain())
+	{
+		_usLen = iap_GetRemain();
+	}
+	if (s_tIap.ucErr != IAP_OK)
+	{
+		s_tIap.ulAddr += _usLen;	/* 丢弃 */
+		return _usLen;
+	}
+
+	usDone = 0;
+	if (s_tIap.ucOdd && _usLen > 0)
+	{
+		aHalf[0] = s_tIap.ucOddByte;
+		aHalf[1] = _pBuf[0];
+		s_tIap.ucOdd = 0;
+		usDone = 1;
+
+		IapEraseAhead(s_tIap.ulAddr);
+		if (iap_Program(s_tIap.ulAddr, aHalf, 2) != IAP_OK)
+		{
+			s_tIap.ucErr = IAP_ERR_FLASH;
+		}
+		s_tIap.ulAddr += 2;
+	}
+
+	usEven = (_usLen - usDone) & ~1;
+	if (usEven > 0)
+	{
+		IapEraseAhead(s_tIap.ulAddr + usEven - 1);
+		if (iap_Program(s_tIap.ulAddr, &_pBuf[usDone], usEven) != IAP_OK)
+		{
+			s_tIap.ucErr = IAP_ERR_FLASH;
+		}
+		s_tIap.ulAddr += usEven;
+		usDone += usEven;
+	}
+
+	if (usDone < _usLen)
+	{
+		s_tIap.ucOddByte = _pBuf[usDone];
+		s_tIap.ucOdd = 1;
+		usDone++;
+	}
+	return usDone;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: iap_GetRemain
+*	功能说明: 读取还需要接收的字节数
+*	形    参: 无
+*	返 回 值: 字节数, 没有在接收时返回0
+*********************************************************************************************************
+*/
+uint32_t iap_GetRemain(void)
+{
+	if (s_tIap.ucBusy == 0)
+	{
+		return 0;
+	}
+	return s_tIap.ulSize - (s_tIap.ulAddr - IAP_DL_ADDR) - s_tIap.ucOdd;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: iap_Finish
+*	功能说明: 结束接收, 用硬件CRC单元校验下载区。正确时写升级信息页, 复位后由 Bootloader 安装。
+*	形    参: 无
+*	返 回 值: IAP_OK, IAP_ERR_STATE, IAP_ERR_FLASH, IAP_ERR_CRC
+*********************************************************************************************************
+*/
+uint8_t iap_Finish(void)
+{
+	IAP_INFO_T tInfo;
+	uint8_t ucRet;
+
+	if (s_tIap.ucBusy == 0 || iap_GetRemain() != 0)
+	{
+		return IAP_ERR_STATE;
+	}
+
+	ucRet = s_tIap.ucErr;
+	if (ucRet == IAP_OK && iap_CalcCrc(IAP_DL_ADDR, s_tIap.ulSize) != s_tIap.ulCrc)
+	{
+		ucRet = IAP_ERR_CRC;
+	}
+
+	if (ucRet == IAP_OK)
+	{
+		tInfo.ulMagic = IAP_MAGIC_READY;
+		tInfo.ulSize = s_tIap.ulSize;
+		tInfo.ulCrc = s_tIap.ulCrc;
+		tInfo.ulCrcInv = ~s_tIap.ulCrc;
+		if (iap_Program(IAP_INFO_ADDR, (uint8_t *)&tInfo, sizeof(tInfo)) != IAP_OK)
+		{
+			ucRet = IAP_ERR_FLASH;
+		}
+	}
+
+	iap_Abort();
+	return ucRet;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: iap_Abort
+*	功能说明: 放弃接收 (例如主机超时), 锁定Flash。升级信息页已在 iap_Start() 中擦除, 不会安装不完整的程序。
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void iap_Abort(void)
+{
+	s_tIap.ucBusy = 0;
+	FLASH_Lock();
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: iap_CalcCrc
+*	功能说明: 用硬件CRC单元计算一段Flash的CRC32。CPU直接从Flash读数据, 64K约需1ms。
+*	形    参: _ulAddr : 起始地址, 4字节对齐
+*			  _ulSize : 字节数, 4的整数倍
+*	返 回 值: CRC32
+*********************************************************************************************************
+*/
+uint32_t iap_CalcCrc(uint32_t _ulAddr, uint32_t _ulSize)
+{
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_CRC, ENABLE);
+
+	CRC_ResetDR();
+	return CRC_CalcBlockCRC((uint32_t *)_ulAddr, _ulSize / 4);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: iap_ErasePage
+*	功能说明: 擦除一页Flash。调用前需要 FLASH_Unlock()。
+*	形    参: _ulAddr : 页内任意地址
+*	返 回 值: IAP_OK, IAP_ERR_FLASH
+*********************************************************************************************************
+*/
+uint8_t iap_ErasePage(uint32_t _ulAddr)
+{
+	if (FLASH_ErasePage(_ulAddr) != FLASH_COMPLETE)
+	{
+		return IAP_ERR_FLASH;
+	}
+	return IAP_OK;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: iap_Program
+*	功能说明: 按半字写入一段已擦除的Flash。调用前需要 FLASH_Unlock()。
+*	形    参: _ulAddr : 起始地址, 2字节对齐
+*			  _pBuf : 数据, 可以不对齐
+*			  _ulLen : 字节数, 2的整数倍
+*	返 回 值: IAP_OK, IAP_ERR_FLASH
+*********************************************************************************************************
+*/
+uint8_t iap_Program(uint32_t _ulAddr, const uint8_t *_pBuf, uint32_t _ulLen)
+{
+	uint32_t i;
+
+	for (i = 0; i < _ulLen; i += 2)
+	{
+		if (FLASH_ProgramHalfWord(_ulAddr + i, _pBuf[i] | (_pBuf[i + 1] << 8)) != FLASH_COMPLETE)
+		{
+			return IAP_ERR_FLASH;
+		}
+	}
+	return IAP_OK;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: IapEraseAhead
+*	功能说明: 保证从写入位置所在页开始的 IAP_ERASE_AHEAD 页已经擦除。每进入一个新页只擦除一页。
+*	形    参: _ulAddr : 即将写入的最后一个字节的地址
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void IapEraseAhead(uint32_t _ulAddr)
+{
+	uint32_t ulTarget;
+
+	ulTarget = _ulAddr - (_ulAddr - IAP_DL_ADDR) % IAP_PAGE_SIZE + IAP_ERASE_AHEAD * IAP_PAGE_SIZE;
+	if (ulTarget > s_tIap.ulEnd)
+	{
+		ulTarget = s_tIap.ulEnd;
+	}
+
+	while (s_tIap.ulErased < ulTarget)
+	{
+		if (iap_ErasePage(s_tIap.ulErased) != IAP_OK)
+		{
+			s_tIap.ucErr = IAP_ERR_FLASH;
+		}
+		s_tIap.ulErased += IAP_PAGE_SIZE;
+	}
+}
+
+#endif
+
+/***************************** 安富莱电子 www.armfly.com (END OF FILE) *********************************/
@@ -0,0 +1,83 @@
+/*
+*********************************************************************************************************
+*
+*	模块名称 : 在应用编程(IAP)模块
+*	文件名称 : iap.h
+*	版    本 : V1.0
+*	说    明 : 头文件。Flash 分区和升级接口。
+*
+*	Copyright (C), 2013-2014, 安富莱电子 www.armfly.com
+*
+*********************************************************************************************************
+*/
+
+#ifndef __IAP_H
+#define __IAP_H
+
+#include "stm32f10x.h"
+
+/*
+	IAP 需要两份程序空间, 只有大容量芯片(103ZE, 512K Flash, 2K/页)支持。64K Flash 的 103C8 不支持。
+	修改 IAP_EN 或分区后, 需要同步修改 Keil 工程 103ZE 目标的 IROM 起始地址和大小 (IAP_APP_ADDR, IAP_SLOT_SIZE)。
+*/
+#if defined(STM32F10X_HD)
+	#define IAP_EN			1
+#else
+	#define IAP_EN			0
+#endif
+
+#if IAP_EN == 1
+
+/*
+	Flash 分区:
+	0x08000000  Bootloader (Boot 目标, 8K)
+	0x08002000  应用程序 (103ZE 目标, 248K)
+	0x08040000  下载区, 新程序先写入这里, 校验通过后由 Bootloader 复制到应用程序区 (248K)
+	0x0807E000  升级信息页, 记录下载区中待安装的程序 (2K)
+*/
+#define IAP_PAGE_SIZE		2048
+#define IAP_BOOT_ADDR		0x08000000
+#define IAP_APP_ADDR		0x08002000
+#define IAP_DL_ADDR			0x08040000
+#define IAP_INFO_ADDR		0x0807E000
+#define IAP_SLOT_SIZE		(IAP_DL_ADDR - IAP_APP_ADDR)
+
+#define IAP_ERASE_AHEAD		2			/* 提前擦除的页数。擦除一页约20ms, 期间USB数据在接收FIFO中排队 */
+
+#define IAP_MAGIC_READY		0x50414955	/* "UIAP", 下载区有校验通过、等待安装的程序 */
+
+/* 升级信息页的内容 */
+typedef struct
+{
+	uint32_t ulMagic;		/* IAP_MAGIC_READY */
+	uint32_t ulSize;		/* 程序字节数, 4的整数倍 */
+	uint32_t ulCrc;			/* 硬件CRC单元计算的CRC32 */
+	uint32_t ulCrcInv;		/* ~ulCrc, 防止擦除不完整等情况被误认为有效 */
+}IAP_INFO_T;
+
+/* 函数返回值 */
+enum
+{
+	IAP_OK = 0,
+	IAP_ERR_SIZE,			/* 长度为0、不是4的整数倍或超过分区大小 */
+	IAP_ERR_STATE,			/* 没有调用 iap_Start() 或数据未接收完 */
+	IAP_ERR_FLASH,			/* 擦除或编程失败 */
+	IAP_ERR_CRC,			/* CRC校验失败 */
+	IAP_ERR_PATCH			/* 差分包格式错误, 或和正在运行的程序版本不符 (见 iap_patch.c) */
+};
+
+uint8_t iap_Start(uint32_t _ulSize, uint32_t _ulCrc);
+uint16_t iap_Write(const uint8_t *_pBuf, uint16_t _usLen);
+uint32_t iap_GetRemain(void);
+uint8_t iap_Finish(void);
+void iap_Abort(void);
+
+uint32_t iap_CalcCrc(uint32_t _ulAddr, uint32_t _ulSize);
+uint8_t iap_ErasePage(uint32_t _ulAddr);
+uint8_t iap_Program(uint32_t _ulAddr, const uint8_t *_pBuf, uint32_t _ulLen);
+
+#endif
+
+#endif
+
+/***************************** 安富莱电子 www.armfly.com (END OF FILE) *********************************/
@@ -0,0 +1,146 @@
+/*
+*********************************************************************************************************
+*
+*	模块名称 : Bootloader 主程序
+*	文件名称 : iap_boot.c
+*	版    本 : V1.0
+*	说    明 : Keil 工程 Boot 目标的主程序, 位于 Flash 开头 (IAP_BOOT_ADDR)。用 ST-Link 烧写一次即可。
+*
+*				(1) 升级信息页有效, 并且下载区CRC正确时, 把下载区逐页复制到应用程序区, 内容相同的页跳过,
+*				    复制后再次校验CRC, 最后擦除升级信息页。复制过程中掉电, 重新上电后会从头再复制一次;
+*				(2) 跳转到应用程序。应用程序自己把中断向量表设置到 IAP_APP_ADDR (见 main.c)。
+*
+*				应用程序区没有有效程序(栈顶地址不在RAM中)时停在 Bootloader, 需要用 ST-Link 烧写。
+*
+*	修改记录 :
+*		版本号  日期        作者     说明
+*		V1.0    2026-10-17 armfly  正式发布
+*
+*	Copyright (C), 2013-2014, 安富莱电子 www.armfly.com
+*
+*********************************************************************************************************
+*/
+
+#include "iap.h"
+#include <string.h>
+
+/* 跳转地址用全局变量保存: 修改MSP后不能再访问栈上的局部变量 */
+static void (*s_pAppEntry)(void);
+
+static uint8_t BootCheckInfo(IAP_INFO_T *_pInfo);
+static void BootInstall(IAP_INFO_T *_pInfo);
+static void BootJumpToApp(void);
+
+/*
+*********************************************************************************************************
+*	函 数 名: main
+*	功能说明: Bootloader 入口。启动文件已经执行 SystemInit(), CPU 运行在72MHz。
+*	形    参：无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+int main(void)
+{
+	IAP_INFO_T *pInfo;
+
+	pInfo = (IAP_INFO_T *)IAP_INFO_ADDR;
+	if (BootCheckInfo(pInfo))
+	{
+		BootInstall(pInfo);
+	}
+
+	BootJumpToApp();
+
+	while (1);		/* 没有有效的应用程序 */
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: BootCheckInfo
+*	功能说明: 检查升级信息页和下载区
+*	形    参: _pInfo : 升级信息页
+*	返 回 值: 1 表示下载区中有需要安装的程序
+*********************************************************************************************************
+*/
+static uint8_t BootCheckInfo(IAP_INFO_T *_pInfo)
+{
+	if (_pInfo->ulMagic != IAP_MAGIC_READY || _pInfo->ulCrc != ~_pInfo->ulCrcInv)
+	{
+		return 0;
+	}
+	if (_pInfo->ulSize == 0 || (_pInfo->ulSize % 4) || _pInfo->ulSize > IAP_SLOT_SIZE)
+	{
+		return 0;
+	}
+	return (iap_CalcCrc(IAP_DL_ADDR, _pInfo->ulSize) == _pInfo->ulCrc);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: BootInstall
+*	功能说明: 把下载区复制到应用程序区。和应用程序区内容相同的页不擦写, 小改动的程序安装更快。
+*			  校验通过后擦除升级信息页; 重试3次仍失败时保留升级信息页, 下次上电再安装。
+*	形    参: _pInfo : 升级信息页
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void BootInstall(IAP_INFO_T *_pInfo)
+{
+	uint32_t ulOffset;
+	uint32_t ulLen;
+	uint8_t ucRetry;
+
+	FLASH_Unlock();
+
+	for (ucRetry = 0; ucRetry < 3; ucRetry++)
+	{
+		for (ulOffset = 0; ulOffset < _pInfo->ulSize; ulOffset += IAP_PAGE_SIZE)
+		{
+			ulLen = _pInfo->ulSize - ulOffset;
+			if (ulLen > IAP_PAGE_SIZE)
+			{
+				ulLen = IAP_PAGE_SIZE;
+			}
+
+			if (memcmp((uint8_t *)(IAP_APP_ADDR + ulOffset), (uint8_t *)(IAP_DL_ADDR + ulOffset), ulLen) == 0)
+			{
+				continue;	/* 内容相同, 跳过 */
+			}
+
+			iap_ErasePage(IAP_APP_ADDR + ulOffset);
+			iap_Program(IAP_APP_ADDR + ulOffset, (uint8_t *)(IAP_DL_ADDR + ulOffset), ulLen);
+		}
+
+		if (iap_CalcCrc(IAP_APP_ADDR, _pInfo->ulSize) == _pInfo->ulCrc)
+		{
+			iap_ErasePage(IAP_INFO_ADDR);
+			break;
+		}
+	}
+
+	FLASH_Lock();
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: BootJumpToApp
+*	功能说明: 跳转到应用程序。应用程序向量表的第1个字是栈顶地址, 第2个字是复位入口。
+*	形    参: 无
+*	返 回 值: 无 (应用程序无效时返回)
+*********************************************************************************************************
+*/
+static void BootJumpToApp(void)
+{
+	if ((*(__IO uint32_t *)IAP_APP_ADDR & 0x2FFE0000) != SRAM_BASE)
+	{
+		return;
+	}
+
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_CRC, DISABLE);
+
+	s_pAppEntry = (void (*)(void))(*(__IO uint32_t *)(IAP_APP_ADDR + 4));
+	__set_MSP(*(__IO uint32_t *)IAP_APP_ADDR);
+	s_pAppEntry();
+}
+
+/***************************** 安富莱电子 www.armfly.com (END OF FILE) *********************************/
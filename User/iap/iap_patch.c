@@ -0,0 +1,358 @@
+/*
+*********************************************************************************************************
+*
+*	模块名称 : 差分升级模块
+*	文件名称 : iap_patch.c
+*	版    本 : V1.0
+*	说    明 : 用正在运行的程序(应用程序区)和差分包生成新程序, 写入下载区, 之后和完整升级一样
+*			  由 iap_Finish() 校验、Bootloader 安装。差分包由 Tools/iap_diff.py 生成。
+*
+*				差分包格式 (多字节数据都是小端):
+*				包头 20字节 : "DPT1", 旧程序长度, 旧程序CRC32, 新程序长度, 新程序CRC32
+*				命令序列    : 按顺序生成新程序
+*					0x01 COPY 长度 增量	从旧程序复制。源地址 = 上一条COPY的结束地址 + 增量
+*					0x02 DATA 长度 数据	新数据
+*					0x00 END				结束, 后面不能再有数据
+*				长度和增量是变长整数(每字节7位, 低位在前, 最高位为1表示后面还有字节), 增量是有符号数,
+*				按 (n << 1) ^ (n >> 31) 编码。
+*
+*				(1) 旧程序长度和CRC必须和应用程序区一致, 差分包只能用于生成它的那个版本;
+*				(2) 解码逐字节进行, 差分包可以按任意长度分段输入, 不需要缓存整个包或整页数据。
+*				    COPY 直接从应用程序区读取, DATA 直接转交 iap_Write(), 除状态变量外不占用RAM;
+*				(3) 发生错误后继续接收并丢弃数据, 由 iap_PatchFinish() 报告。
+*
+*	修改记录 :
+*		版本号  日期        作者     说明
+*		V1.0    2026-10-17 armfly  正式发布
+*
+*	Copyright (C), 2013-2014, 安富莱电子 www.armfly.com
+*
+*********************************************************************************************************
+*/
+
+#include "iap_patch.h"
+
+#if IAP_EN == 1
+
+/* 解码状态 */
+enum
+{
+	PS_HEAD = 0,		/* 接收包头 */
+	PS_OP,				/* 等待命令 */
+	PS_LEN,				/* 接收长度 */
+	PS_SRC,				/* 接收COPY的源地址增量 */
+	PS_DATA,			/* 接收DATA的数据 */
+	PS_END				/* 已收到END */
+};
+
+typedef struct
+{
+	uint32_t ulRemain;		/* 还需要接收的差分包字节数 */
+	uint32_t ulOldSize;		/* 旧程序长度 */
+	uint32_t ulSrc;			/* 旧程序中下一个COPY的默认起始位置 */
+	uint32_t ulLen;			/* 当前命令剩余的长度 */
+	uint32_t ulVar;			/* 正在解码的变长整数 */
+	uint8_t ucShift;		/* 变长整数已解码的位数 */
+	uint8_t ucState;		/* PS_HEAD 等 */
+	uint8_t ucOp;			/* 当前命令 */
+	uint8_t ucErr;			/* IAP_OK 表示无错误 */
+	uint8_t ucBusy;			/* 1 表示正在接收 */
+	uint8_t ucHeadLen;		/* 已收到的包头字节数 */
+	uint8_t aHead[PATCH_HEAD_SIZE];
+}PATCH_T;
+
+static PATCH_T s_tPatch;
+
+static void PatchCheckHead(void);
+static uint8_t PatchVarint(uint8_t _ucByte);
+static void PatchOutput(const uint8_t *_pData, uint32_t _ulLen);
+static uint32_t PatchGetU32(uint8_t _ucPos);
+
+/*
+*********************************************************************************************************
+*	函 数 名: iap_PatchStart
+*	功能说明: 开始接收差分包。下载区在收到包头、确认版本后才开始擦除。
+*	形    参: _ulPatchSize : 差分包字节数
+*	返 回 值: IAP_OK, IAP_ERR_SIZE
+*********************************************************************************************************
+*/
+uint8_t iap_PatchStart(uint32_t _ulPatchSize)
+{
+	if (_ulPatchSize <= PATCH_HEAD_SIZE)
+	{
+		return IAP_ERR_SIZE;
+	}
+
+	s_tPatch.ulRemain = _ulPatchSize;
+	s_tPatch.ucHeadLen = 0;
+	s_tPatch.ucState = PS_HEAD;
+	s_tPatch.ucErr = IAP_OK;
+	s_tPatch.ucBusy = 1;
+	return IAP_OK;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: iap_PatchWrite
+*	功能说明: 输入一段差分包数据, 解码并把生成的新程序写入下载区
+*	形    参: _pBuf : 数据
+*			  _usLen : 数据长度
+*	返 回 值: 使用的字节数。超过 iap_PatchStart() 给出的长度的部分不使用。
+*********************************************************************************************************
+*/
+uint16_t iap_PatchWrite(const uint8_t *_pBuf, uint16_t _usLen)
+{
+	uint16_t i;
+	uint32_t ulNum;
+
+	if (s_tPatch.ucBusy == 0)
+	{
+		return 0;
+	}
+
+	if (_usLen > s_tPatch.ulRemain)
+	{
+		_usLen = s_tPatch.ulRemain;
+	}
+	s_tPatch.ulRemain -= _usLen;
+
+	i = 0;
+	while (i < _usLen && s_tPatch.ucErr == IAP_OK)
+	{
+		switch (s_tPatch.ucState)
+		{
+			case PS_HEAD:
+				s_tPatch.aHead[s_tPatch.ucHeadLen++] = _pBuf[i++];
+				if (s_tPatch.ucHeadLen == PATCH_HEAD_SIZE)
+				{
+					PatchCheckHead();
+				}
+				break;
+
+			case PS_OP:
+				s_tPatch.ucOp = _pBuf[i++];
+				s_tPatch.ulVar = 0;
+				s_tPatch.ucShift = 0;
+				if (s_tPatch.ucOp == PATCH_OP_END)
+				{
+					s_tPatch.ucState = PS_END;
+				}
+				else if (s_tPatch.ucOp == PATCH_OP_COPY || s_tPatch.ucOp == PATCH_OP_DATA)
+				{
+					s_tPatch.ucState = PS_LEN;
+				}
+				else
+				{
+					s_tPatch.ucErr = IAP_ERR_PATCH;
+				}
+				break;
+
+			case PS_LEN:
+				if (PatchVarint(_pBuf[i++]))
+				{
+					s_tPatch.ulLen = s_tPatch.ulVar;
+					s_tPatch.ulVar = 0;
+					s_tPatch.ucShift = 0;
+					if (s_tPatch.ucOp == PATCH_OP_COPY)
+					{
+						s_tPatch.ucState = PS_SRC;
+					}
+					else
+					{
+						s_tPatch.ucState = (s_tPatch.ulLen > 0) ? PS_DATA : PS_OP;
+					}
+				}
+				break;
+
+			case PS_SRC:
+				if (PatchVarint(_pBuf[i++]))
+				{
+					/* 有符号增量, 按补码加到源地址上 */
+					s_tPatch.ulSrc += (s_tPatch.ulVar >> 1) ^ (0 - (s_tPatch.ulVar & 1));
+					if (s_tPatch.ulSrc > s_tPatch.ulOldSize || s_tPatch.ulLen > s_tPatch.ulOldSize - s_tPatch.ulSrc)
+					{
+						s_tPatch.ucErr = IAP_ERR_PATCH;
+						break;
+					}
+					PatchOutput((uint8_t *)(IAP_APP_ADDR + s_tPatch.ulSrc), s_tPatch.ulLen);
+					s_tPatch.ulSrc += s_tPatch.ulLen;
+					s_tPatch.ucState = PS_OP;
+				}
+				break;
+
+			case PS_DATA:
+				ulNum = _usLen - i;
+				if (ulNum > s_tPatch.ulLen)
+				{
+					ulNum = s_tPatch.ulLen;
+				}
+				PatchOutput(&_pBuf[i], ulNum);
+				i += ulNum;
+				s_tPatch.ulLen -= ulNum;
+				if (s_tPatch.ulLen == 0)
+				{
+					s_tPatch.ucState = PS_OP;
+				}
+				break;
+
+			default:	/* PS_END 后面还有数据 */
+				s_tPatch.ucErr = IAP_ERR_PATCH;
+				break;
+		}
+	}
+	return _usLen;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: iap_PatchGetRemain
+*	功能说明: 读取还需要接收的差分包字节数
+*	形    参: 无
+*	返 回 值: 字节数, 没有在接收时返回0
+*********************************************************************************************************
+*/
+uint32_t iap_PatchGetRemain(void)
+{
+	if (s_tPatch.ucBusy == 0)
+	{
+		return 0;
+	}
+	return s_tPatch.ulRemain;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: iap_PatchFinish
+*	功能说明: 结束接收差分包。新程序完整时由 iap_Finish() 校验CRC并写升级信息页。
+*	形    参: 无
+*	返 回 值: IAP_OK, 或错误代码 (见 iap.h)
+*********************************************************************************************************
+*/
+uint8_t iap_PatchFinish(void)
+{
+	if (s_tPatch.ucBusy == 0 || s_tPatch.ulRemain != 0)
+	{
+		return IAP_ERR_STATE;
+	}
+	s_tPatch.ucBusy = 0;
+
+	if (s_tPatch.ucErr == IAP_OK && (s_tPatch.ucState != PS_END || iap_GetRemain() != 0))
+	{
+		s_tPatch.ucErr = IAP_ERR_PATCH;		/* 差分包不完整, 或生成的程序长度不对 */
+	}
+	if (s_tPatch.ucErr != IAP_OK)
+	{
+		iap_Abort();
+		return s_tPatch.ucErr;
+	}
+	return iap_Finish();
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: iap_PatchAbort
+*	功能说明: 放弃接收差分包 (例如主机超时)
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void iap_PatchAbort(void)
+{
+	s_tPatch.ucBusy = 0;
+	iap_Abort();
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: PatchCheckHead
+*	功能说明: 检查包头。旧程序必须和应用程序区完全相同, 然后开始写入下载区。
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void PatchCheckHead(void)
+{
+	s_tPatch.ulOldSize = PatchGetU32(4);
+	s_tPatch.ulSrc = 0;
+	s_tPatch.ucState = PS_OP;
+
+	if (PatchGetU32(0) != PATCH_MAGIC || s_tPatch.ulOldSize == 0 || (s_tPatch.ulOldSize % 4)
+		|| s_tPatch.ulOldSize > IAP_SLOT_SIZE)
+	{
+		s_tPatch.ucErr = IAP_ERR_PATCH;
+		return;
+	}
+
+	if (iap_CalcCrc(IAP_APP_ADDR, s_tPatch.ulOldSize) != PatchGetU32(8))
+	{
+		s_tPatch.ucErr = IAP_ERR_PATCH;		/* 正在运行的不是差分包对应的旧版本 */
+		return;
+	}
+
+	s_tPatch.ucErr = iap_Start(PatchGetU32(12), PatchGetU32(16));
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: PatchVarint
+*	功能说明: 输入变长整数的一个字节, 结果在 s_tPatch.ulVar 中
+*	形    参: _ucByte : 字节
+*	返 回 值: 1 表示整数已结束
+*********************************************************************************************************
+*/
+static uint8_t PatchVarint(uint8_t _ucByte)
+{
+	if (s_tPatch.ucShift >= 32)
+	{
+		s_tPatch.ucErr = IAP_ERR_PATCH;		/* 超过5个字节 */
+		return 0;
+	}
+
+	s_tPatch.ulVar |= (uint32_t)(_ucByte & 0x7F) << s_tPatch.ucShift;
+	s_tPatch.ucShift += 7;
+	return ((_ucByte & 0x80) == 0);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: PatchOutput
+*	功能说明: 把生成的新程序数据写入下载区。超过新程序长度时报错。
+*	形    参: _pData : 数据, 可以在应用程序区(Flash)中
+*			  _ulLen : 数据长度
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void PatchOutput(const uint8_t *_pData, uint32_t _ulLen)
+{
+	uint16_t usNum;
+
+	while (_ulLen > 0)
+	{
+		usNum = (_ulLen > 0x8000) ? 0x8000 : _ulLen;
+		if (iap_Write(_pData, usNum) != usNum)
+		{
+			s_tPatch.ucErr = IAP_ERR_PATCH;
+			return;
+		}
+		_pData += usNum;
+		_ulLen -= usNum;
+	}
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: PatchGetU32
+*	功能说明: 从包头中读取一个小端32位数
+*	形    参: _ucPos : 包头中的位置
+*	返 回 值: 32位数
+*********************************************************************************************************
+*/
+static uint32_t PatchGetU32(uint8_t _ucPos)
+{
+	return s_tPatch.aHead[_ucPos] | (s_tPatch.aHead[_ucPos + 1] << 8)
+		| (s_tPatch.aHead[_ucPos + 2] << 16) | ((uint32_t)s_tPatch.aHead[_ucPos + 3] << 24);
+}
+
+#endif
+
+/***************************** 安富莱电子 www.armfly.com (END OF FILE) *********************************/
@@ -0,0 +1,39 @@
+/*
+*********************************************************************************************************
+*
+*	模块名称 : 差分升级模块
+*	文件名称 : iap_patch.h
+*	版    本 : V1.0
+*	说    明 : 头文件。差分包格式见 iap_patch.c。
+*
+*	Copyright (C), 2013-2014, 安富莱电子 www.armfly.com
+*
+*********************************************************************************************************
+*/
+
+#ifndef __IAP_PATCH_H
+#define __IAP_PATCH_H
+
+#include "iap.h"
+
+#if IAP_EN == 1
+
+#define PATCH_MAGIC			0x31545044	/* "DPT1" */
+#define PATCH_HEAD_SIZE		20			/* 包头: 标志, 旧程序长度, 旧程序CRC, 新程序长度, 新程序CRC */
+
+/* 命令 */
+#define PATCH_OP_END		0x00		/* 结束 */
+#define PATCH_OP_COPY		0x01		/* 从旧程序复制: 长度, 源地址增量 */
+#define PATCH_OP_DATA		0x02		/* 新数据: 长度, 数据 */
+
+uint8_t iap_PatchStart(uint32_t _ulPatchSize);
+uint16_t iap_PatchWrite(const uint8_t *_pBuf, uint16_t _usLen);
+uint32_t iap_PatchGetRemain(void);
+uint8_t iap_PatchFinish(void);
+void iap_PatchAbort(void);
+
+#endif
+
+#endif
+
+/***************************** 安富莱电子 www.armfly.com (END OF FILE) *********************************/
@@ -1,231 +1,634 @@
-/*
-	通信协议：
-	(1) 采用ASCII字符通信
-	(2) 每个命令帧由$开头，#结束
-	(3) PC发往开发板的命令定义：
-		$LEDON=1#    			点亮开发板上LED灯, 数字范围：1-4
-		$LEDOFF=2#    			熄灭开发板上LED灯, 数字范围：1-4	
-		$LEDONALL#    			点亮开发板上所有的LED灯
-		$LEDOFFALL#    			熄灭开发板上所有的LED灯
-		
-	(4) 开发板发往PC的命令定义 (为了便于超级终端换行显示，#后面还加了回车和换行字符\r\n)
-		$OK#                    对PC命令的正确应答；如果不正确，则不响应
-		$KEY=U#	   				摇杆上键按下
-		$KEY=D#					摇杆下键按下
-		$KEY=L#					摇杆左键按下
-		$KEY=R#					摇杆右键按下
-*/
-#define NANOPRINTF_IMPLEMENTATION
-#include "nanoprintf.h"
-#include "bsp.h"
-#include "hw_config.h"			/* USB模块 */
-
-/* 仅允许本文件内调用的函数声明 */
-static void InitBoard(void);
-static void PrintHelpInfo(void);
-static void UsbCmdPro(void);
-static void ReportOk(void);
-static void AnalyzeCmd(uint8_t *_pCmdBuf, uint16_t _usLen);
-
-/*
-*********************************************************************************************************
-*	函 数 名: main
-*	功能说明: c程序入口
-*	形    参：无
-*	返 回 值: 错误代码(无需处理)
-*********************************************************************************************************
-*/
-int main(void)
-{
-	uint8_t ucKeyCode;
-
-	/*
-		由于ST固件库的启动文件已经执行了CPU系统时钟的初始化，所以不必再次重复配置系统时钟。
-		启动文件配置了CPU主时钟频率、内部Flash访问速度和可选的外部SRAM FSMC初始化。
-
-		系统时钟缺省配置为72MHz，如果需要更改，可以修改：
-		\Libraries\CMSIS\CM3\DeviceSupport\ST\STM32F10x\system_stm32f10x.c
-		中配置系统时钟的宏。
-	*/
-
-	InitBoard();	/* 为了是main函数看起来更简洁些，我们将硬件初始化的代码封装到这个函数 */
-
-	/* 初始化USB设备 */
-	bsp_InitUsb();
-
-   	PrintHelpInfo();	/* 打印帮助提示到串口1 */
-
-	while(1)
-	{
-		CPU_IDLE();
-
-		UsbCmdPro();	/* 处理PC通过USB发来的命令 (非阻塞) */
-        usb_SendDataToHost((uint8_t*)"$KEY=U#\r\n", 9);
-		ucKeyCode = bsp_GetKey();	/* 读取键值, 无键按下时返回 KEY_NONE = 0 */
-		if (ucKeyCode != KEY_NONE)
-		{
-			/* 有键按下 */
-			switch (ucKeyCode)
-			{
-				case KID_K1:		/* 摇杆UP键按下 */
-					usb_SendDataToHost((uint8_t*)"$KEY=U#\r\n", 9);
-					break;
-
-				case KID_K2:		/* 摇杆DOWN键按下 */
-					usb_SendDataToHost((uint8_t*)"$KEY=D#\r\n", 9);
-					break;
-
-				default:
-					break;
-			}
-		}
-	}			
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: PrintHelpInfo
-*	功能说明: 将帮助信息打印到串口
-*	形    参：无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-static void PrintHelpInfo(void)
-{
-	printf("请安装stm32_vcp USB虚拟串口驱动，然后用串口工具打开这个虚拟串口进行操作。\r\n");
-	printf("PC->开发板的命令格式：\r\n");
-	printf("  $LEDON=1#     点亮开发板上LED灯, 数字范围：1-4\r\n");
-	printf("  $LEDOFF=2#    熄灭开发板上LED灯, 数字范围：1-4\r\n");
-	printf("  $LEDONALL#    点亮开发板上所有的LED灯\r\n");
-	printf("  $LEDOFFALL#   熄灭开发板上所有的LED灯\r\n");
-    
-	printf("开发板->PC的汇报格式：\r\n");
-	printf("  $OK#          对PC命令的正确应答；如果不正确，则不响应\r\n");
-	printf("  $KEY=U#       摇杆上键按下\r\n");
-	printf("  $KEY=D#       摇杆下键按\r\n");
-	printf("  $KEY=L#       摇杆左键按下\r\n");
-	printf("  $KEY=R#       摇杆右键按下\r\n");
-    npf_pprintf(0, 0, "  $KEY=R#       摇杆右键按下\r\n");
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: UsbCmdPro
-*	功能说明: 处理USB口接收到的数据。 非阻塞模式
-*	形    参：无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-static void UsbCmdPro(void)
-{
-	uint8_t ucData;
-	uint8_t ucNum;
-	static uint8_t aCmdBuf[32];
-	static uint16_t usPos;
-	
-	ucData = usb_GetRxByte(&ucNum);	/* 从USB口读取一个字节 ucNum存放读到的字节个数 */
-	if (ucNum == 0)
-	{
-		return;
-	}
-	usb_SendDataToHost(&ucData, 1);	/* 在PC串口工具回显键入的字符 */
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: ReportOk
-*	功能说明: 相应命令正确应答
-*	形    参：无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-static void ReportOk(void)
-{
-	usb_SendDataToHost((uint8_t*)"\r\n$OK#\r\n", 8);;
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: AnalyzeCmd
-*	功能说明: 分析PC机的命令
-*	形    参：无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-static void AnalyzeCmd(uint8_t *_pCmdBuf, uint16_t _usLen)
-{
-	/*	
-		$LEDON=1#    			点亮开发板上LED灯, 数字范围：1-4
-		$LEDOFF=2#    			熄灭开发板上LED灯, 数字范围：1-4	
-		$LEDONALL#    			点亮开发板上所有的LED灯
-		$LEDOFFALL#    		熄灭开发板上所有的LED灯
-		
-	开发板发往PC的命令定义
-		$OK#                    对PC命令的正确应答；如果不正确，则不响应
-		$KEY=U#	   				摇杆上键按下
-		$KEY=D#					摇杆下键按下
-		$KEY=L#					摇杆左键按下
-		$KEY=R#					摇杆右键按下
-	*/
-	_pCmdBuf[_usLen] = 0;
-
-	if ((_usLen == 7) && (memcmp(_pCmdBuf, "LEDON=", 6) == 0))	  /* 点亮LED灯 */
-	{
-		ReportOk();	/* 应答OK */
-		if ((_pCmdBuf[6] >= '1') && (_pCmdBuf[6] <= '4'))
-		{
-			bsp_LedOn(_pCmdBuf[6] - '0');
-		}
-	}
-	else if ((_usLen == 8) && (memcmp(_pCmdBuf, "LEDOFF=", 7) == 0))
-	{
-		ReportOk();	/* 应答OK */
-		if ((_pCmdBuf[7] >= '1') && (_pCmdBuf[7] <= '4'))
-		{
-			bsp_LedOn(_pCmdBuf[7] - '0');
-		}
-	}
-	else if ((_usLen == 8) && (memcmp(_pCmdBuf, "LEDONALL", 8) == 0))
-	{
-		ReportOk();	/* 应答OK */
-		bsp_LedOn(1);
-		bsp_LedOn(2);
-		bsp_LedOn(3);
-		bsp_LedOn(4);
-	}
-	else if ((_usLen == 9) && (memcmp(_pCmdBuf, "LEDOFFALL", 9) == 0))
-	{
-		ReportOk();	/* 应答OK */
-		bsp_LedOff(1);
-		bsp_LedOff(2);
-		bsp_LedOff(3);
-		bsp_LedOff(4);
-	}
-	else
-	{
-		usb_SendDataToHost((uint8_t*)"\r\n$ERRCMD#\r\n", 10);		/* 应答错误 */
-	}
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: InitBoard
-*	功能说明: 初始化硬件设备
-*	形    参：无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-static void InitBoard(void)
-{
-	/* 配置串口，用于printf输出 */
-	bsp_InitUart();
-
-	/* 配置LED指示灯GPIO */
-	bsp_InitLed();
-
-	/* 配置按键GPIO, 必须在bsp_InitTimer之前调用 */
-	bsp_InitKey();
-
-	/* 初始化systick定时器，并启动定时中断 */
-	bsp_InitTimer();
-}
+/*
+	通信协议：
+	(1) 采用ASCII字符通信
+	(2) 每个命令帧由$开头，#结束
+	(3) PC发往开发板的命令定义：
+		$LEDON=1#    			点亮开发板上LED灯, 数字范围：1-4
+		$LEDOFF=2#    			熄灭开发板上LED灯, 数字范围：1-4	
+		$LEDONALL#    			点亮开发板上所有的LED灯
+		$LEDOFFALL#    			熄灭开发板上所有的LED灯
+		$TXDROP#				查询USB发送FIFO满被丢弃的字节数, 应答 $TXDROP=123#
+		$IAP=65536,1A2B3C4D#	升级程序 (仅103ZE): 程序长度(十进制, 4的整数倍), 硬件CRC32(十六进制)。
+								应答 $IAP=OK# 后PC连续发送程序的二进制数据(不回显), 接收完并校验通过后
+								应答 $IAP=OK# 并复位, 由 Bootloader 安装; 失败应答 $IAP=ERR=n# (n 见 iap.h)。
+								主机可以用 Tools/usb_iap.py 升级。
+		$IAPD=1234#				差分升级 (仅103ZE): 差分包长度(十进制)。应答和数据流程同 $IAP#, 设备用正在运行的
+								程序和差分包生成新程序。差分包由 Tools/iap_diff.py 生成, 同样用 usb_iap.py 发送。
+		
+	(4) 开发板发往PC的命令定义 (为了便于超级终端换行显示，#后面还加了回车和换行字符\r\n)
+		$OK#                    对PC命令的正确应答；如果不正确，则不响应
+		$KEY=U#	   				摇杆上键按下
+		$KEY=D#					摇杆下键按下
+		$KEY=L#					摇杆左键按下
+		$KEY=R#					摇杆右键按下
+
+	(5) 复合设备 (usb_conf.h 中 USB_COMPOSITE_EN = 1) 时, 以上命令只在第1个虚拟串口(USB_COM1)上处理;
+		厂商自定义批量接口(USB_VENDOR)把收到的数据原样发回, 用于测试吞吐量 (Tools/usb_vendor_bench.py)。
+	(6) 串口桥接 (Keil 目标 103ZE_Bridge, 或 usb_conf.h 中 USB_BRIDGE_EN = 1) 时, 第2个虚拟串口(USB_COM2)在中断中和 USART2 双向透传,
+		PC端设置的波特率等参数直接配置 USART2, 主程序不参与 (见 usb_bridge.c)。
+*/
+#define NANOPRINTF_IMPLEMENTATION
+#include "nanoprintf.h"
+#include "bsp.h"
+#include "hw_config.h"			/* USB模块 */
+#include "modbus_slave.h"		/* MODBUS RTU 从站 (RS485) */
+#include "iap.h"				/* 在应用编程 */
+#include "iap_patch.h"			/* 差分升级 */
+
+#define IAP_TIMEOUT		3000	/* 升级时PC停止发送数据的超时时间, 单位ms */
+
+/* 1 表示上电时测量 nanoprintf 整数转换的速度, 结果存入 g_tNpfBench 并输出到日志 */
+#define NPF_BENCH_EN	0
+
+/* 仅允许本文件内调用的函数声明 */
+static void InitBoard(void);
+static void PrintHelpInfo(void);
+static void UsbCmdPro(void);
+#if USB_COMPOSITE_EN == 1
+	static void UsbVendorPro(void);
+#endif
+static void ReportOk(void);
+static void AnalyzeCmd(uint8_t *_pCmdBuf, uint16_t _usLen);
+#if IAP_EN == 1
+	static void UsbIapPro(void);
+	static void StartIap(uint8_t *_pCmdBuf);
+	static void StartIapPatch(uint8_t *_pCmdBuf);
+	static uint32_t IapGetRemain(void);
+	static void ReportIap(uint8_t _ucRet);
+
+	static int32_t s_iIapTime;	/* 最后一次收到升级数据的时刻 */
+	static uint8_t s_ucIapPatch;	/* 1 表示正在接收差分包, 0 表示完整程序 */
+#endif
+#if NPF_BENCH_EN == 1
+	static void NpfBench(void);
+#endif
+
+/*
+*********************************************************************************************************
+*	函 数 名: main
+*	功能说明: c程序入口
+*	形    参：无
+*	返 回 值: 错误代码(无需处理)
+*********************************************************************************************************
+*/
+int main(void)
+{
+	uint8_t ucKeyCode;
+
+#if IAP_EN == 1
+	/* 程序由 Bootloader 启动, SystemInit() 把中断向量表设置在Flash开头, 需要改到应用程序区 */
+	NVIC_SetVectorTable(NVIC_VectTab_FLASH, IAP_APP_ADDR - NVIC_VectTab_FLASH);
+#endif
+
+	/*
+		由于ST固件库的启动文件已经执行了CPU系统时钟的初始化，所以不必再次重复配置系统时钟。
+		启动文件配置了CPU主时钟频率、内部Flash访问速度和可选的外部SRAM FSMC初始化。
+
+		系统时钟缺省配置为72MHz，如果需要更改，可以修改：
+		\Libraries\CMSIS\CM3\DeviceSupport\ST\STM32F10x\system_stm32f10x.c
+		中配置系统时钟的宏。
+	*/
+
+	InitBoard();	/* 为了是main函数看起来更简洁些，我们将硬件初始化的代码封装到这个函数 */
+
+#if NPF_BENCH_EN == 1
+	NpfBench();		/* 测量 nanoprintf 整数转换速度 */
+#endif
+
+	/* 初始化USB设备 */
+	bsp_InitUsb();
+
+   	PrintHelpInfo();	/* 打印帮助提示到串口1 */
+
+	while(1)
+	{
+		CPU_IDLE();
+
+		UsbCmdPro();	/* 处理PC通过USB发来的命令 (非阻塞) */
+	#if USB_COMPOSITE_EN == 1
+		UsbVendorPro();	/* 厂商批量接口数据回环 (非阻塞) */
+	#endif
+		MODS_Poll();	/* 处理RS485收到的MODBUS命令 (非阻塞) */
+		ucKeyCode = bsp_GetKey();	/* 读取键值, 无键按下时返回 KEY_NONE = 0 */
+		if (ucKeyCode != KEY_NONE)
+		{
+			/* 有键按下 */
+			switch (ucKeyCode)
+			{
+				case KID_K1:		/* 摇杆UP键按下 */
+					usb_SendDataToHost((uint8_t*)"$KEY=U#\r\n", 9);
+					break;
+
+				case KID_K2:		/* 摇杆DOWN键按下 */
+					usb_SendDataToHost((uint8_t*)"$KEY=D#\r\n", 9);
+					break;
+
+				default:
+					break;
+			}
+		}
+	}			
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: PrintHelpInfo
+*	功能说明: 将帮助信息打印到串口。给串口终端直接看, 用 printf 输出普通文字, 不经过二进制日志,
+*			  不需要 Tools/log_decode.py (解码程序原样显示日志帧以外的文字)。
+*	形    参：无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void PrintHelpInfo(void)
+{
+	printf("请安装stm32_vcp USB虚拟串口驱动，然后用串口工具打开这个虚拟串口进行操作。\r\n");
+	printf("PC->开发板的命令格式：\r\n");
+	printf("  $LEDON=1#     点亮开发板上LED灯, 数字范围：1-4\r\n");
+	printf("  $LEDOFF=2#    熄灭开发板上LED灯, 数字范围：1-4\r\n");
+	printf("  $LEDONALL#    点亮开发板上所有的LED灯\r\n");
+	printf("  $LEDOFFALL#   熄灭开发板上所有的LED灯\r\n");
+	printf("  $TXDROP#      查询USB发送FIFO满被丢弃的字节数\r\n");
+#if IAP_EN == 1
+	printf("  $IAP=长度,CRC# 升级程序, 见 Tools/usb_iap.py\r\n");
+	printf("  $IAPD=长度#   差分升级, 见 Tools/iap_diff.py\r\n");
+#endif
+
+	printf("开发板->PC的汇报格式：\r\n");
+	printf("  $OK#          对PC命令的正确应答；如果不正确，则不响应\r\n");
+	printf("  $KEY=U#       摇杆上键按下\r\n");
+	printf("  $KEY=D#       摇杆下键按\r\n");
+	printf("  $KEY=L#       摇杆左键按下\r\n");
+	printf("  $KEY=R#       摇杆右键按下\r\n");
+}
+
+#if USB_COMPOSITE_EN == 1
+/*
+*********************************************************************************************************
+*	函 数 名: UsbVendorPro
+*	功能说明: 厂商自定义批量接口的数据回环。 非阻塞模式。每次最多取发送FIFO放得下的数据,
+*			  放不下的留在接收FIFO中, 接收FIFO满时OUT端点自动NAK, 主机暂停发送。
+*	形    参：无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void UsbVendorPro(void)
+{
+	uint8_t aBuf[128];
+	uint16_t usLen;
+	
+	usLen = usb_PortTxFree(USB_VENDOR);
+	if (usLen > sizeof(aBuf))
+	{
+		usLen = sizeof(aBuf);
+	}
+	usLen = usb_PortRead(USB_VENDOR, aBuf, usLen);
+	if (usLen > 0)
+	{
+		usb_PortSend(USB_VENDOR, aBuf, usLen, USB_TX_PARTIAL);	/* 已按空闲空间读取, 一定能全部写入 */
+	}
+}
+#endif
+
+/*
+*********************************************************************************************************
+*	函 数 名: UsbCmdPro
+*	功能说明: 处理USB口接收到的数据。 非阻塞模式。收到的数据原样回显, 同时从中提取 $...# 命令帧。
+*	形    参：无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void UsbCmdPro(void)
+{
+	uint8_t aBuf[64];
+	uint16_t usLen;
+	uint16_t i;
+	uint8_t ucData;
+	static uint8_t aCmdBuf[32];
+	static uint16_t usPos;		/* 0 表示等待帧头$; 否则为已收到的命令字符数 + 1 */
+
+#if IAP_EN == 1
+	if (IapGetRemain() > 0)
+	{
+		UsbIapPro();		/* 正在接收升级数据 */
+		return;
+	}
+#endif
+	
+	/* 在PC串口工具回显键入的字符。每次最多取发送FIFO放得下的数据，放不下的留在接收FIFO中 */
+	usLen = usb_GetTxFree();
+	if (usLen > sizeof(aBuf))
+	{
+		usLen = sizeof(aBuf);
+	}
+	usLen = usb_GetRxBuf(aBuf, usLen);	/* 从USB口读取一批数据 */
+	if (usLen == 0)
+	{
+		return;
+	}
+	usb_SendDataToHost(aBuf, usLen);
+
+	for (i = 0; i < usLen; i++)
+	{
+		ucData = aBuf[i];
+		if (ucData == '$')
+		{
+			usPos = 1;			/* 帧头, 重新开始一帧 */
+		}
+		else if (usPos == 0)
+		{
+			;					/* 帧外的字符忽略 */
+		}
+		else if (ucData == '#')
+		{
+			AnalyzeCmd(aCmdBuf, usPos - 1);
+			usPos = 0;
+		#if IAP_EN == 1
+			if (IapGetRemain() > 0)
+			{
+				/* PC应该等待应答后再发送程序数据, 这里只是防止同一批中命令后面的数据丢失 */
+				if (s_ucIapPatch)
+				{
+					iap_PatchWrite(&aBuf[i + 1], usLen - i - 1);
+				}
+				else
+				{
+					iap_Write(&aBuf[i + 1], usLen - i - 1);
+				}
+				break;
+			}
+		#endif
+		}
+		else if (usPos < sizeof(aCmdBuf))
+		{
+			aCmdBuf[usPos - 1] = ucData;	/* 留1个字节给 AnalyzeCmd 添加的结束符 */
+			usPos++;
+		}
+		else
+		{
+			usPos = 0;			/* 命令太长, 丢弃这一帧 */
+		}
+	}
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: ReportOk
+*	功能说明: 相应命令正确应答
+*	形    参：无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void ReportOk(void)
+{
+	usb_SendDataToHost((uint8_t*)"\r\n$OK#\r\n", 8);;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: AnalyzeCmd
+*	功能说明: 分析PC机的命令
+*	形    参：无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void AnalyzeCmd(uint8_t *_pCmdBuf, uint16_t _usLen)
+{
+	/*	
+		$LEDON=1#    			点亮开发板上LED灯, 数字范围：1-4
+		$LEDOFF=2#    			熄灭开发板上LED灯, 数字范围：1-4	
+		$LEDONALL#    			点亮开发板上所有的LED灯
+		$LEDOFFALL#    		熄灭开发板上所有的LED灯
+		$TXDROP#				查询USB发送FIFO满被丢弃的字节数
+		
+	开发板发往PC的命令定义
+		$OK#                    对PC命令的正确应答；如果不正确，则不响应
+		$KEY=U#	   				摇杆上键按下
+		$KEY=D#					摇杆下键按下
+		$KEY=L#					摇杆左键按下
+		$KEY=R#					摇杆右键按下
+	*/
+	_pCmdBuf[_usLen] = 0;
+
+	if ((_usLen == 7) && (memcmp(_pCmdBuf, "LEDON=", 6) == 0))	  /* 点亮LED灯 */
+	{
+		ReportOk();	/* 应答OK */
+		if ((_pCmdBuf[6] >= '1') && (_pCmdBuf[6] <= '4'))
+		{
+			bsp_LedOn(_pCmdBuf[6] - '0');
+		}
+	}
+	else if ((_usLen == 8) && (memcmp(_pCmdBuf, "LEDOFF=", 7) == 0))
+	{
+		ReportOk();	/* 应答OK */
+		if ((_pCmdBuf[7] >= '1') && (_pCmdBuf[7] <= '4'))
+		{
+			bsp_LedOn(_pCmdBuf[7] - '0');
+		}
+	}
+	else if ((_usLen == 8) && (memcmp(_pCmdBuf, "LEDONALL", 8) == 0))
+	{
+		ReportOk();	/* 应答OK */
+		bsp_LedOn(1);
+		bsp_LedOn(2);
+		bsp_LedOn(3);
+		bsp_LedOn(4);
+	}
+	else if ((_usLen == 9) && (memcmp(_pCmdBuf, "LEDOFFALL", 9) == 0))
+	{
+		ReportOk();	/* 应答OK */
+		bsp_LedOff(1);
+		bsp_LedOff(2);
+		bsp_LedOff(3);
+		bsp_LedOff(4);
+	}
+	else if ((_usLen == 6) && (memcmp(_pCmdBuf, "TXDROP", 6) == 0))
+	{
+		char acReply[32];
+		int iLen;
+
+		iLen = npf_snprintf(acReply, sizeof(acReply), "\r\n$TXDROP=%u#\r\n", (unsigned int)usb_GetTxDropped());
+		usb_SendDataToHostEx((uint8_t *)acReply, iLen, USB_TX_BLOCK);	/* 发送FIFO满时等待, 应答不能丢 */
+	}
+#if IAP_EN == 1
+	else if ((_usLen > 4) && (memcmp(_pCmdBuf, "IAP=", 4) == 0))
+	{
+		StartIap(&_pCmdBuf[4]);
+	}
+	else if ((_usLen > 5) && (memcmp(_pCmdBuf, "IAPD=", 5) == 0))
+	{
+		StartIapPatch(&_pCmdBuf[5]);
+	}
+#endif
+	/* 不正确的命令不响应 (见文件头的通信协议), 避免回显的数据流中偶然出现的 $...# 引起多余的应答 */
+}
+
+#if IAP_EN == 1
+/*
+*********************************************************************************************************
+*	函 数 名: StartIap
+*	功能说明: 处理 $IAP=长度,CRC# 命令, 开始接收新程序
+*	形    参: _pCmdBuf : "=" 后面的参数, 以0结束
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void StartIap(uint8_t *_pCmdBuf)
+{
+	char *p;
+	uint32_t ulSize;
+	uint32_t ulCrc;
+
+	ulSize = strtoul((char *)_pCmdBuf, &p, 10);
+	if (*p != ',')
+	{
+		ReportIap(IAP_ERR_SIZE);
+		return;
+	}
+	ulCrc = strtoul(p + 1, &p, 16);
+	if (*p != 0)
+	{
+		ReportIap(IAP_ERR_SIZE);
+		return;
+	}
+
+	s_iIapTime = bsp_GetRunTime();
+	s_ucIapPatch = 0;
+	ReportIap(iap_Start(ulSize, ulCrc));
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: StartIapPatch
+*	功能说明: 处理 $IAPD=长度# 命令, 开始接收差分包
+*	形    参: _pCmdBuf : "=" 后面的参数, 以0结束
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void StartIapPatch(uint8_t *_pCmdBuf)
+{
+	char *p;
+	uint32_t ulSize;
+
+	ulSize = strtoul((char *)_pCmdBuf, &p, 10);
+	if (*p != 0)
+	{
+		ReportIap(IAP_ERR_SIZE);
+		return;
+	}
+
+	s_iIapTime = bsp_GetRunTime();
+	s_ucIapPatch = 1;
+	ReportIap(iap_PatchStart(ulSize));
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: IapGetRemain
+*	功能说明: 读取正在进行的升级还需要接收的字节数 (完整程序或差分包)
+*	形    参: 无
+*	返 回 值: 字节数, 0 表示没有在升级
+*********************************************************************************************************
+*/
+static uint32_t IapGetRemain(void)
+{
+	if (s_ucIapPatch)
+	{
+		return iap_PatchGetRemain();
+	}
+	return iap_GetRemain();
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: UsbIapPro
+*	功能说明: 接收升级数据并写入Flash。 非阻塞模式。写Flash期间USB中断继续接收, 接收FIFO满时主机暂停发送。
+*			  接收完成后校验, 正确时应答并复位, 由 Bootloader 安装新程序。
+*	形    参：无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void UsbIapPro(void)
+{
+	uint8_t aBuf[256];
+	uint16_t usLen;
+	uint8_t ucRet;
+
+	usLen = usb_GetRxBuf(aBuf, sizeof(aBuf));
+	if (usLen == 0)
+	{
+		if (bsp_CheckRunTime(s_iIapTime) > IAP_TIMEOUT)
+		{
+			if (s_ucIapPatch)
+			{
+				iap_PatchAbort();
+			}
+			else
+			{
+				iap_Abort();
+			}
+			ReportIap(IAP_ERR_STATE);
+		}
+		return;
+	}
+
+	s_iIapTime = bsp_GetRunTime();
+	if (s_ucIapPatch)
+	{
+		iap_PatchWrite(aBuf, usLen);
+		if (iap_PatchGetRemain() > 0)
+		{
+			return;
+		}
+		ucRet = iap_PatchFinish();
+	}
+	else
+	{
+		iap_Write(aBuf, usLen);
+		if (iap_GetRemain() > 0)
+		{
+			return;
+		}
+		ucRet = iap_Finish();
+	}
+	ReportIap(ucRet);
+	if (ucRet == IAP_OK)
+	{
+		bsp_DelayMS(100);		/* 等待应答发送到PC */
+		NVIC_SystemReset();
+	}
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: ReportIap
+*	功能说明: 应答升级命令, $IAP=OK# 或 $IAP=ERR=n#
+*	形    参: _ucRet : iap_Start(), iap_Finish() 等的返回值
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void ReportIap(uint8_t _ucRet)
+{
+	char acReply[24];
+	int iLen;
+
+	if (_ucRet == IAP_OK)
+	{
+		iLen = npf_snprintf(acReply, sizeof(acReply), "\r\n$IAP=OK#\r\n");
+	}
+	else
+	{
+		iLen = npf_snprintf(acReply, sizeof(acReply), "\r\n$IAP=ERR=%u#\r\n", _ucRet);
+	}
+	usb_SendDataToHostEx((uint8_t *)acReply, iLen, USB_TX_BLOCK);
+}
+#endif
+
+#if NPF_BENCH_EN == 1
+#define NPF_BENCH_LOOP	16		/* 每项测试的调用次数, 结果取平均 */
+
+/* nanoprintf 测速结果, 每次调用所用的CPU时钟周期 */
+typedef struct
+{
+	uint32_t RefUtoa;					/* 原来的转换循环, 每位用一次除法, 10位十进制数 */
+	uint32_t FastUtoa;					/* npf__utoa_rev, 倒数乘法 */
+}NPF_BENCH_T;
+
+NPF_BENCH_T g_tNpfBench;
+
+/*
+*********************************************************************************************************
+*	函 数 名: NpfUtoaRef
+*	功能说明: nanoprintf 原来的整数转换循环, 进制是变量, 每位一次除法和一次求余。仅用于测速对比。
+*	形    参: 同 npf__utoa_rev, 只支持小写
+*	返 回 值: 字符个数 (逆序)
+*********************************************************************************************************
+*/
+static int NpfUtoaRef(char *buf, uint32_t i, unsigned base)
+{
+	char *dst = buf;
+
+	if (i == 0)
+	{
+		*dst++ = '0';
+	}
+	else
+	{
+		while (i)
+		{
+			unsigned const d = (unsigned)(i % base);
+
+			i /= base;
+			*dst++ = (d < 10) ? (char)('0' + d) : (char)('a' + (d - 10));
+		}
+	}
+	return (int)(dst - buf);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: NpfBench
+*	功能说明: 用DWT周期计数器比较原来的逐位除法和 npf__utoa_rev 转换10位十进制数的时间,
+*			  结果存入 g_tNpfBench, 并用日志输出。测量时关中断。
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void NpfBench(void)
+{
+	char acBuf[48];
+	volatile unsigned uiBase = 10;	/* 进制用变量, 防止编译器把除法优化成常数乘法 */
+	uint32_t ulStart;
+	uint8_t k;
+
+	/* 打开DWT周期计数器 */
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	DISABLE_INT();
+	ulStart = DWT->CYCCNT;
+	for (k = 0; k < NPF_BENCH_LOOP; k++)
+	{
+		NpfUtoaRef(acBuf, 4000000000u, uiBase);
+	}
+	g_tNpfBench.RefUtoa = (DWT->CYCCNT - ulStart) / NPF_BENCH_LOOP;
+
+	ulStart = DWT->CYCCNT;
+	for (k = 0; k < NPF_BENCH_LOOP; k++)
+	{
+		npf__utoa_rev(acBuf, 4000000000u, uiBase, NPF_FMT_SPEC_CONV_CASE_LOWER);
+	}
+	g_tNpfBench.FastUtoa = (DWT->CYCCNT - ulStart) / NPF_BENCH_LOOP;
+	ENABLE_INT();
+
+	bsp_Log("npf bench: utoa %u -> %u cycles\r\n", g_tNpfBench.RefUtoa, g_tNpfBench.FastUtoa);
+}
+#endif
+
+/*
+*********************************************************************************************************
+*	函 数 名: InitBoard
+*	功能说明: 初始化硬件设备
+*	形    参：无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void InitBoard(void)
+{
+	/* 初始化日志缓冲区, 之后就可以调用 bsp_Log() */
+	bsp_InitLog();
+
+	/* 配置串口，用于printf和日志输出 */
+	bsp_InitUart();
+
+	/* 配置LED指示灯GPIO */
+	bsp_InitLed();
+
+	/* 配置按键GPIO, 必须在bsp_InitTimer之前调用 */
+	bsp_InitKey();
+
+	/* 初始化systick定时器，并启动定时中断 */
+	bsp_InitTimer();
+
+	/* 初始化MODBUS从站, 使用RS485 (COM3) */
+	MODS_Init(SBAUD485);
+
+}
@@ -0,0 +1,23 @@
+/*
+*********************************************************************************************************
+*
+*	模块名称 : CRC16 校验模块
+*	文件名称 : crc16.h
+*	版    本 : V1.0
+*	说    明 : 头文件
+*
+*	Copyright (C), 2013-2014, 安富莱电子 www.armfly.com
+*
+*********************************************************************************************************
+*/
+
+#ifndef __CRC16_H
+#define __CRC16_H
+
+#include <stdint.h>
+
+uint16_t CRC16_Modbus(const uint8_t *_pBuf, uint16_t _usLen);
+
+#endif
+
+/***************************** 安富莱电子 www.armfly.com (END OF FILE) *********************************/
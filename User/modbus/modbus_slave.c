@@ -0,0 +1,514 @@
+/*
+*********************************************************************************************************
+*
+*	模块名称 : MODBUS RTU 从站模块
+*	文件名称 : modbus_slave.c
+*	版    本 : V1.2
+*	说    明 : 通过 COM3 (RS485) 实现 MODBUS RTU 从站。
+*
+*				(1) 串口中断通过 RS485_ReciveNew() -> MODBUS_ReciveNew() 把新数据交给本模块，
+*				    同时用两个硬件定时(bsp_StartHardTimerEx)检测 T1.5 字符间隔和 T3.5 帧间隔。
+*				(2) T3.5 到时表示一帧结束，主程序中的 MODS_Poll() 校验CRC，执行功能码 03/04/06/10，
+*				    然后通过 RS485_SendBuf() 应答。RS485 收发切换由 RS485_SendBefor/RS485_SendOver 完成。
+*				(3) 记录应答延迟（从检测到帧结束到应答数据交给串口）, 通过输入寄存器读取。
+*
+*				COM3 采用DMA接收时(UART3_RX_DMA_EN = 1)，数据在总线空闲(IDLE)或DMA半满/全满时成批到达，
+*				无法看到一批数据内部的字符间隔，因此不做 T1.5 检查; IDLE 本身比最后一个字节晚1个字符时间,
+*				T3.5 定时相应缩短1个字符时间。
+*
+*	修改记录 :
+*		版本号  日期        作者     说明
+*		V1.0    2026-10-17          正式发布
+*		V1.1    2026-10-17          帧间隔定时改用 bsp_StartHardTimerEx(), 不再占用硬件比较通道; 应答延迟改用32位计数值
+*		V1.2    2026-10-17          增加 MODS_RxIsEmpty(), 供低功耗模式判断能否休眠
+*
+*	Copyright (C), 2013-2014, 安富莱电子 www.armfly.com
+*
+*********************************************************************************************************
+*/
+
+#include "modbus_slave.h"
+#include "crc16.h"
+
+MODS_T g_tModS;
+uint16_t g_usHoldReg[HOLD_REG_NUM];		/* 保持寄存器 */
+
+static uint16_t s_usTchar;				/* 1个字符的时间, 单位us */
+
+#if UART3_RX_DMA_EN == 0
+static HARD_TMR_T s_tT15Tmr;			/* T1.5 字符间隔定时 */
+static void MODS_T15Timeout(void *_pArg);
+#endif
+static HARD_TMR_T s_tT35Tmr;			/* T3.5 帧结束定时 */
+static void MODS_T35Timeout(void *_pArg);
+static void MODS_AnalyzeApp(void);
+static void MODS_ReadRegs(uint8_t _ucFunc);
+static void MODS_06H(void);
+static void MODS_10H(void);
+static void MODS_SendAckErr(uint8_t _ucErrCode);
+static void MODS_SendWithCRC(void);
+static uint8_t MODS_ReadRegValue(uint8_t _ucFunc, uint16_t _usAddr, uint16_t *_pValue);
+
+/*
+*********************************************************************************************************
+*	函 数 名: MODS_Init
+*	功能说明: 初始化MODBUS从站变量，根据波特率计算 T1.5 和 T3.5
+*	形    参: _baud : RS485 波特率
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void MODS_Init(uint32_t _baud)
+{
+	/*
+		MODBUS RTU 规定每个字符 11 位 (起始位 + 8数据位 + 校验位/停止位 + 停止位)。
+		波特率大于 19200 时, 固定使用 T1.5 = 750us, T3.5 = 1750us
+	*/
+	s_usTchar = 11000000 / _baud;
+	if (_baud > 19200)
+	{
+		g_tModS.usT15 = 750;
+		g_tModS.usT35 = 1750;
+	}
+	else
+	{
+		g_tModS.usT15 = s_usTchar * 3 / 2;
+		g_tModS.usT35 = s_usTchar * 7 / 2;
+	}
+
+	g_tModS.RxCount = 0;
+	g_tModS.RxStatus = 0;
+	g_tModS.RxGap = 0;
+	g_tModS.RxBad = 0;
+	g_tModS.TxCount = 0;
+
+	g_tModS.usFrameOk = 0;
+	g_tModS.usCrcErr = 0;
+	g_tModS.usFrameErr = 0;
+	g_tModS.usExcCount = 0;
+	g_tModS.usLatLast = 0;
+	g_tModS.usLatMin = 0xFFFF;
+	g_tModS.usLatMax = 0;
+	g_tModS.uiLatSum = 0;
+	g_tModS.usLatCount = 0;
+
+	RS485_RX_EN();		/* RS485 芯片缺省处于接收状态 */
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: MODBUS_ReciveNew
+*	功能说明: 串口接收中断回调函数，保存新数据并重新启动帧间隔定时器。被 RS485_ReciveNew() 调用。
+*	形    参: _pBuf : 新收到的数据
+*			  _usLen : 数据长度
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void MODBUS_ReciveNew(uint8_t *_pBuf, uint16_t _usLen)
+{
+	uint16_t usFree;
+
+	if (g_tModS.RxStatus != 0)
+	{
+		return;		/* 上一帧还未处理完毕, 丢弃新数据 */
+	}
+
+	if (g_tModS.RxGap != 0 && g_tModS.RxCount > 0)
+	{
+		g_tModS.RxBad = 1;		/* 字符间隔超过 T1.5 后又收到数据 */
+	}
+	g_tModS.RxGap = 0;
+
+	usFree = S_RX_BUF_SIZE - g_tModS.RxCount;
+	if (_usLen > usFree)
+	{
+		_usLen = usFree;
+		g_tModS.RxBad = 1;		/* 帧太长 */
+	}
+	memcpy(&g_tModS.RxBuf[g_tModS.RxCount], _pBuf, _usLen);
+	g_tModS.RxCount += _usLen;
+
+#if UART3_RX_DMA_EN == 1
+	bsp_StartHardTimerEx(&s_tT35Tmr, g_tModS.usT35 - s_usTchar, 0, MODS_T35Timeout, 0);
+#else
+	bsp_StartHardTimerEx(&s_tT15Tmr, g_tModS.usT15, 0, MODS_T15Timeout, 0);
+	bsp_StartHardTimerEx(&s_tT35Tmr, g_tModS.usT35, 0, MODS_T35Timeout, 0);
+#endif
+}
+
+#if UART3_RX_DMA_EN == 0
+/*
+*********************************************************************************************************
+*	函 数 名: MODS_T15Timeout
+*	功能说明: T1.5 超时，在硬件定时器中断中执行。此后再收到数据，说明帧内字符间隔过大。
+*	形    参: _pArg : 未用
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void MODS_T15Timeout(void *_pArg)
+{
+	(void)_pArg;
+	g_tModS.RxGap = 1;
+}
+#endif
+
+/*
+*********************************************************************************************************
+*	函 数 名: MODS_T35Timeout
+*	功能说明: T3.5 超时，在硬件定时器中断中执行。表示一帧接收完毕，通知 MODS_Poll 处理。
+*	形    参: _pArg : 未用
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void MODS_T35Timeout(void *_pArg)
+{
+	(void)_pArg;
+
+#if UART3_RX_DMA_EN == 1
+	/*
+		DMA半满/全满中断发布数据时, 总线可能还没有空闲。取出DMA已经收到但还未发布的数据,
+		如果有, 说明帧还没有结束 (MODBUS_ReciveNew 已经重新启动了定时器)
+	*/
+	if (comPollRxDma(COM3) > 0)
+	{
+		return;
+	}
+#endif
+
+	DISABLE_INT();
+	if (g_tModS.RxCount > 0 && g_tModS.RxStatus == 0)
+	{
+		if (g_tModS.RxBad != 0 || g_tModS.RxCount < 4)
+		{
+			g_tModS.usFrameErr++;		/* 格式错误的帧直接丢弃 */
+			g_tModS.RxCount = 0;
+			g_tModS.RxBad = 0;
+		}
+		else
+		{
+			g_tModS.RxEndTick = bsp_GetHardTimerCount32();
+			g_tModS.RxStatus = 1;
+		}
+	}
+	ENABLE_INT();
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: MODS_Poll
+*	功能说明: 解析数据包. 在主程序中轮流调用。
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void MODS_Poll(void)
+{
+	uint8_t ucAddr;
+
+	/* 数据已经在接收回调函数中复制到 RxBuf, 清空串口接收FIFO */
+	comClearRxFifo(COM3);
+
+	if (g_tModS.RxStatus == 0)
+	{
+		return;
+	}
+
+	/* 计算CRC校验和, 包括CRC在内的整帧计算结果为0表示正确 */
+	if (CRC16_Modbus(g_tModS.RxBuf, g_tModS.RxCount) != 0)
+	{
+		g_tModS.usCrcErr++;
+		goto err_ret;
+	}
+
+	/* 站地址 (0 表示广播, 只执行不应答) */
+	ucAddr = g_tModS.RxBuf[0];
+	if (ucAddr != SADDR485 && ucAddr != 0)
+	{
+		goto err_ret;
+	}
+
+	g_tModS.usFrameOk++;
+	MODS_AnalyzeApp();
+
+	if (ucAddr != 0 && g_tModS.TxCount > 0)
+	{
+		MODS_SendWithCRC();
+	}
+
+err_ret:
+	g_tModS.RxCount = 0;
+	g_tModS.RxBad = 0;
+	g_tModS.RxGap = 0;
+	g_tModS.RxStatus = 0;		/* 最后清标志, 允许接收下一帧 */
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: MODS_RxIsEmpty
+*	功能说明: 判断是否有等待 MODS_Poll() 处理的帧。bsp_Idle() 在低功耗模式下据此决定能否休眠。
+*	形    参: 无
+*	返 回 值: 1 表示没有, 0 表示收到完整的一帧还未处理
+*********************************************************************************************************
+*/
+uint8_t MODS_RxIsEmpty(void)
+{
+	return (g_tModS.RxStatus == 0);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: MODS_AnalyzeApp
+*	功能说明: 按功能码分析应用层协议，结果放在 TxBuf (不含CRC)
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void MODS_AnalyzeApp(void)
+{
+	g_tModS.TxCount = 0;
+
+	switch (g_tModS.RxBuf[1])
+	{
+		case MODS_READ_HOLD_REG:	/* 读保持寄存器 */
+		case MODS_READ_INPUT_REG:	/* 读输入寄存器 */
+			MODS_ReadRegs(g_tModS.RxBuf[1]);
+			break;
+
+		case MODS_WRITE_REG:		/* 写单个寄存器 */
+			MODS_06H();
+			break;
+
+		case MODS_WRITE_REGS:		/* 写多个寄存器 */
+			MODS_10H();
+			break;
+
+		default:
+			MODS_SendAckErr(RSP_ERR_CMD);
+			break;
+	}
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: MODS_ReadRegValue
+*	功能说明: 读取1个寄存器的值
+*	形    参: _ucFunc : 功能码, 03 读保持寄存器, 04 读输入寄存器
+*			  _usAddr : 寄存器地址
+*			  _pValue : 存放寄存器的值
+*	返 回 值: 1 表示成功, 0 表示地址错误
+*********************************************************************************************************
+*/
+static uint8_t MODS_ReadRegValue(uint8_t _ucFunc, uint16_t _usAddr, uint16_t *_pValue)
+{
+	if (_ucFunc == MODS_READ_HOLD_REG)
+	{
+		if ((uint16_t)(_usAddr - HOLD_REG_ADDR) >= HOLD_REG_NUM)	/* 小于起始地址时相减回绕, 也大于个数 */
+		{
+			return 0;
+		}
+		*_pValue = g_usHoldReg[_usAddr - HOLD_REG_ADDR];
+		return 1;
+	}
+
+	switch (_usAddr - INPUT_REG_ADDR)
+	{
+		case REG_FRAME_OK:	*_pValue = g_tModS.usFrameOk;	break;
+		case REG_CRC_ERR:	*_pValue = g_tModS.usCrcErr;	break;
+		case REG_FRAME_ERR:	*_pValue = g_tModS.usFrameErr;	break;
+		case REG_EXC_COUNT:	*_pValue = g_tModS.usExcCount;	break;
+		case REG_LAT_LAST:	*_pValue = g_tModS.usLatLast;	break;
+		case REG_LAT_MIN:	*_pValue = (g_tModS.usLatCount > 0) ? g_tModS.usLatMin : 0;	break;
+		case REG_LAT_MAX:	*_pValue = g_tModS.usLatMax;	break;
+		case REG_LAT_AVG:
+			*_pValue = (g_tModS.usLatCount > 0) ? (g_tModS.uiLatSum / g_tModS.usLatCount) : 0;
+			break;
+
+		default:
+			return 0;
+	}
+	return 1;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: MODS_ReadRegs
+*	功能说明: 读取保持寄存器(03H)或输入寄存器(04H)
+*			  请求: 地址 功能码 寄存器地址(2) 寄存器个数(2) CRC(2)
+*			  应答: 地址 功能码 字节数 数据(2*N)
+*	形    参: _ucFunc : 功能码
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void MODS_ReadRegs(uint8_t _ucFunc)
+{
+	uint16_t usReg;
+	uint16_t usNum;
+	uint16_t usValue;
+	uint16_t i;
+
+	if (g_tModS.RxCount != 8)
+	{
+		MODS_SendAckErr(RSP_ERR_VALUE);
+		return;
+	}
+
+	usReg = (g_tModS.RxBuf[2] << 8) | g_tModS.RxBuf[3];
+	usNum = (g_tModS.RxBuf[4] << 8) | g_tModS.RxBuf[5];
+	if (usNum == 0 || usNum > 125)
+	{
+		MODS_SendAckErr(RSP_ERR_VALUE);
+		return;
+	}
+
+	g_tModS.TxBuf[0] = g_tModS.RxBuf[0];
+	g_tModS.TxBuf[1] = _ucFunc;
+	g_tModS.TxBuf[2] = usNum * 2;
+	g_tModS.TxCount = 3;
+	for (i = 0; i < usNum; i++)
+	{
+		if (MODS_ReadRegValue(_ucFunc, usReg + i, &usValue) == 0)
+		{
+			MODS_SendAckErr(RSP_ERR_REG_ADDR);
+			return;
+		}
+		g_tModS.TxBuf[g_tModS.TxCount++] = usValue >> 8;
+		g_tModS.TxBuf[g_tModS.TxCount++] = usValue;
+	}
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: MODS_06H
+*	功能说明: 写单个保持寄存器
+*			  请求: 地址 06 寄存器地址(2) 数值(2) CRC(2)
+*			  应答: 原样返回请求
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void MODS_06H(void)
+{
+	uint16_t usReg;
+
+	if (g_tModS.RxCount != 8)
+	{
+		MODS_SendAckErr(RSP_ERR_VALUE);
+		return;
+	}
+
+	usReg = (g_tModS.RxBuf[2] << 8) | g_tModS.RxBuf[3];
+	if ((uint16_t)(usReg - HOLD_REG_ADDR) >= HOLD_REG_NUM)
+	{
+		MODS_SendAckErr(RSP_ERR_REG_ADDR);
+		return;
+	}
+
+	g_usHoldReg[usReg - HOLD_REG_ADDR] = (g_tModS.RxBuf[4] << 8) | g_tModS.RxBuf[5];
+
+	memcpy(g_tModS.TxBuf, g_tModS.RxBuf, 6);
+	g_tModS.TxCount = 6;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: MODS_10H
+*	功能说明: 连续写多个保持寄存器
+*			  请求: 地址 10 寄存器地址(2) 寄存器个数(2) 字节数 数据(2*N) CRC(2)
+*			  应答: 地址 10 寄存器地址(2) 寄存器个数(2)
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void MODS_10H(void)
+{
+	uint16_t usReg;
+	uint16_t usNum;
+	uint16_t i;
+
+	if (g_tModS.RxCount < 11)
+	{
+		MODS_SendAckErr(RSP_ERR_VALUE);
+		return;
+	}
+
+	usReg = (g_tModS.RxBuf[2] << 8) | g_tModS.RxBuf[3];
+	usNum = (g_tModS.RxBuf[4] << 8) | g_tModS.RxBuf[5];
+	if (usNum == 0 || usNum > 123 || g_tModS.RxBuf[6] != usNum * 2 || g_tModS.RxCount != 9 + usNum * 2)
+	{
+		MODS_SendAckErr(RSP_ERR_VALUE);
+		return;
+	}
+
+	if ((uint16_t)(usReg - HOLD_REG_ADDR) + usNum > HOLD_REG_NUM)
+	{
+		MODS_SendAckErr(RSP_ERR_REG_ADDR);
+		return;
+	}
+
+	for (i = 0; i < usNum; i++)
+	{
+		g_usHoldReg[usReg - HOLD_REG_ADDR + i] = (g_tModS.RxBuf[7 + 2 * i] << 8) | g_tModS.RxBuf[8 + 2 * i];
+	}
+
+	memcpy(g_tModS.TxBuf, g_tModS.RxBuf, 6);
+	g_tModS.TxCount = 6;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: MODS_SendAckErr
+*	功能说明: 生成异常应答
+*	形    参: _ucErrCode : 异常码
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void MODS_SendAckErr(uint8_t _ucErrCode)
+{
+	g_tModS.TxBuf[0] = g_tModS.RxBuf[0];
+	g_tModS.TxBuf[1] = g_tModS.RxBuf[1] | 0x80;		/* 异常应答的功能码最高位置1 */
+	g_tModS.TxBuf[2] = _ucErrCode;
+	g_tModS.TxCount = 3;
+	g_tModS.usExcCount++;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: MODS_SendWithCRC
+*	功能说明: 在 TxBuf 末尾加CRC后通过RS485发送, 并统计应答延迟
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void MODS_SendWithCRC(void)
+{
+	uint16_t usCRC;
+	uint32_t uiLat;
+	uint16_t usLat;
+
+	usCRC = CRC16_Modbus(g_tModS.TxBuf, g_tModS.TxCount);
+	g_tModS.TxBuf[g_tModS.TxCount++] = usCRC;			/* 先发低字节 */
+	g_tModS.TxBuf[g_tModS.TxCount++] = usCRC >> 8;
+
+	RS485_SendBuf(g_tModS.TxBuf, g_tModS.TxCount);
+
+	/* 应答延迟统计。总线上的实际应答间隔还要再加上 T3.5 */
+	uiLat = bsp_GetHardTimerCount32() - g_tModS.RxEndTick;
+	usLat = (uiLat > 0xFFFF) ? 0xFFFF : uiLat;		/* 输入寄存器是16位的 */
+	g_tModS.usLatLast = usLat;
+	if (usLat < g_tModS.usLatMin)
+	{
+		g_tModS.usLatMin = usLat;
+	}
+	if (usLat > g_tModS.usLatMax)
+	{
+		g_tModS.usLatMax = usLat;
+	}
+	if (g_tModS.usLatCount == 0xFFFF)
+	{
+		g_tModS.uiLatSum = 0;		/* 计数即将溢出, 重新开始计算平均值 */
+		g_tModS.usLatCount = 0;
+	}
+	g_tModS.uiLatSum += usLat;
+	g_tModS.usLatCount++;
+}
+
+/***************************** 安富莱电子 www.armfly.com (END OF FILE) *********************************/
@@ -0,0 +1,95 @@
+/*
+*********************************************************************************************************
+*
+*	模块名称 : MODBUS RTU 从站模块
+*	文件名称 : modbus_slave.h
+*	版    本 : V1.0
+*	说    明 : 头文件
+*
+*	Copyright (C), 2013-2014, 安富莱电子 www.armfly.com
+*
+*********************************************************************************************************
+*/
+
+#ifndef __MODBUS_SLAVE_H
+#define __MODBUS_SLAVE_H
+
+#include "bsp.h"
+
+#define SADDR485	1				/* 本机的MODBUS从站地址 */
+#define SBAUD485	UART3_BAUD		/* RS485 波特率 */
+
+/* 功能码 */
+#define MODS_READ_HOLD_REG		0x03	/* 读保持寄存器 */
+#define MODS_READ_INPUT_REG		0x04	/* 读输入寄存器 */
+#define MODS_WRITE_REG			0x06	/* 写单个寄存器 */
+#define MODS_WRITE_REGS			0x10	/* 写多个寄存器 */
+
+/* 异常应答码 */
+#define RSP_OK				0		/* 成功 */
+#define RSP_ERR_CMD			0x01	/* 不支持的功能码 */
+#define RSP_ERR_REG_ADDR	0x02	/* 寄存器地址错误 */
+#define RSP_ERR_VALUE		0x03	/* 数据值域错误 */
+
+/* 保持寄存器, 可读可写, 功能码 03/06/10 */
+#define HOLD_REG_ADDR		0x0000	/* 起始地址 */
+#define HOLD_REG_NUM		32		/* 个数 */
+
+/* 输入寄存器, 只读, 功能码 04。用于报告通信统计 */
+#define INPUT_REG_ADDR		0x0000
+enum
+{
+	REG_FRAME_OK = 0,		/* 正确接收的帧数 */
+	REG_CRC_ERR,			/* CRC错误的帧数 */
+	REG_FRAME_ERR,			/* 格式错误的帧数 (字符间隔超过T1.5, 或超长) */
+	REG_EXC_COUNT,			/* 异常应答次数 */
+	REG_LAT_LAST,			/* 最近一次应答延迟, 单位us */
+	REG_LAT_MIN,			/* 最小应答延迟, 单位us */
+	REG_LAT_MAX,			/* 最大应答延迟, 单位us */
+	REG_LAT_AVG,			/* 平均应答延迟, 单位us */
+	INPUT_REG_NUM
+};
+
+#define S_RX_BUF_SIZE		256
+#define S_TX_BUF_SIZE		256
+
+typedef struct
+{
+	uint8_t RxBuf[S_RX_BUF_SIZE];
+	__IO uint16_t RxCount;		/* 已接收的字节数 */
+	__IO uint8_t RxStatus;		/* 1 表示收到完整的一帧, 等待 MODS_Poll 处理 */
+	__IO uint8_t RxGap;			/* 1 表示字符间隔已经超过 T1.5 */
+	__IO uint8_t RxBad;			/* 1 表示本帧格式错误, 帧结束后丢弃 */
+	__IO uint32_t RxEndTick;	/* 检测到帧结束时的32位硬件定时器计数值, 单位us */
+
+	uint8_t TxBuf[S_TX_BUF_SIZE];
+	uint16_t TxCount;
+
+	uint16_t usT15;				/* T1.5 超时时间, 单位us */
+	uint16_t usT35;				/* T3.5 超时时间, 单位us */
+
+	/* 通信统计 */
+	uint16_t usFrameOk;
+	uint16_t usCrcErr;
+	uint16_t usFrameErr;
+	uint16_t usExcCount;
+
+	/* 应答延迟: 从检测到帧结束(T3.5到)到应答数据交给串口发送 */
+	uint16_t usLatLast;
+	uint16_t usLatMin;
+	uint16_t usLatMax;
+	uint32_t uiLatSum;
+	uint16_t usLatCount;
+}MODS_T;
+
+extern MODS_T g_tModS;
+extern uint16_t g_usHoldReg[HOLD_REG_NUM];
+
+void MODS_Init(uint32_t _baud);
+void MODS_Poll(void);
+uint8_t MODS_RxIsEmpty(void);
+void MODBUS_ReciveNew(uint8_t *_pBuf, uint16_t _usLen);
+
+#endif
+
+/***************************** 安富莱电子 www.armfly.com (END OF FILE) *********************************/
@@ -1,388 +1,757 @@
-#include "stm32f10x.h"
-
-#include "stm32f10x_it.h"
-#include "usb_lib.h"
-#include "usb_prop.h"
-#include "usb_desc.h"
-#include "hw_config.h"
-#include "usb_pwr.h"
-
-/* 定义控制USB上拉电阻的GPIO, PC4 */
-#define	RCC_USB_PULL_UP		RCC_APB2Periph_GPIOB
-#define	PORT_USB_PULL_UP	GPIOB
-#define	PIN_USB_PULL_UP		GPIO_Pin_14
-
-#define USB_CABLE_ENABLE()	GPIO_ResetBits(PORT_USB_PULL_UP, PIN_USB_PULL_UP)	/* 连接USB设备  */
-#define USB_CABLE_DISABLE()	GPIO_SetBits(PORT_USB_PULL_UP, PIN_USB_PULL_UP)		/* 断开USB设备 */
-
-USB_COM_FIFO_T g_tUsbFifo;		/* 定义一个全局的结构体，用于FIFO */
-
-static void IntToUnicode (uint32_t _ulValue , uint8_t *_pBuf , uint8_t _ucLen);
-
-/*
-*********************************************************************************************************
-*	函 数 名: bsp_InitUsb
-*	功能说明: 初始化CPU的USB硬件设备。配置控制上拉电阻的GPIO，配置USB输入时钟48MHz；配置USB中断
-*	形    参：无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void bsp_InitUsb(void)
-{
-	GPIO_InitTypeDef GPIO_InitStructure;
-	
-	/* 使能控制USB上拉电阻GPIO的时钟 */
-	RCC_APB2PeriphClockCmd(RCC_USB_PULL_UP, ENABLE);
-	
-	/* 配置 USB 上拉引脚 */
-	USB_CABLE_DISABLE();	/* 断开USB设备 */
-	GPIO_InitStructure.GPIO_Pin = PIN_USB_PULL_UP;
-	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
-	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_OD;
-	GPIO_Init(PORT_USB_PULL_UP, &GPIO_InitStructure);
-
-	/* 设置USB时钟源 */
-	RCC_USBCLKConfig(RCC_USBCLKSource_PLLCLK_1Div5);
-	
-	/* 使能USB时钟 */
-	RCC_APB1PeriphClockCmd(RCC_APB1Periph_USB, ENABLE);
-	
-	/* 配置USB中断 */
-	{
-		NVIC_InitTypeDef NVIC_InitStructure;
-		
-		NVIC_PriorityGroupConfig(NVIC_PriorityGroup_1);
-		
-		NVIC_InitStructure.NVIC_IRQChannel = USB_LP_CAN1_RX0_IRQn;
-		NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
-		NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
-		NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
-		NVIC_Init(&NVIC_InitStructure);
-		
-		#if 0	/* 根据需要使能中断:USB从挂起状态到恢复 */
-		{
-			EXTI_InitTypeDef EXTI_InitStructure;
-			
-			/* 配置外部中断线18连接到USB IP中断(CPU内部连接) */
-			EXTI_ClearITPendingBit(EXTI_Line18);
-			EXTI_InitStructure.EXTI_Line = EXTI_Line18; /* USB从挂起状态到恢复 */
-			EXTI_InitStructure.EXTI_Trigger = EXTI_Trigger_Rising;
-			EXTI_InitStructure.EXTI_LineCmd = ENABLE;
-			EXTI_Init(&EXTI_InitStructure);
-		}
-		#endif
-	}
-
-	g_tUsbFifo.usRxWrite = 0;
-	g_tUsbFifo.usRxRead = 0;
-	g_tUsbFifo.usTxWrite = 0;
-	g_tUsbFifo.usTxRead = 0;
-
-	USB_Init();	
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: usb_EnterLowPowerMode
-*	功能说明: 进入低功耗模式。当USB设备进入挂起模式时，关闭系统时钟和电源
-*	形    参: 无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void usb_EnterLowPowerMode(void)
-{
-	/* 设置设备状态为 suspend, bDeviceState 全局变量在 usb_pwr.c 中定义 */
-	bDeviceState = SUSPENDED;
-
-	#if 0	/* 根据需要关闭电源 （鼠标键盘设备可进入挂起状态，虚拟串口等设备最好保持常开） */
-		/* 清 EXTI Line18 中断标志 */
-		EXTI_ClearITPendingBit(EXTI_Line8);
-		
-		/* 在低功耗状态，关闭电压调节器 */
-		PWR_EnterSTOPMode(PWR_Regulator_LowPower, PWR_STOPEntry_WFI);	
-	#endif
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: usb_LeaveLowPowerMode
-*	功能说明: 退出低功耗模式。恢复系统时钟。
-*	形    参: 无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void usb_LeaveLowPowerMode(void)
-{
-	DEVICE_INFO *pInfo = &Device_Info;  /* 全局变量Device_Info 在USB固件库 usb_init.c 中定义 */	
-
-#if 0	/* 根据需要恢复系统时钟 */
-	/* 使能 HSE */
-	RCC_HSEConfig(RCC_HSE_ON);
-	
-	/* 等待 HSE 就绪 */
-	RCC_WaitForHSEStartUp();
-	
-	/* 使能 HSE */
-	RCC_HSEConfig(RCC_HSE_ON);
-	
-	/* 等待 HSE 就绪 */
-	while (RCC_GetFlagStatus(RCC_FLAG_HSERDY) == RESET);
-	
-	/* 使能PLL */
-	RCC_PLLCmd(ENABLE);
-	
-	/* 等待PLL就绪 */
-	while (RCC_GetFlagStatus(RCC_FLAG_PLLRDY) == RESET);
-	
-	/* 选择PLL作为系统时钟源 */
-	RCC_SYSCLKConfig(RCC_SYSCLKSource_PLLCLK);
-	
-	/* 等待PLL系统时钟源稳定 */
-	while (RCC_GetSYSCLKSource() != 0x08);
-#endif
-	
-	/* 更新全局变量bDeviceState，表示usb设备状态 */
-	if (pInfo->Current_Configuration != 0)
-	{
-		bDeviceState = CONFIGURED;	/* 配置成功 */
-	}
-	else
-	{
-		bDeviceState = ATTACHED;	/* USB设备已连接，但还未配置 */
-	}	
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: usb_CableConfig
-*	功能说明: 软件控制USB电缆连接和断开
-*	形    参: _ucMode ： ENABLE表示连接，DISABLE表示断开
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void usb_CableConfig(uint8_t _ucMode)
-{
-	if (_ucMode == DISABLE)
-	{
-		USB_CABLE_DISABLE();	/* 断开USB设备 */
-	}
-	else
-	{
-		USB_CABLE_ENABLE();		/* 连接USB设备, 实质上将D+上拉，此时USB设备就能被集线器检测到了 */
-	}
-}
-				   
-/*
-*********************************************************************************************************
-*	函 数 名: usb_SendBuf
-*	功能说明: 向PC主机发送一组数据
-*	形    参：_pBuf 输入缓冲区; 	_ucLen : 数据长度
-*	返 回 值: 错误代码(无需处理)
-*********************************************************************************************************
-*/
-void usb_SendBuf(uint8_t *_pTxBuf, uint8_t _ucLen)
-{
-    UserToPMABufferCopy(_pTxBuf, ENDP1_TXADDR, _ucLen);
-    SetEPTxCount(ENDP1, _ucLen);
-    SetEPTxValid(ENDP1); 
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: Get_SerialNum
-*	功能说明: 获取一个设备序列号，需要转换为UNICODE格式
-*	形    参：_pBuf 目标缓冲区
-*	返 回 值: 错误代码(无需处理)
-*********************************************************************************************************
-*/
-void Get_SerialNum(uint8_t *_pBuf)
-{
-	uint32_t Device_Serial0, Device_Serial1, Device_Serial2;
-	
-	Device_Serial0 = *(__IO uint32_t*)(0x1FFFF7E8);
-	Device_Serial1 = *(__IO uint32_t*)(0x1FFFF7EC);
-	Device_Serial2 = *(__IO uint32_t*)(0x1FFFF7F0);
-	
-	Device_Serial0 += Device_Serial2;
-	
-	if (Device_Serial0 != 0)
-	{
-		IntToUnicode (Device_Serial0, &_pBuf[2] , 8);
-		IntToUnicode (Device_Serial1, &_pBuf[18], 4);
-	}
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: IntToUnicode
-*	功能说明: 将一个32位的HEX值转换为Unicode编码格式的字符串
-*	形    参：_ulValue : 32位Hex； 
-*			  _pBuf : 目标缓冲区
-*			 _ucLen : 目标码长度
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-static void IntToUnicode (uint32_t _ulValue , uint8_t *_pBuf , uint8_t _ucLen)
-{
-	uint8_t idx = 0;
-	
-	for( idx = 0 ; idx < _ucLen ; idx ++)
-	{
-		if( ((_ulValue >> 28)) < 0xA )
-		{
-			_pBuf[2 * idx] = (_ulValue >> 28) + '0';
-		}
-		else
-		{
-			_pBuf[2 * idx] = (_ulValue >> 28) + 'A' - 10; 
-		}
-		
-		_ulValue = _ulValue << 4;
-		
-		_pBuf[ 2 * idx + 1] = 0;
-	}
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: SaveHostDataToBuf
-*	功能说明: 将USB主机发送的数据缓存到全局缓冲区。该函数被USB中断服务程序调用。
-*	形    参: _pInBuf :输入缓冲区；PC发到设备的数据 
-*			  _pBuf : 目标缓冲区
-*			 _ucLen : 目标码长度
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void usb_SaveHostDataToBuf(uint8_t *_pInBuf, uint16_t _usLen)
-{
-	uint16_t i;
-	
-	/* 未考虑缓冲区填满的情况 */
-	for (i = 0 ; i < _usLen; i++)
-	{
-		g_tUsbFifo.aRxBuf[g_tUsbFifo.usRxWrite] = _pInBuf[i];
-		
-		if (++g_tUsbFifo.usRxWrite >= USB_RX_BUF_SIZE)
-		{
-			g_tUsbFifo.usRxWrite = 0;
-		}
-	}
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: usb_GetRxByte
-*	功能说明: 从USB接收缓冲区读取1个字节. 被主程序调用
-*	形    参: _pInBuf :输入缓冲区；PC发到设备的数据 
-*			  _pBuf : 目标缓冲区
-*			 _ucLen : 目标码长度
-*	返 回 值: 读取的字节
-*********************************************************************************************************
-*/
-uint8_t usb_GetRxByte(uint8_t *_pByteNum)
-{
-	uint8_t ucData;
-	uint16_t usRxWrite;
-	
-	__set_PRIMASK(1);  		/* 关中断，避免USB中断程序和主程序访问变量冲突 */
-	usRxWrite = g_tUsbFifo.usRxWrite;
-	__set_PRIMASK(0);  		/* 开中断 */
-
-	/* 发送缓冲区为空时，返回字节数 = 0 */
-	if (g_tUsbFifo.usRxRead == usRxWrite)
-	{
-		*_pByteNum = 0;
-		return 0;
-	}
-	
-	/* 保存第1个字节 */
-	ucData = g_tUsbFifo.aRxBuf[g_tUsbFifo.usRxRead];
-	
-	/* 移动读指针 */
-	if (++g_tUsbFifo.usRxRead >= USB_RX_BUF_SIZE)
-	{
-		g_tUsbFifo.usRxRead = 0;
-	}
-
-	*_pByteNum = 1;		/* 有效字节个数 = 1 */
-	return ucData;		
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: SendDataToHost
-*	功能说明: 发送数据到主机。 主程序调用。
-*	形    参: _pInBuf :输入缓冲区；PC发到设备的数据 
-*			  _pBuf : 目标缓冲区
-*			 _ucLen : 目标码长度
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void usb_SendDataToHost(uint8_t *_pTxBuf, uint16_t _usLen)
-{
-	uint16_t i;
-	
-	/* 未考虑缓冲区填满的情况 */
-	/* 先将数据缓存到内存 */
-	for (i = 0 ; i < _usLen; i++)
-	{
-		g_tUsbFifo.aTxBuf[g_tUsbFifo.usTxWrite] = _pTxBuf[i];
-
-		__set_PRIMASK(1);  		/* 关中断，避免USB中断程序和主程序访问 usTxWrite 变量冲突 */
-		
-		if (++g_tUsbFifo.usTxWrite >= USB_RX_BUF_SIZE)
-		{
-			g_tUsbFifo.usTxWrite = 0;
-		}
-
-		__set_PRIMASK(0);  		/* 开中断 */
-	}
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: usb_GetTxWord
-*	功能说明: 从发送缓冲区读取1个字，2字节. 用于USB中断
-*	形    参: _pByteNum : 存储读取的字节数的变量的指针
-*	返 回 值: 读到字（2字节）
-*********************************************************************************************************
-*/
-uint16_t usb_GetTxWord(uint8_t *_pByteNum)
-{
-	uint16_t usData;
-	
-	/* 发送缓冲区为空时，返回字节数 = 0 */
-	if (g_tUsbFifo.usTxRead == g_tUsbFifo.usTxWrite)
-	{
-		*_pByteNum = 0;
-		return 0;
-	}
-	
-	/* 保存第1个字节 */
-	usData = g_tUsbFifo.aTxBuf[g_tUsbFifo.usTxRead];
-	
-	/* 移动读指针 */
-	if (++g_tUsbFifo.usTxRead >= USB_TX_BUF_SIZE)
-	{
-		g_tUsbFifo.usTxRead = 0;
-	}
-	
-	/* 不足2字节，直接返回 */
-	if (g_tUsbFifo.usTxRead == g_tUsbFifo.usTxWrite)
-	{
-		*_pByteNum = 1;		/* 有效字节个数 = 1 */
-		return usData;
-	}	
-	
-	/* 保存第2个字节 */
-	usData += g_tUsbFifo.aTxBuf[g_tUsbFifo.usTxRead] << 8;
-
-	/* 移动读指针 */
-	if (++g_tUsbFifo.usTxRead >= USB_TX_BUF_SIZE)
-	{
-		g_tUsbFifo.usTxRead = 0;
-	}
-
-	*_pByteNum = 2;		/* 有效字节个数 = 2 */
-	return usData;		
-}
+#include "stm32f10x.h"
+
+#include "stm32f10x_it.h"
+#include "usb_lib.h"
+#include "usb_prop.h"
+#include "usb_desc.h"
+#include "hw_config.h"
+#include "usb_pwr.h"
+#include "usb_mem.h"
+#include "usb_bridge.h"
+#include "bsp.h"
+
+/* 定义控制USB上拉电阻的GPIO, PC4 */
+#define	RCC_USB_PULL_UP		RCC_APB2Periph_GPIOB
+#define	PORT_USB_PULL_UP	GPIOB
+#define	PIN_USB_PULL_UP		GPIO_Pin_14
+
+#define USB_CABLE_ENABLE()	GPIO_ResetBits(PORT_USB_PULL_UP, PIN_USB_PULL_UP)	/* 连接USB设备  */
+#define USB_CABLE_DISABLE()	GPIO_SetBits(PORT_USB_PULL_UP, PIN_USB_PULL_UP)		/* 断开USB设备 */
+
+USB_COM_FIFO_T g_tUsbFifo[USB_PORT_NUM];	/* 每个USB端口一个结构体，用于FIFO和流量控制 */
+
+static uint8_t g_UsbTxBuf1[USB_TX_BUF_SIZE];	/* USB_COM1 发送缓冲区, 设备->PC */
+static uint8_t g_UsbRxBuf1[USB_RX_BUF_SIZE];	/* USB_COM1 接收缓冲区, PC->设备 */
+#if USB_COMPOSITE_EN == 1
+	static uint8_t g_UsbTxBuf2[USB_COM2_TX_BUF_SIZE];		/* USB_COM2 */
+	static uint8_t g_UsbRxBuf2[USB_COM2_RX_BUF_SIZE];
+	static uint8_t g_UsbTxBufV[USB_VENDOR_TX_BUF_SIZE];		/* USB_VENDOR */
+	static uint8_t g_UsbRxBufV[USB_VENDOR_RX_BUF_SIZE];
+#endif
+
+#if USB_CYCLE_STAT_EN == 1
+	USB_CYCLE_STAT_T g_tUsbRxCycle;	/* EP3 OUT 每个包的中断处理时间 */
+	USB_CYCLE_STAT_T g_tUsbTxCycle;	/* EP1 IN 每个包的中断处理时间 */
+	USB_PMA_BENCH_T g_tUsbPmaBench;	/* PMA拷贝函数测速结果 */
+#endif
+
+static void IntToUnicode (uint32_t _ulValue , uint8_t *_pBuf , uint8_t _ucLen);
+static void UsbPortVarInit(void);
+#if USB_CYCLE_STAT_EN == 1
+	static void usb_PmaBench(void);
+#endif
+
+/*
+*********************************************************************************************************
+*	函 数 名: bsp_InitUsb
+*	功能说明: 初始化CPU的USB硬件设备。配置控制上拉电阻的GPIO，配置USB输入时钟48MHz；配置USB中断
+*	形    参：无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void bsp_InitUsb(void)
+{
+	GPIO_InitTypeDef GPIO_InitStructure;
+	
+	/* 使能控制USB上拉电阻GPIO的时钟 */
+	RCC_APB2PeriphClockCmd(RCC_USB_PULL_UP, ENABLE);
+	
+	/* 配置 USB 上拉引脚 */
+	USB_CABLE_DISABLE();	/* 断开USB设备 */
+	GPIO_InitStructure.GPIO_Pin = PIN_USB_PULL_UP;
+	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_OD;
+	GPIO_Init(PORT_USB_PULL_UP, &GPIO_InitStructure);
+
+	/* 设置USB时钟源 */
+	RCC_USBCLKConfig(RCC_USBCLKSource_PLLCLK_1Div5);
+	
+	/* 使能USB时钟 */
+	RCC_APB1PeriphClockCmd(RCC_APB1Periph_USB, ENABLE);
+	
+	/* 配置USB中断 */
+	{
+		NVIC_InitTypeDef NVIC_InitStructure;
+		
+		NVIC_PriorityGroupConfig(NVIC_PriorityGroup_1);
+		
+		NVIC_InitStructure.NVIC_IRQChannel = USB_LP_CAN1_RX0_IRQn;
+	#if USB_BRIDGE_EN == 1
+		/* 桥接数据在USB中断和串口(DMA)中断之间转发, 抢占优先级和串口相同(0), 两者不会互相打断 */
+		NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0;
+	#else
+		NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
+	#endif
+		NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+		NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+		NVIC_Init(&NVIC_InitStructure);
+
+		#if USB_DBL_BUF_EN == 1
+			/* 双缓冲批量端点的传输完成(CTR)由高优先级中断产生, 抢占优先级和低优先级中断相同, 两者不会嵌套 */
+			NVIC_InitStructure.NVIC_IRQChannel = USB_HP_CAN1_TX_IRQn;
+			NVIC_Init(&NVIC_InitStructure);
+		#endif
+		
+		#if 0	/* 根据需要使能中断:USB从挂起状态到恢复 */
+		{
+			EXTI_InitTypeDef EXTI_InitStructure;
+			
+			/* 配置外部中断线18连接到USB IP中断(CPU内部连接) */
+			EXTI_ClearITPendingBit(EXTI_Line18);
+			EXTI_InitStructure.EXTI_Line = EXTI_Line18; /* USB从挂起状态到恢复 */
+			EXTI_InitStructure.EXTI_Trigger = EXTI_Trigger_Rising;
+			EXTI_InitStructure.EXTI_LineCmd = ENABLE;
+			EXTI_Init(&EXTI_InitStructure);
+		}
+		#endif
+	}
+
+	UsbPortVarInit();		/* 必须在 USB_Init() 之前初始化端口变量, 复位中断会用到端点号和PMA地址 */
+
+#if USB_BRIDGE_EN == 1
+	usb_BridgeInit();		/* 串口桥接, 必须在 bsp_InitUart() 之后调用 */
+#endif
+
+#if USB_CYCLE_STAT_EN == 1
+	/* 打开DWT周期计数器 */
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	usb_PmaBench();		/* USB_Init() 之前端点都未使用, 可以借用PMA测速 */
+#endif
+
+	USB_Init();	
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: UsbPortVarInit
+*	功能说明: 初始化各USB端口的FIFO、端点号和PMA地址
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void UsbPortVarInit(void)
+{
+	USB_COM_FIFO_T *pPort;
+	uint8_t i;
+
+	for (i = 0; i < USB_PORT_NUM; i++)
+	{
+		pPort = &g_tUsbFifo[i];
+		pPort->ucTxBusy = 0;
+		pPort->ucTxReady = 0;
+		pPort->ucTxZlp = 0;
+		pPort->ucRxNak = 0;
+		pPort->ulTxDropped = 0;
+		pPort->usRxPktSize = VIRTUAL_COM_PORT_DATA_SIZE;
+		pPort->ReciveNew = 0;
+		pPort->TxLow = 0;
+	}
+
+	pPort = &g_tUsbFifo[USB_COM1];
+	bsp_RingInit(&pPort->tTxRing, g_UsbTxBuf1, USB_TX_BUF_SIZE);
+	bsp_RingInit(&pPort->tRxRing, g_UsbRxBuf1, USB_RX_BUF_SIZE);
+	pPort->ucTxEp = ENDP1;
+	pPort->ucRxEp = ENDP3;
+#if USB_DBL_BUF_EN == 1
+	pPort->usTxAddr[0] = ENDP1_BUF0ADDR;
+	pPort->usTxAddr[1] = ENDP1_BUF1ADDR;
+	pPort->usRxAddr[0] = ENDP3_BUF0ADDR;
+	pPort->usRxAddr[1] = ENDP3_BUF1ADDR;
+#else
+	pPort->usTxAddr[0] = ENDP1_TXADDR;
+	pPort->usTxAddr[1] = ENDP1_TXADDR;
+	pPort->usRxAddr[0] = ENDP3_RXADDR;
+	pPort->usRxAddr[1] = ENDP3_RXADDR;
+#endif
+
+#if USB_COMPOSITE_EN == 1
+	pPort = &g_tUsbFifo[USB_COM2];
+	bsp_RingInit(&pPort->tTxRing, g_UsbTxBuf2, USB_COM2_TX_BUF_SIZE);
+	bsp_RingInit(&pPort->tRxRing, g_UsbRxBuf2, USB_COM2_RX_BUF_SIZE);
+	pPort->ucTxEp = ENDP4;
+	pPort->ucRxEp = ENDP4;		/* EP4 的 IN 和 OUT 共用一个端点寄存器 */
+	pPort->usTxAddr[0] = ENDP4_TXADDR;
+	pPort->usTxAddr[1] = ENDP4_TXADDR;
+	pPort->usRxAddr[0] = ENDP4_RXADDR;
+	pPort->usRxAddr[1] = ENDP4_RXADDR;
+	pPort->usRxPktSize = VIRTUAL_COM_PORT_DBG_OUT_SIZE;
+
+	pPort = &g_tUsbFifo[USB_VENDOR];
+	bsp_RingInit(&pPort->tTxRing, g_UsbTxBufV, USB_VENDOR_TX_BUF_SIZE);
+	bsp_RingInit(&pPort->tRxRing, g_UsbRxBufV, USB_VENDOR_RX_BUF_SIZE);
+	pPort->ucTxEp = ENDP5;
+	pPort->ucRxEp = ENDP6;
+	pPort->usTxAddr[0] = ENDP5_TXADDR;
+	pPort->usTxAddr[1] = ENDP5_TXADDR;
+	pPort->usRxAddr[0] = ENDP6_RXADDR;
+	pPort->usRxAddr[1] = ENDP6_RXADDR;
+#endif
+}
+
+#if USB_CYCLE_STAT_EN == 1
+/*
+*********************************************************************************************************
+*	函 数 名: usb_CycleStat
+*	功能说明: 记录一次中断处理时间。在USB中断中调用。
+*	形    参: _pStat : 统计结构体
+*			  _ulCycles : 本次执行的CPU时钟周期数 (DWT->CYCCNT 之差)
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void usb_CycleStat(USB_CYCLE_STAT_T *_pStat, uint32_t _ulCycles)
+{
+	_pStat->Count++;
+	_pStat->Last = _ulCycles;
+	_pStat->Sum += _ulCycles;
+	if (_ulCycles > _pStat->Max)
+	{
+		_pStat->Max = _ulCycles;
+	}
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: usb_PmaWriteRef / usb_PmaReadRef
+*	功能说明: ST固件库原来的PMA拷贝循环, 每个半字由两个字节拼装。仅用于测速对比。
+*	形    参: 同 UserToPMABufferCopy / PMAToUserBufferCopy
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void usb_PmaWriteRef(uint8_t *pbUsrBuf, uint16_t wPMABufAddr, uint16_t wNBytes)
+{
+	uint32_t n = (wNBytes + 1) >> 1;
+	uint32_t i, temp1, temp2;
+	uint16_t *pdwVal;
+	
+	pdwVal = (uint16_t *)(wPMABufAddr * 2 + PMAAddr);
+	for (i = n; i != 0; i--)
+	{
+		temp1 = (uint16_t) * pbUsrBuf;
+		pbUsrBuf++;
+		temp2 = temp1 | (uint16_t) * pbUsrBuf << 8;
+		*pdwVal++ = temp2;
+		pdwVal++;
+		pbUsrBuf++;
+	}
+}
+
+static void usb_PmaReadRef(uint8_t *pbUsrBuf, uint16_t wPMABufAddr, uint16_t wNBytes)
+{
+	uint32_t n = (wNBytes + 1) >> 1;
+	uint32_t i;
+	uint32_t *pdwVal;
+	
+	pdwVal = (uint32_t *)(wPMABufAddr * 2 + PMAAddr);
+	for (i = n; i != 0; i--)
+	{
+		*(uint16_t*)pbUsrBuf++ = *pdwVal++;
+		pbUsrBuf++;
+	}
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: usb_PmaBench
+*	功能说明: 用DWT周期计数器测量64字节PMA拷贝的时间, 结果存入 g_tUsbPmaBench, 可在调试器中查看。
+*			  必须在USB时钟打开之后、USB_Init()之前调用。
+*			  尚未在开发板上运行, 新旧实现的周期数没有实测数据。
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void usb_PmaBench(void)
+{
+	uint32_t aBuf[VIRTUAL_COM_PORT_DATA_SIZE / 4 + 1];
+	uint8_t *pBuf = (uint8_t *)aBuf;
+	uint32_t ulStart;
+	uint16_t i;
+
+	for (i = 0; i < VIRTUAL_COM_PORT_DATA_SIZE; i++)
+	{
+		pBuf[i] = i;
+	}
+
+	DISABLE_INT();
+
+	ulStart = DWT->CYCCNT;
+	usb_PmaWriteRef(pBuf, ENDP0_RXADDR, VIRTUAL_COM_PORT_DATA_SIZE);
+	g_tUsbPmaBench.RefWrite = DWT->CYCCNT - ulStart;
+
+	ulStart = DWT->CYCCNT;
+	UserToPMABufferCopy(pBuf, ENDP0_RXADDR, VIRTUAL_COM_PORT_DATA_SIZE);
+	g_tUsbPmaBench.FastWrite = DWT->CYCCNT - ulStart;
+
+	ulStart = DWT->CYCCNT;
+	UserToPMABufferCopy(pBuf + 1, ENDP0_RXADDR, VIRTUAL_COM_PORT_DATA_SIZE);
+	g_tUsbPmaBench.FastWriteOdd = DWT->CYCCNT - ulStart;
+
+	ulStart = DWT->CYCCNT;
+	usb_PmaReadRef(pBuf, ENDP0_RXADDR, VIRTUAL_COM_PORT_DATA_SIZE);
+	g_tUsbPmaBench.RefRead = DWT->CYCCNT - ulStart;
+
+	ulStart = DWT->CYCCNT;
+	PMAToUserBufferCopy(pBuf, ENDP0_RXADDR, VIRTUAL_COM_PORT_DATA_SIZE);
+	g_tUsbPmaBench.FastRead = DWT->CYCCNT - ulStart;
+
+	ulStart = DWT->CYCCNT;
+	PMAToUserBufferCopy(pBuf + 1, ENDP0_RXADDR, VIRTUAL_COM_PORT_DATA_SIZE);
+	g_tUsbPmaBench.FastReadOdd = DWT->CYCCNT - ulStart;
+
+	ENABLE_INT();
+}
+#endif
+
+/*
+*********************************************************************************************************
+*	函 数 名: usb_EnterLowPowerMode
+*	功能说明: 进入低功耗模式。当USB设备进入挂起模式时，关闭系统时钟和电源
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void usb_EnterLowPowerMode(void)
+{
+	/* 设置设备状态为 suspend, bDeviceState 全局变量在 usb_pwr.c 中定义 */
+	bDeviceState = SUSPENDED;
+
+	#if 0	/* 根据需要关闭电源 （鼠标键盘设备可进入挂起状态，虚拟串口等设备最好保持常开） */
+		/* 清 EXTI Line18 中断标志 */
+		EXTI_ClearITPendingBit(EXTI_Line8);
+		
+		/* 在低功耗状态，关闭电压调节器 */
+		PWR_EnterSTOPMode(PWR_Regulator_LowPower, PWR_STOPEntry_WFI);	
+	#endif
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: usb_LeaveLowPowerMode
+*	功能说明: 退出低功耗模式。恢复系统时钟。
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void usb_LeaveLowPowerMode(void)
+{
+	DEVICE_INFO *pInfo = &Device_Info;  /* 全局变量Device_Info 在USB固件库 usb_init.c 中定义 */	
+
+#if 0	/* 根据需要恢复系统时钟 */
+	/* 使能 HSE */
+	RCC_HSEConfig(RCC_HSE_ON);
+	
+	/* 等待 HSE 就绪 */
+	RCC_WaitForHSEStartUp();
+	
+	/* 使能 HSE */
+	RCC_HSEConfig(RCC_HSE_ON);
+	
+	/* 等待 HSE 就绪 */
+	while (RCC_GetFlagStatus(RCC_FLAG_HSERDY) == RESET);
+	
+	/* 使能PLL */
+	RCC_PLLCmd(ENABLE);
+	
+	/* 等待PLL就绪 */
+	while (RCC_GetFlagStatus(RCC_FLAG_PLLRDY) == RESET);
+	
+	/* 选择PLL作为系统时钟源 */
+	RCC_SYSCLKConfig(RCC_SYSCLKSource_PLLCLK);
+	
+	/* 等待PLL系统时钟源稳定 */
+	while (RCC_GetSYSCLKSource() != 0x08);
+#endif
+	
+	/* 更新全局变量bDeviceState，表示usb设备状态 */
+	if (pInfo->Current_Configuration != 0)
+	{
+		bDeviceState = CONFIGURED;	/* 配置成功 */
+	}
+	else
+	{
+		bDeviceState = ATTACHED;	/* USB设备已连接，但还未配置 */
+	}	
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: usb_CableConfig
+*	功能说明: 软件控制USB电缆连接和断开
+*	形    参: _ucMode ： ENABLE表示连接，DISABLE表示断开
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void usb_CableConfig(uint8_t _ucMode)
+{
+	if (_ucMode == DISABLE)
+	{
+		USB_CABLE_DISABLE();	/* 断开USB设备 */
+	}
+	else
+	{
+		USB_CABLE_ENABLE();		/* 连接USB设备, 实质上将D+上拉，此时USB设备就能被集线器检测到了 */
+	}
+}
+				   
+/*
+*********************************************************************************************************
+*	函 数 名: usb_SendBuf
+*	功能说明: 向PC主机发送一组数据。EP1 由发送FIFO驱动(单缓冲或双缓冲), 不能直接写PMA, 因此经过发送FIFO。
+*	形    参：_pBuf 输入缓冲区; 	_ucLen : 数据长度
+*	返 回 值: 错误代码(无需处理)
+*********************************************************************************************************
+*/
+void usb_SendBuf(uint8_t *_pTxBuf, uint8_t _ucLen)
+{
+	usb_SendDataToHost(_pTxBuf, _ucLen);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: Get_SerialNum
+*	功能说明: 获取一个设备序列号，需要转换为UNICODE格式
+*	形    参：_pBuf 目标缓冲区
+*	返 回 值: 错误代码(无需处理)
+*********************************************************************************************************
+*/
+void Get_SerialNum(uint8_t *_pBuf)
+{
+	uint32_t Device_Serial0, Device_Serial1, Device_Serial2;
+	
+	Device_Serial0 = *(__IO uint32_t*)(0x1FFFF7E8);
+	Device_Serial1 = *(__IO uint32_t*)(0x1FFFF7EC);
+	Device_Serial2 = *(__IO uint32_t*)(0x1FFFF7F0);
+	
+	Device_Serial0 += Device_Serial2;
+	
+	if (Device_Serial0 != 0)
+	{
+		IntToUnicode (Device_Serial0, &_pBuf[2] , 8);
+		IntToUnicode (Device_Serial1, &_pBuf[18], 4);
+	}
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: IntToUnicode
+*	功能说明: 将一个32位的HEX值转换为Unicode编码格式的字符串
+*	形    参：_ulValue : 32位Hex； 
+*			  _pBuf : 目标缓冲区
+*			 _ucLen : 目标码长度
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void IntToUnicode (uint32_t _ulValue , uint8_t *_pBuf , uint8_t _ucLen)
+{
+	uint8_t idx = 0;
+	
+	for( idx = 0 ; idx < _ucLen ; idx ++)
+	{
+		if( ((_ulValue >> 28)) < 0xA )
+		{
+			_pBuf[2 * idx] = (_ulValue >> 28) + '0';
+		}
+		else
+		{
+			_pBuf[2 * idx] = (_ulValue >> 28) + 'A' - 10; 
+		}
+		
+		_ulValue = _ulValue << 4;
+		
+		_pBuf[ 2 * idx + 1] = 0;
+	}
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: usb_GetPort
+*	功能说明: 将USB端口号转换为端口结构体指针
+*	形    参: _ePort : 端口号 (USB_COM1, USB_COM2, USB_VENDOR)
+*	返 回 值: 端口结构体指针, 0 表示端口不存在 (非复合设备只有 USB_COM1)
+*********************************************************************************************************
+*/
+USB_COM_FIFO_T *usb_GetPort(USB_PORT_E _ePort)
+{
+	if ((uint8_t)_ePort >= USB_PORT_NUM)
+	{
+		return 0;
+	}
+	return &g_tUsbFifo[_ePort];
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: usb_PortSend
+*	功能说明: 向指定的USB端口发送数据。数据整块拷贝进发送FIFO(最多两段), 每次写入只发布一次写索引。
+*			  每个端口的发送FIFO只能有一个生产者, 写FIFO不需要关中断。各端口的FIFO和端点相互独立。
+*			  USB_TX_BLOCK 会等待, 只能由主程序调用; USB_TX_DROP 和 USB_TX_PARTIAL 不等待, 也可以在中断中调用
+*			  (例如串口桥接在串口/USB中断中用 USB_TX_PARTIAL 发送), 此时该端口不能再由主程序发送。
+*	形    参: _ePort : 端口号
+*			  _pTxBuf : 待发送的数据
+*			  _usLen : 数据长度
+*			  _ePolicy : 发送FIFO空间不够时的处理策略
+*						USB_TX_BLOCK   : 等待, 直到全部写入
+*						USB_TX_DROP    : 整条丢弃, 计入丢弃字节数
+*						USB_TX_PARTIAL : 只写入放得下的部分
+*	返 回 值: 实际写入发送FIFO的字节数
+*********************************************************************************************************
+*/
+uint16_t usb_PortSend(USB_PORT_E _ePort, const uint8_t *_pTxBuf, uint16_t _usLen, USB_TX_POLICY_E _ePolicy)
+{
+	USB_COM_FIFO_T *pPort;
+	uint16_t usDone;
+
+	pPort = usb_GetPort(_ePort);
+	if (pPort == 0)
+	{
+		return 0;
+	}
+
+	if (_ePolicy == USB_TX_DROP)
+	{
+		if (bsp_RingFree(&pPort->tTxRing) < _usLen)
+		{
+			pPort->ulTxDropped += _usLen;
+			return 0;
+		}
+		usDone = bsp_RingPut(&pPort->tTxRing, _pTxBuf, _usLen);
+	}
+	else if (_ePolicy == USB_TX_PARTIAL)
+	{
+		usDone = bsp_RingPut(&pPort->tTxRing, _pTxBuf, _usLen);
+	}
+	else	/* USB_TX_BLOCK */
+	{
+		usDone = 0;
+		while (1)
+		{
+			usDone += bsp_RingPut(&pPort->tTxRing, &_pTxBuf[usDone], _usLen - usDone);
+			if (usDone == _usLen)
+			{
+				break;
+			}
+
+			/* 设备未配置时没有人取走数据, 不能等待 */
+			if (bDeviceState != CONFIGURED)
+			{
+				pPort->ulTxDropped += _usLen - usDone;
+				break;
+			}
+
+			/*
+				直接等待IN端点取走数据, 不调用 bsp_Idle(): 其中的日志发送等任务可能再次调用本函数。
+				关中断后再检查FIFO, 检查之后到达的发送完成中断会挂起, WFI 立即返回, 不会错过唤醒。
+			*/
+			usb_StartTx(pPort);
+			DISABLE_INT();
+			if (bsp_RingFree(&pPort->tTxRing) == 0)
+			{
+				__WFI();
+			}
+			ENABLE_INT();
+		}
+	}
+
+	usb_StartTx(pPort);		/* IN端点空闲时立即开始发送 */
+	return usDone;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: usb_PortRead
+*	功能说明: 从指定USB端口的接收缓冲区读取一批数据. 被主程序调用
+*	形    参: _ePort : 端口号
+*			  _pBuf : 目标缓冲区
+*			  _usMaxLen : 最多读取的字节数
+*	返 回 值: 实际读取的字节数
+*********************************************************************************************************
+*/
+uint16_t usb_PortRead(USB_PORT_E _ePort, uint8_t *_pBuf, uint16_t _usMaxLen)
+{
+	USB_COM_FIFO_T *pPort;
+	uint16_t usLen;
+
+	pPort = usb_GetPort(_ePort);
+	if (pPort == 0)
+	{
+		return 0;
+	}
+
+	/* 主程序是接收FIFO唯一的消费者，不需要关中断 */
+	usLen = bsp_RingGet(&pPort->tRxRing, _pBuf, _usMaxLen);
+	if (pPort->ucRxNak)
+	{
+		usb_ResumeRx(pPort);	/* OUT端点因FIFO满暂停接收, 腾出空间后恢复 */
+	}
+	return usLen;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: usb_RxIsEmpty
+*	功能说明: 判断所有USB端口的接收FIFO是否都已读空。bsp_Idle() 在低功耗模式下据此决定能否休眠。
+*	形    参: 无
+*	返 回 值: 1 表示全部为空, 0 表示还有未读的数据
+*********************************************************************************************************
+*/
+uint8_t usb_RxIsEmpty(void)
+{
+	uint8_t i;
+
+	for (i = 0; i < USB_PORT_NUM; i++)
+	{
+		if (bsp_RingCount(&g_tUsbFifo[i].tRxRing) != 0)
+		{
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: usb_PortTxFree
+*	功能说明: 读取指定USB端口发送FIFO的空闲字节数。主程序调用。
+*	形    参: _ePort : 端口号
+*	返 回 值: 空闲字节数
+*********************************************************************************************************
+*/
+uint16_t usb_PortTxFree(USB_PORT_E _ePort)
+{
+	USB_COM_FIFO_T *pPort;
+
+	pPort = usb_GetPort(_ePort);
+	if (pPort == 0)
+	{
+		return 0;
+	}
+	return bsp_RingFree(&pPort->tTxRing);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: usb_PortTxDropped
+*	功能说明: 读取指定USB端口发送FIFO满被丢弃的字节数 (USB_TX_DROP 和设备未配置时的 USB_TX_BLOCK)
+*	形    参: _ePort : 端口号
+*	返 回 值: 累计丢弃字节数
+*********************************************************************************************************
+*/
+uint32_t usb_PortTxDropped(USB_PORT_E _ePort)
+{
+	USB_COM_FIFO_T *pPort;
+
+	pPort = usb_GetPort(_ePort);
+	if (pPort == 0)
+	{
+		return 0;
+	}
+	return pPort->ulTxDropped;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: SaveHostDataToBuf
+*	功能说明: 将数据存入 USB_COM1 的接收缓冲区, 和PC发来的数据一样由主程序读取。
+*			  OUT端点只在FIFO能放下一个满包时才接收 (见 usb_endp.c), 因此数据不会被丢弃。
+*	形    参: _pInBuf :输入缓冲区
+*			  _usLen : 数据长度
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void usb_SaveHostDataToBuf(uint8_t *_pInBuf, uint16_t _usLen)
+{
+	bsp_RingPut(&g_tUsbFifo[USB_COM1].tRxRing, _pInBuf, _usLen);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: usb_GetRxByte
+*	功能说明: 从 USB_COM1 接收缓冲区读取1个字节. 被主程序调用
+*	形    参: _pByteNum : 返回读到的字节数, 0 表示缓冲区为空
+*	返 回 值: 读取的字节
+*********************************************************************************************************
+*/
+uint8_t usb_GetRxByte(uint8_t *_pByteNum)
+{
+	uint8_t ucData;
+
+	if (usb_PortRead(USB_COM1, &ucData, 1) == 0)
+	{
+		*_pByteNum = 0;
+		return 0;
+	}
+
+	*_pByteNum = 1;		/* 有效字节个数 = 1 */
+	return ucData;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: usb_SendDataToHost
+*	功能说明: 通过 USB_COM1 发送数据到主机。 主程序调用。发送FIFO放不下时整条丢弃 (USB_TX_DROP)。
+*	形    参: _pTxBuf : 待发送的数据
+*			  _usLen : 数据长度
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void usb_SendDataToHost(uint8_t *_pTxBuf, uint16_t _usLen)
+{
+	usb_PortSend(USB_COM1, _pTxBuf, _usLen, USB_TX_DROP);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: usb_SendDataToHostEx
+*	功能说明: 通过 USB_COM1 发送数据到主机, 见 usb_PortSend()
+*	形    参: _pTxBuf : 待发送的数据
+*			  _usLen : 数据长度
+*			  _ePolicy : 发送FIFO空间不够时的处理策略
+*	返 回 值: 实际写入发送FIFO的字节数
+*********************************************************************************************************
+*/
+uint16_t usb_SendDataToHostEx(const uint8_t *_pTxBuf, uint16_t _usLen, USB_TX_POLICY_E _ePolicy)
+{
+	return usb_PortSend(USB_COM1, _pTxBuf, _usLen, _ePolicy);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: usb_GetTxDropped
+*	功能说明: 读取 USB_COM1 发送FIFO满被丢弃的字节数
+*	形    参: 无
+*	返 回 值: 累计丢弃字节数
+*********************************************************************************************************
+*/
+uint32_t usb_GetTxDropped(void)
+{
+	return usb_PortTxDropped(USB_COM1);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: usb_GetTxFree
+*	功能说明: 读取 USB_COM1 发送FIFO的空闲字节数。主程序调用。
+*	形    参: 无
+*	返 回 值: 空闲字节数
+*********************************************************************************************************
+*/
+uint16_t usb_GetTxFree(void)
+{
+	return usb_PortTxFree(USB_COM1);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: usb_GetRxBuf
+*	功能说明: 从 USB_COM1 接收缓冲区读取一批数据. 被主程序调用
+*	形    参: _pBuf : 目标缓冲区
+*			  _usMaxLen : 最多读取的字节数
+*	返 回 值: 实际读取的字节数
+*********************************************************************************************************
+*/
+uint16_t usb_GetRxBuf(uint8_t *_pBuf, uint16_t _usMaxLen)
+{
+	return usb_PortRead(USB_COM1, _pBuf, _usMaxLen);
+}
@@ -1,49 +1,133 @@
-/*
-*********************************************************************************************************
-*	                                  
-*	模块名称 : STM32 USB硬件配置模块    
-*	文件名称 : usb_hw.h
-*	版    本 : V2.0
-*	USB固件库驱动 : V3.3.0
-*	说    明 :  头文件
-*
-*	Copyright (C), 2010-2011, 安富莱电子 www.armfly.com
-*
-*********************************************************************************************************
-*/
-
-#ifndef __HW_CONFIG_H
-#define __HW_CONFIG_H
-
-#include "usb_type.h"
-#include "stm32f10x.h"
-#define USB_TX_BUF_SIZE		2048		/* 设备->PC，发送缓冲区大小 */
-#define USB_RX_BUF_SIZE		2048		/* PC->设备，接收缓冲区大小 */
-
-typedef struct
-{
-	uint8_t aTxBuf[USB_TX_BUF_SIZE];	/* 发送缓冲区, 设备->PC */
-	uint8_t aRxBuf[USB_RX_BUF_SIZE];	/* 接收缓冲区, PC->设备 */
-	
-	uint16_t usTxRead;					/* 发送缓冲区读指针 */
-	uint16_t usTxWrite;					/* 发送缓冲区写指针 */
-	uint16_t usRxRead;					/* 接收缓冲区读指针 */
-	uint16_t usRxWrite;					/* 接收缓冲区写指针 */
-	
-	uint16_t usTxState;					/* 发送状态 */		
-}USB_COM_FIFO_T;
-
-extern USB_COM_FIFO_T g_tUsbFifo;
-
-void bsp_InitUsb(void);
-void usb_EnterLowPowerMode(void);
-void usb_LeaveLowPowerMode(void);
-void usb_CableConfig(uint8_t _ucMode);
-void Get_SerialNum(uint8_t *_pBuf);
-
-void usb_SaveHostDataToBuf(uint8_t *_pInBuf, uint16_t _usLen);
-uint16_t usb_GetTxWord(uint8_t *_pByteNum);
-uint8_t usb_GetRxByte(uint8_t *_pByteNum);
-void usb_SendDataToHost(uint8_t *_pTxBuf, uint16_t _usLen);
-
-#endif
+/*
+*********************************************************************************************************
+*	                                  
+*	模块名称 : STM32 USB硬件配置模块    
+*	文件名称 : usb_hw.h
+*	版    本 : V2.0
+*	USB固件库驱动 : V3.3.0
+*	说    明 :  头文件
+*
+*	Copyright (C), 2010-2011, 安富莱电子 www.armfly.com
+*
+*********************************************************************************************************
+*/
+
+#ifndef __HW_CONFIG_H
+#define __HW_CONFIG_H
+
+#include "usb_type.h"
+#include "stm32f10x.h"
+#include "bsp_ring.h"
+#include "usb_conf.h"
+
+/* USB端口号。复合设备有3个端口, 否则只有 USB_COM1 */
+typedef enum
+{
+	USB_COM1 = 0,		/* CDC虚拟串口1, 命令通道 (接口0/1, EP1 IN, EP3 OUT) */
+	USB_COM2 = 1,		/* CDC虚拟串口2, 调试打印通道 (接口2/3, EP4 IN/OUT); USB_BRIDGE_EN = 1 时桥接到USART2 */
+	USB_VENDOR = 2		/* 厂商自定义批量接口, 二进制数据流 (接口4, EP5 IN, EP6 OUT) */
+}USB_PORT_E;
+
+/* 各端口的FIFO大小, 必须是2的整数次幂 */
+#if USB_COMPOSITE_EN == 1
+	#define USB_PORT_NUM			3
+	
+	#define USB_TX_BUF_SIZE			1024	/* USB_COM1 设备->PC */
+	#define USB_RX_BUF_SIZE			1024	/* USB_COM1 PC->设备 */
+	#define USB_COM2_TX_BUF_SIZE	1024	/* USB_COM2 调试打印主要是设备->PC */
+	#define USB_COM2_RX_BUF_SIZE	256
+	#define USB_VENDOR_TX_BUF_SIZE	2048	/* USB_VENDOR 高速数据流 */
+	#define USB_VENDOR_RX_BUF_SIZE	2048
+#else
+	#define USB_PORT_NUM			1
+	
+	#define USB_TX_BUF_SIZE			2048	/* 设备->PC，发送缓冲区大小 */
+	#define USB_RX_BUF_SIZE			2048	/* PC->设备，接收缓冲区大小 */
+#endif
+
+/* usb_SendDataToHostEx() / usb_PortSend() 发送FIFO空间不够时的处理策略 */
+typedef enum
+{
+	USB_TX_BLOCK = 0,		/* 等待USB取走数据, 直到全部写入。只能在主程序中使用; 设备未配置时不等待, 放不下的部分丢弃 */
+	USB_TX_DROP = 1,		/* 放不下整条数据时整条丢弃, 保证命令帧不被截断 */
+	USB_TX_PARTIAL = 2		/* 只写入放得下的部分, 由调用者根据返回值处理剩余数据, 不计入丢弃字节数 */
+}USB_TX_POLICY_E;
+
+/* 每个USB端口一个结构体: 独立的收发FIFO、端点和流量控制状态 */
+typedef struct
+{
+	RING_T tTxRing;						/* 发送FIFO, 主程序写入, USB中断取出 */
+	RING_T tRxRing;						/* 接收FIFO, USB中断写入, 主程序取出 */
+	
+	uint8_t ucTxEp;						/* IN端点号 (设备->PC) */
+	uint8_t ucRxEp;						/* OUT端点号 (PC->设备), 可以和IN端点相同 */
+	uint16_t usTxAddr[2];				/* IN端点PMA缓冲区地址, 双缓冲时两个都有效 */
+	uint16_t usRxAddr[2];				/* OUT端点PMA缓冲区地址, 双缓冲时两个都有效 */
+	uint16_t usRxPktSize;				/* OUT端点最大包长, 接收FIFO至少要有这么多空间才接收 */
+	
+	__IO uint8_t ucTxBusy;				/* 1 表示IN端点正在发送, 发送完成中断会继续从发送FIFO装入数据 */
+	uint8_t ucTxReady;					/* 双缓冲时有效, 1 表示程序一侧的缓冲区已装好下一个包, 等待交给USB模块 */
+	uint8_t ucTxZlp;					/* 1 表示上一个包是满包, 发送FIFO空时需要补发零长度包 */
+	__IO uint8_t ucRxNak;				/* 1 表示接收FIFO空间不足, OUT端点暂停接收(NAK), 等待主程序读走数据 */
+	uint32_t ulTxDropped;				/* 发送FIFO满被丢弃的字节数, 只由主程序修改 */
+	
+	void (*ReciveNew)(void);			/* OUT端点收到数据的回调函数, 在USB中断中执行, 0 表示不需要 */
+	void (*TxLow)(void);				/* IN端点发送完一个包的回调函数(发送FIFO有了空间), 在USB中断中执行 */
+}USB_COM_FIFO_T;
+
+extern USB_COM_FIFO_T g_tUsbFifo[USB_PORT_NUM];
+
+/* 中断处理时间统计, 单位: CPU时钟周期 (72MHz 时 72个周期 = 1us) */
+typedef struct
+{
+	uint32_t Count;		/* 统计次数 */
+	uint32_t Last;		/* 最近一次 */
+	uint32_t Max;		/* 最大值 */
+	uint32_t Sum;		/* 累计值, Sum / Count 为平均值 */
+}USB_CYCLE_STAT_T;
+
+/* PMA拷贝函数测速结果, 拷贝64字节所用的CPU时钟周期。Ref 为ST固件库原来的逐字节拼装循环 */
+typedef struct
+{
+	uint32_t RefWrite;			/* 原 UserToPMABufferCopy */
+	uint32_t FastWrite;			/* 新 UserToPMABufferCopy, 源地址2字节对齐 */
+	uint32_t FastWriteOdd;		/* 新 UserToPMABufferCopy, 源地址奇数 */
+	uint32_t RefRead;			/* 原 PMAToUserBufferCopy */
+	uint32_t FastRead;			/* 新 PMAToUserBufferCopy, 目标地址2字节对齐 */
+	uint32_t FastReadOdd;		/* 新 PMAToUserBufferCopy, 目标地址奇数 */
+}USB_PMA_BENCH_T;
+
+#if USB_CYCLE_STAT_EN == 1
+	extern USB_CYCLE_STAT_T g_tUsbRxCycle;
+	extern USB_CYCLE_STAT_T g_tUsbTxCycle;
+	extern USB_PMA_BENCH_T g_tUsbPmaBench;
+	void usb_CycleStat(USB_CYCLE_STAT_T *_pStat, uint32_t _ulCycles);
+#endif
+
+void bsp_InitUsb(void);
+void usb_EnterLowPowerMode(void);
+void usb_LeaveLowPowerMode(void);
+void usb_CableConfig(uint8_t _ucMode);
+void Get_SerialNum(uint8_t *_pBuf);
+
+USB_COM_FIFO_T *usb_GetPort(USB_PORT_E _ePort);
+uint16_t usb_PortSend(USB_PORT_E _ePort, const uint8_t *_pTxBuf, uint16_t _usLen, USB_TX_POLICY_E _ePolicy);
+uint16_t usb_PortRead(USB_PORT_E _ePort, uint8_t *_pBuf, uint16_t _usMaxLen);
+uint16_t usb_PortTxFree(USB_PORT_E _ePort);
+uint8_t usb_RxIsEmpty(void);
+uint32_t usb_PortTxDropped(USB_PORT_E _ePort);
+
+/* 以下函数操作 USB_COM1, 保持和单CDC时的接口兼容 */
+void usb_SaveHostDataToBuf(uint8_t *_pInBuf, uint16_t _usLen);
+uint8_t usb_GetRxByte(uint8_t *_pByteNum);
+void usb_SendDataToHost(uint8_t *_pTxBuf, uint16_t _usLen);
+uint16_t usb_SendDataToHostEx(const uint8_t *_pTxBuf, uint16_t _usLen, USB_TX_POLICY_E _ePolicy);
+uint32_t usb_GetTxDropped(void);
+uint16_t usb_GetRxBuf(uint8_t *_pBuf, uint16_t _usMaxLen);
+uint16_t usb_GetTxFree(void);
+
+/* usb_endp.c */
+void usb_StartTx(USB_COM_FIFO_T *_pPort);
+void usb_ResumeRx(USB_COM_FIFO_T *_pPort);
+
+#endif
@@ -0,0 +1,262 @@
+/*
+*********************************************************************************************************
+*	                                  
+*	模块名称 : USB虚拟串口桥接模块
+*	文件名称 : usb_bridge.c
+*	版    本 : V1.0
+*	说    明 : 把CDC虚拟串口2 (USB_COM2) 桥接到 USART2 (COM2), 实现USB转串口。
+*			  (1) PC设置的波特率/数据位/校验位/停止位 (SET_LINE_CODING) 直接配置 USART2;
+*			  (2) DTR/RTS (SET_CONTROL_LINE_STATE) 输出到GPIO;
+*			  (3) 数据在中断中转发, 不经过主程序:
+*				  USB -> 串口 : OUT端点收到数据、串口发送FIFO降到低水位时, 把USB接收FIFO的数据写入串口发送FIFO;
+*				  串口 -> USB : 串口收到数据(DMA)、IN端点发送完一个包时, 把串口接收FIFO的数据写入USB发送FIFO。
+*			  两边都是零拷贝地按连续段转发, 对方FIFO满时停止, 由对方腾出空间的回调继续。USB接收FIFO满时
+*			  OUT端点回应NAK, 串口发送FIFO有空间后恢复, 因此 USB -> 串口方向不丢数据。
+*
+*			  USB中断和串口/DMA中断的抢占优先级都是0, 相互不会打断, 回调函数之间不需要关中断。
+*			  回调函数调用的 usb_StartTx()、usb_ResumeRx()、UartTxStart() 内部保存并恢复 PRIMASK, 可以在中断中调用。
+*			  921600bps 时串口每秒约 92KB, USB全速批量端点远高于此, 瓶颈在串口。
+*
+*	修改记录 :
+*		版本号  日期        作者     说明
+*		V1.0    2026-10-17 armfly  正式发布
+*		V1.1    2026-10-17         DTR/RTS 引脚改在 bsp_uart_fifo.h 中定义。
+*
+*	Copyright (C), 2010-2011, 安富莱电子 www.armfly.com
+*
+*********************************************************************************************************
+*/
+
+#include "bsp.h"
+#include "hw_config.h"
+#include "usb_bridge.h"
+
+#if USB_BRIDGE_EN == 1
+
+static void BridgeUsbToUart(void);
+static void BridgeUartToUsb(void);
+static void BridgeUartRxNew(uint8_t *_pBuf, uint16_t _usLen);
+
+/*
+*********************************************************************************************************
+*	函 数 名: usb_BridgeInit
+*	功能说明: 初始化串口桥接: 配置DTR/RTS引脚, 注册USB端口和串口的回调函数, 按默认线路编码配置 USART2。
+*			  在 bsp_InitUart() 之后、USB_Init() 之前调用。
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void usb_BridgeInit(void)
+{
+	GPIO_InitTypeDef GPIO_InitStructure;
+	USB_COM_FIFO_T *pPort;
+
+	RCC_APB2PeriphClockCmd(RCC_COM2_DTR | RCC_COM2_RTS, ENABLE);
+
+	usb_BridgeSetCtrlLine(0);		/* 先输出无效电平, 再配置为输出 */
+
+	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_PP;	/* 推挽输出 */
+	GPIO_InitStructure.GPIO_Pin = PIN_COM2_DTR;
+	GPIO_Init(PORT_COM2_DTR, &GPIO_InitStructure);
+
+	GPIO_InitStructure.GPIO_Pin = PIN_COM2_RTS;
+	GPIO_Init(PORT_COM2_RTS, &GPIO_InitStructure);
+
+	pPort = usb_GetPort(USB_BRIDGE_PORT);
+	pPort->ReciveNew = BridgeUsbToUart;
+	pPort->TxLow = BridgeUartToUsb;
+
+	comSetTxLowCallback(COM2, UART2_TX_BUF_SIZE / 2, BridgeUsbToUart);
+	comSetReciveNewCallback(COM2, BridgeUartRxNew);
+
+	usb_BridgeSetLineCoding(&linecoding[USB_BRIDGE_PORT]);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: usb_BridgeSetLineCoding
+*	功能说明: 按CDC线路编码配置 USART2。在USB中断(SET_LINE_CODING 状态阶段)中执行。
+*			  STM32的数据位包含校验位: 8位数据加校验用9位字长, 7位数据加校验用8位字长。
+*			  不支持的组合(5/6位数据, 7位无校验, mark/space 校验)按 8位无校验处理。
+*	形    参: _pLineCoding : 线路编码
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void usb_BridgeSetLineCoding(LINE_CODING *_pLineCoding)
+{
+	uint16_t usParity;
+	uint16_t usWordLength;
+	uint16_t usStopBits;
+
+	if (_pLineCoding->bitrate == 0)
+	{
+		return;
+	}
+
+	/* bParityType : 0 = 无, 1 = 奇, 2 = 偶, 3 = mark, 4 = space */
+	if (_pLineCoding->paritytype == 1)
+	{
+		usParity = USART_Parity_Odd;
+	}
+	else if (_pLineCoding->paritytype == 2)
+	{
+		usParity = USART_Parity_Even;
+	}
+	else
+	{
+		usParity = USART_Parity_No;
+	}
+
+	if (usParity != USART_Parity_No && _pLineCoding->datatype == 8)
+	{
+		usWordLength = USART_WordLength_9b;
+	}
+	else if (usParity != USART_Parity_No && _pLineCoding->datatype == 7)
+	{
+		usWordLength = USART_WordLength_8b;
+	}
+	else
+	{
+		usWordLength = USART_WordLength_8b;
+		usParity = USART_Parity_No;
+	}
+
+	/* bCharFormat : 0 = 1位停止位, 1 = 1.5位, 2 = 2位 */
+	if (_pLineCoding->format == 1)
+	{
+		usStopBits = USART_StopBits_1_5;
+	}
+	else if (_pLineCoding->format == 2)
+	{
+		usStopBits = USART_StopBits_2;
+	}
+	else
+	{
+		usStopBits = USART_StopBits_1;
+	}
+
+	/* PCLK1 = 36MHz, 921600bps 时 USARTDIV = 2.4414, BRR = 0x27 (误差 0.16%) */
+	bsp_SetUart2Param(_pLineCoding->bitrate, usWordLength, usStopBits, usParity);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: usb_BridgeSetCtrlLine
+*	功能说明: 把 SET_CONTROL_LINE_STATE 的 DTR/RTS 状态输出到GPIO, 低电平有效。在USB中断中执行。
+*	形    参: _usState : wValue, bit0 = DTR, bit1 = RTS
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void usb_BridgeSetCtrlLine(uint16_t _usState)
+{
+	if (_usState & 0x01)
+	{
+		PORT_COM2_DTR->BRR = PIN_COM2_DTR;
+	}
+	else
+	{
+		PORT_COM2_DTR->BSRR = PIN_COM2_DTR;
+	}
+
+	if (_usState & 0x02)
+	{
+		PORT_COM2_RTS->BRR = PIN_COM2_RTS;
+	}
+	else
+	{
+		PORT_COM2_RTS->BSRR = PIN_COM2_RTS;
+	}
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: BridgeUsbToUart
+*	功能说明: 把USB接收FIFO中的数据写入串口发送FIFO。OUT端点收到数据和串口发送FIFO降到低水位时调用。
+*			  串口发送FIFO满时停止, comSendBufNoWait() 会在低水位时再次调用本函数。
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void BridgeUsbToUart(void)
+{
+	USB_COM_FIFO_T *pPort;
+	uint8_t *pData;
+	uint16_t usSpan;
+	uint16_t usPut;
+
+	pPort = usb_GetPort(USB_BRIDGE_PORT);
+	while (1)
+	{
+		usSpan = bsp_RingPeekSpan(&pPort->tRxRing, &pData);
+		if (usSpan == 0)
+		{
+			break;
+		}
+
+		usPut = comSendBufNoWait(COM2, pData, usSpan);
+		bsp_RingConsume(&pPort->tRxRing, usPut);
+		if (usPut < usSpan)
+		{
+			break;		/* 串口发送FIFO满 */
+		}
+	}
+
+	if (pPort->ucRxNak)
+	{
+		usb_ResumeRx(pPort);	/* USB接收FIFO腾出了空间, 恢复OUT端点接收 */
+	}
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: BridgeUartToUsb
+*	功能说明: 把串口接收FIFO中的数据写入USB发送FIFO。串口收到数据和IN端点发送完一个包时调用。
+*			  USB发送FIFO满时停止, 数据留在串口接收FIFO中, IN端点发送完成后继续。
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void BridgeUartToUsb(void)
+{
+	uint8_t *pData;
+	uint16_t usSpan;
+	uint16_t usPut;
+
+	while (1)
+	{
+		usSpan = comPeekSpan(COM2, &pData);
+		if (usSpan == 0)
+		{
+			break;
+		}
+
+		usPut = usb_PortSend(USB_BRIDGE_PORT, pData, usSpan, USB_TX_PARTIAL);
+		comConsume(COM2, usPut);
+		if (usPut < usSpan)
+		{
+			break;		/* USB发送FIFO满 */
+		}
+	}
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: BridgeUartRxNew
+*	功能说明: USART2 的 ReciveNew 回调, 在串口/DMA中断中执行。数据已经在接收FIFO中, 直接转发。
+*	形    参: _pBuf : 新数据 (不使用)
+*			  _usLen : 新数据长度 (不使用)
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void BridgeUartRxNew(uint8_t *_pBuf, uint16_t _usLen)
+{
+	(void)_pBuf;
+	(void)_usLen;
+
+	BridgeUartToUsb();
+}
+
+#endif
+
+/***************************** 安富莱电子 www.armfly.com (END OF FILE) *********************************/
@@ -0,0 +1,34 @@
+/*
+*********************************************************************************************************
+*	                                  
+*	模块名称 : USB虚拟串口桥接模块
+*	文件名称 : usb_bridge.h
+*	版    本 : V1.0
+*	说    明 : 头文件
+*
+*	Copyright (C), 2010-2011, 安富莱电子 www.armfly.com
+*
+*********************************************************************************************************
+*/
+
+#ifndef __USB_BRIDGE_H
+#define __USB_BRIDGE_H
+
+#include "usb_conf.h"
+#include "usb_prop.h"
+
+#if USB_BRIDGE_EN == 1
+
+#define USB_BRIDGE_PORT		USB_COM2	/* 桥接的USB端口 (CDC虚拟串口2), 对应串口 COM2 (USART2) */
+
+/* DTR/RTS 控制线输出引脚在 bsp_uart_fifo.h 中定义 (RCC_COM2_DTR, PORT_COM2_DTR, PIN_COM2_DTR 等) */
+
+void usb_BridgeInit(void);
+void usb_BridgeSetLineCoding(LINE_CODING *_pLineCoding);
+void usb_BridgeSetCtrlLine(uint16_t _usState);
+
+#endif
+
+#endif
+
+/***************************** 安富莱电子 www.armfly.com (END OF FILE) *********************************/
@@ -1,74 +1,167 @@
-/*
-*********************************************************************************************************
-*
-*	模块名称 : 主程序模块。
-*	文件名称 : usb_conf.h
-*	版    本 : V2.0
-*	说    明 : USB虚拟串口模块头文件
-*	修改记录 :
-*		版本号  日期       作者    说明
-*		v1.0    2011-08-27 armfly  ST固件库V3.5.0版本。
-*		v2.0    2011-10-16 armfly  优化工程结构。
-*
-*	Copyright (C), 2010-2011, 安富莱电子 www.armfly.com
-*
-*********************************************************************************************************
-*/
-
-#ifndef __USB_CONF_H
-#define __USB_CONF_H
-
-#define EP_NUM				(4)		/* 定义USB设备使用了几个端点 */
-
-/*-------------------------------------------------------------*/
-/* --------------   Buffer Description Table  -----------------*/
-/*-------------------------------------------------------------*/
-/* buffer table base address */
-/* buffer table base address */
-#define BTABLE_ADDRESS      (0x00)
-
-/* EP0  */
-/* rx/tx buffer base address */
-#define ENDP0_RXADDR        (0x40)
-#define ENDP0_TXADDR        (0x80)
-
-/* EP1  */
-/* tx buffer base address */
-#define ENDP1_TXADDR        (0xC0)
-#define ENDP2_TXADDR        (0x100)
-#define ENDP3_RXADDR        (0x110)
-
-
-/*-------------------------------------------------------------*/
-/* -------------------   ISTR events  -------------------------*/
-/*-------------------------------------------------------------*/
-/* 定义应用软件用到的USB事件 */
-#define IMR_MSK (CNTR_CTRM  | CNTR_SOFM  | CNTR_RESETM )
-
-/*#define CTR_CALLBACK*/
-/*#define DOVR_CALLBACK*/
-/*#define ERR_CALLBACK*/
-/*#define WKUP_CALLBACK*/
-/*#define SUSP_CALLBACK*/
-/*#define RESET_CALLBACK*/
-#define SOF_CALLBACK
-/*#define ESOF_CALLBACK*/
-
-/* CTR 服务程序, 未用的端点回调函数定义为空操作 */
-/*#define  EP1_IN_Callback   NOP_Process */		/* 本例程使用了 EP1_IN */
-#define  EP2_IN_Callback   NOP_Process
-#define  EP3_IN_Callback   NOP_Process
-#define  EP4_IN_Callback   NOP_Process
-#define  EP5_IN_Callback   NOP_Process
-#define  EP6_IN_Callback   NOP_Process
-#define  EP7_IN_Callback   NOP_Process
-
-#define  EP1_OUT_Callback   NOP_Process
-#define  EP2_OUT_Callback   NOP_Process
-/*#define  EP3_OUT_Callback   NOP_Process*/		/* 本例程使用了 EP1_IN */
-#define  EP4_OUT_Callback   NOP_Process
-#define  EP5_OUT_Callback   NOP_Process
-#define  EP6_OUT_Callback   NOP_Process
-#define  EP7_OUT_Callback   NOP_Process
-
-#endif /* __USB_CONF_H */
+/*
+*********************************************************************************************************
+*
+*	模块名称 : 主程序模块。
+*	文件名称 : usb_conf.h
+*	版    本 : V2.0
+*	说    明 : USB虚拟串口模块头文件
+*	修改记录 :
+*		版本号  日期       作者    说明
+*		v1.0    2011-08-27 armfly  ST固件库V3.5.0版本。
+*		v2.0    2011-10-16 armfly  优化工程结构。
+*		v2.1    2026-10-17 armfly  增加 USB_DBL_BUF_EN, EP1 IN 和 EP3 OUT 可选双缓冲; 重新分配PMA。
+*		v2.2    2026-10-17 armfly  增加 USB_COMPOSITE_EN, 复合设备: 2个CDC虚拟串口 + 1个厂商自定义批量接口。
+*		v2.3    2026-10-17 armfly  增加 USB_BRIDGE_EN, CDC虚拟串口2 桥接到 USART2。
+*		v2.4    2026-10-17         复合设备使用自己的PID (USB_PID_COMPOSITE); 日志从 USB_COM2 发出。
+*		v2.5    2026-10-17         USB_COMPOSITE_EN / USB_BRIDGE_EN 可以由编译选项定义 (Keil 目标 103ZE_Bridge)。
+*
+*	Copyright (C), 2010-2011, 安富莱电子 www.armfly.com
+*
+*********************************************************************************************************
+*/
+
+#ifndef __USB_CONF_H
+#define __USB_CONF_H
+
+/*
+	1 表示复合设备 (用IAD描述符组合多个功能):
+		接口0/1 : CDC虚拟串口1, 命令通道      EP1 IN(批量), EP3 OUT(批量), EP2 IN(中断通知)
+		接口2/3 : CDC虚拟串口2, 调试打印通道或串口桥接  EP4 IN/OUT(批量, 同一个端点寄存器), EP7 IN(中断通知)
+				  BSP_Printf() 的日志从这里发出 (见 bsp_log.h 中 LOG_USB_EN), 不再占用串口1
+		接口4   : 厂商自定义批量接口, 二进制数据流, 没有CDC的线路编码等控制请求  EP5 IN, EP6 OUT
+	  PC端需要为接口4安装 WinUSB/libusb 驱动 (例如用 Zadig), Linux 可直接用 libusb 访问。
+	  复合设备的代价 (PMA只有512字节, 8个端点分用):
+		- EP1 IN / EP3 OUT 不能使用双缓冲 (USB_DBL_BUF_EN 强制为0), 命令通道的吞吐量低于单CDC;
+		- 控制端点 EP0 最大包长从64减小到32字节, 枚举和线路编码请求需要更多的包;
+		- 命令通道的收发FIFO从各2KB减小到各1KB, 其余RAM分给 USB_COM2 和厂商接口;
+		- PID 和单CDC不同 (USB_PID_COMPOSITE), 主机按PID分别记住两种配置的驱动绑定, 切换配置不需要卸载设备。
+	0 表示只有一个CDC虚拟串口 (原来的配置), 缺省值。
+	编译选项中已经定义时 (例如 Keil 目标 103ZE_Bridge) 以编译选项为准。
+*/
+#ifndef USB_COMPOSITE_EN
+	#define USB_COMPOSITE_EN	0
+#endif
+
+/* 设备描述符中的VID/PID。单CDC是产品使用的PID; 复合设备的接口组成不同, 使用另一个PID */
+#define USB_VID				0x0483
+#define USB_PID_CDC			0x5740
+#define USB_PID_COMPOSITE	0x5741
+
+/*
+	1 表示USB转串口桥接模式: CDC虚拟串口2 (USB_COM2) 和 USART2 (COM2, GPRS模块) 之间的数据在中断中
+	直接转发, 不经过主程序。PC设置的波特率等线路编码用于配置USART2, DTR/RTS 输出到GPIO (见 usb_bridge.h)。
+	需要复合设备 (USB_COMPOSITE_EN = 1), 单CDC时唯一的虚拟串口是命令通道。
+	缺省关闭: 打开后 USART2 归桥接使用, USB中断的抢占优先级提高到和串口相同。
+	Keil 目标 103ZE_Bridge 在编译选项中定义 USB_COMPOSITE_EN=1, USB_BRIDGE_EN=1, 主机端测试见 Tests/test_usb_bridge.c。
+*/
+#ifndef USB_BRIDGE_EN
+	#define USB_BRIDGE_EN		0
+#endif
+
+#if USB_BRIDGE_EN == 1 && USB_COMPOSITE_EN == 0
+	#error "USB_BRIDGE_EN requires USB_COMPOSITE_EN"
+#endif
+
+/*
+	1 表示批量端点 EP1 IN 和 EP3 OUT 使用双缓冲。USB模块收发一个缓冲区的同时，CPU读写另一个缓冲区，
+	主机连续发起的事务不必等待CPU拷贝数据。双缓冲批量端点的传输完成中断由 USB_HP_CAN1_TX_IRQn 产生。
+	0 表示使用单缓冲，每个包处理完之前端点回应NAK。
+	复合设备有8个端点, 512字节的PMA放不下双缓冲, 只能使用单缓冲。
+*/
+#if USB_COMPOSITE_EN == 1
+	#define USB_DBL_BUF_EN		0
+#else
+	#define USB_DBL_BUF_EN		1
+#endif
+
+#if USB_COMPOSITE_EN == 1
+	#define EP_NUM				(8)		/* 定义USB设备使用了几个端点 */
+	#define USB_EP0_SIZE		32		/* 控制端点最大包长, 减小到32字节为其他端点节省PMA */
+#else
+	#define EP_NUM				(4)		/* 定义USB设备使用了几个端点 */
+	#define USB_EP0_SIZE		64		/* 控制端点最大包长 */
+#endif
+
+/*
+	1 表示用DWT周期计数器统计 EP1_IN_Callback、EP3_OUT_Callback 每个包的执行时间 (g_tUsbTxCycle, g_tUsbRxCycle),
+	并在 bsp_InitUsb() 中测量PMA拷贝函数新旧实现的速度 (g_tUsbPmaBench), 见 hw_config.h
+*/
+#define USB_CYCLE_STAT_EN	0
+
+/*-------------------------------------------------------------*/
+/* --------------   Buffer Description Table  -----------------*/
+/*-------------------------------------------------------------*/
+/* buffer table base address */
+/* buffer table base address */
+#define BTABLE_ADDRESS      (0x00)
+
+/*
+	PMA共512字节(USB模块的16位地址)。
+	单CDC: 0x00-0x1F 为4个端点的缓冲区描述表, EP0收发各64字节; 双缓冲时 EP1、EP3 各占 2 x 64 字节, 一直用到 0x1D0。
+	复合设备: 0x00-0x3F 为8个端点的缓冲区描述表, EP0收发各32字节, 批量端点单缓冲, 一直用到 0x1F0。
+*/
+#if USB_COMPOSITE_EN == 1
+	#define ENDP0_RXADDR        (0x40)
+	#define ENDP0_TXADDR        (0x60)
+	#define ENDP1_TXADDR        (0x80)		/* CDC1 数据 IN, 64字节 */
+	#define ENDP2_TXADDR        (0xC0)		/* CDC1 通知, 8字节 */
+	#define ENDP3_RXADDR        (0xC8)		/* CDC1 数据 OUT, 64字节 */
+	#define ENDP4_TXADDR        (0x108)		/* CDC2 数据 IN, 64字节 */
+	#define ENDP4_RXADDR        (0x148)		/* CDC2 数据 OUT, 32字节 (调试口, 主要是设备->PC) */
+	#define ENDP5_TXADDR        (0x168)		/* 厂商接口 IN, 64字节 */
+	#define ENDP6_RXADDR        (0x1A8)		/* 厂商接口 OUT, 64字节 */
+	#define ENDP7_TXADDR        (0x1E8)		/* CDC2 通知, 8字节 */
+#elif USB_DBL_BUF_EN == 1
+	#define ENDP0_RXADDR        (0x40)
+	#define ENDP0_TXADDR        (0x80)
+	#define ENDP2_TXADDR        (0xC0)		/* 中断端点, 8字节, 预留16字节 */
+	#define ENDP1_BUF0ADDR      (0xD0)		/* EP1 IN 缓冲区0 */
+	#define ENDP1_BUF1ADDR      (0x110)		/* EP1 IN 缓冲区1 */
+	#define ENDP3_BUF0ADDR      (0x150)		/* EP3 OUT 缓冲区0 */
+	#define ENDP3_BUF1ADDR      (0x190)		/* EP3 OUT 缓冲区1 */
+#else
+	#define ENDP0_RXADDR        (0x40)
+	#define ENDP0_TXADDR        (0x80)
+	#define ENDP1_TXADDR        (0xC0)
+	#define ENDP2_TXADDR        (0x100)
+	#define ENDP3_RXADDR        (0x110)
+#endif
+
+
+/*-------------------------------------------------------------*/
+/* -------------------   ISTR events  -------------------------*/
+/*-------------------------------------------------------------*/
+/* 定义应用软件用到的USB事件 */
+#define IMR_MSK (CNTR_CTRM  | CNTR_RESETM )		/* EP1 IN 由传输完成中断驱动, 不需要SOF中断 */
+
+/*#define CTR_CALLBACK*/
+/*#define DOVR_CALLBACK*/
+/*#define ERR_CALLBACK*/
+/*#define WKUP_CALLBACK*/
+/*#define SUSP_CALLBACK*/
+/*#define RESET_CALLBACK*/
+/*#define SOF_CALLBACK*/
+/*#define ESOF_CALLBACK*/
+
+/* CTR 服务程序, 未用的端点回调函数定义为空操作 */
+/*#define  EP1_IN_Callback   NOP_Process */		/* 本例程使用了 EP1_IN */
+#define  EP2_IN_Callback   NOP_Process
+#define  EP3_IN_Callback   NOP_Process
+#if USB_COMPOSITE_EN == 0
+	#define  EP4_IN_Callback   NOP_Process
+	#define  EP5_IN_Callback   NOP_Process
+#endif
+#define  EP6_IN_Callback   NOP_Process
+#define  EP7_IN_Callback   NOP_Process
+
+#define  EP1_OUT_Callback   NOP_Process
+#define  EP2_OUT_Callback   NOP_Process
+/*#define  EP3_OUT_Callback   NOP_Process*/		/* 本例程使用了 EP3_OUT */
+#if USB_COMPOSITE_EN == 0
+	#define  EP4_OUT_Callback   NOP_Process
+	#define  EP6_OUT_Callback   NOP_Process
+#endif
+#define  EP5_OUT_Callback   NOP_Process
+#define  EP7_OUT_Callback   NOP_Process
+
+#endif /* __USB_CONF_H */
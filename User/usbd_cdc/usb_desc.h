@@ -1,43 +1,54 @@
-/*
-*********************************************************************************************************
-*	                                  
-*	模块名称 : USB设备描述符模块    
-*	文件名称 : usb_istr.h
-*	版    本 : V2.0
-*	USB固件库驱动 : V3.3.0
-*	说    明 : 头文件
-*
-*	Copyright (C), 2010-2011, 安富莱电子 www.armfly.com
-*
-*********************************************************************************************************
-*/
-#ifndef __USB_DESC_H
-#define __USB_DESC_H
-
-#define USB_DEVICE_DESCRIPTOR_TYPE              0x01
-#define USB_CONFIGURATION_DESCRIPTOR_TYPE       0x02
-#define USB_STRING_DESCRIPTOR_TYPE              0x03
-#define USB_INTERFACE_DESCRIPTOR_TYPE           0x04
-#define USB_ENDPOINT_DESCRIPTOR_TYPE            0x05
-
-#define VIRTUAL_COM_PORT_DATA_SIZE              64
-#define VIRTUAL_COM_PORT_INT_SIZE               8
-
-#define VIRTUAL_COM_PORT_SIZ_DEVICE_DESC        18
-#define VIRTUAL_COM_PORT_SIZ_CONFIG_DESC        67
-#define VIRTUAL_COM_PORT_SIZ_STRING_LANGID      4
-#define VIRTUAL_COM_PORT_SIZ_STRING_VENDOR      38
-#define VIRTUAL_COM_PORT_SIZ_STRING_PRODUCT     50
-#define VIRTUAL_COM_PORT_SIZ_STRING_SERIAL      26
-
-#define STANDARD_ENDPOINT_DESC_SIZE             0x09
-
-extern const uint8_t Virtual_Com_Port_DeviceDescriptor[VIRTUAL_COM_PORT_SIZ_DEVICE_DESC];
-extern const uint8_t Virtual_Com_Port_ConfigDescriptor[VIRTUAL_COM_PORT_SIZ_CONFIG_DESC];
-
-extern const uint8_t Virtual_Com_Port_StringLangID[VIRTUAL_COM_PORT_SIZ_STRING_LANGID];
-extern const uint8_t Virtual_Com_Port_StringVendor[VIRTUAL_COM_PORT_SIZ_STRING_VENDOR];
-extern const uint8_t Virtual_Com_Port_StringProduct[VIRTUAL_COM_PORT_SIZ_STRING_PRODUCT];
-extern uint8_t Virtual_Com_Port_StringSerial[VIRTUAL_COM_PORT_SIZ_STRING_SERIAL];
-
-#endif /* __USB_DESC_H */
+/*
+*********************************************************************************************************
+*	                                  
+*	模块名称 : USB设备描述符模块    
+*	文件名称 : usb_istr.h
+*	版    本 : V2.0
+*	USB固件库驱动 : V3.3.0
+*	说    明 : 头文件
+*
+*	Copyright (C), 2010-2011, 安富莱电子 www.armfly.com
+*
+*********************************************************************************************************
+*/
+#ifndef __USB_DESC_H
+#define __USB_DESC_H
+
+#include "usb_conf.h"
+
+#define USB_DEVICE_DESCRIPTOR_TYPE              0x01
+#define USB_CONFIGURATION_DESCRIPTOR_TYPE       0x02
+#define USB_STRING_DESCRIPTOR_TYPE              0x03
+#define USB_INTERFACE_DESCRIPTOR_TYPE           0x04
+#define USB_ENDPOINT_DESCRIPTOR_TYPE            0x05
+
+#define VIRTUAL_COM_PORT_DATA_SIZE              64
+#define VIRTUAL_COM_PORT_INT_SIZE               8
+#define VIRTUAL_COM_PORT_DBG_OUT_SIZE           32		/* 复合设备CDC2(调试口)的OUT包长, 节省PMA */
+
+#define VIRTUAL_COM_PORT_SIZ_DEVICE_DESC        18
+#if USB_COMPOSITE_EN == 1
+	#define VIRTUAL_COM_PORT_SIZ_CONFIG_DESC    164		/* 9 + 2 x (IAD 8 + CDC 58) + 厂商接口 23 */
+	#define VIRTUAL_COM_PORT_NUM_INTERFACE      5		/* 接口0-3: 2个CDC虚拟串口, 接口4: 厂商自定义批量接口 */
+	#define VIRTUAL_COM_PORT_NUM_CDC            2
+#else
+	#define VIRTUAL_COM_PORT_SIZ_CONFIG_DESC    67
+	#define VIRTUAL_COM_PORT_NUM_INTERFACE      2
+	#define VIRTUAL_COM_PORT_NUM_CDC            1
+#endif
+#define VIRTUAL_COM_PORT_SIZ_STRING_LANGID      4
+#define VIRTUAL_COM_PORT_SIZ_STRING_VENDOR      38
+#define VIRTUAL_COM_PORT_SIZ_STRING_PRODUCT     50
+#define VIRTUAL_COM_PORT_SIZ_STRING_SERIAL      26
+
+#define STANDARD_ENDPOINT_DESC_SIZE             0x09
+
+extern const uint8_t Virtual_Com_Port_DeviceDescriptor[VIRTUAL_COM_PORT_SIZ_DEVICE_DESC];
+extern const uint8_t Virtual_Com_Port_ConfigDescriptor[VIRTUAL_COM_PORT_SIZ_CONFIG_DESC];
+
+extern const uint8_t Virtual_Com_Port_StringLangID[VIRTUAL_COM_PORT_SIZ_STRING_LANGID];
+extern const uint8_t Virtual_Com_Port_StringVendor[VIRTUAL_COM_PORT_SIZ_STRING_VENDOR];
+extern const uint8_t Virtual_Com_Port_StringProduct[VIRTUAL_COM_PORT_SIZ_STRING_PRODUCT];
+extern uint8_t Virtual_Com_Port_StringSerial[VIRTUAL_COM_PORT_SIZ_STRING_SERIAL];
+
+#endif /* __USB_DESC_H */
@@ -1,130 +1,427 @@
-#include "usb_lib.h"
-#include "usb_desc.h"
-#include "usb_mem.h"
-#include "hw_config.h"
-#include "usb_istr.h"
-#include "usb_pwr.h"
-
-/* Interval between sending IN packets in frame number (1 frame = 1ms) */
-#define VCOMPORT_IN_FRAME_INTERVAL             5
-
-extern  uint8_t USART_Rx_Buffer[];
-extern uint32_t USART_Rx_ptr_out;
-extern uint32_t USART_Rx_length;
-extern uint8_t  USB_Tx_State;
-
-/*
-*********************************************************************************************************
-*	函 数 名: EP1_IN_Callback
-*	功能说明: 端点1 IN包（设备->PC）回调函数
-*	形    参: 无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void EP1_IN_Callback (void)
-{
-	/*
-	为了提高传输效率，并且方便FIFO操作，将 UserToPMABufferCopy() 函数就地展开 
-	void UserToPMABufferCopy(uint8_t *pbUsrBuf, uint16_t wPMABufAddr, uint16_t wNBytes)
-	{
-	  uint32_t n = (wNBytes + 1) >> 1;
-	  uint32_t i, temp1, temp2;
-	  uint16_t *pdwVal;
-	  pdwVal = (uint16_t *)(wPMABufAddr * 2 + PMAAddr);
-	  for (i = n; i != 0; i--)
-	  {
-	    temp1 = (uint16_t) * pbUsrBuf;
-	    pbUsrBuf++;
-	    temp2 = temp1 | (uint16_t) * pbUsrBuf << 8;
-	    *pdwVal++ = temp2;
-	    pdwVal++;
-	    pbUsrBuf++;
-	  }
-	}		
-	*/
-	uint16_t i;
-	uint16_t usWord;
-	uint8_t ucByteNum;
-	uint16_t *pdwVal;
-	uint16_t usTotalSize;
-	
-	usTotalSize = 0;
-	pdwVal = (uint16_t *)(ENDP1_TXADDR * 2 + PMAAddr);	
-	for (i = 0 ; i < VIRTUAL_COM_PORT_DATA_SIZE / 2; i++)
-	{
-		usWord = usb_GetTxWord(&ucByteNum);
-		if (ucByteNum == 0)
-		{
-			break;
-		}
-		
-		usTotalSize += ucByteNum;
-		
-		*pdwVal++ = usWord;
-		pdwVal++;		
-
-		/*
-			STM32的USB缓冲区是一个双端口的RAM，CPU一端需要使用32位方式访问，但USB模块一端使用16位方式访问。
-			也就是说每个USB模块中的地址*2才能对应到控制器中的实际地址，这样每四个字节地址空间后两个字节
-			地址空间是空的
-		*/
-	}
-	
-	if (usTotalSize == 0)
-	{
-		return;
-	}
-	
-	SetEPTxCount(ENDP1, usTotalSize);
-	SetEPTxValid(ENDP1); 
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: EP3_OUT_Callback
-*	功能说明: 端点3 OUT包（PC->设备）回调函数
-*	形    参: 无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void EP3_OUT_Callback(void)
-{
-	uint16_t usRxCnt;
-	uint8_t USB_Rx_Buffer[VIRTUAL_COM_PORT_DATA_SIZE];
-	
-	/* 将USB端点3收到的数据存储到USB_Rx_Buffer， 数据大小保存在USB_Rx_Cnt */
-	usRxCnt = USB_SIL_Read(EP3_OUT, USB_Rx_Buffer);
-	
-	/* 立即将接收到的数据缓存到内存 */
-	usb_SaveHostDataToBuf(USB_Rx_Buffer, usRxCnt);
-	
-	/* 允许 EP3 端点接收数据 */
-	SetEPRxValid(ENDP3);
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: SOF_Callback
-*	功能说明: SOF回调函数  .SOF是host用来指示frame的开头的。
-*	形    参: 无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void SOF_Callback(void)
-{
-	static uint32_t FrameCount = 0;
-	
-	if (bDeviceState == CONFIGURED)
-	{
-		if (FrameCount++ == VCOMPORT_IN_FRAME_INTERVAL)
-		{
-			/* Reset the frame counter */
-			FrameCount = 0;
-			
-			/* Check the data to be sent through IN pipe */
-			EP1_IN_Callback();
-			//Handle_USBAsynchXfer();
-		}
-	}  
-}
-
+#include "usb_lib.h"
+#include "usb_desc.h"
+#include "usb_mem.h"
+#include "hw_config.h"
+#include "usb_istr.h"
+#include "usb_pwr.h"
+#include "bsp.h"
+
+/*
+	EP1 IN (设备->PC) 采用完成驱动:
+	(1) 主机确认(ACK)一个包后 EP1_IN_Callback() 立即从发送FIFO装入下一个包, 不再等待SOF轮询;
+	(2) 发送FIFO为空时端点空闲, usb_SendDataToHost() 写入数据后调用 usb_StartTx() 启动发送;
+	(3) 最后一个包正好是64字节时补发一个零长度包, 使主机的读操作及时结束。
+
+	USB_DBL_BUF_EN = 1 时 EP1 IN 和 EP3 OUT 为双缓冲 (见 usb_conf.h):
+	(1) EP1: USB模块发送一个缓冲区时, 程序预先把下一个包装入另一个缓冲区(ucTxReady = 1)。
+	    发送完成中断只需翻转 SW_BUF 把它交给USB模块, 拷贝数据的时间不再占用总线;
+	(2) EP3: 接收完成中断先翻转 SW_BUF, 把上次读完的缓冲区还给USB模块, 再读取刚收到的缓冲区。
+	    CPU拷贝数据时USB模块可以接收下一个包。
+
+	EP3 OUT 流量控制: 接收FIFO放不下一个满包(64字节)时不再接收, 端点回应NAK, 主机自动重试。
+	主程序读走数据后调用 usb_ResumeRx() 恢复接收, 因此主机大量下发数据时不会丢数据。
+
+	复合设备 (USB_COMPOSITE_EN = 1) 的每个端口 (见 hw_config.h 的 USB_PORT_E) 都使用同样的收发流程,
+	各自有独立的FIFO、端点和NAK流量控制, 端点回调函数只是选择端口:
+		USB_COM1   : EP1 IN, EP3 OUT
+		USB_COM2   : EP4 IN/OUT
+		USB_VENDOR : EP5 IN, EP6 OUT
+*/
+
+/*
+*********************************************************************************************************
+*	函 数 名: UsbFillPMA
+*	功能说明: 从端口的发送FIFO取出最多64字节写入PMA缓冲区。FIFO中的数据最多分两段连续空间(环绕处),
+*			  每段用 UserToPMABufferCopy() 整段拷贝。在USB中断或关中断状态下调用。
+*	形    参: _pPort : 端口
+*			  _usAddr : PMA缓冲区地址 (USB模块一侧的地址)
+*			  _pusLen : 返回包长度
+*	返 回 值: 1 表示已经装入一个包(包括零长度包), 0 表示没有数据需要发送
+*********************************************************************************************************
+*/
+static uint8_t UsbFillPMA(USB_COM_FIFO_T *_pPort, uint16_t _usAddr, uint16_t *_pusLen)
+{
+	uint16_t usTotalSize;
+	uint16_t usSpan;
+	uint8_t *pBuf;
+	
+	/*
+		STM32的USB缓冲区是一个双端口的RAM，CPU一端需要使用32位方式访问，但USB模块一端使用16位方式访问。
+		拷贝函数负责地址换算; 第一段长度为奇数时, 第二段从PMA奇地址开始, 拷贝函数会保留前一个字节。
+	*/
+	usTotalSize = 0;
+	while (usTotalSize < VIRTUAL_COM_PORT_DATA_SIZE)
+	{
+		usSpan = bsp_RingPeekSpan(&_pPort->tTxRing, &pBuf);
+		if (usSpan == 0)
+		{
+			break;
+		}
+		if (usSpan > VIRTUAL_COM_PORT_DATA_SIZE - usTotalSize)
+		{
+			usSpan = VIRTUAL_COM_PORT_DATA_SIZE - usTotalSize;
+		}
+		
+		UserToPMABufferCopy(pBuf, _usAddr + usTotalSize, usSpan);
+		bsp_RingConsume(&_pPort->tTxRing, usSpan);
+		usTotalSize += usSpan;
+	}
+	
+	if (usTotalSize == 0)
+	{
+		if (_pPort->ucTxZlp == 0)
+		{
+			return 0;
+		}
+		_pPort->ucTxZlp = 0;		/* 上一个是满包, 补发零长度包 */
+	}
+	else
+	{
+		_pPort->ucTxZlp = (usTotalSize == VIRTUAL_COM_PORT_DATA_SIZE);
+	}
+	
+	*_pusLen = usTotalSize;
+	return 1;
+}
+
+#if USB_DBL_BUF_EN == 1
+/*
+*********************************************************************************************************
+*	函 数 名: UsbLoadPacket
+*	功能说明: 把下一个包装入程序一侧的缓冲区 (SW_BUF 指向的缓冲区), 暂不交给USB模块。
+*	形    参: _pPort : 端口
+*	返 回 值: 1 表示已经装入一个包(包括零长度包), 0 表示没有数据需要发送
+*********************************************************************************************************
+*/
+static uint8_t UsbLoadPacket(USB_COM_FIFO_T *_pPort)
+{
+	uint16_t usLen;
+
+	if (GetENDPOINT(_pPort->ucTxEp) & EP_DTOG_RX)	/* IN端点的 SW_BUF 位在 DTOG_RX 位置 */
+	{
+		if (UsbFillPMA(_pPort, _pPort->usTxAddr[1], &usLen) == 0)
+		{
+			return 0;
+		}
+		SetEPDblBuf1Count(_pPort->ucTxEp, EP_DBUF_IN, usLen);
+	}
+	else
+	{
+		if (UsbFillPMA(_pPort, _pPort->usTxAddr[0], &usLen) == 0)
+		{
+			return 0;
+		}
+		SetEPDblBuf0Count(_pPort->ucTxEp, EP_DBUF_IN, usLen);
+	}
+	return 1;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: UsbPump
+*	功能说明: USB模块空闲时把装好的包交给它发送, 然后预装下一个包。在USB中断或关中断状态下调用。
+*	形    参: _pPort : 端口
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void UsbPump(USB_COM_FIFO_T *_pPort)
+{
+	if (_pPort->ucTxBusy == 0)
+	{
+		if (_pPort->ucTxReady == 0)
+		{
+			_pPort->ucTxReady = UsbLoadPacket(_pPort);
+			if (_pPort->ucTxReady == 0)
+			{
+				return;		/* 没有数据, 端点保持空闲 */
+			}
+		}
+
+		FreeUserBuffer(_pPort->ucTxEp, EP_DBUF_IN);	/* 翻转 SW_BUF, 装好的缓冲区交给USB模块 */
+		_pPort->ucTxReady = 0;
+		_pPort->ucTxBusy = 1;
+	}
+
+	if (_pPort->ucTxReady == 0)
+	{
+		_pPort->ucTxReady = UsbLoadPacket(_pPort);	/* 趁USB模块发送时预装下一个包 */
+	}
+}
+#else
+/*
+*********************************************************************************************************
+*	函 数 名: UsbLoadPacket
+*	功能说明: 从端口的发送FIFO装入一个包并使能发送。在USB中断或关中断状态下调用。
+*	形    参: _pPort : 端口
+*	返 回 值: 1 表示已经装入一个包(包括零长度包), 0 表示没有数据需要发送
+*********************************************************************************************************
+*/
+static uint8_t UsbLoadPacket(USB_COM_FIFO_T *_pPort)
+{
+	uint16_t usLen;
+
+	if (UsbFillPMA(_pPort, _pPort->usTxAddr[0], &usLen) == 0)
+	{
+		return 0;
+	}
+	SetEPTxCount(_pPort->ucTxEp, usLen);
+	SetEPTxValid(_pPort->ucTxEp); 
+	return 1;
+}
+#endif
+
+/*
+*********************************************************************************************************
+*	函 数 名: UsbTxDone
+*	功能说明: IN端点上一个包发送完成, 立即装入下一个包。在IN端点回调函数中调用。
+*	形    参: _pPort : 端口
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void UsbTxDone(USB_COM_FIFO_T *_pPort)
+{
+#if USB_DBL_BUF_EN == 1
+	_pPort->ucTxBusy = 0;
+	UsbPump(_pPort);
+#else
+	_pPort->ucTxBusy = UsbLoadPacket(_pPort);
+#endif
+
+	if (_pPort->TxLow)
+	{
+		_pPort->TxLow();	/* 发送FIFO有了空间, 通知数据源继续写入 */
+	}
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: usb_StartTx
+*	功能说明: 端口的IN端点空闲时启动发送。被 usb_PortSend() 调用; 设备配置完成时也调用一次, 发送配置前缓存的数据。
+*			  可以在中断中调用。
+*	形    参: _pPort : 端口
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void usb_StartTx(USB_COM_FIFO_T *_pPort)
+{
+	uint32_t ulPrimask;
+
+	ulPrimask = __get_PRIMASK();	/* 桥接回调在中断中调用本函数, 保存并恢复 PRIMASK */
+	DISABLE_INT();		/* 和IN端点回调函数互斥 */
+
+#if USB_DBL_BUF_EN == 1
+	if (bDeviceState == CONFIGURED)
+	{
+		UsbPump(_pPort);		/* 发送中也可以预装下一个包 */
+	}
+#else
+	if (_pPort->ucTxBusy == 0 && bDeviceState == CONFIGURED)
+	{
+		_pPort->ucTxBusy = UsbLoadPacket(_pPort);
+	}
+#endif
+
+	__set_PRIMASK(ulPrimask);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: UsbReadPacket
+*	功能说明: 读取OUT端点收到的一个包, 从PMA直接解包到接收FIFO的连续空间, 不经过中间缓冲区。
+*			  包跨越FIFO末尾时分两段拷贝。调用前接收FIFO至少要有一个满包的空间。
+*			  在USB中断或关中断状态下调用。
+*	形    参: _pPort : 端口
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void UsbReadPacket(USB_COM_FIFO_T *_pPort)
+{
+	uint16_t usRxCnt;
+	uint16_t usAddr;
+	uint16_t usSpan;
+	uint8_t *pBuf;
+	
+#if USB_DBL_BUF_EN == 1
+	/* 翻转 SW_BUF: 上次读完的缓冲区交给USB模块继续接收, SW_BUF 随之指向刚收到数据的缓冲区 */
+	FreeUserBuffer(_pPort->ucRxEp, EP_DBUF_OUT);
+
+	if (GetENDPOINT(_pPort->ucRxEp) & EP_DTOG_TX)	/* OUT端点的 SW_BUF 位在 DTOG_TX 位置 */
+	{
+		usRxCnt = GetEPDblBuf1Count(_pPort->ucRxEp);
+		usAddr = _pPort->usRxAddr[1];
+	}
+	else
+	{
+		usRxCnt = GetEPDblBuf0Count(_pPort->ucRxEp);
+		usAddr = _pPort->usRxAddr[0];
+	}
+#else
+	usRxCnt = GetEPRxCount(_pPort->ucRxEp);
+	usAddr = _pPort->usRxAddr[0];
+#endif
+
+	usSpan = bsp_RingReserveSpan(&_pPort->tRxRing, &pBuf);
+	if (usSpan < usRxCnt)
+	{
+		/* 写索引到FIFO末尾放不下整个包, 先拷贝前一段, 剩余部分从FIFO开头继续 */
+		PMAToUserBufferCopy(pBuf, usAddr, usSpan);
+		bsp_RingCommit(&_pPort->tRxRing, usSpan);
+		usAddr += usSpan;
+		usRxCnt -= usSpan;
+		bsp_RingReserveSpan(&_pPort->tRxRing, &pBuf);
+	}
+	PMAToUserBufferCopy(pBuf, usAddr, usRxCnt);
+	bsp_RingCommit(&_pPort->tRxRing, usRxCnt);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: UsbRxDone
+*	功能说明: OUT端点收到一个包。接收FIFO放不下下一个包时端点保持NAK, 主机暂停发送,
+*			  主程序读走数据后由 usb_ResumeRx() 恢复接收。在OUT端点回调函数中调用。
+*	形    参: _pPort : 端口
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void UsbRxDone(USB_COM_FIFO_T *_pPort)
+{
+#if USB_DBL_BUF_EN == 1
+	/*
+		双缓冲时USB模块已经在用另一个缓冲区接收。FIFO空间不足时先不读这个包, 也不翻转 SW_BUF,
+		两个缓冲区都被占用, 端点自动回应NAK, 数据留在PMA中不会丢失。
+	*/
+	if (bsp_RingFree(&_pPort->tRxRing) < _pPort->usRxPktSize)
+	{
+		_pPort->ucRxNak = 1;
+	}
+	else
+	{
+		UsbReadPacket(_pPort);
+	}
+#else
+	/* 单缓冲时收到包后端点已自动变为NAK, 读走数据后只有FIFO还能放下一个满包才允许接收 */
+	UsbReadPacket(_pPort);
+	if (bsp_RingFree(&_pPort->tRxRing) < _pPort->usRxPktSize)
+	{
+		_pPort->ucRxNak = 1;
+	}
+	else
+	{
+		SetEPRxValid(_pPort->ucRxEp);		/* 允许OUT端点接收数据 */
+	}
+#endif
+
+	if (_pPort->ReciveNew)
+	{
+		_pPort->ReciveNew();	/* 通知数据的使用者, 例如串口桥接立即转发 */
+	}
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: usb_ResumeRx
+*	功能说明: 端口的OUT端点因接收FIFO满处于NAK状态时, 如果FIFO已能放下一个满包, 则恢复接收。
+*			  主程序从接收FIFO读取数据后调用, 也可以在中断中调用 (串口桥接)。
+*	形    参: _pPort : 端口
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void usb_ResumeRx(USB_COM_FIFO_T *_pPort)
+{
+	uint32_t ulPrimask;
+
+	ulPrimask = __get_PRIMASK();	/* 桥接回调在中断中调用本函数, 保存并恢复 PRIMASK */
+	DISABLE_INT();		/* 和OUT端点回调函数互斥 */
+
+	if (_pPort->ucRxNak == 1 && bsp_RingFree(&_pPort->tRxRing) >= _pPort->usRxPktSize)
+	{
+		_pPort->ucRxNak = 0;
+	#if USB_DBL_BUF_EN == 1
+		UsbReadPacket(_pPort);	/* 读走滞留在PMA中的包, 同时把另一个缓冲区交给USB模块 */
+	#else
+		SetEPRxValid(_pPort->ucRxEp);
+	#endif
+	}
+
+	__set_PRIMASK(ulPrimask);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: EP1_IN_Callback
+*	功能说明: 端点1 IN包（设备->PC）回调函数。USB_COM1 上一个包发送完成, 立即装入下一个包。
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void EP1_IN_Callback (void)
+{
+#if USB_CYCLE_STAT_EN == 1
+	uint32_t ulStart = DWT->CYCCNT;
+#endif
+
+	UsbTxDone(&g_tUsbFifo[USB_COM1]);
+
+#if USB_CYCLE_STAT_EN == 1
+	usb_CycleStat(&g_tUsbTxCycle, DWT->CYCCNT - ulStart);
+#endif
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: EP3_OUT_Callback
+*	功能说明: 端点3 OUT包（PC->设备）回调函数。USB_COM1 收到一个包。
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void EP3_OUT_Callback(void)
+{
+#if USB_CYCLE_STAT_EN == 1
+	uint32_t ulStart = DWT->CYCCNT;
+#endif
+
+	UsbRxDone(&g_tUsbFifo[USB_COM1]);
+
+#if USB_CYCLE_STAT_EN == 1
+	usb_CycleStat(&g_tUsbRxCycle, DWT->CYCCNT - ulStart);
+#endif
+}
+
+#if USB_COMPOSITE_EN == 1
+/*
+*********************************************************************************************************
+*	函 数 名: EP4_IN_Callback / EP4_OUT_Callback
+*	功能说明: 端点4 回调函数, USB_COM2 (调试打印通道)。IN 和 OUT 共用端点4。
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void EP4_IN_Callback(void)
+{
+	UsbTxDone(&g_tUsbFifo[USB_COM2]);
+}
+
+void EP4_OUT_Callback(void)
+{
+	UsbRxDone(&g_tUsbFifo[USB_COM2]);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: EP5_IN_Callback / EP6_OUT_Callback
+*	功能说明: 端点5 IN、端点6 OUT 回调函数, USB_VENDOR (厂商自定义批量接口)。
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void EP5_IN_Callback(void)
+{
+	UsbTxDone(&g_tUsbFifo[USB_VENDOR]);
+}
+
+void EP6_OUT_Callback(void)
+{
+	UsbRxDone(&g_tUsbFifo[USB_VENDOR]);
+}
+#endif
@@ -1,155 +1,155 @@
-#include "stm32f10x.h"
-#include "usb_type.h"
-#include "usb_regs.h"
-#include "usb_pwr.h"
-#include "usb_istr.h"
-#include "usb_init.h"
-#include "usb_int.h"
-#include "usb_lib.h"
-
-__IO uint16_t wIstr;  /* ISTR register last read value */
-__IO uint8_t bIntPackSOF = 0;  /* SOFs received between 2 consecutive packets */
-
-/* 函数指针数组，每个端点服务的执行函数列表 */
-void (*pEpInt_IN[7])(void) =
-{
-	EP1_IN_Callback,
-	EP2_IN_Callback,
-	EP3_IN_Callback,
-	EP4_IN_Callback,
-	EP5_IN_Callback,
-	EP6_IN_Callback,
-	EP7_IN_Callback,
-};
-
-void (*pEpInt_OUT[7])(void) =
-{
-	EP1_OUT_Callback,
-	EP2_OUT_Callback,
-	EP3_OUT_Callback,
-	EP4_OUT_Callback,
-	EP5_OUT_Callback,
-	EP6_OUT_Callback,
-	EP7_OUT_Callback,
-};
-
-/*
-*********************************************************************************************************
-*	函 数 名: usb_Istr
-*	功能说明: USB ISTR 中断服务程序
-*	形    参: 无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void usb_Istr(void)
-{
-	wIstr = _GetISTR();
-
-#if (IMR_MSK & ISTR_CTR)
-	if (wIstr & ISTR_CTR & wInterrupt_Mask)
-	{
-		/* servicing of the endpoint correct transfer interrupt */
-		/* clear of the CTR flag into the sub */
-		CTR_LP();
-	#ifdef CTR_CALLBACK
-	    CTR_Callback();
-	#endif
-  	}
-#endif  
-
-	/*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*/
-#if (IMR_MSK & ISTR_RESET)
-	if (wIstr & ISTR_RESET & wInterrupt_Mask)
-	{
-		_SetISTR((uint16_t)CLR_RESET);
-		Device_Property.Reset();
-	#ifdef RESET_CALLBACK
-		RESET_Callback();
-	#endif
-	}
-#endif
-
-	/*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*/
-#if (IMR_MSK & ISTR_DOVR)
-	if (wIstr & ISTR_DOVR & wInterrupt_Mask)
-	{
-		_SetISTR((uint16_t)CLR_DOVR);
-	#ifdef DOVR_CALLBACK
-		DOVR_Callback();
-	#endif
-	}
-#endif
-
-	/*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*/
-#if (IMR_MSK & ISTR_ERR)
-	if (wIstr & ISTR_ERR & wInterrupt_Mask)
-	{
-		_SetISTR((uint16_t)CLR_ERR);
-	#ifdef ERR_CALLBACK
-		ERR_Callback();
-	#endif
-	}
-#endif
-
-	/*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*/
-#if (IMR_MSK & ISTR_WKUP)
-	if (wIstr & ISTR_WKUP & wInterrupt_Mask)
-	{
-		_SetISTR((uint16_t)CLR_WKUP);
-		Resume(RESUME_EXTERNAL);
-	#ifdef WKUP_CALLBACK
-		WKUP_Callback();
-	#endif
-	}
-#endif
-  
-	/*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*/
-#if (IMR_MSK & ISTR_SUSP)
-	if (wIstr & ISTR_SUSP & wInterrupt_Mask)
-	{
-		/* check if SUSPEND is possible */
-		if (fSuspendEnabled)
-		{
-			Suspend();
-		}
-		else
-		{
-			/* if not possible then resume after xx ms */
-			Resume(RESUME_LATER);
-		}
-		
-		/* clear of the ISTR bit must be done after setting of CNTR_FSUSP */
-		_SetISTR((uint16_t)CLR_SUSP);
-	#ifdef SUSP_CALLBACK
-		SUSP_Callback();
-	#endif
-	}
-#endif
-
-	/*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*/
-#if (IMR_MSK & ISTR_SOF)
-	if (wIstr & ISTR_SOF & wInterrupt_Mask)
-	{
-		_SetISTR((uint16_t)CLR_SOF);
-		bIntPackSOF++;
-		
-	#ifdef SOF_CALLBACK
-		SOF_Callback();
-	#endif
-	}
-#endif
-
-	/*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*/
-#if (IMR_MSK & ISTR_ESOF)
-	if (wIstr & ISTR_ESOF & wInterrupt_Mask)
-	{
-		_SetISTR((uint16_t)CLR_ESOF);
-		/* resume handling timing is made with ESOFs */
-		Resume(RESUME_ESOF); /* request without change of the machine state */
-	
-	#ifdef ESOF_CALLBACK
-		ESOF_Callback();
-	#endif
-	}
-#endif
-}
+#include "stm32f10x.h"
+#include "usb_type.h"
+#include "usb_regs.h"
+#include "usb_pwr.h"
+#include "usb_istr.h"
+#include "usb_init.h"
+#include "usb_int.h"
+#include "usb_lib.h"
+
+__IO uint16_t wIstr;  /* ISTR register last read value */
+__IO uint8_t bIntPackSOF = 0;  /* SOFs received between 2 consecutive packets */
+
+/* 函数指针数组，每个端点服务的执行函数列表 */
+void (*pEpInt_IN[7])(void) =
+{
+	EP1_IN_Callback,
+	EP2_IN_Callback,
+	EP3_IN_Callback,
+	EP4_IN_Callback,
+	EP5_IN_Callback,
+	EP6_IN_Callback,
+	EP7_IN_Callback,
+};
+
+void (*pEpInt_OUT[7])(void) =
+{
+	EP1_OUT_Callback,
+	EP2_OUT_Callback,
+	EP3_OUT_Callback,
+	EP4_OUT_Callback,
+	EP5_OUT_Callback,
+	EP6_OUT_Callback,
+	EP7_OUT_Callback,
+};
+
+/*
+*********************************************************************************************************
+*	函 数 名: USB_Istr
+*	功能说明: USB ISTR 中断服务程序
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void USB_Istr(void)
+{
+	wIstr = _GetISTR();
+
+#if (IMR_MSK & ISTR_CTR)
+	if (wIstr & ISTR_CTR & wInterrupt_Mask)
+	{
+		/* servicing of the endpoint correct transfer interrupt */
+		/* clear of the CTR flag into the sub */
+		CTR_LP();
+	#ifdef CTR_CALLBACK
+	    CTR_Callback();
+	#endif
+  	}
+#endif  
+
+	/*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*/
+#if (IMR_MSK & ISTR_RESET)
+	if (wIstr & ISTR_RESET & wInterrupt_Mask)
+	{
+		_SetISTR((uint16_t)CLR_RESET);
+		Device_Property.Reset();
+	#ifdef RESET_CALLBACK
+		RESET_Callback();
+	#endif
+	}
+#endif
+
+	/*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*/
+#if (IMR_MSK & ISTR_DOVR)
+	if (wIstr & ISTR_DOVR & wInterrupt_Mask)
+	{
+		_SetISTR((uint16_t)CLR_DOVR);
+	#ifdef DOVR_CALLBACK
+		DOVR_Callback();
+	#endif
+	}
+#endif
+
+	/*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*/
+#if (IMR_MSK & ISTR_ERR)
+	if (wIstr & ISTR_ERR & wInterrupt_Mask)
+	{
+		_SetISTR((uint16_t)CLR_ERR);
+	#ifdef ERR_CALLBACK
+		ERR_Callback();
+	#endif
+	}
+#endif
+
+	/*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*/
+#if (IMR_MSK & ISTR_WKUP)
+	if (wIstr & ISTR_WKUP & wInterrupt_Mask)
+	{
+		_SetISTR((uint16_t)CLR_WKUP);
+		Resume(RESUME_EXTERNAL);
+	#ifdef WKUP_CALLBACK
+		WKUP_Callback();
+	#endif
+	}
+#endif
+  
+	/*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*/
+#if (IMR_MSK & ISTR_SUSP)
+	if (wIstr & ISTR_SUSP & wInterrupt_Mask)
+	{
+		/* check if SUSPEND is possible */
+		if (fSuspendEnabled)
+		{
+			Suspend();
+		}
+		else
+		{
+			/* if not possible then resume after xx ms */
+			Resume(RESUME_LATER);
+		}
+		
+		/* clear of the ISTR bit must be done after setting of CNTR_FSUSP */
+		_SetISTR((uint16_t)CLR_SUSP);
+	#ifdef SUSP_CALLBACK
+		SUSP_Callback();
+	#endif
+	}
+#endif
+
+	/*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*/
+#if (IMR_MSK & ISTR_SOF)
+	if (wIstr & ISTR_SOF & wInterrupt_Mask)
+	{
+		_SetISTR((uint16_t)CLR_SOF);
+		bIntPackSOF++;
+		
+	#ifdef SOF_CALLBACK
+		SOF_Callback();
+	#endif
+	}
+#endif
+
+	/*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*/
+#if (IMR_MSK & ISTR_ESOF)
+	if (wIstr & ISTR_ESOF & wInterrupt_Mask)
+	{
+		_SetISTR((uint16_t)CLR_ESOF);
+		/* resume handling timing is made with ESOFs */
+		Resume(RESUME_ESOF); /* request without change of the machine state */
+	
+	#ifdef ESOF_CALLBACK
+		ESOF_Callback();
+	#endif
+	}
+#endif
+}
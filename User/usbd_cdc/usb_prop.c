@@ -1,382 +1,541 @@
-#include "usb_lib.h"
-#include "usb_conf.h"
-#include "usb_prop.h"
-#include "usb_desc.h"
-#include "usb_pwr.h"
-#include "hw_config.h"
-
-static uint8_t s_Request = 0;
-
-LINE_CODING linecoding =
-{
-	115200, /* 波特率 */
-	0x00,   /* 停止位-1 */
-	0x00,   /* 检验位： 无 */
-	0x08    /* 数据位：8bit */
-};
-
-DEVICE Device_Table =
-{
-    EP_NUM,	/* 端点个数 */
-    1
-};
-
-/* 设备属性 */
-DEVICE_PROP Device_Property =
-{
-    Virtual_Com_Port_init,
-    Virtual_Com_Port_Reset,
-    Virtual_Com_Port_Status_In,
-    Virtual_Com_Port_Status_Out,
-    Virtual_Com_Port_Data_Setup,
-    Virtual_Com_Port_NoData_Setup,
-    Virtual_Com_Port_Get_Interface_Setting,
-    Virtual_Com_Port_GetDeviceDescriptor,
-    Virtual_Com_Port_GetConfigDescriptor,
-    Virtual_Com_Port_GetStringDescriptor,
-    0,
-    0x40 	/*MAX PACKET SIZE*/
-};
-
-USER_STANDARD_REQUESTS User_Standard_Requests =
-{
-    Virtual_Com_Port_GetConfiguration,
-    Virtual_Com_Port_SetConfiguration,
-    Virtual_Com_Port_GetInterface,
-    Virtual_Com_Port_SetInterface,
-    Virtual_Com_Port_GetStatus,
-    Virtual_Com_Port_ClearFeature,
-    Virtual_Com_Port_SetEndPointFeature,
-    Virtual_Com_Port_SetDeviceFeature,
-    Virtual_Com_Port_SetDeviceAddress
-};
-
-ONE_DESCRIPTOR Device_Descriptor =
-{
-    (uint8_t*)Virtual_Com_Port_DeviceDescriptor,
-    VIRTUAL_COM_PORT_SIZ_DEVICE_DESC
-};
-
-ONE_DESCRIPTOR Config_Descriptor =
-{
-    (uint8_t*)Virtual_Com_Port_ConfigDescriptor,
-    VIRTUAL_COM_PORT_SIZ_CONFIG_DESC
-};
-
-ONE_DESCRIPTOR String_Descriptor[4] =
-{
-	{(uint8_t*)Virtual_Com_Port_StringLangID, VIRTUAL_COM_PORT_SIZ_STRING_LANGID},
-	{(uint8_t*)Virtual_Com_Port_StringVendor, VIRTUAL_COM_PORT_SIZ_STRING_VENDOR},
-	{(uint8_t*)Virtual_Com_Port_StringProduct, VIRTUAL_COM_PORT_SIZ_STRING_PRODUCT},
-	{(uint8_t*)Virtual_Com_Port_StringSerial, VIRTUAL_COM_PORT_SIZ_STRING_SERIAL}
-};
-
-/*
-*********************************************************************************************************
-*	函 数 名: Virtual_Com_Port_init
-*	功能说明: 虚拟串口初始化
-*	形    参: 无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void Virtual_Com_Port_init(void)
-{
-	/* 获取设备序列号 */
-	Get_SerialNum(Virtual_Com_Port_StringSerial);
-	
-	pInformation->Current_Configuration = 0;		/* pInformation 全局变量，在USB固件库中定义 */
-	
-	/* 连接USB设备。该函数会使能USB上拉电阻，并进行必要的设置 */
-	usb_PowerOn();
-	
-	/* 执行基本的设备初始化 */
-	USB_SIL_Init();
-	
-	bDeviceState = UNCONNECTED;		/* 更行设备状态变量 */
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: Virtual_Com_Port_Reset
-*	功能说明: 虚拟串口复位
-*	形    参: 无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void Virtual_Com_Port_Reset(void)
-{
-	/* 设置设备状态为：未配置 */
-	pInformation->Current_Configuration = 0;
-	
-	/* 设置设备当前特性 */
-	pInformation->Current_Feature = Virtual_Com_Port_ConfigDescriptor[7];
-	
-	/* 设置设备当前接口 */
-	pInformation->Current_Interface = 0;
-	
-	SetBTABLE(BTABLE_ADDRESS);	/* 设置分组缓冲区描述报表寄存器BTABLE中的地址 */
-	
-	/* 初始化端点0为控制传输模式 */
-	SetEPType(ENDP0, EP_CONTROL);
-	SetEPTxStatus(ENDP0, EP_TX_STALL);
-	SetEPRxAddr(ENDP0, ENDP0_RXADDR);
-	SetEPTxAddr(ENDP0, ENDP0_TXADDR);
-	Clear_Status_Out(ENDP0);
-	SetEPRxCount(ENDP0, Device_Property.MaxPacketSize);
-	SetEPRxValid(ENDP0);
-	
-	/* 初始化端点1为BULK批量传输模式 */
-	SetEPType(ENDP1, EP_BULK);
-	SetEPTxAddr(ENDP1, ENDP1_TXADDR);
-	SetEPTxStatus(ENDP1, EP_TX_NAK);
-	SetEPRxStatus(ENDP1, EP_RX_DIS);
-	
-	/* 初始化端点2为中断传输模式 */
-	SetEPType(ENDP2, EP_INTERRUPT);
-	SetEPTxAddr(ENDP2, ENDP2_TXADDR);
-	SetEPRxStatus(ENDP2, EP_RX_DIS);
-	SetEPTxStatus(ENDP2, EP_TX_NAK);
-	
-	/* 初始化端点3为BULK批量传输模式 */
-	SetEPType(ENDP3, EP_BULK);
-	SetEPRxAddr(ENDP3, ENDP3_RXADDR);
-	SetEPRxCount(ENDP3, VIRTUAL_COM_PORT_DATA_SIZE);
-	SetEPRxStatus(ENDP3, EP_RX_VALID);
-	SetEPTxStatus(ENDP3, EP_TX_DIS);
-	
-	/* Set this device to response on default address */
-	SetDeviceAddress(0);
-
-	bDeviceState = ATTACHED;	/* 设备已连接 */
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: Virtual_Com_Port_SetConfiguration
-*	功能说明: 更新设备状态为：已配置
-*	形    参: 无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void Virtual_Com_Port_SetConfiguration(void)
-{
-	DEVICE_INFO *pInfo = &Device_Info;
-	
-	if (pInfo->Current_Configuration != 0)
-	{
-		/* 设备已经配置完成 */
-		bDeviceState = CONFIGURED;
-	}
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: Virtual_Com_Port_SetDeviceAddress
-*	功能说明: 更新设备状态为：已寻址
-*	形    参: 无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void Virtual_Com_Port_SetDeviceAddress (void)
-{
-	bDeviceState = ADDRESSED;
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: Virtual_Com_Port_Status_In
-*	功能说明: Virtual COM Port Status In Routine.
-*	形    参: 无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void Virtual_Com_Port_Status_In(void)
-{
-	if (s_Request == SET_LINE_CODING)
-	{
-		/* USART_Config(); */
-		s_Request = 0;
-	}
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: Virtual_Com_Port_Status_Out
-*	功能说明: Virtual COM Port Status OUT Routine.
-*	形    参: 无
-*	返 回 值: 无
-*********************************************************************************************************
-*/
-void Virtual_Com_Port_Status_Out(void)
-{
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: Virtual_Com_Port_Data_Setup
-*	功能说明: handle the data class specific requests
-*	形    参: RequestNo
-*	返 回 值: USB_UNSUPPORT or USB_SUCCESS.
-*********************************************************************************************************
-*/
-RESULT Virtual_Com_Port_Data_Setup(uint8_t RequestNo)
-{
-	uint8_t    *(*CopyRoutine)(uint16_t);
-	
-	CopyRoutine = NULL;
-	
-	if (RequestNo == GET_LINE_CODING)
-	{
-		if (Type_Recipient == (CLASS_REQUEST | INTERFACE_RECIPIENT))
-		{
-			CopyRoutine = Virtual_Com_Port_GetLineCoding;
-		}
-	}
-	else if (RequestNo == SET_LINE_CODING)
-	{
-		if (Type_Recipient == (CLASS_REQUEST | INTERFACE_RECIPIENT))
-		{
-			CopyRoutine = Virtual_Com_Port_SetLineCoding;
-		}
-		s_Request = SET_LINE_CODING;
-	}
-	
-	if (CopyRoutine == NULL)
-	{
-		return USB_UNSUPPORT;
-	}
-	
-	pInformation->Ctrl_Info.CopyData = CopyRoutine;
-	pInformation->Ctrl_Info.Usb_wOffset = 0;
-	(*CopyRoutine)(0);
-	return USB_SUCCESS;
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: Virtual_Com_Port_NoData_Setup
-*	功能说明:  handle the no data class specific requests.
-*	形    参: RequestNo
-*	返 回 值: USB_UNSUPPORT or USB_SUCCESS.
-*********************************************************************************************************
-*/
-RESULT Virtual_Com_Port_NoData_Setup(uint8_t RequestNo)
-{
-	if (Type_Recipient == (CLASS_REQUEST | INTERFACE_RECIPIENT))
-	{
-		if (RequestNo == SET_COMM_FEATURE)
-		{
-			return USB_SUCCESS;
-		}
-		else if (RequestNo == SET_CONTROL_LINE_STATE)
-		{
-			return USB_SUCCESS;
-		}
-	}
-	
-	return USB_UNSUPPORT;
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: Virtual_Com_Port_GetDeviceDescriptor
-*	功能说明:  获取设备描述符
-*	形    参: Length : 长度
-*	返 回 值: 设备描述符数组的地址
-*********************************************************************************************************
-*/
-uint8_t *Virtual_Com_Port_GetDeviceDescriptor(uint16_t Length)
-{
-	return Standard_GetDescriptorData(Length, &Device_Descriptor);
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: Virtual_Com_Port_GetConfigDescriptor
-*	功能说明:  获取配置描述符
-*	形    参: Length : 长度
-*	返 回 值: 配置描述符数组的地址
-*********************************************************************************************************
-*/
-uint8_t *Virtual_Com_Port_GetConfigDescriptor(uint16_t Length)
-{
-	return Standard_GetDescriptorData(Length, &Config_Descriptor);
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: Virtual_Com_Port_GetStringDescriptor
-*	功能说明:  获取字符串描述符
-*	形    参: Length : 长度
-*	返 回 值: 字符串描述符数组的地址
-*********************************************************************************************************
-*/
-uint8_t *Virtual_Com_Port_GetStringDescriptor(uint16_t Length)
-{
-	uint8_t wValue0 = pInformation->USBwValue0;
-	if (wValue0 > 4)
-	{
-		return NULL;
-	}
-	else
-	{
-		return Standard_GetDescriptorData(Length, &String_Descriptor[wValue0]);
-	}
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: Virtual_Com_Port_Get_Interface_Setting
-*	功能说明: 测试设备是否支持相应的接口
-*	形    参: Interface : 接口号； AlternateSetting ：接口设置号
-*	返 回 值: 字符串描述符数组的地址
-*********************************************************************************************************
-*/
-RESULT Virtual_Com_Port_Get_Interface_Setting(uint8_t Interface, uint8_t AlternateSetting)
-{
-	if (AlternateSetting > 0)
-	{
-		return USB_UNSUPPORT;
-	}
-	else if (Interface > 1)
-	{
-		return USB_UNSUPPORT;
-	}
-	return USB_SUCCESS;
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: Virtual_Com_Port_GetLineCoding
-*	功能说明: 发送 linecoding 结构给PC主机
-*	形    参: Length : 长度
-*	返 回 值: linecoding 结构体的指针
-*********************************************************************************************************
-*/
-uint8_t *Virtual_Com_Port_GetLineCoding(uint16_t Length)
-{
-	if (Length == 0)
-	{
-		pInformation->Ctrl_Info.Usb_wLength = sizeof(linecoding);
-		return NULL;
-	}
-	return (uint8_t *)&linecoding;
-}
-
-/*
-*********************************************************************************************************
-*	函 数 名: Virtual_Com_Port_SetLineCoding
-*	功能说明: 设置linecoding结构体的字段
-*	形    参: Length : 长度
-*	返 回 值: linecoding 结构体的指针
-*********************************************************************************************************
-*/
-uint8_t *Virtual_Com_Port_SetLineCoding(uint16_t Length)
-{
-	if (Length == 0)
-	{
-		pInformation->Ctrl_Info.Usb_wLength = sizeof(linecoding);
-		return NULL;
-	}
-	return(uint8_t *)&linecoding;
-}
+#include "usb_lib.h"
+#include "usb_conf.h"
+#include "usb_prop.h"
+#include "usb_desc.h"
+#include "usb_pwr.h"
+#include "hw_config.h"
+#include "usb_bridge.h"
+
+static uint8_t s_Request = 0;
+static uint8_t s_RequestCdc = 0;	/* GET/SET_LINE_CODING 请求对应的CDC虚拟串口序号, 在数据和状态阶段使用 */
+
+/* 每个CDC虚拟串口一个线路编码, 按通信接口号区分 (接口0 -> [0], 接口2 -> [1]) */
+LINE_CODING linecoding[VIRTUAL_COM_PORT_NUM_CDC] =
+{
+	{
+		115200, /* 波特率 */
+		0x00,   /* 停止位-1 */
+		0x00,   /* 检验位： 无 */
+		0x08    /* 数据位：8bit */
+	},
+#if USB_COMPOSITE_EN == 1
+	{
+		115200,
+		0x00,
+		0x00,
+		0x08
+	},
+#endif
+};
+
+static RESULT GetCdcIndex(uint8_t *_pucCdc);
+static LINE_CODING *GetLineCoding(void);
+#if USB_COMPOSITE_EN == 1
+	static void UsbPortEpInit(USB_COM_FIFO_T *_pPort);
+#endif
+
+DEVICE Device_Table =
+{
+    EP_NUM,	/* 端点个数 */
+    1
+};
+
+/* 设备属性 */
+DEVICE_PROP Device_Property =
+{
+    Virtual_Com_Port_init,
+    Virtual_Com_Port_Reset,
+    Virtual_Com_Port_Status_In,
+    Virtual_Com_Port_Status_Out,
+    Virtual_Com_Port_Data_Setup,
+    Virtual_Com_Port_NoData_Setup,
+    Virtual_Com_Port_Get_Interface_Setting,
+    Virtual_Com_Port_GetDeviceDescriptor,
+    Virtual_Com_Port_GetConfigDescriptor,
+    Virtual_Com_Port_GetStringDescriptor,
+    0,
+    USB_EP0_SIZE 	/*MAX PACKET SIZE, 和设备描述符的 bMaxPacketSize0 一致*/
+};
+
+USER_STANDARD_REQUESTS User_Standard_Requests =
+{
+    Virtual_Com_Port_GetConfiguration,
+    Virtual_Com_Port_SetConfiguration,
+    Virtual_Com_Port_GetInterface,
+    Virtual_Com_Port_SetInterface,
+    Virtual_Com_Port_GetStatus,
+    Virtual_Com_Port_ClearFeature,
+    Virtual_Com_Port_SetEndPointFeature,
+    Virtual_Com_Port_SetDeviceFeature,
+    Virtual_Com_Port_SetDeviceAddress
+};
+
+ONE_DESCRIPTOR Device_Descriptor =
+{
+    (uint8_t*)Virtual_Com_Port_DeviceDescriptor,
+    VIRTUAL_COM_PORT_SIZ_DEVICE_DESC
+};
+
+ONE_DESCRIPTOR Config_Descriptor =
+{
+    (uint8_t*)Virtual_Com_Port_ConfigDescriptor,
+    VIRTUAL_COM_PORT_SIZ_CONFIG_DESC
+};
+
+ONE_DESCRIPTOR String_Descriptor[4] =
+{
+	{(uint8_t*)Virtual_Com_Port_StringLangID, VIRTUAL_COM_PORT_SIZ_STRING_LANGID},
+	{(uint8_t*)Virtual_Com_Port_StringVendor, VIRTUAL_COM_PORT_SIZ_STRING_VENDOR},
+	{(uint8_t*)Virtual_Com_Port_StringProduct, VIRTUAL_COM_PORT_SIZ_STRING_PRODUCT},
+	{(uint8_t*)Virtual_Com_Port_StringSerial, VIRTUAL_COM_PORT_SIZ_STRING_SERIAL}
+};
+
+/*
+*********************************************************************************************************
+*	函 数 名: Virtual_Com_Port_init
+*	功能说明: 虚拟串口初始化
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void Virtual_Com_Port_init(void)
+{
+	/* 获取设备序列号 */
+	Get_SerialNum(Virtual_Com_Port_StringSerial);
+	
+	pInformation->Current_Configuration = 0;		/* pInformation 全局变量，在USB固件库中定义 */
+	
+	/* 连接USB设备。该函数会使能USB上拉电阻，并进行必要的设置 */
+	usb_PowerOn();
+	
+	/* 执行基本的设备初始化 */
+	USB_SIL_Init();
+	
+	bDeviceState = UNCONNECTED;		/* 更行设备状态变量 */
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: Virtual_Com_Port_Reset
+*	功能说明: 虚拟串口复位
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void Virtual_Com_Port_Reset(void)
+{
+	/* 设置设备状态为：未配置 */
+	pInformation->Current_Configuration = 0;
+	
+	/* 设置设备当前特性 */
+	pInformation->Current_Feature = Virtual_Com_Port_ConfigDescriptor[7];
+	
+	/* 设置设备当前接口 */
+	pInformation->Current_Interface = 0;
+	
+	SetBTABLE(BTABLE_ADDRESS);	/* 设置分组缓冲区描述报表寄存器BTABLE中的地址 */
+	
+	/* 初始化端点0为控制传输模式 */
+	SetEPType(ENDP0, EP_CONTROL);
+	SetEPTxStatus(ENDP0, EP_TX_STALL);
+	SetEPRxAddr(ENDP0, ENDP0_RXADDR);
+	SetEPTxAddr(ENDP0, ENDP0_TXADDR);
+	Clear_Status_Out(ENDP0);
+	SetEPRxCount(ENDP0, Device_Property.MaxPacketSize);
+	SetEPRxValid(ENDP0);
+	
+	/* 初始化端点1为BULK批量传输模式 */
+	SetEPType(ENDP1, EP_BULK);
+#if USB_DBL_BUF_EN == 1
+	/*
+		双缓冲IN端点: USB模块发送 DTOG_TX 指向的缓冲区, 程序填写 SW_BUF(DTOG_RX位) 指向的缓冲区。
+		两者相等时没有可发送的包, 端点回应NAK。因此端点状态始终为 VALID, 由 SW_BUF 控制发送。
+	*/
+	SetEPDoubleBuff(ENDP1);
+	SetEPDblBuffAddr(ENDP1, ENDP1_BUF0ADDR, ENDP1_BUF1ADDR);
+	SetEPDblBuffCount(ENDP1, EP_DBUF_IN, 0);
+	ClearDTOG_RX(ENDP1);
+	ClearDTOG_TX(ENDP1);
+	SetEPRxStatus(ENDP1, EP_RX_DIS);
+	SetEPTxStatus(ENDP1, EP_TX_VALID);
+#else
+	SetEPTxAddr(ENDP1, ENDP1_TXADDR);
+	SetEPTxStatus(ENDP1, EP_TX_NAK);
+	SetEPRxStatus(ENDP1, EP_RX_DIS);
+#endif
+	g_tUsbFifo[USB_COM1].ucTxBusy = 0;
+	g_tUsbFifo[USB_COM1].ucTxReady = 0;
+	g_tUsbFifo[USB_COM1].ucTxZlp = 0;
+	
+	/* 初始化端点2为中断传输模式 */
+	SetEPType(ENDP2, EP_INTERRUPT);
+	SetEPTxAddr(ENDP2, ENDP2_TXADDR);
+	SetEPRxStatus(ENDP2, EP_RX_DIS);
+	SetEPTxStatus(ENDP2, EP_TX_NAK);
+	
+	/* 初始化端点3为BULK批量传输模式 */
+	SetEPType(ENDP3, EP_BULK);
+#if USB_DBL_BUF_EN == 1
+	/*
+		双缓冲OUT端点: USB模块接收到 DTOG_RX 指向的缓冲区, 程序读取 SW_BUF(DTOG_TX位) 指向的缓冲区。
+		SW_BUF 初值为1: 缓冲区0空闲可接收, 缓冲区1归程序所有(空)。
+	*/
+	SetEPDoubleBuff(ENDP3);
+	SetEPDblBuffAddr(ENDP3, ENDP3_BUF0ADDR, ENDP3_BUF1ADDR);
+	SetEPDblBuffCount(ENDP3, EP_DBUF_OUT, VIRTUAL_COM_PORT_DATA_SIZE);
+	ClearDTOG_RX(ENDP3);
+	ClearDTOG_TX(ENDP3);
+	ToggleDTOG_TX(ENDP3);
+#else
+	SetEPRxAddr(ENDP3, ENDP3_RXADDR);
+	SetEPRxCount(ENDP3, VIRTUAL_COM_PORT_DATA_SIZE);
+#endif
+	SetEPRxStatus(ENDP3, EP_RX_VALID);
+	g_tUsbFifo[USB_COM1].ucRxNak = 0;
+	SetEPTxStatus(ENDP3, EP_TX_DIS);
+	
+#if USB_COMPOSITE_EN == 1
+	/* 初始化 USB_COM2 (EP4) 和 USB_VENDOR (EP5, EP6) 为BULK批量传输模式 */
+	UsbPortEpInit(&g_tUsbFifo[USB_COM2]);
+	UsbPortEpInit(&g_tUsbFifo[USB_VENDOR]);
+	
+	/* 初始化端点7为中断传输模式, USB_COM2 的通知端点 */
+	SetEPType(ENDP7, EP_INTERRUPT);
+	SetEPTxAddr(ENDP7, ENDP7_TXADDR);
+	SetEPRxStatus(ENDP7, EP_RX_DIS);
+	SetEPTxStatus(ENDP7, EP_TX_NAK);
+#endif
+	
+	/* Set this device to response on default address */
+	SetDeviceAddress(0);
+
+	bDeviceState = ATTACHED;	/* 设备已连接 */
+}
+
+#if USB_COMPOSITE_EN == 1
+/*
+*********************************************************************************************************
+*	函 数 名: UsbPortEpInit
+*	功能说明: 把端口的IN、OUT端点初始化为单缓冲BULK端点。IN和OUT可以是同一个端点(共用端点寄存器)。
+*	形    参: _pPort : 端口
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+static void UsbPortEpInit(USB_COM_FIFO_T *_pPort)
+{
+	SetEPType(_pPort->ucTxEp, EP_BULK);
+	SetEPTxAddr(_pPort->ucTxEp, _pPort->usTxAddr[0]);
+	SetEPTxStatus(_pPort->ucTxEp, EP_TX_NAK);
+	if (_pPort->ucRxEp != _pPort->ucTxEp)
+	{
+		SetEPRxStatus(_pPort->ucTxEp, EP_RX_DIS);
+		SetEPType(_pPort->ucRxEp, EP_BULK);
+		SetEPTxStatus(_pPort->ucRxEp, EP_TX_DIS);
+	}
+	SetEPRxAddr(_pPort->ucRxEp, _pPort->usRxAddr[0]);
+	SetEPRxCount(_pPort->ucRxEp, _pPort->usRxPktSize);
+	SetEPRxStatus(_pPort->ucRxEp, EP_RX_VALID);
+	
+	_pPort->ucTxBusy = 0;
+	_pPort->ucTxReady = 0;
+	_pPort->ucTxZlp = 0;
+	_pPort->ucRxNak = 0;
+}
+#endif
+
+/*
+*********************************************************************************************************
+*	函 数 名: Virtual_Com_Port_SetConfiguration
+*	功能说明: 更新设备状态为：已配置
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void Virtual_Com_Port_SetConfiguration(void)
+{
+	DEVICE_INFO *pInfo = &Device_Info;
+	uint8_t i;
+	
+	if (pInfo->Current_Configuration != 0)
+	{
+		/* 设备已经配置完成 */
+		bDeviceState = CONFIGURED;
+
+		for (i = 0; i < USB_PORT_NUM; i++)
+		{
+			usb_StartTx(&g_tUsbFifo[i]);	/* 发送配置完成前各端口缓存的数据 */
+		}
+	}
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: Virtual_Com_Port_SetDeviceAddress
+*	功能说明: 更新设备状态为：已寻址
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void Virtual_Com_Port_SetDeviceAddress (void)
+{
+	bDeviceState = ADDRESSED;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: Virtual_Com_Port_Status_In
+*	功能说明: Virtual COM Port Status In Routine.
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void Virtual_Com_Port_Status_In(void)
+{
+	if (s_Request == SET_LINE_CODING)
+	{
+		/* 状态阶段时数据阶段已经完成, linecoding 中是PC新设置的值 */
+	#if USB_BRIDGE_EN == 1
+		if (s_RequestCdc == USB_BRIDGE_PORT)	/* CDC序号和 USB_COM1/USB_COM2 端口号相同 */
+		{
+			usb_BridgeSetLineCoding(&linecoding[s_RequestCdc]);
+		}
+	#endif
+		s_Request = 0;
+	}
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: Virtual_Com_Port_Status_Out
+*	功能说明: Virtual COM Port Status OUT Routine.
+*	形    参: 无
+*	返 回 值: 无
+*********************************************************************************************************
+*/
+void Virtual_Com_Port_Status_Out(void)
+{
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: Virtual_Com_Port_Data_Setup
+*	功能说明: handle the data class specific requests
+*	形    参: RequestNo
+*	返 回 值: USB_UNSUPPORT or USB_SUCCESS.
+*********************************************************************************************************
+*/
+RESULT Virtual_Com_Port_Data_Setup(uint8_t RequestNo)
+{
+	uint8_t    *(*CopyRoutine)(uint16_t);
+	
+	CopyRoutine = NULL;
+	
+	/* 只有CDC接口支持线路编码请求, 其他接口(例如厂商自定义接口)回应 STALL */
+	if (GetCdcIndex(&s_RequestCdc) != USB_SUCCESS)
+	{
+		return USB_UNSUPPORT;
+	}
+	
+	if (RequestNo == GET_LINE_CODING)
+	{
+		if (Type_Recipient == (CLASS_REQUEST | INTERFACE_RECIPIENT))
+		{
+			CopyRoutine = Virtual_Com_Port_GetLineCoding;
+		}
+	}
+	else if (RequestNo == SET_LINE_CODING)
+	{
+		if (Type_Recipient == (CLASS_REQUEST | INTERFACE_RECIPIENT))
+		{
+			CopyRoutine = Virtual_Com_Port_SetLineCoding;
+		}
+		s_Request = SET_LINE_CODING;
+	}
+	
+	if (CopyRoutine == NULL)
+	{
+		return USB_UNSUPPORT;
+	}
+	
+	pInformation->Ctrl_Info.CopyData = CopyRoutine;
+	pInformation->Ctrl_Info.Usb_wOffset = 0;
+	(*CopyRoutine)(0);
+	return USB_SUCCESS;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: Virtual_Com_Port_NoData_Setup
+*	功能说明:  handle the no data class specific requests.
+*	形    参: RequestNo
+*	返 回 值: USB_UNSUPPORT or USB_SUCCESS.
+*********************************************************************************************************
+*/
+RESULT Virtual_Com_Port_NoData_Setup(uint8_t RequestNo)
+{
+	uint8_t ucCdc;
+	
+	if (Type_Recipient == (CLASS_REQUEST | INTERFACE_RECIPIENT))
+	{
+		if (GetCdcIndex(&ucCdc) != USB_SUCCESS)
+		{
+			return USB_UNSUPPORT;	/* 不是CDC的接口 */
+		}
+		
+		if (RequestNo == SET_COMM_FEATURE)
+		{
+			return USB_SUCCESS;
+		}
+		else if (RequestNo == SET_CONTROL_LINE_STATE)
+		{
+		#if USB_BRIDGE_EN == 1
+			if (ucCdc == USB_BRIDGE_PORT)
+			{
+				usb_BridgeSetCtrlLine(pInformation->USBwValue0);	/* bit0 = DTR, bit1 = RTS */
+			}
+		#endif
+			return USB_SUCCESS;
+		}
+	}
+	
+	return USB_UNSUPPORT;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: Virtual_Com_Port_GetDeviceDescriptor
+*	功能说明:  获取设备描述符
+*	形    参: Length : 长度
+*	返 回 值: 设备描述符数组的地址
+*********************************************************************************************************
+*/
+uint8_t *Virtual_Com_Port_GetDeviceDescriptor(uint16_t Length)
+{
+	return Standard_GetDescriptorData(Length, &Device_Descriptor);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: Virtual_Com_Port_GetConfigDescriptor
+*	功能说明:  获取配置描述符
+*	形    参: Length : 长度
+*	返 回 值: 配置描述符数组的地址
+*********************************************************************************************************
+*/
+uint8_t *Virtual_Com_Port_GetConfigDescriptor(uint16_t Length)
+{
+	return Standard_GetDescriptorData(Length, &Config_Descriptor);
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: Virtual_Com_Port_GetStringDescriptor
+*	功能说明:  获取字符串描述符
+*	形    参: Length : 长度
+*	返 回 值: 字符串描述符数组的地址
+*********************************************************************************************************
+*/
+uint8_t *Virtual_Com_Port_GetStringDescriptor(uint16_t Length)
+{
+	uint8_t wValue0 = pInformation->USBwValue0;
+	if (wValue0 > 4)
+	{
+		return NULL;
+	}
+	else
+	{
+		return Standard_GetDescriptorData(Length, &String_Descriptor[wValue0]);
+	}
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: Virtual_Com_Port_Get_Interface_Setting
+*	功能说明: 测试设备是否支持相应的接口
+*	形    参: Interface : 接口号； AlternateSetting ：接口设置号
+*	返 回 值: 字符串描述符数组的地址
+*********************************************************************************************************
+*/
+RESULT Virtual_Com_Port_Get_Interface_Setting(uint8_t Interface, uint8_t AlternateSetting)
+{
+	if (AlternateSetting > 0)
+	{
+		return USB_UNSUPPORT;
+	}
+	else if (Interface >= VIRTUAL_COM_PORT_NUM_INTERFACE)
+	{
+		return USB_UNSUPPORT;
+	}
+	return USB_SUCCESS;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: GetCdcIndex
+*	功能说明: 根据类请求的接口号(wIndex)得到CDC虚拟串口的序号。
+*			  每个CDC占用2个接口, 通信接口号为偶数, 数据接口号为奇数。
+*	形    参: _pucCdc : 存放CDC序号, 0 - (VIRTUAL_COM_PORT_NUM_CDC - 1)
+*	返 回 值: USB_SUCCESS 表示是CDC接口; USB_UNSUPPORT 表示不是CDC接口 (例如厂商自定义接口4), 不修改 *_pucCdc
+*********************************************************************************************************
+*/
+static RESULT GetCdcIndex(uint8_t *_pucCdc)
+{
+	uint8_t ucCdc;
+	
+	ucCdc = pInformation->USBwIndex0 / 2;
+	if (ucCdc >= VIRTUAL_COM_PORT_NUM_CDC)
+	{
+		return USB_UNSUPPORT;
+	}
+	*_pucCdc = ucCdc;
+	return USB_SUCCESS;
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: GetLineCoding
+*	功能说明: 得到当前线路编码请求对应CDC虚拟串口的 linecoding。接口号已在 Virtual_Com_Port_Data_Setup() 中检查。
+*	形    参: 无
+*	返 回 值: linecoding 结构体的指针
+*********************************************************************************************************
+*/
+static LINE_CODING *GetLineCoding(void)
+{
+	return &linecoding[s_RequestCdc];
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: Virtual_Com_Port_GetLineCoding
+*	功能说明: 发送 linecoding 结构给PC主机
+*	形    参: Length : 长度
+*	返 回 值: linecoding 结构体的指针
+*********************************************************************************************************
+*/
+uint8_t *Virtual_Com_Port_GetLineCoding(uint16_t Length)
+{
+	if (Length == 0)
+	{
+		pInformation->Ctrl_Info.Usb_wLength = sizeof(LINE_CODING);
+		return NULL;
+	}
+	return (uint8_t *)GetLineCoding();
+}
+
+/*
+*********************************************************************************************************
+*	函 数 名: Virtual_Com_Port_SetLineCoding
+*	功能说明: 设置linecoding结构体的字段
+*	形    参: Length : 长度
+*	返 回 值: linecoding 结构体的指针
+*********************************************************************************************************
+*/
+uint8_t *Virtual_Com_Port_SetLineCoding(uint16_t Length)
+{
+	if (Length == 0)
+	{
+		pInformation->Ctrl_Info.Usb_wLength = sizeof(LINE_CODING);
+		return NULL;
+	}
+	return(uint8_t *)GetLineCoding();
+}